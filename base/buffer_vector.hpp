@@ -246,6 +246,7 @@ public:
 
   bool empty() const { return (IsDynamic() ? m_dynamic.empty() : m_size == 0); }
   size_t size() const { return (IsDynamic() ? m_dynamic.size() : m_size); }
+  size_t capacity() const { return (IsDynamic() ? m_dynamic.capacity() : N); }
 
   T const & front() const
   {
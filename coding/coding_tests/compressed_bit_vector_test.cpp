@@ -3,10 +3,13 @@
 #include "coding/compressed_bit_vector.hpp"
 #include "coding/writer.hpp"
 
+#include "base/bits.hpp"
+
 #include <algorithm>
 #include <cstdint>
 #include <iterator>
 #include <memory>
+#include <random>
 #include <set>
 #include <vector>
 
@@ -84,6 +87,63 @@ void CheckUnion(vector<uint64_t> & setBits1, coding::CompressedBitVector::Storag
   TEST_EQUAL(resultStrategy, cbv3->GetStorageStrategy(), ());
   CheckUnion(setBits1, setBits2, *cbv3);
 }
+
+vector<uint64_t> GetSetBits(coding::CompressedBitVector const & cbv)
+{
+  vector<uint64_t> setBits;
+  coding::CompressedBitVectorEnumerator::ForEach(cbv,
+                                                 [&setBits](uint64_t i) { setBits.push_back(i); });
+  return setBits;
+}
+
+// Following functions make sorted positions of set bits which are stored with
+// Dense, Sparse and Run strategies respectively.
+vector<uint64_t> MakeDenseBits(mt19937 & rng, uint64_t numBits)
+{
+  vector<uint64_t> setBits;
+  bernoulli_distribution isSet(0.5);
+  for (uint64_t i = 0; i < numBits; ++i)
+  {
+    if (isSet(rng))
+      setBits.push_back(i);
+  }
+  return setBits;
+}
+
+vector<uint64_t> MakeSparseBits(mt19937 & rng, uint64_t numBits)
+{
+  vector<uint64_t> setBits;
+  bernoulli_distribution isSet(0.01);
+  for (uint64_t i = 0; i < numBits; ++i)
+  {
+    if (isSet(rng))
+      setBits.push_back(i);
+  }
+  return setBits;
+}
+
+vector<uint64_t> MakeRunBits(mt19937 & rng, uint64_t numBits)
+{
+  vector<uint64_t> setBits;
+  uniform_int_distribution<uint64_t> length(1, 2000);
+  uint64_t pos = length(rng);
+  while (pos < numBits)
+  {
+    uint64_t const end = min(pos + length(rng), numBits);
+    for (; pos < end; ++pos)
+      setBits.push_back(pos);
+    pos += length(rng);
+  }
+  return setBits;
+}
+
+template <typename SetOp>
+vector<uint64_t> Apply(SetOp && op, vector<uint64_t> const & a, vector<uint64_t> const & b)
+{
+  vector<uint64_t> res;
+  op(a.begin(), a.end(), b.begin(), b.end(), back_inserter(res));
+  return res;
+}
 }  // namespace
 
 UNIT_TEST(CompressedBitVector_Intersect1)
@@ -472,3 +532,172 @@ UNIT_TEST(CompressedBitVector_SparseLeaveFirstNBits)
   for (uint64_t bit = 0; bit < (1 << 10); ++bit)
     TEST(!cbv->GetBit(bit), (bit));
 }
+
+UNIT_TEST(CompressedBitVector_RunSmoke)
+{
+  vector<uint64_t> setBits;
+  for (uint64_t i = 1000; i < 2000; ++i)
+    setBits.push_back(i);
+  for (uint64_t i = 5000; i < 6000; ++i)
+    setBits.push_back(i);
+
+  auto cbv = coding::CompressedBitVectorBuilder::FromBitPositions(setBits);
+  TEST_EQUAL(cbv->GetStorageStrategy(), coding::CompressedBitVector::StorageStrategy::Run, ());
+  TEST_EQUAL(static_cast<coding::RunCBV const &>(*cbv).NumRuns(), 2, ());
+  TEST_EQUAL(cbv->PopCount(), 2000, ());
+  TEST(!cbv->GetBit(999), ());
+  TEST(cbv->GetBit(1000), ());
+  TEST(cbv->GetBit(1999), ());
+  TEST(!cbv->GetBit(2000), ());
+  TEST(cbv->GetBit(5999), ());
+  TEST(!cbv->GetBit(6000), ());
+  TEST_EQUAL(GetSetBits(*cbv), setBits, ());
+
+  auto const first = cbv->LeaveFirstSetNBits(1500);
+  TEST_EQUAL(first->PopCount(), 1500, ());
+  TEST(first->GetBit(5499), ());
+  TEST(!first->GetBit(5500), ());
+
+  // The same bits given as bit groups.
+  vector<uint64_t> bitGroups(6000 / coding::DenseCBV::kBlockSize + 1);
+  for (auto const bit : setBits)
+    bitGroups[bit / coding::DenseCBV::kBlockSize] |= uint64_t{1} << (bit % coding::DenseCBV::kBlockSize);
+  auto fromGroups = coding::CompressedBitVectorBuilder::FromBitGroups(move(bitGroups));
+  TEST_EQUAL(fromGroups->GetStorageStrategy(), coding::CompressedBitVector::StorageStrategy::Run,
+             ());
+  TEST_EQUAL(GetSetBits(*fromGroups), setBits, ());
+}
+
+UNIT_TEST(CompressedBitVector_SerializationRun)
+{
+  mt19937 rng(0);
+  vector<uint64_t> farRuns;
+  for (uint64_t i = 0; i < 1000; ++i)
+  {
+    farRuns.push_back(i);
+    farRuns.push_back(1000000 + i);
+  }
+  sort(farRuns.begin(), farRuns.end());
+
+  // Runs are written as a dense and as a sparse bit vector respectively.
+  for (auto const & setBits : {MakeRunBits(rng, 100000), farRuns})
+  {
+    auto const cbv = coding::CompressedBitVectorBuilder::FromBitPositions(setBits);
+    TEST_EQUAL(cbv->GetStorageStrategy(), coding::CompressedBitVector::StorageStrategy::Run, ());
+
+    vector<uint8_t> buf;
+    {
+      MemWriter<vector<uint8_t>> writer(buf);
+      cbv->Serialize(writer);
+    }
+
+    MemReader reader(buf.data(), buf.size());
+    auto const deserialized = coding::CompressedBitVectorBuilder::DeserializeFromReader(reader);
+    TEST_NOT_EQUAL(deserialized->GetStorageStrategy(),
+                   coding::CompressedBitVector::StorageStrategy::Run, ());
+    TEST_EQUAL(GetSetBits(*deserialized), setBits, ());
+  }
+}
+
+UNIT_TEST(CompressedBitVector_AllStrategiesOps)
+{
+  using Strategy = coding::CompressedBitVector::StorageStrategy;
+
+  mt19937 rng(0);
+  uint64_t const kNumBits = 100000;
+  vector<pair<Strategy, vector<uint64_t>>> const bitVectors = {
+      {Strategy::Dense, MakeDenseBits(rng, kNumBits)},
+      {Strategy::Dense, MakeDenseBits(rng, kNumBits / 3)},
+      {Strategy::Sparse, MakeSparseBits(rng, kNumBits)},
+      {Strategy::Sparse, MakeSparseBits(rng, kNumBits * 3)},
+      {Strategy::Run, MakeRunBits(rng, kNumBits)},
+      {Strategy::Run, MakeRunBits(rng, kNumBits / 2)},
+      {Strategy::Sparse, {}}};
+
+  for (auto const & [strategyA, bitsA] : bitVectors)
+  {
+    auto const a = coding::CompressedBitVectorBuilder::FromBitPositions(bitsA);
+    TEST_EQUAL(a->GetStorageStrategy(), strategyA, ());
+
+    for (auto const & [strategyB, bitsB] : bitVectors)
+    {
+      auto const b = coding::CompressedBitVectorBuilder::FromBitPositions(bitsB);
+      auto const ops = make_pair(strategyA, strategyB);
+
+      auto const intersection = coding::CompressedBitVector::Intersect(*a, *b);
+      auto const expectedIntersection = Apply(
+          [](auto &&... args) { return set_intersection(args...); }, bitsA, bitsB);
+      TEST_EQUAL(GetSetBits(*intersection), expectedIntersection, (ops));
+      TEST_EQUAL(intersection->PopCount(), expectedIntersection.size(), (ops));
+
+      auto const difference = coding::CompressedBitVector::Subtract(*a, *b);
+      auto const expectedDifference = Apply(
+          [](auto &&... args) { return set_difference(args...); }, bitsA, bitsB);
+      TEST_EQUAL(GetSetBits(*difference), expectedDifference, (ops));
+      TEST_EQUAL(difference->PopCount(), expectedDifference.size(), (ops));
+
+      auto const united = coding::CompressedBitVector::Union(*a, *b);
+      auto const expectedUnion =
+          Apply([](auto &&... args) { return set_union(args...); }, bitsA, bitsB);
+      TEST_EQUAL(GetSetBits(*united), expectedUnion, (ops));
+      TEST_EQUAL(united->PopCount(), expectedUnion.size(), (ops));
+    }
+  }
+}
+
+UNIT_TEST(CompressedBitVector_BitGroupsKernels)
+{
+  using coding::BitGroupsKernel;
+
+  mt19937 rng(0);
+  uniform_int_distribution<uint64_t> random;
+  size_t const kCount = 1001;
+  vector<uint64_t> a(kCount);
+  vector<uint64_t> b(kCount);
+  for (size_t i = 0; i < kCount; ++i)
+  {
+    a[i] = random(rng);
+    b[i] = random(rng);
+  }
+
+  vector<uint64_t> expected(kCount);
+  vector<uint64_t> res(kCount);
+  for (auto const kernel : {BitGroupsKernel::Scalar, BitGroupsKernel::Avx2, BitGroupsKernel::Neon})
+  {
+    if (!coding::IsSupported(kernel))
+      continue;
+
+    for (size_t count : {size_t{0}, size_t{1}, size_t{5}, kCount})
+    {
+      uint64_t expectedPopCount = 0;
+      for (size_t i = 0; i < count; ++i)
+      {
+        expected[i] = a[i] & b[i];
+        expectedPopCount += bits::PopCount(expected[i]);
+      }
+      TEST_EQUAL(coding::IntersectBitGroups(kernel, a.data(), b.data(), count, res.data()),
+                 expectedPopCount, (kernel, count));
+      TEST(equal(res.begin(), res.begin() + count, expected.begin()), (kernel, count));
+
+      expectedPopCount = 0;
+      for (size_t i = 0; i < count; ++i)
+      {
+        expected[i] = a[i] | b[i];
+        expectedPopCount += bits::PopCount(expected[i]);
+      }
+      TEST_EQUAL(coding::UniteBitGroups(kernel, a.data(), b.data(), count, res.data()),
+                 expectedPopCount, (kernel, count));
+      TEST(equal(res.begin(), res.begin() + count, expected.begin()), (kernel, count));
+
+      expectedPopCount = 0;
+      for (size_t i = 0; i < count; ++i)
+      {
+        expected[i] = a[i] & ~b[i];
+        expectedPopCount += bits::PopCount(expected[i]);
+      }
+      TEST_EQUAL(coding::SubtractBitGroups(kernel, a.data(), b.data(), count, res.data()),
+                 expectedPopCount, (kernel, count));
+      TEST(equal(res.begin(), res.begin() + count, expected.begin()), (kernel, count));
+    }
+  }
+}
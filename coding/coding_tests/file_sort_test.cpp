@@ -1,6 +1,7 @@
 #include "testing/testing.hpp"
 
 #include "coding/file_sort.hpp"
+#include "coding/internal/file_data.hpp"
 #include "coding/write_to_sink.hpp"
 #include "coding/reader.hpp"
 
@@ -14,24 +15,26 @@ using namespace std;
 
 namespace
 {
-  void TestFileSorter(vector<uint32_t> & data, char const * tmpFileName, size_t bufferSize)
+  void TestFileSorter(vector<uint32_t> & data, char const * tmpFileName, size_t bufferSize,
+                      size_t threadsCount = 1, bool compressRuns = false)
   {
     vector<char> serial;
     typedef MemWriter<vector<char> > MemWriterType;
     MemWriterType writer(serial);
     typedef WriterFunctor<MemWriterType> OutT;
     OutT out(writer);
-    FileSorter<uint32_t, OutT> sorter(bufferSize, tmpFileName, out);
+    FileSorter<uint32_t, OutT> sorter(bufferSize, tmpFileName, out, less<uint32_t>(), threadsCount,
+                                      compressRuns);
     for (size_t i = 0; i < data.size(); ++i)
       sorter.Add(data[i]);
     sorter.SortAndFinish();
 
     TEST_EQUAL(serial.size(), data.size() * sizeof(data[0]), ());
     sort(data.begin(), data.end());
-    MemReader reader(&serial[0], serial.size());
+    MemReader reader(serial.data(), serial.size());
     TEST_EQUAL(reader.Size(), data.size() * sizeof(data[0]), ());
     vector<uint32_t> result(data.size());
-    reader.Read(0, &result[0], reader.Size());
+    reader.Read(0, result.data(), reader.Size());
     TEST_EQUAL(result, data, ());
   }
 }
@@ -55,3 +58,54 @@ UNIT_TEST(FileSorter_Random)
 
   TestFileSorter(data, "file_sorter_test_random.tmp", data.size() / 10);
 }
+
+UNIT_TEST(FileSorter_Empty)
+{
+  vector<uint32_t> data;
+  TestFileSorter(data, "file_sorter_test_empty.tmp", 10);
+  TestFileSorter(data, "file_sorter_test_empty.tmp", 10, 4 /* threadsCount */, true /* compressRuns */);
+}
+
+UNIT_TEST(FileSorter_ParallelAndCompressed)
+{
+  mt19937 rng(0);
+  vector<uint32_t> data(100000);
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = (i % 7 == 0) ? static_cast<uint32_t>(i % 100) : rng();
+
+  for (size_t const threadsCount : {1, 2, 4})
+  {
+    for (bool const compressRuns : {false, true})
+    {
+      // Small buffers make many runs, large ones make runs of several compressed blocks.
+      for (size_t const bufferSize : {size_t(1000), size_t(1000000)})
+      {
+        auto copy = data;
+        TestFileSorter(copy, "file_sorter_test_parallel.tmp", bufferSize, threadsCount,
+                       compressRuns);
+      }
+    }
+  }
+}
+
+UNIT_TEST(FileSorter_IntermediateMerges)
+{
+  mt19937 rng(0);
+  vector<uint32_t> data(300000);
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = rng();
+
+  // A 256KB budget makes several runs, while at most 3 runs of 64KB blocks are merged at once.
+  for (size_t const threadsCount : {1, 2})
+  {
+    for (bool const compressRuns : {false, true})
+    {
+      auto copy = data;
+      TestFileSorter(copy, "file_sorter_test_intermediate.tmp", 256 * 1024, threadsCount,
+                     compressRuns);
+      uint64_t size = 0;
+      TEST(!base::GetFileSize("file_sorter_test_intermediate.tmp", size), ());
+      TEST(!base::GetFileSize("file_sorter_test_intermediate.tmp.merge", size), ());
+    }
+  }
+}
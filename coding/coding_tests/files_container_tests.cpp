@@ -1,6 +1,8 @@
 #include "testing/testing.hpp"
 
 #include "coding/files_container.hpp"
+#include "coding/reader_stats.hpp"
+#include "coding/shared_page_cache.hpp"
 #include "coding/varint.hpp"
 
 #include "base/logging.hpp"
@@ -11,6 +13,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <string>
 
 #ifndef OMIM_OS_WINDOWS
@@ -19,6 +22,101 @@
 
 using namespace std;
 
+UNIT_TEST(FilesContainer_SectionStats)
+{
+  string const fName = "files_container.tmp";
+  FileWriter::DeleteFileX(fName);
+  SCOPE_GUARD(deleteFile, bind(&FileWriter::DeleteFileX, fName));
+
+  {
+    FilesContainerW writer(fName);
+    auto w = writer.GetWriter("stats_test_section");
+    for (uint32_t j = 0; j < 1000; ++j)
+      WriteVarUint(w, j);
+  }
+
+  ReaderStats::Instance().SetEnabled(true);
+  ReaderStats::Instance().GetSection("stats_test_section").Reset();
+  {
+    FilesContainerR reader(fName);
+    ReaderSource<FilesContainerR::TReader> src(reader.GetReader("stats_test_section"));
+    for (uint32_t j = 0; j < 1000; ++j)
+      TEST_EQUAL(j, ReadVarUint<uint32_t>(src), ());
+  }
+  ReaderStats::Instance().SetEnabled(false);
+
+  bool found = false;
+  for (auto const & section : ReaderStats::Instance().GetSnapshot())
+  {
+    if (section.first != "stats_test_section")
+      continue;
+    found = true;
+    TEST_GREATER(section.second.m_reads, 0, ());
+    TEST_GREATER(section.second.m_pageHits + section.second.m_pageMisses, 0, ());
+    TEST_GREATER_OR_EQUAL(section.second.m_bytesAsked, 1000, ());
+  }
+  TEST(found, ());
+
+  // Readers which are created while the stats are disabled are not accounted.
+  {
+    FilesContainerW writer(fName);
+    auto w = writer.GetWriter("stats_disabled_section");
+    WriteVarUint(w, 1u);
+  }
+  {
+    FilesContainerR reader(fName);
+    ReaderSource<FilesContainerR::TReader> src(reader.GetReader("stats_disabled_section"));
+    ReaderStats::Instance().SetEnabled(true);
+    TEST_EQUAL(1, ReadVarUint<uint32_t>(src), ());
+    ReaderStats::Instance().SetEnabled(false);
+  }
+  for (auto const & section : ReaderStats::Instance().GetSnapshot())
+    TEST_NOT_EQUAL(section.first, "stats_disabled_section", ());
+}
+
+UNIT_TEST(FilesContainer_SectionStatsSharedCache)
+{
+  string const fName = "files_container.tmp";
+  FileWriter::DeleteFileX(fName);
+  SCOPE_GUARD(deleteFile, bind(&FileWriter::DeleteFileX, fName));
+
+  {
+    FilesContainerW writer(fName);
+    // The section takes many pages, not only the ones read with the container header.
+    auto w = writer.GetWriter("stats_shared_section");
+    for (uint32_t j = 0; j < 10000; ++j)
+      WriteVarUint(w, j);
+  }
+
+  ReaderStats::Instance().SetEnabled(true);
+  ReaderStats::Instance().GetSection("stats_shared_section").Reset();
+  {
+    SharedPageCache cache(10 /* logPageSize */, 2 /* logShardsCount */, 64 * 1024 /* bytesLimit */);
+    FilesContainerR reader(make_unique<FileReader>(fName, cache));
+    for (size_t i = 0; i < 2; ++i)
+    {
+      ReaderSource<FilesContainerR::TReader> src(reader.GetReader("stats_shared_section"));
+      for (uint32_t j = 0; j < 10000; ++j)
+        TEST_EQUAL(j, ReadVarUint<uint32_t>(src), ());
+    }
+  }
+  ReaderStats::Instance().SetEnabled(false);
+
+  bool found = false;
+  for (auto const & section : ReaderStats::Instance().GetSnapshot())
+  {
+    if (section.first != "stats_shared_section")
+      continue;
+    found = true;
+    TEST_GREATER(section.second.m_reads, 0, ());
+    TEST_GREATER(section.second.m_pageMisses, 0, ());
+    // The second pass reads the cached pages.
+    TEST_GREATER(section.second.m_pageHits, 0, ());
+    TEST_EQUAL(section.second.m_readAheadPages, 0, ());
+  }
+  TEST(found, ());
+}
+
 UNIT_TEST(FilesContainer_Smoke)
 {
   string const fName = "files_container.tmp";
@@ -16,6 +16,8 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <limits>
+#include <random>
 #include <vector>
 
 using namespace coding;
@@ -69,6 +71,30 @@ void TestPolylineEncode(string testName, vector<m2::PointU> const & points,
   }
 }
 
+vector<uint64_t> MakeRandomDeltas(size_t count)
+{
+  mt19937 rng(0);
+  uniform_int_distribution<uint32_t> coord;
+  uniform_int_distribution<uint32_t> smallDiff(0, 1000);
+  vector<uint64_t> deltas;
+  deltas.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    switch (i % 3)
+    {
+    // Arbitrary bits.
+    case 0: deltas.push_back((static_cast<uint64_t>(coord(rng)) << 32) | coord(rng)); break;
+    // Far points.
+    case 1: deltas.push_back(EncodePointDeltaAsUint(PU(coord(rng), coord(rng)), PU(coord(rng), coord(rng)))); break;
+    // Near points, as in real geometry.
+    default:
+      PU const p(coord(rng) / 2, coord(rng) / 2);
+      deltas.push_back(EncodePointDeltaAsUint(PU(p.x + smallDiff(rng), p.y - smallDiff(rng)), p));
+    }
+  }
+  return deltas;
+}
+
 vector<m2::PointU> SimplifyPoints(vector<m2::PointU> const & points, double eps)
 {
   vector<m2::PointU> simpPoints;
@@ -190,3 +216,44 @@ UNIT_TEST(DecodeEncodePolyline_DataSet1)
 
   TestPolylineEncode("DataSet1", points, GetMaxPoint(), &EncodePolyline, &DecodePolyline);
 }
+
+UNIT_TEST(DecodePointDeltasFromUint_Decoders)
+{
+  TEST(IsSupported(GetBestDeltasDecoder()), ());
+  LOG(LINFO, ("Best deltas decoder:", GetBestDeltasDecoder()));
+
+  auto const deltas = MakeRandomDeltas(1000);
+  vector<uint64_t> const specialDeltas = {0, 1, 2, 3, numeric_limits<uint64_t>::max(),
+                                          0x5555555555555555ULL, 0xAAAAAAAAAAAAAAAAULL,
+                                          EncodePointDeltaAsUint(PU(0, 0), PU(0xFFFFFFFF, 0xFFFFFFFF)),
+                                          EncodePointDeltaAsUint(PU(0xFFFFFFFF, 0), PU(0, 0xFFFFFFFF))};
+
+  PU const base(123456789, 987654321);
+  for (auto const decoder : {DeltasDecoder::Scalar, DeltasDecoder::Sse2, DeltasDecoder::Avx2})
+  {
+    if (!IsSupported(decoder))
+    {
+      LOG(LINFO, ("Skip unsupported decoder", decoder));
+      continue;
+    }
+
+    for (auto const * data : {&deltas, &specialDeltas})
+    {
+      // Counts which are not multiple of vector sizes check the tails.
+      for (size_t const count : {size_t(0), size_t(1), size_t(2), size_t(3), size_t(5), size_t(7),
+                                 size_t(9), data->size()})
+      {
+        if (count > data->size())
+          continue;
+
+        vector<m2::PointI> diffs(count);
+        DecodePointDeltasFromUint(decoder, data->data(), count, diffs.data());
+        for (size_t i = 0; i < count; ++i)
+        {
+          TEST_EQUAL(DecodePointDeltaFromUint((*data)[i], base),
+                     PU(base.x + diffs[i].x, base.y + diffs[i].y), (decoder, i, (*data)[i]));
+        }
+      }
+    }
+  }
+}
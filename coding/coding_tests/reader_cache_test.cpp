@@ -2,6 +2,10 @@
 
 #include "coding/reader_cache.hpp"
 #include "coding/reader.hpp"
+#include "coding/reader_stats.hpp"
+#include "coding/shared_page_cache.hpp"
+
+#include "base/thread_pool_computational.hpp"
 
 #include <algorithm>
 #include <random>
@@ -46,3 +50,159 @@ UNIT_TEST(CacheReaderRandomTest)
     TEST_EQUAL(readMem, readCache, (pos, len, i));
   }
 }
+
+UNIT_TEST(SharedPageCacheRandomTest)
+{
+  vector<char> data(100000);
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = static_cast<char>(i % 253);
+  MemReader memReader(&data[0], data.size());
+
+  // Small limit to check eviction.
+  SharedPageCache cache(10 /* logPageSize */, 2 /* logShardsCount */, 16 * 1024 /* bytesLimit */);
+  auto const fileId = cache.GetFileId("data", data.size());
+  TEST_EQUAL(fileId, cache.GetFileId("data", data.size()), ());
+  TEST_NOT_EQUAL(fileId, cache.GetFileId("data2", data.size()), ());
+
+  auto const readPage = [&memReader](uint64_t pos, void * p, size_t size)
+  {
+    memReader.Read(pos, p, size);
+  };
+
+  mt19937 rng(0);
+  for (size_t i = 0; i < 100000; ++i)
+  {
+    size_t pos = rng() % data.size();
+    size_t len = min(static_cast<size_t>(1 + (rng() % 3000)), data.size() - pos);
+    string readMem(len, '0'), readCache(len, '0');
+    memReader.Read(pos, &readMem[0], len);
+    cache.Read(fileId, data.size(), pos, &readCache[0], len, readPage);
+    TEST_EQUAL(readMem, readCache, (pos, len, i));
+  }
+
+  auto const stats = cache.GetStats();
+  TEST_GREATER(stats.m_hits, 0, ());
+  TEST_GREATER(stats.m_misses, 0, ());
+  TEST_LESS_OR_EQUAL(stats.m_bytesCached, 16 * 1024, ());
+
+  cache.DropFile(fileId);
+  TEST_EQUAL(cache.GetStats().m_bytesCached, 0, ());
+}
+
+UNIT_TEST(SharedPageCacheDropFileByNameTest)
+{
+  vector<char> data(10000);
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = static_cast<char>(i % 253);
+  MemReader memReader(&data[0], data.size());
+  auto const readPage = [&memReader](uint64_t pos, void * p, size_t size)
+  {
+    memReader.Read(pos, p, size);
+  };
+
+  SharedPageCache cache(10 /* logPageSize */, 2 /* logShardsCount */, 16 * 1024 /* bytesLimit */);
+  auto const fileId = cache.GetFileId("data", data.size());
+  string readCache(data.size(), '0');
+  cache.Read(fileId, data.size(), 0, &readCache[0], data.size(), readPage);
+  TEST_EQUAL(cache.GetStats().m_bytesCached, data.size(), ());
+
+  cache.DropFile("data");
+  TEST_EQUAL(cache.GetStats().m_bytesCached, 0, ());
+
+  // A reader which is still open reads past the cache.
+  cache.Read(fileId, data.size(), 0, &readCache[0], data.size(), readPage);
+  TEST_EQUAL(readCache, string(data.begin(), data.end()), ());
+  TEST_EQUAL(cache.GetStats().m_bytesCached, 0, ());
+
+  // New readers get a new id and are cached again.
+  auto const newFileId = cache.GetFileId("data", data.size());
+  TEST_NOT_EQUAL(newFileId, fileId, ());
+  cache.Read(newFileId, data.size(), 0, &readCache[0], data.size(), readPage);
+  TEST_EQUAL(cache.GetStats().m_bytesCached, data.size(), ());
+}
+
+UNIT_TEST(SharedPageCacheConcurrentTest)
+{
+  vector<char> data(1 << 16);
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = static_cast<char>(i % 251);
+
+  SharedPageCache cache(8 /* logPageSize */, 3 /* logShardsCount */, 1 << 14 /* bytesLimit */);
+  auto const fileId = cache.GetFileId("data", data.size());
+
+  size_t const kThreadsCount = 4;
+  vector<size_t> errors(kThreadsCount, 0);
+  {
+    base::thread_pool::computational::ThreadPool pool(kThreadsCount);
+    for (size_t t = 0; t < kThreadsCount; ++t)
+    {
+      pool.SubmitWork([&, t]()
+      {
+        // Every thread owns its reader, only cached pages are shared.
+        MemReader memReader(&data[0], data.size());
+        mt19937 rng(static_cast<uint32_t>(t));
+        for (size_t i = 0; i < 20000; ++i)
+        {
+          size_t pos = rng() % data.size();
+          size_t len = min(static_cast<size_t>(1 + (rng() % 700)), data.size() - pos);
+          string readCache(len, '0');
+          cache.Read(fileId, data.size(), pos, &readCache[0], len,
+                     [&memReader](uint64_t pos, void * p, size_t size) { memReader.Read(pos, p, size); });
+          if (readCache != string(data.begin() + pos, data.begin() + pos + len))
+            ++errors[t];
+        }
+      });
+    }
+  }
+
+  for (size_t t = 0; t < kThreadsCount; ++t)
+    TEST_EQUAL(errors[t], 0, (t));
+}
+
+UNIT_TEST(CacheReaderReadAheadTest)
+{
+  vector<char> data(100000);
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = static_cast<char>(i % 253);
+  MemReader memReader(&data[0], data.size());
+
+  ReaderStats::Instance().SetEnabled(true);
+  ReaderSectionStats & stats = ReaderStats::Instance().GetSection("reader_cache_test");
+  stats.Reset();
+
+  ReaderCache<MemReader const> cache(10 /* logPageSize */, 6 /* logPageCount */);
+  // Sequential reads grow the read ahead window.
+  for (size_t pos = 0; pos + 100 <= data.size(); pos += 100)
+  {
+    string readCache(100, '0');
+    cache.Read(memReader, pos, &readCache[0], readCache.size(), &stats);
+    TEST_EQUAL(readCache, string(data.begin() + pos, data.begin() + pos + 100), (pos));
+  }
+  TEST_EQUAL(cache.GetReadAheadPages(), 16, ());
+
+  auto const sequential = stats.GetSnapshot();
+  TEST_EQUAL(sequential.m_reads, data.size() / 100, ());
+  TEST_GREATER_OR_EQUAL(sequential.m_bytesRead, data.size(), ());
+  TEST_LESS(sequential.m_bytesRead, 2 * data.size(), ());
+  TEST_GREATER(sequential.m_readAheadPages, 0, ());
+  TEST_LESS(sequential.m_pageMisses, 20, ());
+
+  // Random reads fall back to single pages.
+  stats.Reset();
+  mt19937 rng(0);
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    size_t pos = rng() % data.size();
+    size_t len = min(static_cast<size_t>(1 + (rng() % 127)), data.size() - pos);
+    string readCache(len, '0');
+    cache.Read(memReader, pos, &readCache[0], len, &stats);
+    TEST_EQUAL(readCache, string(data.begin() + pos, data.begin() + pos + len), (pos, len, i));
+  }
+  TEST_LESS(stats.GetSnapshot().m_readAheadPages, 50, ());
+
+  ReaderStats::Instance().SetEnabled(false);
+  stats.Reset();
+  string readCache(10, '0');
+  cache.Read(memReader, 0, &readCache[0], readCache.size(), &stats);
+  TEST_EQUAL(stats.GetSnapshot().m_reads, 0, ());
+}
@@ -5,7 +5,9 @@
 #include "coding/file_reader.hpp"
 #include "coding/file_writer.hpp"
 #include "coding/buffer_reader.hpp"
+#include "coding/mmap_reader.hpp"
 #include "coding/reader_streambuf.hpp"
+#include "coding/shared_page_cache.hpp"
 
 #include <cstring>
 #include <iostream>
@@ -39,6 +41,39 @@ UNIT_TEST(FileReaderSmokeTest)
   FileWriter::DeleteFileX("reader_test_tmp.dat");
 }
 
+UNIT_TEST(FileReaderSharedCacheSmokeTest)
+{
+  {
+    FileWriter writer("reader_test_tmp.dat");
+    writer.Write(&kData[0], kData.size());
+  }
+
+  {
+    SharedPageCache cache(4 /* logPageSize */, 1 /* logShardsCount */, 1024 /* bytesLimit */);
+    FileReader fileReader1("reader_test_tmp.dat", cache);
+    TestReader(fileReader1);
+    FileReader fileReader2("reader_test_tmp.dat", cache);
+    TestReader(fileReader2);
+    TEST_GREATER(cache.GetStats().m_hits, 0, ());
+  }
+  FileWriter::DeleteFileX("reader_test_tmp.dat");
+}
+
+UNIT_TEST(MmapReaderSmokeTest)
+{
+  {
+    FileWriter writer("reader_test_tmp.dat");
+    writer.Write(&kData[0], kData.size());
+  }
+
+  {
+    ModelReaderPtr mmapReader(
+        std::make_unique<MmapReader>("reader_test_tmp.dat", MmapReader::Advice::Random));
+    TestReader(mmapReader);
+  }
+  FileWriter::DeleteFileX("reader_test_tmp.dat");
+}
+
 UNIT_TEST(BufferReaderSmokeTest)
 {
   BufferReader r1(&kData[0], kData.size());
@@ -7,12 +7,431 @@
 
 #include <algorithm>
 
+// _mm_popcnt_u64() is declared on x86_64 only.
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define BIT_GROUPS_KERNEL_AVX2
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#define BIT_GROUPS_KERNEL_NEON
+#include <arm_neon.h>
+#endif
+
 namespace coding
 {
 using std::make_unique, std::max, std::min, std::unique_ptr, std::vector;
 
 namespace
 {
+using Interval = RunCBV::Interval;
+
+uint64_t constexpr kBlockSize = DenseCBV::kBlockSize;
+
+// Bit vectors with fewer set bits are never stored as RunCBV: both other
+// representations are small for them and have faster random access.
+uint64_t constexpr kMinRunsPopCount = 256;
+
+// RunCBV is used only when it is at least kMinRunsGain times smaller than the other
+// representations.
+uint64_t constexpr kMinRunsGain = 4;
+
+// Sorted sets with sizes differing more than this are intersected by galloping over
+// the larger set.
+size_t constexpr kGallopingRatio = 32;
+
+// Returns true if a bit vector with popCount bits set out of totalBits
+// is fit to be represented as a DenseCBV. Note that we do not
+// account for possible irregularities in the distribution of bits.
+// In particular, we do not break the bit vector into blocks that are
+// stored separately although this might turn out to be a good idea.
+bool DenseEnough(uint64_t popCount, uint64_t totalBits)
+{
+  // Settle at 30% for now.
+  return popCount * 10 >= totalBits * 3;
+}
+
+// Returns the maximum number of runs a bit vector may have to be represented as a RunCBV.
+uint64_t GetMaxNumRuns(uint64_t popCount, uint64_t maxBit)
+{
+  if (popCount < kMinRunsPopCount)
+    return 0;
+  // A run takes two words.
+  return min(popCount, maxBit / kBlockSize + 1) / (2 * kMinRunsGain);
+}
+
+uint32_t CountTrailingZeros(uint64_t x)
+{
+  ASSERT_NOT_EQUAL(x, 0, ());
+  return bits::PopCount((x & (~x + 1)) - 1);
+}
+
+// Returns the number of runs of set bits in |bitGroups|, stops counting when it exceeds |limit|.
+uint64_t CountRuns(vector<uint64_t> const & bitGroups, uint64_t limit)
+{
+  uint64_t numRuns = 0;
+  uint64_t carry = 0;
+  for (size_t i = 0; i < bitGroups.size() && numRuns <= limit; ++i)
+  {
+    uint64_t const group = bitGroups[i];
+    // Set bits with unset previous bits.
+    numRuns += bits::PopCount(group & ~((group << 1) | carry));
+    carry = group >> (kBlockSize - 1);
+  }
+  return numRuns;
+}
+
+// Appends [run.first, run.second) to |runs| merging it with the last run if they touch.
+void AppendRun(vector<Interval> & runs, Interval const & run)
+{
+  ASSERT_LESS(run.first, run.second, ());
+  if (!runs.empty() && run.first <= runs.back().second)
+  {
+    ASSERT_GREATER_OR_EQUAL(run.first, runs.back().first, ());
+    runs.back().second = max(runs.back().second, run.second);
+    return;
+  }
+  runs.push_back(run);
+}
+
+vector<Interval> RunsFromBitGroups(vector<uint64_t> const & bitGroups)
+{
+  vector<Interval> runs;
+  for (size_t i = 0; i < bitGroups.size(); ++i)
+  {
+    uint64_t const base = i * kBlockSize;
+    uint64_t group = bitGroups[i];
+    while (group != 0)
+    {
+      uint32_t const begin = CountTrailingZeros(group);
+      // Unset bits starting from |begin|.
+      uint64_t const rest = ~group & (~uint64_t{0} << begin);
+      uint32_t const end = rest == 0 ? kBlockSize : CountTrailingZeros(rest);
+      AppendRun(runs, {base + begin, base + end});
+      group = end == kBlockSize ? 0 : group & (~uint64_t{0} << end);
+    }
+  }
+  return runs;
+}
+
+// |positions| must be sorted, duplicates are allowed.
+vector<Interval> RunsFromPositions(vector<uint64_t> const & positions)
+{
+  vector<Interval> runs;
+  for (auto const pos : positions)
+    AppendRun(runs, {pos, pos + 1});
+  return runs;
+}
+
+vector<uint64_t> PositionsFromRuns(vector<Interval> const & runs)
+{
+  vector<uint64_t> positions;
+  for (auto const & run : runs)
+  {
+    for (uint64_t pos = run.first; pos < run.second; ++pos)
+      positions.push_back(pos);
+  }
+  return positions;
+}
+
+// Returns |numGroups| bit groups with the bits from |runs| set, the bits beyond are dropped.
+vector<uint64_t> BitGroupsFromRuns(vector<Interval> const & runs, size_t numGroups)
+{
+  vector<uint64_t> bitGroups(numGroups);
+  uint64_t const numBits = numGroups * kBlockSize;
+  for (auto const & run : runs)
+  {
+    uint64_t begin = run.first;
+    uint64_t const end = min(run.second, numBits);
+    while (begin < end)
+    {
+      size_t const i = static_cast<size_t>(begin / kBlockSize);
+      uint64_t const from = begin % kBlockSize;
+      uint64_t const to = min(end - i * kBlockSize, kBlockSize);
+      uint64_t const upper = to == kBlockSize ? ~uint64_t{0} : (uint64_t{1} << to) - 1;
+      bitGroups[i] |= upper & (~uint64_t{0} << from);
+      begin = i * kBlockSize + to;
+    }
+  }
+  return bitGroups;
+}
+
+size_t NumBitGroupsForRuns(vector<Interval> const & runs)
+{
+  return runs.empty() ? 0 : static_cast<size_t>((runs.back().second - 1) / kBlockSize + 1);
+}
+
+// Returns the first element in [begin, end) which is not less than |value|.
+// Faster than std::lower_bound when the result is close to |begin|.
+template <typename It>
+It Gallop(It begin, It end, uint64_t value)
+{
+  auto lo = begin;
+  auto hi = begin;
+  size_t step = 1;
+  while (hi < end && *hi < value)
+  {
+    lo = hi;
+    hi = static_cast<size_t>(end - hi) > step ? hi + step : end;
+    step *= 2;
+  }
+  return std::lower_bound(lo, hi, value);
+}
+
+// |small| is intersected with |large| by galloping in |large|.
+vector<uint64_t> GallopingIntersect(SparseCBV const & small, SparseCBV const & large)
+{
+  vector<uint64_t> resPos;
+  auto it = large.Begin();
+  for (auto pos = small.Begin(); pos != small.End() && it != large.End(); ++pos)
+  {
+    it = Gallop(it, large.End(), *pos);
+    if (it != large.End() && *it == *pos)
+      resPos.push_back(*pos);
+  }
+  return resPos;
+}
+
+vector<Interval> IntersectRuns(vector<Interval> const & a, vector<Interval> const & b)
+{
+  vector<Interval> res;
+  size_t i = 0;
+  size_t j = 0;
+  while (i < a.size() && j < b.size())
+  {
+    uint64_t const begin = max(a[i].first, b[j].first);
+    uint64_t const end = min(a[i].second, b[j].second);
+    if (begin < end)
+      AppendRun(res, {begin, end});
+
+    if (a[i].second < b[j].second)
+      ++i;
+    else
+      ++j;
+  }
+  return res;
+}
+
+vector<Interval> UniteRuns(vector<Interval> const & a, vector<Interval> const & b)
+{
+  vector<Interval> res;
+  size_t i = 0;
+  size_t j = 0;
+  while (i < a.size() || j < b.size())
+  {
+    if (j == b.size() || (i < a.size() && a[i].first < b[j].first))
+      AppendRun(res, a[i++]);
+    else
+      AppendRun(res, b[j++]);
+  }
+  return res;
+}
+
+vector<Interval> SubtractRuns(vector<Interval> const & a, vector<Interval> const & b)
+{
+  vector<Interval> res;
+  size_t j = 0;
+  for (auto const & run : a)
+  {
+    uint64_t begin = run.first;
+    while (j < b.size() && b[j].second <= begin)
+      ++j;
+
+    while (j < b.size() && b[j].first < run.second)
+    {
+      if (begin < b[j].first)
+        AppendRun(res, {begin, b[j].first});
+      begin = max(begin, b[j].second);
+      if (b[j].second >= run.second)
+        break;
+      ++j;
+    }
+
+    if (begin < run.second)
+      AppendRun(res, {begin, run.second});
+  }
+  return res;
+}
+
+// Bitwise operations for the kernels.
+struct AndOp
+{
+  static uint64_t Apply(uint64_t a, uint64_t b) { return a & b; }
+#ifdef BIT_GROUPS_KERNEL_AVX2
+  __attribute__((target("avx2"))) static __m256i Apply(__m256i a, __m256i b)
+  {
+    return _mm256_and_si256(a, b);
+  }
+#endif
+#ifdef BIT_GROUPS_KERNEL_NEON
+  static uint64x2_t Apply(uint64x2_t a, uint64x2_t b) { return vandq_u64(a, b); }
+#endif
+};
+
+struct OrOp
+{
+  static uint64_t Apply(uint64_t a, uint64_t b) { return a | b; }
+#ifdef BIT_GROUPS_KERNEL_AVX2
+  __attribute__((target("avx2"))) static __m256i Apply(__m256i a, __m256i b)
+  {
+    return _mm256_or_si256(a, b);
+  }
+#endif
+#ifdef BIT_GROUPS_KERNEL_NEON
+  static uint64x2_t Apply(uint64x2_t a, uint64x2_t b) { return vorrq_u64(a, b); }
+#endif
+};
+
+struct AndNotOp
+{
+  static uint64_t Apply(uint64_t a, uint64_t b) { return a & ~b; }
+#ifdef BIT_GROUPS_KERNEL_AVX2
+  __attribute__((target("avx2"))) static __m256i Apply(__m256i a, __m256i b)
+  {
+    return _mm256_andnot_si256(b, a);
+  }
+#endif
+#ifdef BIT_GROUPS_KERNEL_NEON
+  static uint64x2_t Apply(uint64x2_t a, uint64x2_t b) { return vbicq_u64(a, b); }
+#endif
+};
+
+template <typename Op>
+uint64_t ApplyScalar(uint64_t const * a, uint64_t const * b, size_t count, uint64_t * res)
+{
+  uint64_t popCount = 0;
+  for (size_t i = 0; i < count; ++i)
+  {
+    res[i] = Op::Apply(a[i], b[i]);
+    popCount += bits::PopCount(res[i]);
+  }
+  return popCount;
+}
+
+#ifdef BIT_GROUPS_KERNEL_AVX2
+template <typename Op>
+__attribute__((target("avx2,popcnt"))) uint64_t ApplyAvx2(uint64_t const * a, uint64_t const * b,
+                                                          size_t count, uint64_t * res)
+{
+  uint64_t popCount = 0;
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    __m256i const va = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(a + i));
+    __m256i const vb = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(b + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(res + i), Op::Apply(va, vb));
+    popCount += _mm_popcnt_u64(res[i]) + _mm_popcnt_u64(res[i + 1]) +
+                _mm_popcnt_u64(res[i + 2]) + _mm_popcnt_u64(res[i + 3]);
+  }
+  return popCount + ApplyScalar<Op>(a + i, b + i, count - i, res + i);
+}
+#endif  // BIT_GROUPS_KERNEL_AVX2
+
+#ifdef BIT_GROUPS_KERNEL_NEON
+template <typename Op>
+uint64_t ApplyNeon(uint64_t const * a, uint64_t const * b, size_t count, uint64_t * res)
+{
+  uint64_t popCount = 0;
+  size_t i = 0;
+  for (; i + 2 <= count; i += 2)
+  {
+    uint64x2_t const v = Op::Apply(vld1q_u64(a + i), vld1q_u64(b + i));
+    vst1q_u64(res + i, v);
+    popCount += vaddvq_u8(vcntq_u8(vreinterpretq_u8_u64(v)));
+  }
+  return popCount + ApplyScalar<Op>(a + i, b + i, count - i, res + i);
+}
+#endif  // BIT_GROUPS_KERNEL_NEON
+
+template <typename Op>
+uint64_t ApplyKernel(BitGroupsKernel kernel, uint64_t const * a, uint64_t const * b, size_t count,
+                     uint64_t * res)
+{
+  ASSERT(IsSupported(kernel), (kernel));
+  switch (kernel)
+  {
+  case BitGroupsKernel::Scalar: return ApplyScalar<Op>(a, b, count, res);
+#ifdef BIT_GROUPS_KERNEL_AVX2
+  case BitGroupsKernel::Avx2: return ApplyAvx2<Op>(a, b, count, res);
+#endif
+#ifdef BIT_GROUPS_KERNEL_NEON
+  case BitGroupsKernel::Neon: return ApplyNeon<Op>(a, b, count, res);
+#endif
+  default: return ApplyScalar<Op>(a, b, count, res);
+  }
+}
+
+uint64_t CountSetBits(uint64_t const * groups, size_t count)
+{
+  uint64_t popCount = 0;
+  for (size_t i = 0; i < count; ++i)
+    popCount += bits::PopCount(groups[i]);
+  return popCount;
+}
+
+// Operations on the bit groups of dense bit vectors, the groups beyond the end of
+// a vector are zeros.
+unique_ptr<CompressedBitVector> IntersectDense(vector<uint64_t> const & a,
+                                               vector<uint64_t> const & b)
+{
+  vector<uint64_t> resGroups(min(a.size(), b.size()));
+  uint64_t const popCount = IntersectBitGroups(GetBestBitGroupsKernel(), a.data(), b.data(),
+                                               resGroups.size(), resGroups.data());
+  return CompressedBitVectorBuilder::FromBitGroups(std::move(resGroups), popCount);
+}
+
+unique_ptr<CompressedBitVector> SubtractDense(vector<uint64_t> const & a,
+                                              vector<uint64_t> const & b)
+{
+  vector<uint64_t> resGroups(a.size());
+  size_t const commonSize = min(a.size(), b.size());
+  uint64_t popCount = SubtractBitGroups(GetBestBitGroupsKernel(), a.data(), b.data(), commonSize,
+                                        resGroups.data());
+  copy(a.begin() + commonSize, a.end(), resGroups.begin() + commonSize);
+  popCount += CountSetBits(resGroups.data() + commonSize, resGroups.size() - commonSize);
+  return CompressedBitVectorBuilder::FromBitGroups(std::move(resGroups), popCount);
+}
+
+unique_ptr<CompressedBitVector> UniteDense(vector<uint64_t> const & a,
+                                           vector<uint64_t> const & b)
+{
+  size_t const commonSize = min(a.size(), b.size());
+  auto const & longer = a.size() > b.size() ? a : b;
+  vector<uint64_t> resGroups(longer.size());
+  uint64_t popCount = UniteBitGroups(GetBestBitGroupsKernel(), a.data(), b.data(), commonSize,
+                                     resGroups.data());
+  copy(longer.begin() + commonSize, longer.end(), resGroups.begin() + commonSize);
+  popCount += CountSetBits(resGroups.data() + commonSize, resGroups.size() - commonSize);
+  return CompressedBitVectorBuilder::FromBitGroups(std::move(resGroups), popCount);
+}
+
+vector<Interval> ToRuns(SparseCBV const & cbv)
+{
+  vector<Interval> runs;
+  for (auto it = cbv.Begin(); it != cbv.End(); ++it)
+    AppendRun(runs, {*it, *it + 1});
+  return runs;
+}
+
+vector<uint64_t> GetBitGroups(RunCBV const & cbv)
+{
+  auto const & runs = cbv.GetRuns();
+  return BitGroupsFromRuns(runs, NumBitGroupsForRuns(runs));
+}
+
+// Calls |f| for positions of |sparse| with |isInRuns| flag.
+template <typename Fn>
+void ForEachWithRuns(SparseCBV const & sparse, RunCBV const & runs, Fn && f)
+{
+  auto run = runs.Begin();
+  for (auto it = sparse.Begin(); it != sparse.End(); ++it)
+  {
+    while (run != runs.End() && run->second <= *it)
+      ++run;
+    f(*it, run != runs.End() && run->first <= *it);
+  }
+}
+
 struct IntersectOp
 {
   IntersectOp() {}
@@ -20,12 +439,7 @@ struct IntersectOp
   unique_ptr<coding::CompressedBitVector> operator()(coding::DenseCBV const & a,
                                                      coding::DenseCBV const & b) const
   {
-    size_t const sizeA = a.NumBitGroups();
-    size_t const sizeB = b.NumBitGroups();
-    vector<uint64_t> resGroups(min(sizeA, sizeB));
-    for (size_t i = 0; i < resGroups.size(); ++i)
-      resGroups[i] = a.GetBitGroup(i) & b.GetBitGroup(i);
-    return coding::CompressedBitVectorBuilder::FromBitGroups(std::move(resGroups));
+    return IntersectDense(a.GetBitGroups(), b.GetBitGroups());
   }
 
   // The intersection of dense and sparse is always sparse.
@@ -33,11 +447,11 @@ struct IntersectOp
                                                      coding::SparseCBV const & b) const
   {
     vector<uint64_t> resPos;
-    for (size_t i = 0; i < b.PopCount(); ++i)
+    uint64_t const numBits = a.NumBitGroups() * kBlockSize;
+    for (auto it = b.Begin(); it != b.End() && *it < numBits; ++it)
     {
-      auto pos = b.Select(i);
-      if (a.GetBit(pos))
-        resPos.push_back(pos);
+      if (a.GetBit(*it))
+        resPos.push_back(*it);
     }
     return make_unique<coding::SparseCBV>(std::move(resPos));
   }
@@ -51,10 +465,51 @@ struct IntersectOp
   unique_ptr<coding::CompressedBitVector> operator()(coding::SparseCBV const & a,
                                                      coding::SparseCBV const & b) const
   {
+    if (a.PopCount() * kGallopingRatio < b.PopCount())
+      return make_unique<coding::SparseCBV>(GallopingIntersect(a, b));
+    if (b.PopCount() * kGallopingRatio < a.PopCount())
+      return make_unique<coding::SparseCBV>(GallopingIntersect(b, a));
+
     vector<uint64_t> resPos;
     set_intersection(a.Begin(), a.End(), b.Begin(), b.End(), back_inserter(resPos));
     return make_unique<coding::SparseCBV>(std::move(resPos));
   }
+
+  unique_ptr<coding::CompressedBitVector> operator()(coding::DenseCBV const & a,
+                                                     coding::RunCBV const & b) const
+  {
+    return IntersectDense(a.GetBitGroups(), GetBitGroups(b));
+  }
+
+  unique_ptr<coding::CompressedBitVector> operator()(coding::RunCBV const & a,
+                                                     coding::DenseCBV const & b) const
+  {
+    return operator()(b, a);
+  }
+
+  // The intersection of sparse and runs is always sparse.
+  unique_ptr<coding::CompressedBitVector> operator()(coding::SparseCBV const & a,
+                                                     coding::RunCBV const & b) const
+  {
+    vector<uint64_t> resPos;
+    ForEachWithRuns(a, b, [&resPos](uint64_t pos, bool isInRuns) {
+      if (isInRuns)
+        resPos.push_back(pos);
+    });
+    return make_unique<coding::SparseCBV>(std::move(resPos));
+  }
+
+  unique_ptr<coding::CompressedBitVector> operator()(coding::RunCBV const & a,
+                                                     coding::SparseCBV const & b) const
+  {
+    return operator()(b, a);
+  }
+
+  unique_ptr<coding::CompressedBitVector> operator()(coding::RunCBV const & a,
+                                                     coding::RunCBV const & b) const
+  {
+    return CompressedBitVectorBuilder::FromRuns(IntersectRuns(a.GetRuns(), b.GetRuns()));
+  }
 };
 
 struct SubtractOp
@@ -64,12 +519,7 @@ struct SubtractOp
   unique_ptr<coding::CompressedBitVector> operator()(coding::DenseCBV const & a,
                                                      coding::DenseCBV const & b) const
   {
-    size_t const sizeA = a.NumBitGroups();
-    size_t const sizeB = b.NumBitGroups();
-    vector<uint64_t> resGroups(min(sizeA, sizeB));
-    for (size_t i = 0; i < resGroups.size(); ++i)
-      resGroups[i] = a.GetBitGroup(i) & ~b.GetBitGroup(i);
-    return CompressedBitVectorBuilder::FromBitGroups(std::move(resGroups));
+    return SubtractDense(a.GetBitGroups(), b.GetBitGroups());
   }
 
   unique_ptr<coding::CompressedBitVector> operator()(coding::DenseCBV const & a,
@@ -118,6 +568,41 @@ struct SubtractOp
     set_difference(a.Begin(), a.End(), b.Begin(), b.End(), back_inserter(resPos));
     return CompressedBitVectorBuilder::FromBitPositions(std::move(resPos));
   }
+
+  unique_ptr<coding::CompressedBitVector> operator()(coding::DenseCBV const & a,
+                                                     coding::RunCBV const & b) const
+  {
+    return SubtractDense(a.GetBitGroups(), GetBitGroups(b));
+  }
+
+  unique_ptr<coding::CompressedBitVector> operator()(coding::RunCBV const & a,
+                                                     coding::DenseCBV const & b) const
+  {
+    return SubtractDense(GetBitGroups(a), b.GetBitGroups());
+  }
+
+  unique_ptr<coding::CompressedBitVector> operator()(coding::SparseCBV const & a,
+                                                     coding::RunCBV const & b) const
+  {
+    vector<uint64_t> resPos;
+    ForEachWithRuns(a, b, [&resPos](uint64_t pos, bool isInRuns) {
+      if (!isInRuns)
+        resPos.push_back(pos);
+    });
+    return CompressedBitVectorBuilder::FromBitPositions(std::move(resPos));
+  }
+
+  unique_ptr<coding::CompressedBitVector> operator()(coding::RunCBV const & a,
+                                                     coding::SparseCBV const & b) const
+  {
+    return CompressedBitVectorBuilder::FromRuns(SubtractRuns(a.GetRuns(), ToRuns(b)));
+  }
+
+  unique_ptr<coding::CompressedBitVector> operator()(coding::RunCBV const & a,
+                                                     coding::RunCBV const & b) const
+  {
+    return CompressedBitVectorBuilder::FromRuns(SubtractRuns(a.GetRuns(), b.GetRuns()));
+  }
 };
 
 struct UnionOp
@@ -127,25 +612,7 @@ struct UnionOp
   unique_ptr<coding::CompressedBitVector> operator()(coding::DenseCBV const & a,
                                                      coding::DenseCBV const & b) const
   {
-    size_t const sizeA = a.NumBitGroups();
-    size_t const sizeB = b.NumBitGroups();
-
-    size_t commonSize = min(sizeA, sizeB);
-    size_t resultSize = max(sizeA, sizeB);
-    vector<uint64_t> resGroups(resultSize);
-    for (size_t i = 0; i < commonSize; ++i)
-      resGroups[i] = a.GetBitGroup(i) | b.GetBitGroup(i);
-    if (a.NumBitGroups() == resultSize)
-    {
-      for (size_t i = commonSize; i < resultSize; ++i)
-        resGroups[i] = a.GetBitGroup(i);
-    }
-    else
-    {
-      for (size_t i = commonSize; i < resultSize; ++i)
-        resGroups[i] = b.GetBitGroup(i);
-    }
-    return CompressedBitVectorBuilder::FromBitGroups(std::move(resGroups));
+    return UniteDense(a.GetBitGroups(), b.GetBitGroups());
   }
 
   unique_ptr<coding::CompressedBitVector> operator()(coding::DenseCBV const & a,
@@ -168,6 +635,8 @@ struct UnionOp
           resPos.push_back(*j);
           ++j;
         }
+        if (j < b.End() && *j == va)
+          ++j;
         resPos.push_back(va);
       };
       a.ForEach(merge);
@@ -211,52 +680,68 @@ struct UnionOp
     set_union(a.Begin(), a.End(), b.Begin(), b.End(), back_inserter(resPos));
     return CompressedBitVectorBuilder::FromBitPositions(std::move(resPos));
   }
-};
 
-template <typename TBinaryOp>
-unique_ptr<coding::CompressedBitVector> Apply(TBinaryOp const & op, CompressedBitVector const & lhs,
-                                              CompressedBitVector const & rhs)
-{
-  using strat = CompressedBitVector::StorageStrategy;
-  auto const stratA = lhs.GetStorageStrategy();
-  auto const stratB = rhs.GetStorageStrategy();
-  if (stratA == strat::Dense && stratB == strat::Dense)
+  unique_ptr<coding::CompressedBitVector> operator()(coding::DenseCBV const & a,
+                                                     coding::RunCBV const & b) const
   {
-    DenseCBV const & a = static_cast<DenseCBV const &>(lhs);
-    DenseCBV const & b = static_cast<DenseCBV const &>(rhs);
-    return op(a, b);
+    return UniteDense(a.GetBitGroups(), GetBitGroups(b));
   }
-  if (stratA == strat::Dense && stratB == strat::Sparse)
+
+  unique_ptr<coding::CompressedBitVector> operator()(coding::RunCBV const & a,
+                                                     coding::DenseCBV const & b) const
   {
-    DenseCBV const & a = static_cast<DenseCBV const &>(lhs);
-    SparseCBV const & b = static_cast<SparseCBV const &>(rhs);
-    return op(a, b);
+    return operator()(b, a);
   }
-  if (stratA == strat::Sparse && stratB == strat::Dense)
+
+  unique_ptr<coding::CompressedBitVector> operator()(coding::SparseCBV const & a,
+                                                     coding::RunCBV const & b) const
   {
-    SparseCBV const & a = static_cast<SparseCBV const &>(lhs);
-    DenseCBV const & b = static_cast<DenseCBV const &>(rhs);
-    return op(a, b);
+    return CompressedBitVectorBuilder::FromRuns(UniteRuns(ToRuns(a), b.GetRuns()));
+  }
+
+  unique_ptr<coding::CompressedBitVector> operator()(coding::RunCBV const & a,
+                                                     coding::SparseCBV const & b) const
+  {
+    return operator()(b, a);
   }
-  if (stratA == strat::Sparse && stratB == strat::Sparse)
+
+  unique_ptr<coding::CompressedBitVector> operator()(coding::RunCBV const & a,
+                                                     coding::RunCBV const & b) const
   {
-    SparseCBV const & a = static_cast<SparseCBV const &>(lhs);
-    SparseCBV const & b = static_cast<SparseCBV const &>(rhs);
-    return op(a, b);
+    return CompressedBitVectorBuilder::FromRuns(UniteRuns(a.GetRuns(), b.GetRuns()));
   }
+};
 
+template <typename TBinaryOp, typename TLhs>
+unique_ptr<coding::CompressedBitVector> Apply(TBinaryOp const & op, TLhs const & a,
+                                              CompressedBitVector const & rhs)
+{
+  switch (rhs.GetStorageStrategy())
+  {
+  case CompressedBitVector::StorageStrategy::Dense:
+    return op(a, static_cast<DenseCBV const &>(rhs));
+  case CompressedBitVector::StorageStrategy::Sparse:
+    return op(a, static_cast<SparseCBV const &>(rhs));
+  case CompressedBitVector::StorageStrategy::Run:
+    return op(a, static_cast<RunCBV const &>(rhs));
+  }
   return nullptr;
 }
 
-// Returns true if a bit vector with popCount bits set out of totalBits
-// is fit to be represented as a DenseCBV. Note that we do not
-// account for possible irregularities in the distribution of bits.
-// In particular, we do not break the bit vector into blocks that are
-// stored separately although this might turn out to be a good idea.
-bool DenseEnough(uint64_t popCount, uint64_t totalBits)
+template <typename TBinaryOp>
+unique_ptr<coding::CompressedBitVector> Apply(TBinaryOp const & op, CompressedBitVector const & lhs,
+                                              CompressedBitVector const & rhs)
 {
-  // Settle at 30% for now.
-  return popCount * 10 >= totalBits * 3;
+  switch (lhs.GetStorageStrategy())
+  {
+  case CompressedBitVector::StorageStrategy::Dense:
+    return Apply(op, static_cast<DenseCBV const &>(lhs), rhs);
+  case CompressedBitVector::StorageStrategy::Sparse:
+    return Apply(op, static_cast<SparseCBV const &>(lhs), rhs);
+  case CompressedBitVector::StorageStrategy::Run:
+    return Apply(op, static_cast<RunCBV const &>(lhs), rhs);
+  }
+  return nullptr;
 }
 
 template <typename TBitPositions>
@@ -264,7 +749,30 @@ unique_ptr<CompressedBitVector> BuildFromBitPositions(TBitPositions && setBits)
 {
   if (setBits.empty())
     return make_unique<SparseCBV>(std::forward<TBitPositions>(setBits));
-  uint64_t const maxBit = *max_element(setBits.begin(), setBits.end());
+
+  // Runs are counted for sorted positions only.
+  bool sorted = true;
+  uint64_t numRuns = 1;
+  uint64_t numDistinct = 1;
+  for (size_t i = 1; i < setBits.size(); ++i)
+  {
+    if (setBits[i] < setBits[i - 1])
+    {
+      sorted = false;
+      break;
+    }
+    if (setBits[i] == setBits[i - 1])
+      continue;
+
+    ++numDistinct;
+    if (setBits[i] != setBits[i - 1] + 1)
+      ++numRuns;
+  }
+
+  if (sorted && numRuns <= GetMaxNumRuns(numDistinct, setBits.back()))
+    return make_unique<RunCBV>(RunsFromPositions(setBits));
+
+  uint64_t const maxBit = sorted ? setBits.back() : *max_element(setBits.begin(), setBits.end());
 
   if (DenseEnough(setBits.size(), maxBit))
     return make_unique<DenseCBV>(std::forward<TBitPositions>(setBits));
@@ -304,6 +812,16 @@ unique_ptr<DenseCBV> DenseCBV::BuildFromBitGroups(vector<uint64_t> && bitGroups)
   return cbv;
 }
 
+// static
+unique_ptr<DenseCBV> DenseCBV::BuildFromBitGroups(vector<uint64_t> && bitGroups, uint64_t popCount)
+{
+  ASSERT_EQUAL(popCount, CountSetBits(bitGroups.data(), bitGroups.size()), ());
+  unique_ptr<DenseCBV> cbv(new DenseCBV());
+  cbv->m_popCount = popCount;
+  cbv->m_bitGroups = std::move(bitGroups);
+  return cbv;
+}
+
 uint64_t DenseCBV::GetBitGroup(size_t i) const
 {
   return i < m_bitGroups.size() ? m_bitGroups[i] : 0;
@@ -417,6 +935,75 @@ unique_ptr<CompressedBitVector> SparseCBV::Clone() const
   return unique_ptr<CompressedBitVector>(cbv);
 }
 
+RunCBV::RunCBV(vector<Interval> && runs) : m_runs(std::move(runs))
+{
+  for (size_t i = 0; i < m_runs.size(); ++i)
+  {
+    ASSERT_LESS(m_runs[i].first, m_runs[i].second, ());
+    ASSERT(i == 0 || m_runs[i - 1].second < m_runs[i].first, ());
+    m_popCount += m_runs[i].second - m_runs[i].first;
+  }
+}
+
+uint64_t RunCBV::PopCount() const { return m_popCount; }
+
+bool RunCBV::GetBit(uint64_t pos) const
+{
+  auto it = upper_bound(m_runs.begin(), m_runs.end(), pos,
+                        [](uint64_t pos, Interval const & run) { return pos < run.first; });
+  if (it == m_runs.begin())
+    return false;
+  --it;
+  return pos < it->second;
+}
+
+unique_ptr<CompressedBitVector> RunCBV::LeaveFirstSetNBits(uint64_t n) const
+{
+  if (PopCount() <= n)
+    return Clone();
+
+  vector<Interval> runs;
+  for (size_t i = 0; i < m_runs.size() && n != 0; ++i)
+  {
+    uint64_t const size = min(m_runs[i].second - m_runs[i].first, n);
+    runs.emplace_back(m_runs[i].first, m_runs[i].first + size);
+    n -= size;
+  }
+  return CompressedBitVectorBuilder::FromRuns(std::move(runs));
+}
+
+CompressedBitVector::StorageStrategy RunCBV::GetStorageStrategy() const
+{
+  return CompressedBitVector::StorageStrategy::Run;
+}
+
+void RunCBV::Serialize(Writer & writer) const
+{
+  if (m_runs.empty())
+  {
+    SparseCBV().Serialize(writer);
+    return;
+  }
+
+  if (DenseEnough(m_popCount, m_runs.back().second - 1))
+  {
+    DenseCBV::BuildFromBitGroups(BitGroupsFromRuns(m_runs, NumBitGroupsForRuns(m_runs)),
+                                 m_popCount)
+        ->Serialize(writer);
+    return;
+  }
+
+  SparseCBV(PositionsFromRuns(m_runs)).Serialize(writer);
+}
+
+unique_ptr<CompressedBitVector> RunCBV::Clone() const
+{
+  RunCBV * cbv = new RunCBV();
+  cbv->m_runs = m_runs;
+  cbv->m_popCount = m_popCount;
+  return unique_ptr<CompressedBitVector>(cbv);
+}
+
 // static
 unique_ptr<CompressedBitVector> CompressedBitVectorBuilder::FromBitPositions(
     vector<uint64_t> const & setBits)
@@ -435,31 +1022,59 @@ unique_ptr<CompressedBitVector> CompressedBitVectorBuilder::FromBitPositions(
 unique_ptr<CompressedBitVector> CompressedBitVectorBuilder::FromBitGroups(
     vector<uint64_t> && bitGroups)
 {
-  static uint64_t const kBlockSize = DenseCBV::kBlockSize;
+  uint64_t const popCount = CountSetBits(bitGroups.data(), bitGroups.size());
+  return FromBitGroups(std::move(bitGroups), popCount);
+}
 
+// static
+unique_ptr<CompressedBitVector> CompressedBitVectorBuilder::FromBitGroups(
+    vector<uint64_t> && bitGroups, uint64_t popCount)
+{
   while (!bitGroups.empty() && bitGroups.back() == 0)
     bitGroups.pop_back();
   if (bitGroups.empty())
     return make_unique<SparseCBV>(std::move(bitGroups));
 
   uint64_t const maxBit = kBlockSize * (bitGroups.size() - 1) + bits::FloorLog(bitGroups.back());
-  uint64_t popCount = 0;
-  for (size_t i = 0; i < bitGroups.size(); ++i)
-    popCount += bits::PopCount(bitGroups[i]);
+
+  uint64_t const maxNumRuns = GetMaxNumRuns(popCount, maxBit);
+  if (maxNumRuns != 0 && CountRuns(bitGroups, maxNumRuns) <= maxNumRuns)
+    return make_unique<RunCBV>(RunsFromBitGroups(bitGroups));
 
   if (DenseEnough(popCount, maxBit))
-    return DenseCBV::BuildFromBitGroups(std::move(bitGroups));
+    return DenseCBV::BuildFromBitGroups(std::move(bitGroups), popCount);
 
   vector<uint64_t> setBits;
+  setBits.reserve(static_cast<size_t>(popCount));
   for (size_t i = 0; i < bitGroups.size(); ++i)
   {
-    for (size_t j = 0; j < kBlockSize; ++j)
-    {
-      if (((bitGroups[i] >> j) & 1) > 0)
-        setBits.push_back(kBlockSize * i + j);
-    }
+    for (uint64_t group = bitGroups[i]; group != 0; group &= group - 1)
+      setBits.push_back(kBlockSize * i + CountTrailingZeros(group));
+  }
+  return make_unique<SparseCBV>(std::move(setBits));
+}
+
+// static
+unique_ptr<CompressedBitVector> CompressedBitVectorBuilder::FromRuns(vector<Interval> && runs)
+{
+  if (runs.empty())
+    return make_unique<SparseCBV>();
+
+  uint64_t popCount = 0;
+  for (auto const & run : runs)
+    popCount += run.second - run.first;
+  uint64_t const maxBit = runs.back().second - 1;
+
+  if (runs.size() <= GetMaxNumRuns(popCount, maxBit))
+    return make_unique<RunCBV>(std::move(runs));
+
+  if (DenseEnough(popCount, maxBit))
+  {
+    return DenseCBV::BuildFromBitGroups(BitGroupsFromRuns(runs, NumBitGroupsForRuns(runs)),
+                                        popCount);
   }
-  return make_unique<SparseCBV>(setBits);
+
+  return make_unique<SparseCBV>(PositionsFromRuns(runs));
 }
 
 std::string DebugPrint(CompressedBitVector::StorageStrategy strat)
@@ -468,10 +1083,75 @@ std::string DebugPrint(CompressedBitVector::StorageStrategy strat)
   {
   case CompressedBitVector::StorageStrategy::Dense: return "Dense";
   case CompressedBitVector::StorageStrategy::Sparse: return "Sparse";
+  case CompressedBitVector::StorageStrategy::Run: return "Run";
+  }
+  UNREACHABLE();
+}
+
+std::string DebugPrint(BitGroupsKernel kernel)
+{
+  switch (kernel)
+  {
+  case BitGroupsKernel::Scalar: return "Scalar";
+  case BitGroupsKernel::Avx2: return "Avx2";
+  case BitGroupsKernel::Neon: return "Neon";
   }
   UNREACHABLE();
 }
 
+bool IsSupported(BitGroupsKernel kernel)
+{
+  switch (kernel)
+  {
+  case BitGroupsKernel::Scalar: return true;
+  case BitGroupsKernel::Avx2:
+#ifdef BIT_GROUPS_KERNEL_AVX2
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+#else
+    return false;
+#endif
+  case BitGroupsKernel::Neon:
+#ifdef BIT_GROUPS_KERNEL_NEON
+    return true;
+#else
+    return false;
+#endif
+  }
+  UNREACHABLE();
+}
+
+BitGroupsKernel GetBestBitGroupsKernel()
+{
+  static BitGroupsKernel const best = []()
+  {
+    for (auto const kernel : {BitGroupsKernel::Avx2, BitGroupsKernel::Neon})
+    {
+      if (IsSupported(kernel))
+        return kernel;
+    }
+    return BitGroupsKernel::Scalar;
+  }();
+  return best;
+}
+
+uint64_t IntersectBitGroups(BitGroupsKernel kernel, uint64_t const * a, uint64_t const * b,
+                            size_t count, uint64_t * res)
+{
+  return ApplyKernel<AndOp>(kernel, a, b, count, res);
+}
+
+uint64_t UniteBitGroups(BitGroupsKernel kernel, uint64_t const * a, uint64_t const * b,
+                        size_t count, uint64_t * res)
+{
+  return ApplyKernel<OrOp>(kernel, a, b, count, res);
+}
+
+uint64_t SubtractBitGroups(BitGroupsKernel kernel, uint64_t const * a, uint64_t const * b,
+                           size_t count, uint64_t * res)
+{
+  return ApplyKernel<AndNotOp>(kernel, a, b, count, res);
+}
+
 // static
 unique_ptr<CompressedBitVector> CompressedBitVector::Intersect(CompressedBitVector const & lhs,
                                                                CompressedBitVector const & rhs)
@@ -23,7 +23,9 @@ public:
   enum class StorageStrategy
   {
     Dense,
-    Sparse
+    Sparse,
+    // In-memory only, see RunCBV.
+    Run
   };
 
   virtual ~CompressedBitVector() = default;
@@ -71,7 +73,8 @@ public:
 
   // Writes the contents of a bit vector to writer.
   // The first byte is always the header that defines the format.
-  // Currently the header is 0 or 1 for Dense and Sparse strategies respectively.
+  // Currently the header is 0 or 1 for Dense and Sparse strategies respectively,
+  // bit vectors with the Run strategy are written as Dense or Sparse ones.
   // It is easier to dispatch via virtual method calls and not bother
   // with template TWriters here as we do in similar places in our code.
   // This should not pose too much a problem because commonly
@@ -86,6 +89,31 @@ public:
 
 std::string DebugPrint(CompressedBitVector::StorageStrategy strat);
 
+/// Implementations of the word-by-word operations on dense bit vectors.
+enum class BitGroupsKernel
+{
+  Scalar,
+  Avx2,
+  Neon
+};
+
+std::string DebugPrint(BitGroupsKernel kernel);
+
+/// Returns true if |kernel| is compiled in and is supported by the current CPU.
+bool IsSupported(BitGroupsKernel kernel);
+
+/// Returns the fastest kernel for the current CPU, it is selected once at runtime.
+BitGroupsKernel GetBestBitGroupsKernel();
+
+/// Following functions compute res[i] = a[i] & b[i], a[i] | b[i] and a[i] & ~b[i]
+/// for i in [0, count) and return the number of set bits in |res|.
+uint64_t IntersectBitGroups(BitGroupsKernel kernel, uint64_t const * a, uint64_t const * b,
+                            size_t count, uint64_t * res);
+uint64_t UniteBitGroups(BitGroupsKernel kernel, uint64_t const * a, uint64_t const * b,
+                        size_t count, uint64_t * res);
+uint64_t SubtractBitGroups(BitGroupsKernel kernel, uint64_t const * a, uint64_t const * b,
+                           size_t count, uint64_t * res);
+
 class DenseCBV : public CompressedBitVector
 {
 public:
@@ -101,8 +129,14 @@ public:
   // of the array of integers is completely different.
   static std::unique_ptr<DenseCBV> BuildFromBitGroups(std::vector<uint64_t> && bitGroups);
 
+  // Same as above when the number of set bits in |bitGroups| is already known.
+  static std::unique_ptr<DenseCBV> BuildFromBitGroups(std::vector<uint64_t> && bitGroups,
+                                                      uint64_t popCount);
+
   size_t NumBitGroups() const { return m_bitGroups.size(); }
 
+  std::vector<uint64_t> const & GetBitGroups() const { return m_bitGroups; }
+
   template <typename Fn>
   void ForEach(Fn && f) const
   {
@@ -178,6 +212,57 @@ private:
   std::vector<uint64_t> m_positions;
 };
 
+// Stores a bit vector as sorted disjoint half-open intervals [begin, end) of set bits.
+// It pays off for long runs of consecutive features, e.g. the features of a category
+// or the features of a geometry index cell.
+// *NOTE* RunCBV is an in-memory representation only: it is serialized either as a DenseCBV or as
+// a SparseCBV, so the format of the bit vectors stored in mwms does not depend on it.
+class RunCBV : public CompressedBitVector
+{
+public:
+  friend class CompressedBitVectorBuilder;
+  using Interval = std::pair<uint64_t, uint64_t>;
+  using TIterator = std::vector<Interval>::const_iterator;
+
+  RunCBV() = default;
+
+  // |runs| must be sorted, non-empty and must not touch or overlap each other.
+  explicit RunCBV(std::vector<Interval> && runs);
+
+  size_t NumRuns() const { return m_runs.size(); }
+
+  std::vector<Interval> const & GetRuns() const { return m_runs; }
+
+  template <typename Fn>
+  void ForEach(Fn && f) const
+  {
+    base::ControlFlowWrapper<Fn> wrapper(std::forward<Fn>(f));
+    for (auto const & run : m_runs)
+    {
+      for (uint64_t pos = run.first; pos < run.second; ++pos)
+      {
+        if (wrapper(pos) == base::ControlFlow::Break)
+          return;
+      }
+    }
+  }
+
+  // CompressedBitVector overrides:
+  uint64_t PopCount() const override;
+  bool GetBit(uint64_t pos) const override;
+  std::unique_ptr<CompressedBitVector> LeaveFirstSetNBits(uint64_t n) const override;
+  StorageStrategy GetStorageStrategy() const override;
+  void Serialize(Writer & writer) const override;
+  std::unique_ptr<CompressedBitVector> Clone() const override;
+
+  inline TIterator Begin() const { return m_runs.cbegin(); }
+  inline TIterator End() const { return m_runs.cend(); }
+
+private:
+  std::vector<Interval> m_runs;
+  uint64_t m_popCount = 0;
+};
+
 class CompressedBitVectorBuilder
 {
 public:
@@ -192,6 +277,14 @@ public:
   static std::unique_ptr<CompressedBitVector> FromBitGroups(std::vector<uint64_t> & bitGroups);
   static std::unique_ptr<CompressedBitVector> FromBitGroups(std::vector<uint64_t> && bitGroups);
 
+  // Same as above when the number of set bits in |bitGroups| is already known.
+  static std::unique_ptr<CompressedBitVector> FromBitGroups(std::vector<uint64_t> && bitGroups,
+                                                            uint64_t popCount);
+
+  // Chooses a strategy to store the bit vector with the set bits from sorted disjoint
+  // half-open intervals |runs|.
+  static std::unique_ptr<CompressedBitVector> FromRuns(std::vector<RunCBV::Interval> && runs);
+
   // Reads a bit vector from reader which must contain a valid
   // bit vector representation (see CompressedBitVector::Serialize for the format).
   template <typename TReader>
@@ -223,6 +316,8 @@ public:
       rw::ReadVectorOfPOD(src, setBits);
       return std::make_unique<SparseCBV>(std::move(setBits));
     }
+    // Run bit vectors are never serialized as is.
+    case CompressedBitVector::StorageStrategy::Run: break;
     }
     return std::unique_ptr<CompressedBitVector>();
   }
@@ -252,6 +347,12 @@ public:
       sparseCBV.ForEach(f);
       return;
     }
+    case CompressedBitVector::StorageStrategy::Run:
+    {
+      RunCBV const & runCBV = static_cast<RunCBV const &>(cbv);
+      runCBV.ForEach(f);
+      return;
+    }
     }
   }
 };
@@ -1,6 +1,8 @@
 #include "coding/file_reader.hpp"
 
 #include "coding/reader_cache.hpp"
+#include "coding/reader_stats.hpp"
+#include "coding/shared_page_cache.hpp"
 #include "coding/internal/file_data.hpp"
 
 #include "base/logging.hpp"
@@ -29,6 +31,17 @@ public:
 #endif
   }
 
+  FileReaderData(std::string const & fileName, SharedPageCache & sharedCache)
+    // Private cache is not used in this mode, so keep it minimal.
+    : m_fileData(fileName), m_readerCache(kDefaultLogPageSize, 1)
+    , m_sharedCache(&sharedCache)
+    , m_sharedFileId(sharedCache.GetFileId(fileName, m_fileData.Size()))
+  {
+#if LOG_FILE_READER_STATS
+    m_readCallCount = 0;
+#endif
+  }
+
   ~FileReaderData()
   {
 #if LOG_FILE_READER_STATS
@@ -38,7 +51,7 @@ public:
 
   uint64_t Size() const { return m_fileData.Size(); }
 
-  void Read(uint64_t pos, void * p, size_t size)
+  void Read(uint64_t pos, void * p, size_t size, ReaderSectionStats * sectionStats)
   {
 #if LOG_FILE_READER_STATS
     if (((++m_readCallCount) & LOG_FILE_READER_EVERY_N_READS_MASK) == 0)
@@ -47,7 +60,18 @@ public:
     }
 #endif
 
-    return m_readerCache.Read(m_fileData, pos, p, size);
+    if (m_sharedCache)
+    {
+      m_sharedCache->Read(m_sharedFileId, m_fileData.Size(), pos, p, size,
+                          [this](uint64_t pagePos, void * page, size_t pageSize)
+                          {
+                            m_fileData.Read(pagePos, page, pageSize);
+                          },
+                          sectionStats);
+      return;
+    }
+
+    return m_readerCache.Read(m_fileData, pos, p, size, sectionStats);
   }
 
 private:
@@ -68,6 +92,9 @@ private:
   FileDataWithCachedSize m_fileData;
   ReaderCache<FileDataWithCachedSize, LOG_FILE_READER_STATS> m_readerCache;
 
+  SharedPageCache * m_sharedCache = nullptr;
+  SharedPageCache::FileId m_sharedFileId = 0;
+
 #if LOG_FILE_READER_STATS
   uint32_t m_readCallCount;
 #endif
@@ -88,35 +115,53 @@ FileReader::FileReader(std::string const & fileName, uint32_t logPageSize, uint3
 {
 }
 
+FileReader::FileReader(std::string const & fileName, SharedPageCache & cache)
+  : ModelReader(fileName)
+  , m_logPageSize(kDefaultLogPageSize)
+  , m_logPageCount(kDefaultLogPageCount)
+  , m_fileData(std::make_shared<FileReaderData>(fileName, cache))
+  , m_offset(0)
+  , m_size(m_fileData->Size())
+{
+}
+
 FileReader::FileReader(FileReader const & reader, uint64_t offset, uint64_t size,
-                       uint32_t logPageSize, uint32_t logPageCount)
+                       ReaderSectionStats * sectionStats)
   : ModelReader(reader.GetName())
-  , m_logPageSize(logPageSize)
-  , m_logPageCount(logPageCount)
+  , m_logPageSize(reader.m_logPageSize)
+  , m_logPageCount(reader.m_logPageCount)
   , m_fileData(reader.m_fileData)
   , m_offset(offset)
   , m_size(size)
+  , m_sectionStats(sectionStats)
 {
 }
 
 void FileReader::Read(uint64_t pos, void * p, size_t size) const
 {
   CheckPosAndSize(pos, size);
-  m_fileData->Read(m_offset + pos, p, size);
+  m_fileData->Read(m_offset + pos, p, size, m_sectionStats);
 }
 
 FileReader FileReader::SubReader(uint64_t pos, uint64_t size) const
 {
   CheckPosAndSize(pos, size);
-  return FileReader(*this, m_offset + pos, size, m_logPageSize, m_logPageCount);
+  return FileReader(*this, m_offset + pos, size, m_sectionStats);
+}
+
+FileReader FileReader::SectionReader(std::string const & tag, uint64_t pos, uint64_t size) const
+{
+  CheckPosAndSize(pos, size);
+  // Section lookup takes the global stats lock, so it is skipped on hot paths when stats are off.
+  auto & stats = ReaderStats::Instance();
+  return FileReader(*this, m_offset + pos, size, stats.IsEnabled() ? &stats.GetSection(tag) : nullptr);
 }
 
 std::unique_ptr<Reader> FileReader::CreateSubReader(uint64_t pos, uint64_t size) const
 {
   CheckPosAndSize(pos, size);
   // Can't use make_unique with private constructor.
-  return std::unique_ptr<Reader>(
-      new FileReader(*this, m_offset + pos, size, m_logPageSize, m_logPageCount));
+  return std::unique_ptr<Reader>(new FileReader(*this, m_offset + pos, size, m_sectionStats));
 }
 
 void FileReader::CheckPosAndSize(uint64_t pos, uint64_t size) const
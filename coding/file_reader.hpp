@@ -9,6 +9,9 @@
 #include <memory>
 #include <string>
 
+class ReaderSectionStats;
+class SharedPageCache;
+
 // FileReader, cheap to copy, not thread safe.
 // It is assumed that file is not modified during FireReader lifetime,
 // because of caching and assumption that Size() is constant.
@@ -20,6 +23,9 @@ public:
 
   explicit FileReader(std::string const & fileName);
   FileReader(std::string const & fileName, uint32_t logPageSize, uint32_t logPageCount);
+  // Reads through the process-wide |cache| instead of the private per-reader one,
+  // so readers of the same file share cached pages.
+  FileReader(std::string const & fileName, SharedPageCache & cache);
 
   // Reader overrides:
   uint64_t Size() const override { return m_size; }
@@ -27,6 +33,9 @@ public:
   std::unique_ptr<Reader> CreateSubReader(uint64_t pos, uint64_t size) const override;
 
   FileReader SubReader(uint64_t pos, uint64_t size) const;
+  // Sub reader for the container section |tag|, its reads are accounted in ReaderStats
+  // if the stats are enabled when the reader is created.
+  FileReader SectionReader(std::string const & tag, uint64_t pos, uint64_t size) const;
   uint64_t GetOffset() const { return m_offset; }
 
 protected:
@@ -36,8 +45,8 @@ protected:
 private:
   class FileReaderData;
 
-  FileReader(FileReader const & reader, uint64_t offset, uint64_t size, uint32_t logPageSize,
-             uint32_t logPageCount);
+  FileReader(FileReader const & reader, uint64_t offset, uint64_t size,
+             ReaderSectionStats * sectionStats);
 
   // Throws an exception if a (pos, size) read would result in an out-of-bounds access.
   void CheckPosAndSize(uint64_t pos, uint64_t size) const;
@@ -47,4 +56,5 @@ private:
   std::shared_ptr<FileReaderData> m_fileData;
   uint64_t m_offset;
   uint64_t m_size;
+  ReaderSectionStats * m_sectionStats = nullptr;
 };
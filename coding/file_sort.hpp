@@ -2,16 +2,26 @@
 
 #include "coding/file_reader.hpp"
 #include "coding/file_writer.hpp"
+#include "coding/internal/file_data.hpp"
+#include "coding/zlib.hpp"
 
+#include "base/assert.hpp"
 #include "base/base.hpp"
 #include "base/logging.hpp"
 #include "base/exception.hpp"
+#include "base/thread_pool_computational.hpp"
 
 #include <algorithm>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
+#include <deque>
 #include <exception>
 #include <functional>
+#include <future>
+#include <iterator>
 #include <memory>
+#include <mutex>
 #include <queue>
 #include <string>
 #include <utility>
@@ -28,6 +38,14 @@ struct Sorter
   }
 };
 
+// External merge sort of items of a fixed size.
+// Items are collected into buffers which fit into |bufferBytes| all together. A full buffer is
+// sorted and written to the temporary file as a run. With several threads, up to |threadsCount|
+// runs are written while the next items are collected, so every buffer gets 1/(threadsCount + 1)
+// of the budget. Runs may be compressed to save disk space and IO. If all the items fit into
+// a single buffer, they are sorted in memory without the temporary file.
+// Finally, the runs are merged. The merge buffers of all the runs read at once fit into the budget
+// too, so when there are more runs, groups of them are merged into longer runs first.
 template <typename T,                                        // Item type.
           class OutputSinkT = FileWriter,                    // Sink to output into result file.
           typename LessT = std::less<T>,                     // Item comparator.
@@ -37,54 +55,62 @@ class FileSorter
 {
 public:
   FileSorter(size_t bufferBytes, std::string const & tmpFileName, OutputSinkT & outputSink,
-             LessT fLess = LessT())
+             LessT fLess = LessT(), size_t threadsCount = 1, bool compressRuns = false)
     : m_TmpFileName(tmpFileName)
-    , m_BufferCapacity(std::max(size_t(16), bufferBytes / sizeof(T)))
+    , m_BufferCapacity(std::max(size_t(16), GetBufferBytes(bufferBytes, threadsCount) / sizeof(T)))
+    , m_MaxMergedRuns(GetMaxMergedRuns(bufferBytes, compressRuns))
     , m_OutputSink(outputSink)
-    , m_ItemCount(0)
     , m_Less(fLess)
+    , m_CompressRuns(compressRuns)
   {
+    CHECK_GREATER(threadsCount, 0, ());
+    // A single thread sorts the runs by itself.
+    if (threadsCount > 1)
+      m_pThreadPool = std::make_unique<base::thread_pool::computational::ThreadPool>(threadsCount);
+    m_MaxRunsInProgress = threadsCount;
     m_Buffer.reserve(m_BufferCapacity);
-    m_pTmpWriter.reset(new FileWriter(tmpFileName));
   }
 
   void Add(T const & item)
   {
     if (m_Buffer.size() == m_BufferCapacity)
-      FlushToTmpFile();
+      FlushRun();
     m_Buffer.push_back(item);
     ++m_ItemCount;
   }
 
   void SortAndFinish()
   {
-    ASSERT(m_pTmpWriter.get(), ());
-    FlushToTmpFile();
+    ASSERT(!m_Finished, ());
+    m_Finished = true;
 
-    // Write output.
+    if (!m_pTmpWriter)
     {
-      m_pTmpWriter.reset();
-      FileReader reader(m_TmpFileName);
-      ItemIndexPairGreater fGreater(m_Less);
-      PriorityQueue q(fGreater);
-      for (uint32_t i = 0; i < m_ItemCount; i += m_BufferCapacity)
-        Push(q, i, reader);
+      SorterT<LessT> sorter(m_Less);
+      sorter(m_Buffer.begin(), m_Buffer.end());
+      for (auto const & item : m_Buffer)
+        m_OutputSink(item);
+      m_Buffer = {};
+      return;
+    }
 
-      while (!q.empty())
-      {
-        m_OutputSink(q.top().first);
-        uint32_t const i = q.top().second + 1;
-        q.pop();
-        if (i % m_BufferCapacity != 0 && i < m_ItemCount)
-          Push(q, i, reader);
-      }
+    FlushRun();
+    WaitForRuns(0 /* maxRunsInProgress */);
+    m_pTmpWriter.reset();
+
+    while (m_Runs.size() > m_MaxMergedRuns)
+      MergeRunsPass();
+
+    {
+      FileReader reader(m_TmpFileName);
+      MergeRuns(reader, m_Runs.begin(), m_Runs.end(), m_OutputSink);
     }
     FileWriter::DeleteFileX(m_TmpFileName);
   }
 
   ~FileSorter()
   {
-    if (m_pTmpWriter.get())
+    if (!m_Finished)
     {
       try
       {
@@ -102,10 +128,98 @@ public:
   }
 
 private:
+  // Compressed runs consist of blocks of kBlockItems items, every block is prefixed by its size.
+  static size_t constexpr kBlockItems = std::max(size_t(1), size_t(64 * 1024) / sizeof(T));
+
+  // A run reader holds a block of items and, for compressed runs, the packed and
+  // the inflated copies of it.
+  static size_t GetRunReaderBytes(bool compressed)
+  {
+    return kBlockItems * sizeof(T) * (compressed ? 3 : 1);
+  }
+
+  static size_t GetBufferBytes(size_t bufferBytes, size_t threadsCount)
+  {
+    // A single thread has no runs in progress besides the collected one.
+    return threadsCount > 1 ? bufferBytes / (threadsCount + 1) : bufferBytes;
+  }
+
+  static size_t GetMaxMergedRuns(size_t bufferBytes, bool compressed)
+  {
+    // One more reader's worth of memory is left for the writer of the intermediate merges.
+    size_t const readers = bufferBytes / GetRunReaderBytes(compressed);
+    return std::max(size_t(2), readers > 1 ? readers - 1 : 0);
+  }
+
+  struct Run
+  {
+    uint64_t m_offset = 0;
+    uint64_t m_count = 0;
+  };
+
+  class RunReader
+  {
+  public:
+    RunReader(FileReader const & reader, Run const & run, bool compressed)
+      : m_Reader(reader), m_Offset(run.m_offset), m_Left(run.m_count), m_Compressed(compressed)
+    {
+    }
+
+    bool Next(T & item)
+    {
+      if (m_Pos == m_Items.size() && !ReadBlock())
+        return false;
+      item = m_Items[m_Pos++];
+      return true;
+    }
+
+  private:
+    bool ReadBlock()
+    {
+      if (m_Left == 0)
+        return false;
+
+      size_t const count = static_cast<size_t>(std::min<uint64_t>(m_Left, kBlockItems));
+      m_Items.resize(count);
+      if (m_Compressed)
+      {
+        uint32_t size = 0;
+        m_Reader.Read(m_Offset, &size, sizeof(size));
+        m_Packed.resize(size);
+        m_Reader.Read(m_Offset + sizeof(size), m_Packed.data(), size);
+        m_Offset += sizeof(size) + size;
+
+        m_Data.clear();
+        coding::ZLib::Inflate inflate(coding::ZLib::Inflate::Format::ZLib);
+        CHECK(inflate(m_Packed.data(), m_Packed.size(), std::back_inserter(m_Data)), ());
+        CHECK_EQUAL(m_Data.size(), count * sizeof(T), ());
+        std::memcpy(m_Items.data(), m_Data.data(), m_Data.size());
+      }
+      else
+      {
+        m_Reader.Read(m_Offset, m_Items.data(), count * sizeof(T));
+        m_Offset += count * sizeof(T);
+      }
+
+      m_Left -= count;
+      m_Pos = 0;
+      return true;
+    }
+
+    FileReader const & m_Reader;
+    uint64_t m_Offset;
+    uint64_t m_Left;
+    bool m_Compressed;
+    std::vector<T> m_Items;
+    size_t m_Pos = 0;
+    std::vector<char> m_Packed;
+    std::vector<char> m_Data;
+  };
+
   struct ItemIndexPairGreater
   {
     explicit ItemIndexPairGreater(LessT fLess) : m_Less(fLess) {}
-    inline bool operator()(std::pair<T, uint32_t> const & a, std::pair<T, uint32_t> const & b) const
+    inline bool operator()(std::pair<T, size_t> const & a, std::pair<T, size_t> const & b) const
     {
       return m_Less(b.first, a.first);
     }
@@ -113,31 +227,173 @@ private:
   };
 
   using PriorityQueue =
-      std::priority_queue<std::pair<T, uint32_t>, std::vector<std::pair<T, uint32_t>>,
+      std::priority_queue<std::pair<T, size_t>, std::vector<std::pair<T, size_t>>,
                           ItemIndexPairGreater>;
 
-  void FlushToTmpFile()
+  void FlushRun()
   {
     if (m_Buffer.empty())
       return;
+
+    if (!m_pTmpWriter)
+      m_pTmpWriter = std::make_unique<FileWriter>(m_TmpFileName);
+
+    if (!m_pThreadPool)
+    {
+      WriteRun(m_Buffer);
+      m_Buffer.clear();
+      return;
+    }
+
+    // Bounds the memory by the buffers which are being sorted.
+    WaitForRuns(m_MaxRunsInProgress - 1);
+    m_RunsInProgress.push_back(m_pThreadPool->Submit(
+        [this, items = std::move(m_Buffer)]() mutable { WriteRun(items); }));
+    m_Buffer = {};
+    m_Buffer.reserve(m_BufferCapacity);
+  }
+
+  void WaitForRuns(size_t maxRunsInProgress)
+  {
+    while (m_RunsInProgress.size() > maxRunsInProgress)
+    {
+      // Rethrows exceptions of the workers.
+      m_RunsInProgress.front().get();
+      m_RunsInProgress.pop_front();
+    }
+  }
+
+  static void AppendCompressedBlock(T const * items, size_t count, std::vector<char> & data)
+  {
+    coding::ZLib::Deflate deflate(coding::ZLib::Deflate::Format::ZLib,
+                                  coding::ZLib::Deflate::Level::BestSpeed);
+    std::vector<char> block;
+    CHECK(deflate(items, count * sizeof(T), std::back_inserter(block)), ());
+
+    auto const size = static_cast<uint32_t>(block.size());
+    data.insert(data.end(), reinterpret_cast<char const *>(&size),
+                reinterpret_cast<char const *>(&size) + sizeof(size));
+    data.insert(data.end(), block.begin(), block.end());
+  }
+
+  // May be called on several threads.
+  void WriteRun(std::vector<T> & items)
+  {
     SorterT<LessT> sorter(m_Less);
-    sorter(m_Buffer.begin(), m_Buffer.end());
-    m_pTmpWriter->Write(&m_Buffer[0], m_Buffer.size() * sizeof(T));
-    m_Buffer.clear();
+    sorter(items.begin(), items.end());
+
+    std::vector<char> data;
+    if (m_CompressRuns)
+    {
+      for (size_t i = 0; i < items.size(); i += kBlockItems)
+        AppendCompressedBlock(&items[i], std::min(kBlockItems, items.size() - i), data);
+    }
+
+    std::lock_guard lock(m_RunsMutex);
+    m_Runs.push_back({m_pTmpWriter->Pos(), items.size()});
+    if (m_CompressRuns)
+      m_pTmpWriter->Write(data.data(), data.size());
+    else
+      m_pTmpWriter->Write(items.data(), items.size() * sizeof(T));
   }
 
-  void Push(PriorityQueue & q, uint32_t i, FileReader const & reader)
+  void Push(PriorityQueue & q, std::vector<RunReader> & runs, size_t i)
   {
     T item;
-    reader.Read(static_cast<uint64_t>(i) * sizeof(T), &item, sizeof(T));
-    q.push(std::pair<T, uint32_t>(item, i));
+    if (runs[i].Next(item))
+      q.push(std::pair<T, size_t>(item, i));
+  }
+
+  template <typename RunIt, typename Fn>
+  void MergeRuns(FileReader const & reader, RunIt beg, RunIt end, Fn && fn)
+  {
+    std::vector<RunReader> runs;
+    runs.reserve(std::distance(beg, end));
+    ItemIndexPairGreater fGreater(m_Less);
+    PriorityQueue q(fGreater);
+    for (auto it = beg; it != end; ++it)
+    {
+      runs.emplace_back(reader, *it, m_CompressRuns);
+      Push(q, runs, runs.size() - 1);
+    }
+
+    while (!q.empty())
+    {
+      fn(q.top().first);
+      size_t const i = q.top().second;
+      q.pop();
+      Push(q, runs, i);
+    }
+  }
+
+  // Merges every |m_MaxMergedRuns| consecutive runs into one.
+  void MergeRunsPass()
+  {
+    std::string const mergedFileName = m_TmpFileName + ".merge";
+    std::vector<Run> mergedRuns;
+    {
+      FileReader reader(m_TmpFileName);
+      FileWriter writer(mergedFileName);
+      std::vector<T> block;
+      block.reserve(kBlockItems);
+      std::vector<char> data;
+      auto const writeBlock = [&]()
+      {
+        if (m_CompressRuns)
+        {
+          data.clear();
+          AppendCompressedBlock(block.data(), block.size(), data);
+          writer.Write(data.data(), data.size());
+        }
+        else
+        {
+          writer.Write(block.data(), block.size() * sizeof(T));
+        }
+        block.clear();
+      };
+
+      for (size_t i = 0; i < m_Runs.size(); i += m_MaxMergedRuns)
+      {
+        auto const beg = m_Runs.begin() + i;
+        auto const end = m_Runs.begin() + std::min(i + m_MaxMergedRuns, m_Runs.size());
+        Run merged{writer.Pos(), 0};
+        MergeRuns(reader, beg, end, [&](T const & item)
+        {
+          block.push_back(item);
+          if (block.size() == kBlockItems)
+            writeBlock();
+        });
+        if (!block.empty())
+          writeBlock();
+        for (auto it = beg; it != end; ++it)
+          merged.m_count += it->m_count;
+        mergedRuns.push_back(merged);
+      }
+    }
+
+    m_Runs = std::move(mergedRuns);
+    CHECK(base::DeleteFileX(m_TmpFileName), (m_TmpFileName));
+    CHECK(base::RenameFileX(mergedFileName, m_TmpFileName), (mergedFileName, m_TmpFileName));
   }
 
   std::string const m_TmpFileName;
   size_t const m_BufferCapacity;
+  size_t const m_MaxMergedRuns;
   OutputSinkT & m_OutputSink;
   std::unique_ptr<FileWriter> m_pTmpWriter;
   std::vector<T> m_Buffer;
-  uint32_t m_ItemCount;
+  uint64_t m_ItemCount = 0;
   LessT m_Less;
+  bool const m_CompressRuns;
+  bool m_Finished = false;
+
+  size_t m_MaxRunsInProgress = 1;
+  std::deque<std::future<void>> m_RunsInProgress;
+
+  // Guards |m_Runs| and |m_pTmpWriter| while the runs are written.
+  std::mutex m_RunsMutex;
+  std::vector<Run> m_Runs;
+
+  // Declared last to be destroyed first, its tasks use the other members.
+  std::unique_ptr<base::thread_pool::computational::ThreadPool> m_pThreadPool;
 };
@@ -72,12 +72,14 @@ FilesContainerR::FilesContainerR(std::string const & filePath,
                                  uint32_t logPageSize,
                                  uint32_t logPageCount)
   : m_source(std::make_unique<FileReader>(filePath, logPageSize, logPageCount))
+  , m_fileSource(dynamic_cast<FileReader const *>(m_source.GetPtr()))
 {
   ReadInfo(m_source);
 }
 
 FilesContainerR::FilesContainerR(TReader const & file)
   : m_source(file)
+  , m_fileSource(dynamic_cast<FileReader const *>(m_source.GetPtr()))
 {
   ReadInfo(m_source);
 }
@@ -87,6 +89,10 @@ FilesContainerR::TReader FilesContainerR::GetReader(Tag const & tag) const
   TagInfo const * p = GetInfo(tag);
   if (!p)
     MYTHROW(Reader::OpenException, ("Can't find section:", GetFileName(), tag));
+
+  // Sections of a file container are accounted separately in ReaderStats.
+  if (m_fileSource)
+    return std::make_unique<FileReader>(m_fileSource->SectionReader(tag, p->m_offset, p->m_size));
   return m_source.SubReader(p->m_offset, p->m_size);
 }
 
@@ -96,8 +102,7 @@ std::pair<uint64_t, uint64_t> FilesContainerR::GetAbsoluteOffsetAndSize(Tag cons
   if (!p)
     MYTHROW(Reader::OpenException, ("Can't find section:", GetFileName(), tag));
 
-  auto reader = dynamic_cast<FileReader const *>(m_source.GetPtr());
-  uint64_t const offset = reader ? reader->GetOffset() : 0;
+  uint64_t const offset = m_fileSource ? m_fileSource->GetOffset() : 0;
   return std::make_pair(offset + p->m_offset, p->m_size);
 }
 
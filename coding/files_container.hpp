@@ -137,6 +137,8 @@ public:
 
 private:
   TReader m_source;
+  // |m_source| if it is a FileReader, its section readers are accounted in ReaderStats.
+  FileReader const * m_fileSource = nullptr;
 };
 
 namespace detail
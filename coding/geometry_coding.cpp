@@ -5,10 +5,23 @@
 #include "geometry/mercator.hpp"
 
 #include "base/assert.hpp"
+#include "base/bits.hpp"
 
+#include <array>
 #include <complex>
 #include <stack>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DELTAS_DECODER_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(DELTAS_DECODER_SSE2) && (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define DELTAS_DECODER_AVX2
+#include <immintrin.h>
+#endif
+
 namespace
 {
 inline m2::PointU ClampPoint(m2::PointD const & maxPoint, m2::PointD const & point)
@@ -29,6 +42,137 @@ struct edge_less_p0
   bool operator()(edge_t const & e1, int e2) const { return e1.m_p[0] < e2; }
   bool operator()(int e1, edge_t const & e2) const { return e1 < e2.m_p[0]; }
 };
+
+static_assert(sizeof(m2::PointI) == 2 * sizeof(int32_t), "PointI is stored as x, y pair");
+
+void DecodePointDeltasScalar(uint64_t const * deltas, size_t count, m2::PointI * diffs)
+{
+  for (size_t i = 0; i < count; ++i)
+  {
+    uint32_t x, y;
+    bits::BitwiseSplit(deltas[i], x, y);
+    diffs[i] = m2::PointI(bits::ZigZagDecode(x), bits::ZigZagDecode(y));
+  }
+}
+
+// Vector versions of BitwiseSplit work with 64-bit lanes: x is in the even bits of the delta
+// and y is in the odd ones. The even bits are compacted to the low half of the lane, then
+// x and y are put into adjacent 32-bit lanes and zigzag decoded, so every 64-bit lane of
+// the result is a PointI.
+#ifdef DELTAS_DECODER_SSE2
+__m128i CompactEvenBits(__m128i v)
+{
+  v = _mm_and_si128(v, _mm_set1_epi64x(0x5555555555555555LL));
+  v = _mm_and_si128(_mm_or_si128(v, _mm_srli_epi64(v, 1)), _mm_set1_epi64x(0x3333333333333333LL));
+  v = _mm_and_si128(_mm_or_si128(v, _mm_srli_epi64(v, 2)), _mm_set1_epi64x(0x0F0F0F0F0F0F0F0FLL));
+  v = _mm_and_si128(_mm_or_si128(v, _mm_srli_epi64(v, 4)), _mm_set1_epi64x(0x00FF00FF00FF00FFLL));
+  v = _mm_and_si128(_mm_or_si128(v, _mm_srli_epi64(v, 8)), _mm_set1_epi64x(0x0000FFFF0000FFFFLL));
+  v = _mm_and_si128(_mm_or_si128(v, _mm_srli_epi64(v, 16)), _mm_set1_epi64x(0x00000000FFFFFFFFLL));
+  return v;
+}
+
+void DecodePointDeltasSse2(uint64_t const * deltas, size_t count, m2::PointI * diffs)
+{
+  __m128i const one = _mm_set1_epi32(1);
+  size_t i = 0;
+  for (; i + 2 <= count; i += 2)
+  {
+    __m128i const v = _mm_loadu_si128(reinterpret_cast<__m128i const *>(deltas + i));
+    __m128i const x = CompactEvenBits(v);
+    __m128i const y = CompactEvenBits(_mm_srli_epi64(v, 1));
+    __m128i const xy = _mm_or_si128(x, _mm_slli_epi64(y, 32));
+    __m128i const res = _mm_xor_si128(_mm_srli_epi32(xy, 1),
+                                      _mm_sub_epi32(_mm_setzero_si128(), _mm_and_si128(xy, one)));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(diffs + i), res);
+  }
+  DecodePointDeltasScalar(deltas + i, count - i, diffs + i);
+}
+#endif  // DELTAS_DECODER_SSE2
+
+#ifdef DELTAS_DECODER_AVX2
+__attribute__((target("avx2"))) __m256i CompactEvenBits(__m256i v)
+{
+  v = _mm256_and_si256(v, _mm256_set1_epi64x(0x5555555555555555LL));
+  v = _mm256_and_si256(_mm256_or_si256(v, _mm256_srli_epi64(v, 1)),
+                       _mm256_set1_epi64x(0x3333333333333333LL));
+  v = _mm256_and_si256(_mm256_or_si256(v, _mm256_srli_epi64(v, 2)),
+                       _mm256_set1_epi64x(0x0F0F0F0F0F0F0F0FLL));
+  v = _mm256_and_si256(_mm256_or_si256(v, _mm256_srli_epi64(v, 4)),
+                       _mm256_set1_epi64x(0x00FF00FF00FF00FFLL));
+  v = _mm256_and_si256(_mm256_or_si256(v, _mm256_srli_epi64(v, 8)),
+                       _mm256_set1_epi64x(0x0000FFFF0000FFFFLL));
+  v = _mm256_and_si256(_mm256_or_si256(v, _mm256_srli_epi64(v, 16)),
+                       _mm256_set1_epi64x(0x00000000FFFFFFFFLL));
+  return v;
+}
+
+__attribute__((target("avx2"))) void DecodePointDeltasAvx2(uint64_t const * deltas, size_t count,
+                                                            m2::PointI * diffs)
+{
+  __m256i const one = _mm256_set1_epi32(1);
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    __m256i const v = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(deltas + i));
+    __m256i const x = CompactEvenBits(v);
+    __m256i const y = CompactEvenBits(_mm256_srli_epi64(v, 1));
+    __m256i const xy = _mm256_or_si256(x, _mm256_slli_epi64(y, 32));
+    __m256i const res = _mm256_xor_si256(
+        _mm256_srli_epi32(xy, 1), _mm256_sub_epi32(_mm256_setzero_si256(), _mm256_and_si256(xy, one)));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(diffs + i), res);
+  }
+  DecodePointDeltasSse2(deltas + i, count - i, diffs + i);
+}
+#endif  // DELTAS_DECODER_AVX2
+
+// Decodes deltas with the batched decoder by blocks of kBlockSize, which fit on the stack.
+// Deltas must be requested in non-decreasing order of indexes, as polylines and triangles
+// decoders do.
+class DeltasBlockReader
+{
+public:
+  // |shift| is applied to every delta, triangles store tree bits in the lowest bits.
+  explicit DeltasBlockReader(coding::InDeltasT const & deltas, uint8_t shift = 0)
+    : m_deltas(deltas), m_shift(shift)
+  {
+  }
+
+  // Returns the point equal to DecodePointDeltaFromUint(deltas[i] >> shift, prediction).
+  m2::PointU Decode(size_t i, m2::PointU const & prediction)
+  {
+    if (i >= m_end)
+      Fill(i);
+
+    ASSERT_GREATER_OR_EQUAL(i, m_begin, ());
+    m2::PointI const & diff = m_diffs[i - m_begin];
+    return m2::PointU(prediction.x + diff.x, prediction.y + diff.y);
+  }
+
+private:
+  static size_t constexpr kBlockSize = 64;
+
+  void Fill(size_t i)
+  {
+    m_begin = i;
+    m_end = std::min(i + kBlockSize, m_deltas.size());
+
+    uint64_t const * deltas = &m_deltas[i];
+    if (m_shift != 0)
+    {
+      for (size_t j = m_begin; j < m_end; ++j)
+        m_shifted[j - m_begin] = m_deltas[j] >> m_shift;
+      deltas = m_shifted.data();
+    }
+    coding::DecodePointDeltasFromUint(deltas, m_end - m_begin, m_diffs.data());
+  }
+
+  coding::InDeltasT const & m_deltas;
+  uint8_t const m_shift;
+  size_t m_begin = 0;
+  size_t m_end = 0;
+  std::array<m2::PointI, kBlockSize> m_diffs;
+  std::array<uint64_t, kBlockSize> m_shifted;
+};
 }  // namespace
 
 namespace coding
@@ -71,6 +215,74 @@ m2::PointU DecodePointDeltaFromUint(uint64_t delta, m2::PointU const & predictio
   return m2::PointU(prediction.x + bits::ZigZagDecode(x), prediction.y + bits::ZigZagDecode(y));
 }
 
+std::string DebugPrint(DeltasDecoder decoder)
+{
+  switch (decoder)
+  {
+  case DeltasDecoder::Scalar: return "Scalar";
+  case DeltasDecoder::Sse2: return "Sse2";
+  case DeltasDecoder::Avx2: return "Avx2";
+  }
+  UNREACHABLE();
+}
+
+bool IsSupported(DeltasDecoder decoder)
+{
+  switch (decoder)
+  {
+  case DeltasDecoder::Scalar: return true;
+  case DeltasDecoder::Sse2:
+#ifdef DELTAS_DECODER_SSE2
+    return true;
+#else
+    return false;
+#endif
+  case DeltasDecoder::Avx2:
+#ifdef DELTAS_DECODER_AVX2
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+  }
+  UNREACHABLE();
+}
+
+DeltasDecoder GetBestDeltasDecoder()
+{
+  static DeltasDecoder const best = []()
+  {
+    for (auto const decoder : {DeltasDecoder::Avx2, DeltasDecoder::Sse2})
+    {
+      if (IsSupported(decoder))
+        return decoder;
+    }
+    return DeltasDecoder::Scalar;
+  }();
+  return best;
+}
+
+void DecodePointDeltasFromUint(uint64_t const * deltas, size_t count, m2::PointI * diffs)
+{
+  DecodePointDeltasFromUint(GetBestDeltasDecoder(), deltas, count, diffs);
+}
+
+void DecodePointDeltasFromUint(DeltasDecoder decoder, uint64_t const * deltas, size_t count,
+                               m2::PointI * diffs)
+{
+  ASSERT(IsSupported(decoder), (decoder));
+  switch (decoder)
+  {
+  case DeltasDecoder::Scalar: DecodePointDeltasScalar(deltas, count, diffs); return;
+#ifdef DELTAS_DECODER_SSE2
+  case DeltasDecoder::Sse2: DecodePointDeltasSse2(deltas, count, diffs); return;
+#endif
+#ifdef DELTAS_DECODER_AVX2
+  case DeltasDecoder::Avx2: DecodePointDeltasAvx2(deltas, count, diffs); return;
+#endif
+  default: DecodePointDeltasScalar(deltas, count, diffs); return;
+  }
+}
+
 m2::PointU PredictPointInPolyline(m2::PointD const & maxPoint, m2::PointU const & p1,
                                   m2::PointU const & p2, m2::PointU const & p3)
 {
@@ -121,11 +333,12 @@ void DecodePolylinePrev1(InDeltasT const & deltas, m2::PointU const & basePoint,
                          m2::PointU const & /*maxPoint*/, OutPointsT & points)
 {
   size_t const count = deltas.size();
+  DeltasBlockReader reader(deltas);
   if (count > 0)
   {
-    points.push_back(DecodePointDeltaFromUint(deltas[0], basePoint));
+    points.push_back(reader.Decode(0, basePoint));
     for (size_t i = 1; i < count; ++i)
-      points.push_back(DecodePointDeltaFromUint(deltas[i], points.back()));
+      points.push_back(reader.Decode(i, points.back()));
   }
 }
 
@@ -153,18 +366,19 @@ void DecodePolylinePrev2(InDeltasT const & deltas, m2::PointU const & basePoint,
                          m2::PointU const & maxPoint, OutPointsT & points)
 {
   size_t const count = deltas.size();
+  DeltasBlockReader reader(deltas);
   if (count > 0)
   {
-    points.push_back(DecodePointDeltaFromUint(deltas[0], basePoint));
+    points.push_back(reader.Decode(0, basePoint));
     if (count > 1)
     {
       m2::PointD const maxPointD(maxPoint);
-      points.push_back(DecodePointDeltaFromUint(deltas[1], points.back()));
+      points.push_back(reader.Decode(1, points.back()));
       for (size_t i = 2; i < count; ++i)
       {
         size_t const n = points.size();
-        points.push_back(DecodePointDeltaFromUint(
-            deltas[i], PredictPointInPolyline(maxPointD, points[n - 1], points[n - 2])));
+        points.push_back(
+            reader.Decode(i, PredictPointInPolyline(maxPointD, points[n - 1], points[n - 2])));
       }
     }
   }
@@ -208,24 +422,24 @@ void DecodePolylinePrev3(InDeltasT const & deltas, m2::PointU const & basePoint,
   ASSERT_LESS_OR_EQUAL(basePoint.y, maxPoint.y, (basePoint, maxPoint));
 
   size_t const count = deltas.size();
+  DeltasBlockReader reader(deltas);
   if (count > 0)
   {
-    points.push_back(DecodePointDeltaFromUint(deltas[0], basePoint));
+    points.push_back(reader.Decode(0, basePoint));
     if (count > 1)
     {
       m2::PointU const pt0 = points.back();
-      points.push_back(DecodePointDeltaFromUint(deltas[1], pt0));
+      points.push_back(reader.Decode(1, pt0));
       if (count > 2)
       {
         m2::PointD const maxPointD(maxPoint);
-        points.push_back(DecodePointDeltaFromUint(
-            deltas[2], PredictPointInPolyline(maxPointD, points.back(), pt0)));
+        points.push_back(reader.Decode(2, PredictPointInPolyline(maxPointD, points.back(), pt0)));
         for (size_t i = 3; i < count; ++i)
         {
           size_t const n = points.size();
           m2::PointU const prediction = PredictPointInPolyline(
                 maxPointD, points[n - 1], points[n - 2], points[n - 3]);
-          points.push_back(DecodePointDeltaFromUint(deltas[i], prediction));
+          points.push_back(reader.Decode(i, prediction));
         }
       }
     }
@@ -274,9 +488,10 @@ void DecodeTriangleStrip(InDeltasT const & deltas, m2::PointU const & basePoint,
   {
     ASSERT_GREATER(count, 2, ());
 
-    points.push_back(DecodePointDeltaFromUint(deltas[0], basePoint));
-    points.push_back(DecodePointDeltaFromUint(deltas[1], points.back()));
-    points.push_back(DecodePointDeltaFromUint(deltas[2], points.back()));
+    DeltasBlockReader reader(deltas);
+    points.push_back(reader.Decode(0, basePoint));
+    points.push_back(reader.Decode(1, points.back()));
+    points.push_back(reader.Decode(2, points.back()));
 
     m2::PointD const maxPointD(maxPoint);
     for (size_t i = 3; i < count; ++i)
@@ -284,7 +499,7 @@ void DecodeTriangleStrip(InDeltasT const & deltas, m2::PointU const & basePoint,
       size_t const n = points.size();
       m2::PointU const prediction = PredictPointInTriangle(
             maxPointD, points[n - 1], points[n - 2], points[n - 3]);
-      points.push_back(DecodePointDeltaFromUint(deltas[i], prediction));
+      points.push_back(reader.Decode(i, prediction));
     }
   }
 }
@@ -462,6 +677,8 @@ void DecodeTriangles(coding::InDeltasT const & deltas, m2::PointU const & basePo
   points.push_back(coding::DecodePointDeltaFromUint(deltas[1], points.back()));
   points.push_back(coding::DecodePointDeltaFromUint(deltas[2] >> 2, points.back()));
 
+  // Deltas of the next points keep 2 tree bits in the lowest bits.
+  DeltasBlockReader reader(deltas, 2 /* shift */);
   std::stack<size_t> st;
 
   size_t ind = 2;
@@ -504,7 +721,7 @@ void DecodeTriangles(coding::InDeltasT const & deltas, m2::PointU const & basePo
     // push points
     points.push_back(points[trg[0]]);
     points.push_back(points[trg[1]]);
-    points.push_back(coding::DecodePointDeltaFromUint(deltas[i] >> 2, coding::PredictPointInTriangle(
+    points.push_back(reader.Decode(i, coding::PredictPointInTriangle(
             maxPointD, points[trg[0]], points[trg[1]], points[trg[2]])));
 
     // next step
@@ -13,8 +13,11 @@
 #include "base/stl_helpers.hpp"
 
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <list>
+#include <string>
 #include <vector>
 
 namespace coding
@@ -30,6 +33,28 @@ uint64_t EncodePointDeltaAsUint(m2::PointU const & actual, m2::PointU const & pr
 
 m2::PointU DecodePointDeltaFromUint(uint64_t delta, m2::PointU const & prediction);
 
+/// Implementations of the batched point deltas decoder.
+enum class DeltasDecoder
+{
+  Scalar,
+  Sse2,
+  Avx2
+};
+
+std::string DebugPrint(DeltasDecoder decoder);
+
+/// Returns true if |decoder| is compiled in and is supported by the current CPU.
+bool IsSupported(DeltasDecoder decoder);
+
+/// Returns the fastest decoder for the current CPU, it is selected once at runtime.
+DeltasDecoder GetBestDeltasDecoder();
+
+/// Splits |count| deltas made by EncodePointDeltaAsUint into signed coordinate differences:
+/// DecodePointDeltaFromUint(deltas[i], p) == p + diffs[i] for any p and any decoder.
+void DecodePointDeltasFromUint(uint64_t const * deltas, size_t count, m2::PointI * diffs);
+void DecodePointDeltasFromUint(DeltasDecoder decoder, uint64_t const * deltas, size_t count,
+                               m2::PointI * diffs);
+
 // Writes the difference of two 2d vectors to sink.
 template <typename Sink>
 void EncodePointDelta(Sink & sink, m2::PointU const & curr, m2::PointU const & next)
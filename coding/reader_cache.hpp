@@ -1,5 +1,7 @@
 #pragma once
 
+#include "coding/reader_stats.hpp"
+
 #include "base/base.hpp"
 #include "base/cache.hpp"
 #include "base/stats.hpp"
@@ -7,6 +9,7 @@
 #include <algorithm>
 #include <cstdint>
 #include <cstring>
+#include <limits>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -43,21 +46,33 @@ struct ReaderCacheStats<true>
 };
 }  // namespace impl
 
+// Page cache for a reader.
+// Sequential access is detected on page misses: when the missed page follows the previously
+// loaded ones, the next pages are read ahead in one call and the read ahead window grows
+// (up to a quarter of the cache), so sequential sections are effectively read with large pages,
+// while random access sections keep reading by single small pages.
 template <class ReaderT, bool bStats = false>
 class ReaderCache
 {
 public:
   ReaderCache(uint32_t logPageSize, uint32_t logPageCount)
-    : m_Cache(logPageCount), m_LogPageSize(logPageSize)
+    : m_Cache(logPageCount)
+    , m_LogPageSize(logPageSize)
+    , m_MaxReadAheadPages(logPageCount > 2 ? std::min(1U << (logPageCount - 2), kMaxReadAheadPages) : 1)
   {
   }
 
-  void Read(ReaderT & reader, uint64_t pos, void * p, size_t size)
+  /// @param[in] sectionStats runtime counters to update, may be nullptr.
+  void Read(ReaderT & reader, uint64_t pos, void * p, size_t size,
+            ReaderSectionStats * sectionStats = nullptr)
   {
     if (size == 0)
       return;
     ASSERT_LESS_OR_EQUAL(pos + size, reader.Size(), (pos, size, reader.Size()));
     m_Stats.m_ReadSize(static_cast<uint32_t>(size));
+    m_SectionStats = (sectionStats && sectionStats->IsEnabled()) ? sectionStats : nullptr;
+    if (m_SectionStats)
+      m_SectionStats->OnRead(size);
     char * pDst = static_cast<char *>(p);
     uint64_t pageNum = pos >> m_LogPageSize;
     size_t const firstPageOffset = static_cast<size_t>(pos - (pageNum << m_LogPageSize));
@@ -84,7 +99,11 @@ public:
     return m_Stats.GetStatsStr(m_LogPageSize, m_Cache.GetCacheSize());
   }
 
+  uint32_t GetReadAheadPages() const { return m_ReadAheadPages; }
+
 private:
+  static uint32_t constexpr kMaxReadAheadPages = 64;
+
   inline size_t PageSize() const { return 1 << m_LogPageSize; }
 
   inline char const * ReadPage(ReaderT & reader, uint64_t pageNum)
@@ -92,17 +111,59 @@ private:
     bool cached;
     std::vector<char> & v = m_Cache.Find(pageNum, cached);
     m_Stats.m_CacheHit(cached ? 1 : 0);
-    if (!cached)
+    if (cached)
+    {
+      if (m_SectionStats)
+        m_SectionStats->OnPageHit();
+      return &v[0];
+    }
+
+    if (pageNum == m_NextSequentialPage)
+      m_ReadAheadPages = std::min(m_ReadAheadPages * 2, m_MaxReadAheadPages);
+    else if (pageNum <= m_LastMissedPage || pageNum > m_NextSequentialPage)
+      m_ReadAheadPages = 1;
+    // Otherwise the page was read ahead and evicted by a collision, keep the window.
+    m_LastMissedPage = pageNum;
+
+    uint64_t const pos = pageNum << m_LogPageSize;
+    size_t const readSize = static_cast<size_t>(
+        std::min(static_cast<uint64_t>(PageSize()) * m_ReadAheadPages, reader.Size() - pos));
+    size_t const pagesCount = (readSize + PageSize() - 1) >> m_LogPageSize;
+    m_NextSequentialPage = pageNum + pagesCount;
+    if (m_SectionStats)
+      m_SectionStats->OnPageMiss(readSize, pagesCount - 1);
+
+    if (pagesCount == 1)
     {
       if (v.empty())
         v.resize(PageSize());
-      uint64_t const pos = pageNum << m_LogPageSize;
-      reader.Read(pos, &v[0], std::min(PageSize(), static_cast<size_t>(reader.Size() - pos)));
+      reader.Read(pos, &v[0], readSize);
+      return &v[0];
+    }
+
+    m_ReadAheadBuffer.resize(readSize);
+    reader.Read(pos, &m_ReadAheadBuffer[0], readSize);
+    // Read ahead pages may evict the requested one, so it is put into the cache last.
+    char const * res = nullptr;
+    for (size_t i = pagesCount; i > 0; --i)
+    {
+      std::vector<char> & page = m_Cache.Find(pageNum + i - 1, cached);
+      if (page.empty())
+        page.resize(PageSize());
+      size_t const offset = (i - 1) << m_LogPageSize;
+      memcpy(&page[0], &m_ReadAheadBuffer[offset], std::min(PageSize(), readSize - offset));
+      res = &page[0];
     }
-    return &v[0];
+    return res;
   }
 
   base::Cache<uint64_t, std::vector<char> > m_Cache;
   uint32_t const m_LogPageSize;
+  uint32_t const m_MaxReadAheadPages;
+  uint32_t m_ReadAheadPages = 1;
+  uint64_t m_LastMissedPage = std::numeric_limits<uint64_t>::max();
+  uint64_t m_NextSequentialPage = std::numeric_limits<uint64_t>::max();
+  std::vector<char> m_ReadAheadBuffer;
+  ReaderSectionStats * m_SectionStats = nullptr;
   impl::ReaderCacheStats<bStats> m_Stats;
 };
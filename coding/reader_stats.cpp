@@ -0,0 +1,71 @@
+#include "coding/reader_stats.hpp"
+
+#include <sstream>
+
+ReaderSectionStats::Snapshot ReaderSectionStats::GetSnapshot() const
+{
+  Snapshot s;
+  s.m_reads = m_reads.load(std::memory_order_relaxed);
+  s.m_bytesAsked = m_bytesAsked.load(std::memory_order_relaxed);
+  s.m_pageHits = m_pageHits.load(std::memory_order_relaxed);
+  s.m_pageMisses = m_pageMisses.load(std::memory_order_relaxed);
+  s.m_bytesRead = m_bytesRead.load(std::memory_order_relaxed);
+  s.m_readAheadPages = m_readAheadPages.load(std::memory_order_relaxed);
+  return s;
+}
+
+void ReaderSectionStats::Reset()
+{
+  m_reads = 0;
+  m_bytesAsked = 0;
+  m_pageHits = 0;
+  m_pageMisses = 0;
+  m_bytesRead = 0;
+  m_readAheadPages = 0;
+}
+
+// static
+ReaderStats & ReaderStats::Instance()
+{
+  static ReaderStats stats;
+  return stats;
+}
+
+ReaderSectionStats & ReaderStats::GetSection(std::string const & tag)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto & section = m_sections[tag];
+  if (!section)
+    section = std::make_unique<ReaderSectionStats>(m_enabled);
+  return *section;
+}
+
+std::vector<std::pair<std::string, ReaderSectionStats::Snapshot>> ReaderStats::GetSnapshot() const
+{
+  std::vector<std::pair<std::string, ReaderSectionStats::Snapshot>> res;
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (auto const & section : m_sections)
+  {
+    auto const snapshot = section.second->GetSnapshot();
+    if (snapshot.m_reads != 0)
+      res.emplace_back(section.first, snapshot);
+  }
+  return res;
+}
+
+void ReaderStats::Reset()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (auto & section : m_sections)
+    section.second->Reset();
+}
+
+std::string DebugPrint(ReaderSectionStats::Snapshot const & s)
+{
+  std::ostringstream out;
+  out << "ReaderSectionStats [ reads: " << s.m_reads << ", bytes asked: " << s.m_bytesAsked
+      << ", page hits: " << s.m_pageHits << ", page misses: " << s.m_pageMisses
+      << ", bytes read: " << s.m_bytesRead << ", read ahead pages: " << s.m_readAheadPages << " ]";
+  return out.str();
+}
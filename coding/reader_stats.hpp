@@ -0,0 +1,100 @@
+#pragma once
+
+#include "base/macros.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// Runtime counters of ReaderCache reads for one section of a files container
+/// (features, geometry, search index, etc). Counters are shared by all readers of
+/// the section in all threads.
+class ReaderSectionStats
+{
+public:
+  struct Snapshot
+  {
+    uint64_t m_reads = 0;
+    uint64_t m_bytesAsked = 0;
+    uint64_t m_pageHits = 0;
+    uint64_t m_pageMisses = 0;
+    uint64_t m_bytesRead = 0;
+    uint64_t m_readAheadPages = 0;
+  };
+
+  explicit ReaderSectionStats(std::atomic<bool> const & enabled) : m_enabled(enabled) {}
+
+  bool IsEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+  void OnRead(size_t size)
+  {
+    m_reads.fetch_add(1, std::memory_order_relaxed);
+    m_bytesAsked.fetch_add(size, std::memory_order_relaxed);
+  }
+
+  void OnPageHit() { m_pageHits.fetch_add(1, std::memory_order_relaxed); }
+
+  /// |readAheadPages| is the number of pages read in advance together with the missed one.
+  void OnPageMiss(size_t bytesRead, size_t readAheadPages)
+  {
+    m_pageMisses.fetch_add(1, std::memory_order_relaxed);
+    m_bytesRead.fetch_add(bytesRead, std::memory_order_relaxed);
+    m_readAheadPages.fetch_add(readAheadPages, std::memory_order_relaxed);
+  }
+
+  Snapshot GetSnapshot() const;
+  void Reset();
+
+private:
+  std::atomic<bool> const & m_enabled;
+
+  std::atomic<uint64_t> m_reads{0};
+  std::atomic<uint64_t> m_bytesAsked{0};
+  std::atomic<uint64_t> m_pageHits{0};
+  std::atomic<uint64_t> m_pageMisses{0};
+  std::atomic<uint64_t> m_bytesRead{0};
+  std::atomic<uint64_t> m_readAheadPages{0};
+
+  DISALLOW_COPY_AND_MOVE(ReaderSectionStats);
+};
+
+/// Process-wide registry of per-section reader statistics.
+/// Collection is disabled by default and may be switched on at runtime, without rebuilding
+/// with LOG_FILE_READER_STATS.
+/// Sections are accounted for FileReader with both private and shared page caches, the shared
+/// cache doesn't read ahead. MmapReader is not supported: its pages are loaded by the OS, so
+/// hits and misses can't be counted.
+class ReaderStats
+{
+public:
+  static ReaderStats & Instance();
+
+  void SetEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+  bool IsEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+  /// Returns counters for the section |tag|. The reference is valid during the process lifetime.
+  ReaderSectionStats & GetSection(std::string const & tag);
+
+  /// Returns (tag, counters) for every section which has been read from.
+  std::vector<std::pair<std::string, ReaderSectionStats::Snapshot>> GetSnapshot() const;
+
+  void Reset();
+
+private:
+  ReaderStats() = default;
+
+  std::atomic<bool> m_enabled{false};
+
+  mutable std::mutex m_mutex;
+  std::map<std::string, std::unique_ptr<ReaderSectionStats>> m_sections;
+
+  DISALLOW_COPY_AND_MOVE(ReaderStats);
+};
+
+std::string DebugPrint(ReaderSectionStats::Snapshot const & snapshot);
@@ -0,0 +1,150 @@
+#include "coding/shared_page_cache.hpp"
+
+#include <sstream>
+
+// static
+uint32_t const SharedPageCache::kDefaultLogPageSize = 10;  // 1Kb pages, like in FileReader.
+// static
+uint32_t const SharedPageCache::kDefaultLogShardsCount = 4;  // 16 shards.
+// static
+uint64_t const SharedPageCache::kDefaultBytesLimit = 64 * 1024 * 1024;
+
+SharedPageCache::SharedPageCache(uint32_t logPageSize, uint32_t logShardsCount, uint64_t bytesLimit)
+  : m_logPageSize(logPageSize)
+  , m_bytesLimitPerShard(bytesLimit >> logShardsCount)
+  , m_shards(size_t(1) << logShardsCount)
+{
+  CHECK(logPageSize > 0 && logPageSize < 32, (logPageSize));
+  CHECK_LESS(logShardsCount, 16, ());
+  CHECK_GREATER_OR_EQUAL(m_bytesLimitPerShard, PageSize(), (bytesLimit, logShardsCount));
+}
+
+// static
+SharedPageCache & SharedPageCache::Instance()
+{
+  static SharedPageCache cache(kDefaultLogPageSize, kDefaultLogShardsCount, kDefaultBytesLimit);
+  return cache;
+}
+
+SharedPageCache::FileId SharedPageCache::GetFileId(std::string const & fileName, uint64_t fileSize)
+{
+  std::lock_guard<std::mutex> lock(m_filesMutex);
+  auto const res = m_files.emplace(std::make_pair(fileName, fileSize), m_nextFileId);
+  if (res.second)
+    ++m_nextFileId;
+  CHECK_LESS(res.first->second, FileId(1) << (64 - kPageNumBits), ("Too many files in SharedPageCache."));
+  return res.first->second;
+}
+
+void SharedPageCache::DropFile(FileId fileId)
+{
+  for (auto & shard : m_shards)
+    shard.Drop(fileId);
+}
+
+void SharedPageCache::DropFile(std::string const & fileName)
+{
+  std::vector<FileId> fileIds;
+  {
+    std::lock_guard<std::mutex> lock(m_filesMutex);
+    auto it = m_files.lower_bound(std::make_pair(fileName, uint64_t(0)));
+    while (it != m_files.end() && it->first.first == fileName)
+    {
+      fileIds.push_back(it->second);
+      m_droppedFileIds.insert(it->second);
+      it = m_files.erase(it);
+    }
+  }
+
+  // The ids are marked as dropped before the shards are cleared, and Shard::Insert() checks
+  // the mark under the shard lock, so pages which are being loaded are not cached after that.
+  for (auto const fileId : fileIds)
+    DropFile(fileId);
+}
+
+bool SharedPageCache::IsDropped(FileId fileId) const
+{
+  std::lock_guard<std::mutex> lock(m_filesMutex);
+  return m_droppedFileIds.count(fileId) != 0;
+}
+
+SharedPageCache::Stats SharedPageCache::GetStats() const
+{
+  Stats stats;
+  stats.m_hits = m_hits.load(std::memory_order_relaxed);
+  stats.m_misses = m_misses.load(std::memory_order_relaxed);
+  for (auto const & shard : m_shards)
+    stats.m_bytesCached += shard.BytesCached();
+  return stats;
+}
+
+bool SharedPageCache::Shard::Copy(Key key, size_t offset, char * dst, size_t size)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto const it = m_index.find(key);
+  if (it == m_index.end())
+    return false;
+
+  Page const & page = *it->second->second;
+  ASSERT_LESS_OR_EQUAL(offset + size, page.size(), ());
+  memcpy(dst, page.data() + offset, size);
+  // Move the page to the front of the LRU list.
+  m_lru.splice(m_lru.begin(), m_lru, it->second);
+  return true;
+}
+
+void SharedPageCache::Shard::Insert(Key key, std::unique_ptr<Page> && page, uint64_t bytesLimit,
+                                    SharedPageCache const & cache)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  // The page may be loaded concurrently by another reader.
+  if (m_index.count(key) != 0)
+    return;
+
+  if (cache.IsDropped(static_cast<FileId>(key >> kPageNumBits)))
+    return;
+
+  m_bytes += page->size();
+  m_lru.emplace_front(key, std::move(page));
+  m_index.emplace(key, m_lru.begin());
+
+  while (m_bytes > bytesLimit && m_lru.size() > 1)
+  {
+    auto const & lru = m_lru.back();
+    m_bytes -= lru.second->size();
+    m_index.erase(lru.first);
+    m_lru.pop_back();
+  }
+}
+
+void SharedPageCache::Shard::Drop(FileId fileId)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (auto it = m_lru.begin(); it != m_lru.end();)
+  {
+    if ((it->first >> kPageNumBits) == fileId)
+    {
+      m_bytes -= it->second->size();
+      m_index.erase(it->first);
+      it = m_lru.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+}
+
+uint64_t SharedPageCache::Shard::BytesCached() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_bytes;
+}
+
+std::string DebugPrint(SharedPageCache::Stats const & stats)
+{
+  std::ostringstream out;
+  out << "SharedPageCache::Stats [ hits: " << stats.m_hits << ", misses: " << stats.m_misses
+      << ", bytes cached: " << stats.m_bytesCached << " ]";
+  return out.str();
+}
@@ -0,0 +1,174 @@
+#pragma once
+
+#include "coding/reader_stats.hpp"
+
+#include "base/assert.hpp"
+#include "base/macros.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+/// Process-wide page cache shared by all readers of the same file.
+/// Unlike ReaderCache, which is owned by every FileReader instance, pages are keyed by
+/// (file, page number), so different readers (and threads) of the same mwm reuse hot pages.
+/// The cache is split into shards, every shard is an LRU list guarded by its own mutex.
+/// Page loading is performed outside of the shard lock.
+class SharedPageCache
+{
+public:
+  using FileId = uint32_t;
+
+  struct Stats
+  {
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+    uint64_t m_bytesCached = 0;
+  };
+
+  static uint32_t const kDefaultLogPageSize;
+  static uint32_t const kDefaultLogShardsCount;
+  static uint64_t const kDefaultBytesLimit;
+
+  /// @param[in] logPageSize is pow of two for page size in bytes.
+  /// @param[in] logShardsCount is pow of two for number of independently locked shards.
+  /// @param[in] bytesLimit is the overall size limit of cached pages.
+  SharedPageCache(uint32_t logPageSize, uint32_t logShardsCount, uint64_t bytesLimit);
+
+  /// Cache used by FileReader in shared cache mode.
+  static SharedPageCache & Instance();
+
+  /// Returns the same id for the same (fileName, fileSize) pair.
+  /// It is assumed that file is not modified while it is registered, see FileReader.
+  FileId GetFileId(std::string const & fileName, uint64_t fileSize);
+
+  /// Removes all pages of the file from the cache.
+  void DropFile(FileId fileId);
+
+  /// Removes all pages of the file and forgets its ids, so readers which are created later
+  /// get a new id. Readers which still use the dropped ids read pages past the cache.
+  /// Must be called when the file is going to be modified or removed.
+  void DropFile(std::string const & fileName);
+
+  /// Reads [pos, pos + size) from the file through the cache.
+  /// |readPage| is called as readPage(pos, p, size) for every page which is not cached.
+  /// @param[in] sectionStats runtime counters to update, may be nullptr.
+  template <typename ReadPageFn>
+  void Read(FileId fileId, uint64_t fileSize, uint64_t pos, void * p, size_t size,
+            ReadPageFn && readPage, ReaderSectionStats * sectionStats = nullptr)
+  {
+    ASSERT_LESS_OR_EQUAL(pos + size, fileSize, ());
+    if (sectionStats && !sectionStats->IsEnabled())
+      sectionStats = nullptr;
+    if (sectionStats)
+      sectionStats->OnRead(size);
+
+    char * dst = static_cast<char *>(p);
+    uint64_t pageNum = pos >> m_logPageSize;
+    size_t offset = static_cast<size_t>(pos - (pageNum << m_logPageSize));
+    while (size > 0)
+    {
+      size_t const copySize = std::min(size, PageSize() - offset);
+      Key const key = MakeKey(fileId, pageNum);
+      Shard & shard = GetShard(key);
+      if (!shard.Copy(key, offset, dst, copySize))
+      {
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+
+        uint64_t const pagePos = pageNum << m_logPageSize;
+        auto page = std::make_unique<Page>(
+            static_cast<size_t>(std::min<uint64_t>(PageSize(), fileSize - pagePos)));
+        readPage(pagePos, page->data(), page->size());
+        if (sectionStats)
+          sectionStats->OnPageMiss(page->size(), 0 /* readAheadPages */);
+        memcpy(dst, page->data() + offset, copySize);
+        shard.Insert(key, std::move(page), m_bytesLimitPerShard, *this);
+      }
+      else
+      {
+        m_hits.fetch_add(1, std::memory_order_relaxed);
+        if (sectionStats)
+          sectionStats->OnPageHit();
+      }
+
+      dst += copySize;
+      size -= copySize;
+      offset = 0;
+      ++pageNum;
+    }
+  }
+
+  Stats GetStats() const;
+
+  size_t PageSize() const { return size_t(1) << m_logPageSize; }
+
+private:
+  // File id in high 24 bits, page number in low 40 bits: 2^40 pages of 1Kb are more than enough.
+  using Key = uint64_t;
+  using Page = std::vector<char>;
+
+  static uint32_t const kPageNumBits = 40;
+
+  class Shard
+  {
+  public:
+    // Copies a part of the page |key| to |dst|, returns false when the page is not cached.
+    bool Copy(Key key, size_t offset, char * dst, size_t size);
+    // Ignores pages of the files which are dropped by name.
+    void Insert(Key key, std::unique_ptr<Page> && page, uint64_t bytesLimit,
+                SharedPageCache const & cache);
+    void Drop(FileId fileId);
+    uint64_t BytesCached() const;
+
+  private:
+    using LruList = std::list<std::pair<Key, std::unique_ptr<Page>>>;
+
+    mutable std::mutex m_mutex;
+    LruList m_lru;
+    std::unordered_map<Key, LruList::iterator> m_index;
+    uint64_t m_bytes = 0;
+  };
+
+  static Key MakeKey(FileId fileId, uint64_t pageNum)
+  {
+    ASSERT_LESS(pageNum, Key(1) << kPageNumBits, ());
+    return (static_cast<Key>(fileId) << kPageNumBits) | pageNum;
+  }
+
+  bool IsDropped(FileId fileId) const;
+
+  Shard & GetShard(Key key)
+  {
+    // Consecutive pages of the same file go to different shards.
+    return m_shards[(key ^ (key >> kPageNumBits)) & (m_shards.size() - 1)];
+  }
+
+  uint32_t const m_logPageSize;
+  uint64_t const m_bytesLimitPerShard;
+  std::vector<Shard> m_shards;
+
+  // Guards |m_files|, |m_droppedFileIds| and |m_nextFileId|, may be locked under a shard lock.
+  mutable std::mutex m_filesMutex;
+  std::map<std::pair<std::string, uint64_t>, FileId> m_files;
+  // Ids of dropped files are not reused, readers which are still open may use them.
+  std::unordered_set<FileId> m_droppedFileIds;
+  FileId m_nextFileId = 0;
+
+  std::atomic<uint64_t> m_hits{0};
+  std::atomic<uint64_t> m_misses{0};
+
+  DISALLOW_COPY_AND_MOVE(SharedPageCache);
+};
+
+std::string DebugPrint(SharedPageCache::Stats const & stats);
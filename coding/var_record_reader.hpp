@@ -14,14 +14,21 @@ public:
   explicit VarRecordReader(ReaderT const & reader) : m_reader(reader) {}
 
   std::vector<uint8_t> ReadRecord(uint64_t const pos) const
+  {
+    std::vector<uint8_t> buffer;
+    ReadRecord(pos, buffer);
+    return buffer;
+  }
+
+  /// Reads the record into |buffer| reusing its capacity.
+  void ReadRecord(uint64_t const pos, std::vector<uint8_t> & buffer) const
   {
     ReaderSource source(m_reader);
     ASSERT_LESS(pos, source.Size(), ());
     source.Skip(pos);
     uint32_t const recordSize = ReadVarUint<uint32_t>(source);
-    std::vector<uint8_t> buffer(recordSize);
+    buffer.resize(recordSize);
     source.Read(buffer.data(), recordSize);
-    return buffer;
   }
 
   template <class FnT> void ForEachRecord(FnT && fn) const
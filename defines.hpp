@@ -28,10 +28,12 @@
 #define TRIANGLE_FILE_TAG "trg"
 #define INDEX_FILE_TAG "idx"
 #define SEARCH_INDEX_FILE_TAG "sdx"
+#define SEARCH_PREFIXES_FILE_TAG "sdx_prefixes"
 
 // Feature -> Street, do not rename for compatibility.
 #define FEATURE2STREET_FILE_TAG "addr"
 #define FEATURE2PLACE_FILE_TAG "ft2place"
+#define ADDRESS_POINTS_FILE_TAG "addr_points"
 
 #define POSTCODE_POINTS_FILE_TAG "postcode_points"
 #define POSTCODES_FILE_TAG "postcodes"
@@ -59,6 +61,7 @@
 #define DESCRIPTIONS_FILE_TAG "descriptions"
 #define MAXSPEEDS_FILE_TAG "maxspeeds"
 #define ROUTING_WORLD_FILE_TAG "routing_world"
+#define CROSS_MWM_OVERLAY_FILE_TAG "cross_mwm_overlay"
 
 #define READY_FILE_EXTENSION ".ready"
 #define RESUME_FILE_EXTENSION ".resume"
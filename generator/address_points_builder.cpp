@@ -0,0 +1,69 @@
+#include "generator/address_points_builder.hpp"
+
+#include "indexer/address_points.hpp"
+#include "indexer/data_header.hpp"
+#include "indexer/feature_algo.hpp"
+#include "indexer/features_offsets_table.hpp"
+#include "indexer/features_vector.hpp"
+#include "indexer/ftypes_matcher.hpp"
+
+#include "coding/files_container.hpp"
+
+#include "base/exception.hpp"
+#include "base/logging.hpp"
+
+#include "defines.hpp"
+
+namespace indexer
+{
+bool BuildAddressPointsFromDataFile(std::string const & filename, bool forceRebuild)
+{
+  try
+  {
+    search::AddressPointsBuilder builder;
+    size_t numPoints = 0;
+
+    {
+      FilesContainerR rcont(filename);
+      if (!forceRebuild && rcont.IsExist(ADDRESS_POINTS_FILE_TAG))
+        return true;
+
+      auto const table = feature::FeaturesOffsetsTable::Load(rcont);
+      if (!table)
+      {
+        LOG(LERROR, ("Can't load offsets table from:", filename));
+        return false;
+      }
+
+      feature::DataHeader const header(rcont);
+      FeaturesVector const features(rcont, header, table.get(), nullptr);
+
+      // Keep in sync with the house numbers the reverse geocoder looks for.
+      auto const & interpolChecker = ftypes::IsAddressInterpolChecker::Instance();
+      features.ForEach([&](FeatureType & ft, uint32_t featureId)
+      {
+        if (ft.GetHouseNumber().empty() && !(interpolChecker(ft) && !ft.GetRef().empty()))
+          return;
+
+        builder.Put(featureId, feature::GetCenter(ft));
+        ++numPoints;
+      });
+    }
+
+    {
+      FilesContainerW writeContainer(filename, FileWriter::OP_WRITE_EXISTING);
+      auto writer = writeContainer.GetWriter(ADDRESS_POINTS_FILE_TAG);
+      builder.Freeze(*writer);
+    }
+
+    LOG(LINFO, ("Address points:", numPoints));
+  }
+  catch (RootException const & e)
+  {
+    LOG(LERROR, ("Failed to build address points:", e.Msg()));
+    return false;
+  }
+
+  return true;
+}
+}  // namespace indexer
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <string>
+
+namespace indexer
+{
+// Builds the address points section (spatial index of the features
+// with house numbers) and writes it to the mwm file.
+bool BuildAddressPointsFromDataFile(std::string const & filename, bool forceRebuild = false);
+}  // namespace indexer
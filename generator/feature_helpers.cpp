@@ -6,10 +6,11 @@
 #include "base/stl_helpers.hpp"
 
 #include <algorithm>
+#include <utility>
 
 namespace feature
 {
-CalculateMidPoints::CalculateMidPoints()
+CalculateMidPoints::CalculateMidPoints(SinkFn sink) : m_sink(std::move(sink))
 {
   m_minDrawableScaleFn = [](FeatureBuilder const & fb)
   {
@@ -35,7 +36,10 @@ void CalculateMidPoints::operator()(FeatureBuilder const & ft, uint64_t pos)
   if (minScale != -1)
   {
     uint64_t const order = (static_cast<uint64_t>(minScale) << 59) | (pointAsInt64 >> 5);
-    m_vec.emplace_back(order, pos);
+    if (m_sink)
+      m_sink({order, pos});
+    else
+      m_vec.emplace_back(order, pos);
   }
 }
 
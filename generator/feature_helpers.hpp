@@ -26,8 +26,10 @@ class CalculateMidPoints
 public:
   using CellAndOffset = std::pair<uint64_t, uint64_t>;
   using MinDrawableScaleFn = std::function<int (FeatureBuilder const & fb)>;
+  // Receives the points instead of the internal vector, e.g. to sort them externally.
+  using SinkFn = std::function<void(CellAndOffset const & point)>;
 
-  CalculateMidPoints();
+  explicit CalculateMidPoints(SinkFn sink = {});
 
   void operator()(FeatureBuilder const & ft, uint64_t pos);
   bool operator()(m2::PointD const & p);
@@ -44,6 +46,7 @@ private:
   size_t m_allCount = 0;
   uint8_t m_coordBits = serial::GeometryCodingParams().GetCoordBits();
   MinDrawableScaleFn m_minDrawableScaleFn;
+  SinkFn m_sink;
   std::vector<CellAndOffset> m_vec;
 };
 
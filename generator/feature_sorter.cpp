@@ -19,6 +19,7 @@
 #include "platform/mwm_version.hpp"
 #include "platform/platform.hpp"
 
+#include "coding/file_sort.hpp"
 #include "coding/files_container.hpp"
 #include "coding/point_coding.hpp"
 #include "coding/succinct_mapper.hpp"
@@ -30,6 +31,7 @@
 
 #include "defines.hpp"
 
+#include <functional>
 #include <limits>
 #include <list>
 #include <memory>
@@ -357,20 +359,43 @@ bool GenerateFinalFeatures(feature::GenerateInfo const & info, std::string const
   std::string const srcFilePath = info.GetTmpFileName(name);
   std::string const dataFilePath = info.GetTargetFileName(name);
 
+  using CellAndOffset = CalculateMidPoints::CellAndOffset;
+  using WriteFeatureFn = std::function<void(CellAndOffset const & point)>;
+
+  FileReader reader(srcFilePath);
+  // The collector needs the header which depends on all the features, so it is set
+  // after the middle points are calculated.
+  FeaturesCollector2 * collectorPtr = nullptr;
+  WriteFeatureFn writeFeature = [&reader, &collectorPtr](CellAndOffset const & point)
+  {
+    // The sorter may be finished by its destructor when writing has failed.
+    if (!collectorPtr)
+      return;
+
+    ReaderSource<FileReader> src(reader);
+    src.Skip(point.second);
+
+    FeatureBuilder fb;
+    ReadFromSourceRawFormat(src, fb);
+    (*collectorPtr)(fb);
+  };
+
+  // Sort features by their middle point. The points of big mwms don't fit into the memory, so
+  // they are sorted externally. Equal cells are ordered by offsets to keep the output stable.
+  FileSorter<CellAndOffset, WriteFeatureFn> sorter(
+      info.m_sortMemoryBytes, info.GetTmpFileName(name, DATA_FILE_EXTENSION_TMP ".sort"),
+      writeFeature, std::less<CellAndOffset>(), info.m_threadsCount, true /* compressRuns */);
+
   LOG(LINFO, ("Calculating middle points"));
   // Store cellIds for middle points.
-  CalculateMidPoints midPoints;
+  CalculateMidPoints midPoints([&sorter](CellAndOffset const & point) { sorter.Add(point); });
   ForEachFeatureRawFormat(srcFilePath, [&midPoints](FeatureBuilder const & fb, uint64_t pos)
   {
     midPoints(fb, pos);
   });
 
-  // Sort features by their middle point.
-  midPoints.Sort();
-
   // Store sorted features.
   {
-    FileReader reader(srcFilePath);
     // Fill mwm header.
     DataHeader header;
 
@@ -399,15 +424,9 @@ bool GenerateFinalFeatures(feature::GenerateInfo const & info, std::string const
       LOG(LINFO, ("Simplifying and filtering geometry for all geom levels"));
 
       FeaturesCollector2 collector(name, info, header, regionData, info.m_versionDate);
-      for (auto const & point : midPoints.GetVector())
-      {
-        ReaderSource<FileReader> src(reader);
-        src.Skip(point.second);
-
-        FeatureBuilder fb;
-        ReadFromSourceRawFormat(src, fb);
-        collector(fb);
-      }
+      collectorPtr = &collector;
+      SCOPE_GUARD(resetCollector, [&collectorPtr]() { collectorPtr = nullptr; });
+      sorter.SortAndFinish();
 
       LOG(LINFO, ("Writing features' data to", dataFilePath));
 
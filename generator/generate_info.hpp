@@ -19,13 +19,15 @@ struct GenerateInfo
   {
     Memory,
     Index,
-    File
+    File,
+    Compact
   };
 
   enum class OsmSourceType
   {
     XML,
-    O5M
+    O5M,
+    PBF
   };
 
   // Directory for .mwm.tmp files.
@@ -62,6 +64,12 @@ struct GenerateInfo
 
   uint32_t m_versionDate = 0;
 
+  // Number of threads the stages of the generator may use.
+  size_t m_threadsCount = 1;
+
+  // Memory budget of the external sorts of intermediate files, see FileSorter.
+  size_t m_sortMemoryBytes = 512 * 1024 * 1024;
+
   std::vector<std::string> m_bucketNames;
 
   bool m_createWorld = false;
@@ -80,6 +88,8 @@ struct GenerateInfo
       m_osmFileType = OsmSourceType::XML;
     else if (type == "o5m")
       m_osmFileType = OsmSourceType::O5M;
+    else if (type == "pbf")
+      m_osmFileType = OsmSourceType::PBF;
     else
       LOG(LCRITICAL, ("Unknown source type:", type));
   }
@@ -92,6 +102,8 @@ struct GenerateInfo
       m_nodeStorageType = NodeStorageType::Index;
     else if (type == "mem")
       m_nodeStorageType = NodeStorageType::Memory;
+    else if (type == "compact")
+      m_nodeStorageType = NodeStorageType::Compact;
     else
       LOG(LCRITICAL, ("Incorrect node_storage type:", type));
   }
@@ -8,15 +8,29 @@
 
 #include "testing/testing.hpp"
 
+#include "generator/generate_info.hpp"
+#include "generator/intermediate_data.hpp"
 #include "generator/intermediate_elements.hpp"
+#include "generator/osm_source.hpp"
 
+#include "platform/platform.hpp"
+#include "platform/platform_tests_support/scoped_dir.hpp"
+#include "platform/platform_tests_support/scoped_file.hpp"
+
+#include "coding/file_writer.hpp"
 #include "coding/reader.hpp"
 #include "coding/writer.hpp"
 
+#include "base/file_name_utils.hpp"
+
 #include <cstdint>
+#include <sstream>
 #include <string>
+#include <tuple>
 #include <vector>
 
+#include "defines.hpp"
+
 namespace intermediate_data_test
 {
 UNIT_TEST(Intermediate_Data_empty_way_element_save_load_test)
@@ -109,4 +123,187 @@ UNIT_TEST(Intermediate_Data_relation_element_save_load_test)
   TEST_NOT_EQUAL(e2.m_tags["key1old"], "value1old", ());
   TEST_NOT_EQUAL(e2.m_tags["key2old"], "value2old", ());
 }
+
+UNIT_TEST(Intermediate_Data_CompactPointStorage)
+{
+  using namespace generator::cache;
+  using namespace platform::tests_support;
+  using NodeStorageType = feature::GenerateInfo::NodeStorageType;
+
+  ScopedFile const file("compact_point_storage_test.dat", ScopedFile::Mode::DoNotCreate);
+
+  // Several blocks, sparse ids and coordinates of opposite signs.
+  std::vector<std::tuple<uint64_t, double, double>> points;
+  for (uint64_t i = 0; i < 1000; ++i)
+  {
+    auto const sign = i % 2 == 0 ? 1.0 : -1.0;
+    points.emplace_back(i * i * 1000 + 1, sign * 179.9999999, sign * (i % 180) + 0.1234567);
+  }
+
+  {
+    auto writer = CreatePointStorageWriter(NodeStorageType::Compact, file.GetFullPath());
+    for (auto const & [id, lat, lon] : points)
+      writer->AddPoint(id, lat, lon);
+    TEST_EQUAL(writer->GetNumProcessedPoints(), points.size(), ());
+  }
+
+  auto const reader = CreatePointStorageReader(NodeStorageType::Compact, file.GetFullPath());
+  for (auto const & [id, lat, lon] : points)
+  {
+    double readLat = 0.0;
+    double readLon = 0.0;
+    TEST(reader->GetPoint(id, readLat, readLon), (id));
+    TEST_ALMOST_EQUAL_ABS(readLat, lat, 2e-7, (id));
+    TEST_ALMOST_EQUAL_ABS(readLon, lon, 2e-7, (id));
+
+    TEST(!reader->GetPoint(id + 1, readLat, readLon), (id));
+  }
+
+  double lat = 0.0;
+  double lon = 0.0;
+  TEST(!reader->GetPoint(0, lat, lon), ());
+}
+
+uint64_t constexpr kNodesCount = 40000;
+uint64_t constexpr kNodesPerWay = 4;
+uint64_t constexpr kWaysPerRelation = 100;
+uint64_t constexpr kWaysCount = kNodesCount / kNodesPerWay;
+uint64_t constexpr kRelationsCount = kWaysCount / kWaysPerRelation;
+
+// Enough elements for several chunks of the parallel writer.
+std::string MakeOsmXml()
+{
+  std::ostringstream os;
+  os << "<osm version=\"0.6\">\n";
+  for (uint64_t id = 1; id <= kNodesCount; ++id)
+  {
+    os << "<node id=\"" << id << "\" lat=\"" << 50 + id * 1e-5 << "\" lon=\"" << 30 + id * 1e-5
+       << "\"/>\n";
+  }
+
+  for (uint64_t id = 1; id <= kWaysCount; ++id)
+  {
+    os << "<way id=\"" << id << "\">";
+    for (uint64_t i = 0; i < kNodesPerWay; ++i)
+      os << "<nd ref=\"" << (id - 1) * kNodesPerWay + i + 1 << "\"/>";
+    os << "</way>\n";
+  }
+
+  for (uint64_t id = 1; id <= kRelationsCount; ++id)
+  {
+    os << "<relation id=\"" << id << "\">";
+    os << "<member type=\"node\" ref=\"" << id << "\" role=\"label\"/>";
+    // Every way is a member of two relations.
+    for (uint64_t i = 0; i < kWaysPerRelation; ++i)
+    {
+      os << "<member type=\"way\" ref=\"" << (id - 1) * kWaysPerRelation + i + 1
+         << "\" role=\"outer\"/>";
+    }
+    os << "<member type=\"way\" ref=\"" << id << "\" role=\"inner\"/>";
+    if (id > 1)
+      os << "<member type=\"relation\" ref=\"" << id - 1 << "\" role=\"\"/>";
+    os << "<tag k=\"type\" v=\"multipolygon\"/></relation>\n";
+  }
+  os << "</osm>\n";
+  return os.str();
+}
+
+// Reads back all the data written by GenerateIntermediateData.
+std::string ReadIntermediateData(feature::GenerateInfo const & info)
+{
+  using namespace generator::cache;
+
+  IntermediateDataObjectsCache objectsCache;
+  IntermediateData data(objectsCache, info);
+  auto & reader = *data.GetCache();
+
+  std::ostringstream os;
+  for (uint64_t id = 1; id <= kNodesCount; ++id)
+  {
+    double y = 0.0;
+    double x = 0.0;
+    TEST(reader.GetNode(id, y, x), (id));
+    os << y << ' ' << x << ';';
+
+    IntermediateDataReaderInterface::ForEachRelationFn toDo = [&os](uint64_t relationId, auto &) {
+      os << relationId << ',';
+      return base::ControlFlow::Continue;
+    };
+    reader.ForEachRelationByNodeCached(id, toDo);
+  }
+
+  for (uint64_t id = 1; id <= kWaysCount; ++id)
+  {
+    WayElement way(id);
+    TEST(reader.GetWay(id, way), (id));
+    TEST_EQUAL(way.m_nodes.size(), kNodesPerWay, ());
+    for (auto const node : way.m_nodes)
+      os << node << ',';
+
+    size_t count = 0;
+    IntermediateDataReaderInterface::ForEachRelationFn toDo = [&](uint64_t relationId, auto &) {
+      os << relationId << ',';
+      ++count;
+      return base::ControlFlow::Continue;
+    };
+    reader.ForEachRelationByWayCached(id, toDo);
+    TEST_EQUAL(count, id <= kRelationsCount ? 2 : 1, (id));
+  }
+
+  for (uint64_t id = 1; id <= kRelationsCount; ++id)
+  {
+    RelationElement relation;
+    TEST(reader.GetRelation(id, relation), (id));
+    TEST_EQUAL(relation.m_ways.size(), kWaysPerRelation + 1, ());
+    os << DebugPrint(relation);
+
+    IntermediateDataReaderInterface::ForEachRelationFn toDo = [&os](uint64_t relationId, auto &) {
+      os << relationId << ',';
+      return base::ControlFlow::Continue;
+    };
+    reader.ForEachRelationByRelationCached(id, toDo);
+  }
+  return os.str();
+}
+
+UNIT_TEST(Intermediate_Data_ParallelWriting)
+{
+  using namespace platform::tests_support;
+  using NodeStorageType = feature::GenerateInfo::NodeStorageType;
+
+  std::string const kTestDir = "intermediate_data_test";
+  ScopedDir const testDir(kTestDir);
+  ScopedFile const osmFile(base::JoinPath(kTestDir, "planet" OSM_DATA_FILE_EXTENSION), MakeOsmXml());
+
+  std::string expected;
+  for (auto const type : {NodeStorageType::File, NodeStorageType::Index, NodeStorageType::Compact})
+  {
+    for (size_t const threadsCount : {1, 4})
+    {
+      ScopedDir const cacheDir(testDir, std::to_string(threadsCount));
+
+      feature::GenerateInfo info;
+      info.m_cacheDir = info.m_intermediateDir = cacheDir.GetFullPath();
+      info.m_nodeStorageType = type;
+      info.m_osmFileName = osmFile.GetFullPath();
+      info.m_osmFileType = feature::GenerateInfo::OsmSourceType::XML;
+      info.m_threadsCount = threadsCount;
+      TEST(generator::GenerateIntermediateData(info), ());
+
+      auto const data = ReadIntermediateData(info);
+      if (expected.empty())
+        expected = data;
+      else
+        TEST(data == expected, (static_cast<int>(type), threadsCount));
+
+      Platform::FilesList files;
+      Platform::GetFilesByRegExp(cacheDir.GetFullPath(), ".*", files);
+      for (auto const & file : files)
+      {
+        if (file != "." && file != "..")
+          FileWriter::DeleteFileX(base::JoinPath(cacheDir.GetFullPath(), file));
+      }
+    }
+  }
+}
 }  // namespace intermediate_data_test
@@ -0,0 +1,343 @@
+#include "testing/testing.hpp"
+
+#include "generator/generator_tests/source_data.hpp"
+#include "generator/osm_element.hpp"
+#include "generator/osm_pbf_source.hpp"
+#include "generator/osm_source.hpp"
+
+#include "coding/zlib.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace osm_pbf_source_test
+{
+using namespace generator;
+using std::map, std::string, std::vector;
+
+using Buffer = vector<uint8_t>;
+
+// Minimal protobuf writer, enough to encode test files.
+void WriteVarint(Buffer & buffer, uint64_t value)
+{
+  while (value >= 0x80)
+  {
+    buffer.push_back(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  buffer.push_back(static_cast<uint8_t>(value));
+}
+
+uint64_t ZigZag(int64_t value)
+{
+  return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+void WriteVarintField(Buffer & buffer, uint32_t field, uint64_t value)
+{
+  WriteVarint(buffer, field << 3);
+  WriteVarint(buffer, value);
+}
+
+void WriteBytesField(Buffer & buffer, uint32_t field, Buffer const & bytes)
+{
+  WriteVarint(buffer, (field << 3) | 2);
+  WriteVarint(buffer, bytes.size());
+  buffer.insert(buffer.end(), bytes.begin(), bytes.end());
+}
+
+void WriteStringField(Buffer & buffer, uint32_t field, string const & s)
+{
+  WriteBytesField(buffer, field, Buffer(s.begin(), s.end()));
+}
+
+void WritePackedField(Buffer & buffer, uint32_t field, vector<uint64_t> const & values)
+{
+  Buffer packed;
+  for (auto const v : values)
+    WriteVarint(packed, v);
+  WriteBytesField(buffer, field, packed);
+}
+
+int64_t ToFixed(double degrees) { return std::llround(degrees * 1e7); }
+
+class BlockEncoder
+{
+public:
+  explicit BlockEncoder(bool dense) : m_dense(dense) { GetString(""); }
+
+  void Add(OsmElement const & e)
+  {
+    switch (e.m_type)
+    {
+    case OsmElement::EntityType::Node:
+      if (m_dense)
+        AddDenseNode(e);
+      else
+        AddGroup(1 /* nodes */, EncodeNode(e));
+      break;
+    case OsmElement::EntityType::Way: AddGroup(3 /* ways */, EncodeWay(e)); break;
+    case OsmElement::EntityType::Relation: AddGroup(4 /* relations */, EncodeRelation(e)); break;
+    default: TEST(false, (e));
+    }
+  }
+
+  Buffer Finish()
+  {
+    FlushDense();
+
+    Buffer strings;
+    for (auto const & s : m_strings)
+      WriteStringField(strings, 1, s);
+
+    Buffer block;
+    WriteBytesField(block, 1 /* stringtable */, strings);
+    for (auto const & group : m_groups)
+      WriteBytesField(block, 2 /* primitivegroup */, group);
+    WriteVarintField(block, 17 /* granularity */, 100);
+    return block;
+  }
+
+private:
+  uint32_t GetString(string const & s)
+  {
+    auto const it = m_index.emplace(s, static_cast<uint32_t>(m_strings.size()));
+    if (it.second)
+      m_strings.push_back(s);
+    return it.first->second;
+  }
+
+  void WriteTags(Buffer & buffer, OsmElement const & e)
+  {
+    vector<uint64_t> keys;
+    vector<uint64_t> values;
+    for (auto const & tag : e.Tags())
+    {
+      keys.push_back(GetString(tag.m_key));
+      values.push_back(GetString(tag.m_value));
+    }
+    if (!keys.empty())
+    {
+      WritePackedField(buffer, 2, keys);
+      WritePackedField(buffer, 3, values);
+    }
+  }
+
+  void AddGroup(uint32_t field, Buffer const & entity)
+  {
+    FlushDense();
+    Buffer group;
+    WriteBytesField(group, field, entity);
+    m_groups.push_back(std::move(group));
+  }
+
+  Buffer EncodeNode(OsmElement const & e)
+  {
+    Buffer node;
+    WriteVarintField(node, 1, ZigZag(static_cast<int64_t>(e.m_id)));
+    WriteTags(node, e);
+    WriteVarintField(node, 8, ZigZag(ToFixed(e.m_lat)));
+    WriteVarintField(node, 9, ZigZag(ToFixed(e.m_lon)));
+    return node;
+  }
+
+  Buffer EncodeWay(OsmElement const & e)
+  {
+    Buffer way;
+    WriteVarintField(way, 1, e.m_id);
+    WriteTags(way, e);
+    vector<uint64_t> refs;
+    int64_t prev = 0;
+    for (auto const ref : e.Nodes())
+    {
+      refs.push_back(ZigZag(static_cast<int64_t>(ref) - prev));
+      prev = static_cast<int64_t>(ref);
+    }
+    WritePackedField(way, 8, refs);
+    return way;
+  }
+
+  Buffer EncodeRelation(OsmElement const & e)
+  {
+    Buffer relation;
+    WriteVarintField(relation, 1, e.m_id);
+    WriteTags(relation, e);
+    vector<uint64_t> roles;
+    vector<uint64_t> refs;
+    vector<uint64_t> types;
+    int64_t prev = 0;
+    for (auto const & member : e.Members())
+    {
+      roles.push_back(GetString(member.m_role));
+      refs.push_back(ZigZag(static_cast<int64_t>(member.m_ref) - prev));
+      prev = static_cast<int64_t>(member.m_ref);
+      switch (member.m_type)
+      {
+      case OsmElement::EntityType::Node: types.push_back(0); break;
+      case OsmElement::EntityType::Way: types.push_back(1); break;
+      default: types.push_back(2); break;
+      }
+    }
+    WritePackedField(relation, 8, roles);
+    WritePackedField(relation, 9, refs);
+    WritePackedField(relation, 10, types);
+    return relation;
+  }
+
+  void AddDenseNode(OsmElement const & e)
+  {
+    auto const id = static_cast<int64_t>(e.m_id);
+    m_denseIds.push_back(ZigZag(id - m_prevId));
+    m_denseLats.push_back(ZigZag(ToFixed(e.m_lat) - m_prevLat));
+    m_denseLons.push_back(ZigZag(ToFixed(e.m_lon) - m_prevLon));
+    m_prevId = id;
+    m_prevLat = ToFixed(e.m_lat);
+    m_prevLon = ToFixed(e.m_lon);
+
+    for (auto const & tag : e.Tags())
+    {
+      m_denseKeysValues.push_back(GetString(tag.m_key));
+      m_denseKeysValues.push_back(GetString(tag.m_value));
+    }
+    m_denseKeysValues.push_back(0);
+  }
+
+  void FlushDense()
+  {
+    if (m_denseIds.empty())
+      return;
+
+    Buffer dense;
+    WritePackedField(dense, 1, m_denseIds);
+    WritePackedField(dense, 8, m_denseLats);
+    WritePackedField(dense, 9, m_denseLons);
+    WritePackedField(dense, 10, m_denseKeysValues);
+
+    Buffer group;
+    WriteBytesField(group, 2 /* dense */, dense);
+    m_groups.push_back(std::move(group));
+
+    m_denseIds.clear();
+    m_denseLats.clear();
+    m_denseLons.clear();
+    m_denseKeysValues.clear();
+    m_prevId = m_prevLat = m_prevLon = 0;
+  }
+
+  bool const m_dense;
+  vector<string> m_strings;
+  map<string, uint32_t> m_index;
+  vector<Buffer> m_groups;
+
+  vector<uint64_t> m_denseIds;
+  vector<uint64_t> m_denseLats;
+  vector<uint64_t> m_denseLons;
+  vector<uint64_t> m_denseKeysValues;
+  int64_t m_prevId = 0;
+  int64_t m_prevLat = 0;
+  int64_t m_prevLon = 0;
+};
+
+void WriteFileBlock(string & file, string const & type, Buffer const & data, bool compress)
+{
+  Buffer blob;
+  if (compress)
+  {
+    Buffer compressed;
+    coding::ZLib::Deflate const deflate(coding::ZLib::Deflate::Format::ZLib,
+                                        coding::ZLib::Deflate::Level::BestSpeed);
+    TEST(deflate(data.data(), data.size(), std::back_inserter(compressed)), ());
+    WriteVarintField(blob, 2 /* raw_size */, data.size());
+    WriteBytesField(blob, 3 /* zlib_data */, compressed);
+  }
+  else
+  {
+    WriteBytesField(blob, 1 /* raw */, data);
+  }
+
+  Buffer header;
+  WriteStringField(header, 1 /* type */, type);
+  WriteVarintField(header, 3 /* datasize */, blob.size());
+
+  auto const size = static_cast<uint32_t>(header.size());
+  file.push_back(static_cast<char>(size >> 24));
+  file.push_back(static_cast<char>(size >> 16));
+  file.push_back(static_cast<char>(size >> 8));
+  file.push_back(static_cast<char>(size));
+  file.append(header.begin(), header.end());
+  file.append(blob.begin(), blob.end());
+}
+
+string EncodePbf(vector<OsmElement> const & elements, size_t elementsPerBlock, bool dense,
+                 bool compress)
+{
+  string file;
+
+  Buffer header;
+  WriteStringField(header, 4 /* required_features */, "OsmSchema-V0.6");
+  WriteStringField(header, 4 /* required_features */, "DenseNodes");
+  WriteFileBlock(file, pbf::kHeaderBlockType, header, compress);
+
+  for (size_t i = 0; i < elements.size(); i += elementsPerBlock)
+  {
+    BlockEncoder encoder(dense);
+    for (size_t j = i; j < std::min(i + elementsPerBlock, elements.size()); ++j)
+      encoder.Add(elements[j]);
+    WriteFileBlock(file, pbf::kDataBlockType, encoder.Finish(), compress);
+  }
+  return file;
+}
+
+vector<OsmElement> ReadXml(char const * data)
+{
+  std::istringstream ss(data);
+  SourceReader reader(ss);
+  vector<OsmElement> elements;
+  ProcessOsmElementsFromXML(reader, [&elements](OsmElement && e) { elements.push_back(std::move(e)); });
+  return elements;
+}
+
+vector<OsmElement> ReadPbf(string const & data, size_t threadsCount)
+{
+  std::istringstream ss(data);
+  SourceReader reader(ss);
+  vector<OsmElement> elements;
+  ProcessOsmElementsFromPbf(reader, [&elements](OsmElement && e) { elements.push_back(std::move(e)); },
+                            threadsCount);
+  return elements;
+}
+
+UNIT_TEST(OSM_PBF_Source_EquivalenceWithXml)
+{
+  auto const xmlElements = ReadXml(relation_xml_data);
+  TEST_EQUAL(xmlElements.size(), 11, ());
+
+  for (bool const dense : {false, true})
+  {
+    for (bool const compress : {false, true})
+    {
+      for (size_t const elementsPerBlock : {1, 4, 100})
+      {
+        auto const file = EncodePbf(xmlElements, elementsPerBlock, dense, compress);
+        for (size_t const threadsCount : {1, 4})
+        {
+          auto const pbfElements = ReadPbf(file, threadsCount);
+          TEST_EQUAL(pbfElements, xmlElements, (dense, compress, elementsPerBlock, threadsCount));
+        }
+      }
+    }
+  }
+}
+
+UNIT_TEST(OSM_PBF_Source_Empty)
+{
+  TEST(ReadPbf("", 2 /* threadsCount */).empty(), ());
+  TEST(ReadPbf(EncodePbf({}, 1 /* elementsPerBlock */, true /* dense */, true /* compress */),
+               2 /* threadsCount */).empty(), ());
+}
+}  // namespace osm_pbf_source_test
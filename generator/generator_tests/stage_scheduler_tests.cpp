@@ -0,0 +1,169 @@
+#include "testing/testing.hpp"
+
+#include "generator/stage_scheduler.hpp"
+
+#include "base/exception.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace stage_scheduler_tests
+{
+using generator::StageScheduler;
+using std::string, std::vector;
+
+UNIT_TEST(StageScheduler_Dependencies)
+{
+  size_t constexpr kMwmsCount = 20;
+  vector<string> const kStages = {"geometry", "index", "search_index", "routing"};
+
+  std::mutex mutex;
+  vector<vector<string>> done(kMwmsCount);
+
+  StageScheduler scheduler(4 /* threadsCount */);
+  vector<StageScheduler::TaskId> lastTasks;
+  for (size_t mwm = 0; mwm < kMwmsCount; ++mwm)
+  {
+    vector<StageScheduler::TaskId> dependencies;
+    for (auto const & stage : kStages)
+    {
+      auto const id = scheduler.AddTask(stage, [&, mwm, stage]() {
+        std::lock_guard lock(mutex);
+        done[mwm].push_back(stage);
+        return true;
+      }, dependencies);
+      dependencies = {id};
+    }
+    lastTasks.push_back(dependencies.back());
+  }
+
+  std::atomic<size_t> finishedMwms = 0;
+  scheduler.AddTask("overlay", [&]() {
+    std::lock_guard lock(mutex);
+    for (auto const & stages : done)
+      finishedMwms += stages.size() == kStages.size() ? 1 : 0;
+    return true;
+  }, lastTasks);
+
+  TEST(scheduler.Run(), ());
+  for (auto const & stages : done)
+    TEST_EQUAL(stages, kStages, ());
+  TEST_EQUAL(finishedMwms, kMwmsCount, ());
+
+  auto const stats = scheduler.GetStats();
+  TEST_EQUAL(stats.size(), kStages.size() + 1, ());
+  for (size_t i = 0; i < kStages.size(); ++i)
+  {
+    TEST_EQUAL(stats[i].m_stage, kStages[i], ());
+    TEST_EQUAL(stats[i].m_tasksCount, kMwmsCount, ());
+  }
+  TEST_EQUAL(stats.back().m_stage, "overlay", ());
+  TEST_EQUAL(stats.back().m_tasksCount, 1, ());
+}
+
+UNIT_TEST(StageScheduler_Parallel)
+{
+  size_t constexpr kThreadsCount = 4;
+
+  std::atomic<size_t> running = 0;
+  std::atomic<size_t> maxRunning = 0;
+  StageScheduler scheduler(kThreadsCount);
+  for (size_t i = 0; i < 4 * kThreadsCount; ++i)
+  {
+    scheduler.AddTask("stage", [&]() {
+      auto const current = ++running;
+      auto prev = maxRunning.load();
+      while (prev < current && !maxRunning.compare_exchange_weak(prev, current))
+        ;
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      --running;
+      return true;
+    });
+  }
+
+  TEST(scheduler.Run(), ());
+  TEST_GREATER(maxRunning, 1, ());
+  TEST_LESS_OR_EQUAL(maxRunning, kThreadsCount, ());
+
+  auto const stats = scheduler.GetStats();
+  TEST_EQUAL(stats.size(), 1, ());
+  // Tasks ran in parallel.
+  TEST_LESS(stats[0].m_wallSeconds, stats[0].m_totalSeconds, ());
+}
+
+UNIT_TEST(StageScheduler_QueuedTasksTime)
+{
+  StageScheduler scheduler(1 /* threadsCount */);
+  for (size_t i = 0; i < 4; ++i)
+  {
+    scheduler.AddTask("stage", []() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      return true;
+    });
+  }
+
+  TEST(scheduler.Run(), ());
+
+  auto const stats = scheduler.GetStats();
+  TEST_EQUAL(stats.size(), 1, ());
+  // Tasks ran one by one, the time they waited for the thread is not counted.
+  TEST_LESS_OR_EQUAL(stats[0].m_totalSeconds, stats[0].m_wallSeconds + 1e-6, ());
+}
+
+UNIT_TEST(StageScheduler_Failure)
+{
+  std::atomic<size_t> runCount = 0;
+  auto const ok = [&runCount]() {
+    ++runCount;
+    return true;
+  };
+
+  StageScheduler scheduler(2 /* threadsCount */);
+  auto const a = scheduler.AddTask("a", ok);
+  auto const failed = scheduler.AddTask("failed", [&runCount]() {
+    ++runCount;
+    return false;
+  }, {a});
+  auto const skipped = scheduler.AddTask("skipped", ok, {failed});
+  scheduler.AddTask("skipped", ok, {skipped, a});
+  scheduler.AddTask("independent", ok, {a});
+  // Is run after the failed task.
+  scheduler.AddTask("waiting", ok, {a}, {failed, skipped});
+
+  TEST(!scheduler.Run(), ());
+  TEST_EQUAL(runCount, 4, ());
+
+  auto const stats = scheduler.GetStats();
+  TEST_EQUAL(stats.size(), 5, ());
+  TEST_EQUAL(stats[2].m_stage, "skipped", ());
+  TEST_EQUAL(stats[2].m_tasksCount, 0, ());
+}
+
+UNIT_TEST(StageScheduler_Exception)
+{
+  std::atomic<bool> dependentRun = false;
+  std::atomic<bool> independentRun = false;
+
+  StageScheduler scheduler(2 /* threadsCount */);
+  auto const throwing = scheduler.AddTask("throwing", []() -> bool {
+    MYTHROW(RootException, ("Stage error"));
+  });
+  scheduler.AddTask("dependent", [&]() { return dependentRun = true; }, {throwing});
+  scheduler.AddTask("independent", [&]() { return independentRun = true; });
+
+  TEST_ANY_THROW(scheduler.Run(), ());
+  TEST(!dependentRun, ());
+  TEST(independentRun, ());
+}
+
+UNIT_TEST(StageScheduler_Empty)
+{
+  StageScheduler scheduler(1 /* threadsCount */);
+  TEST(scheduler.Run(), ());
+  TEST(scheduler.GetStats().empty(), ());
+}
+}  // namespace stage_scheduler_tests
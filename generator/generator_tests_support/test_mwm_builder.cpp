@@ -1,5 +1,6 @@
 #include "generator/generator_tests_support/test_mwm_builder.hpp"
 
+#include "generator/address_points_builder.hpp"
 #include "generator/centers_table_builder.hpp"
 #include "generator/cities_ids_builder.hpp"
 #include "generator/feature_builder.hpp"
@@ -190,6 +191,9 @@ void TestMwmBuilder::Finish()
   CHECK(indexer::BuildCentersTableFromDataFile(path, true /* forceRebuild */),
         ("Can't build centers table."));
 
+  CHECK(indexer::BuildAddressPointsFromDataFile(path, true /* forceRebuild */),
+        ("Can't build address points."));
+
   CHECK(search::SearchRankTableBuilder::CreateIfNotExists(path), ());
 
   if (!m_languages.empty())
@@ -1,3 +1,4 @@
+#include "generator/address_points_builder.hpp"
 #include "generator/altitude_generator.hpp"
 #include "generator/borders.hpp"
 #include "generator/camera_info_collector.hpp"
@@ -25,6 +26,7 @@
 #include "generator/routing_index_generator.hpp"
 #include "generator/routing_world_roads_generator.hpp"
 #include "generator/search_index_builder.hpp"
+#include "generator/stage_scheduler.hpp"
 #include "generator/statistics.hpp"
 #include "generator/traffic_generator.hpp"
 #include "generator/transit_generator.hpp"
@@ -55,11 +57,15 @@
 
 #include "defines.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <csignal>
 #include <cstdlib>
 #include <fstream>
 #include <memory>
+#include <optional>
 #include <string>
+#include <vector>
 
 #include <gflags/gflags.h>
 
@@ -85,7 +91,7 @@ DEFINE_bool(emit_coasts, false,
 
 // Generator settings and paths.
 DEFINE_string(osm_file_name, "", "Input osm area file.");
-DEFINE_string(osm_file_type, "xml", "Input osm area file type [xml, o5m].");
+DEFINE_string(osm_file_type, "xml", "Input osm area file type [xml, o5m, pbf].");
 DEFINE_string(data_path, "", GetDataPathHelp());
 DEFINE_string(user_resource_path, "", "User defined resource path for classificator.txt and etc.");
 DEFINE_string(intermediate_data_path, "", "Path to stored intermediate data.");
@@ -95,7 +101,8 @@ DEFINE_string(cache_path, "",
 DEFINE_string(output, "", "File name for process (without 'mwm' ext).");
 DEFINE_bool(preload_cache, false, "Preload all ways and relations cache.");
 DEFINE_string(node_storage, "map",
-              "Type of storage for intermediate points representation. Available: raw, map, mem.");
+              "Type of storage for intermediate points representation. Available: raw, map, mem, "
+              "compact (requires nodes sorted by id).");
 DEFINE_uint64(planet_version, base::SecondsSinceEpoch(),
               "Version as seconds since epoch, by default - now.");
 
@@ -128,6 +135,9 @@ DEFINE_string(isolines_path, "",
 DEFINE_bool(make_routing_index, false, "Make sections with the routing information.");
 DEFINE_bool(make_cross_mwm, false,
             "Make section for cross mwm routing (for dynamic indexed routing).");
+DEFINE_bool(make_cross_mwm_overlay, false,
+            "Make section in World.mwm with shortcuts through countries for cross mwm routing. "
+            "Cross mwm sections of all the country mwms should be built before.");
 DEFINE_bool(make_transit_cross_mwm, false, "Make section for cross mwm transit routing.");
 DEFINE_bool(make_transit_cross_mwm_experimental, false,
             "Experimental parameter. If set the new version of transit cross-mwm section will be "
@@ -197,6 +207,8 @@ DEFINE_bool(dump_mwm_tmp, false, "Prints feature builder objects from .mwm.tmp")
 // Common.
 DEFINE_uint64(threads_count, 0, "Desired count of threads. If count equals zero, count of "
                                 "threads is set automatically.");
+DEFINE_uint64(sort_memory_mb, 512, "Memory budget in megabytes of the external sorts of "
+                                   "intermediate files. It is shared by the mwms built at once.");
 DEFINE_bool(verbose, false, "Provide more detailed output.");
 
 MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
@@ -264,6 +276,8 @@ MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
   genInfo.m_idToWikidataFilename = FLAGS_idToWikidata;
   genInfo.m_complexHierarchyFilename = FLAGS_complex_hierarchy_data;
   genInfo.m_isolinesDir = FLAGS_isolines_path;
+  genInfo.m_threadsCount = threadsCount;
+  genInfo.m_sortMemoryBytes = static_cast<size_t>(FLAGS_sort_memory_mb) * 1024 * 1024;
 
   // Use merged style.
   GetStyleReader().SetCurrentStyle(MapStyleMerged);
@@ -306,9 +320,9 @@ MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
 
   // Load mwm tree only if we need it
   std::unique_ptr<storage::CountryParentGetter> countryParentGetter;
-  if (FLAGS_make_routing_index || FLAGS_make_cross_mwm || FLAGS_make_transit_cross_mwm ||
-      FLAGS_make_transit_cross_mwm_experimental || !FLAGS_uk_postcodes_dataset.empty() ||
-      !FLAGS_us_postcodes_dataset.empty())
+  if (FLAGS_make_routing_index || FLAGS_make_cross_mwm || FLAGS_make_cross_mwm_overlay ||
+      FLAGS_make_transit_cross_mwm || FLAGS_make_transit_cross_mwm_experimental ||
+      !FLAGS_uk_postcodes_dataset.empty() || !FLAGS_us_postcodes_dataset.empty())
   {
     countryParentGetter = std::make_unique<storage::CountryParentGetter>();
   }
@@ -328,264 +342,376 @@ MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
     }
   }
 
-  // Enumerate over all features files that were created.
+  // Sections of an mwm are written to the same file, so stages of an mwm are run one after another,
+  // while different mwms are processed in parallel.
   size_t const count = genInfo.m_bucketNames.size();
-  for (size_t i = 0; i < count; ++i)
+  bool const needCountryParentGetter =
+      FLAGS_make_routing_index || FLAGS_make_cross_mwm || FLAGS_make_transit_cross_mwm ||
+      FLAGS_make_transit_cross_mwm_experimental ||
+      (FLAGS_generate_search_index &&
+       (!FLAGS_uk_postcodes_dataset.empty() || !FLAGS_us_postcodes_dataset.empty()));
+  if (count != 0 && needCountryParentGetter && !countryParentGetter)
+  {
+    // All the mwms should use proper VehicleModels.
+    LOG(LCRITICAL,
+        ("Countries file is needed. Please set countries file name (countries.txt). "
+         "File must be located in data directory."));
+    return EXIT_FAILURE;
+  }
+
+  size_t const mwmsThreadsCount = std::max<size_t>(1, std::min<size_t>(threadsCount, count));
+  // Search index of an mwm is built on the threads which are not used by the other mwms.
+  size_t const searchIndexThreadsCount = std::max<size_t>(1, threadsCount / mwmsThreadsCount);
+
+  // Features of an mwm are sorted with its share of the threads and memory.
+  feature::GenerateInfo mwmGenInfo = genInfo;
+  mwmGenInfo.m_threadsCount = searchIndexThreadsCount;
+  mwmGenInfo.m_sortMemoryBytes = genInfo.m_sortMemoryBytes / mwmsThreadsCount;
+
+  using TaskId = StageScheduler::TaskId;
+  StageScheduler scheduler(mwmsThreadsCount);
+  std::atomic<bool> failed = false;
+
+  // World is scheduled last as its cross mwm overlay is built from the other mwms.
+  auto buckets = genInfo.m_bucketNames;
+  std::stable_partition(buckets.begin(), buckets.end(),
+                        [](string const & country) { return country != WORLD_FILE_NAME; });
+  std::vector<TaskId> countriesTasks;
+
+  // Enumerate over all features files that were created.
+  for (string const & country : buckets)
   {
-    string const & country = genInfo.m_bucketNames[i];
     string const dataFile = genInfo.GetTargetFileName(country, DATA_FILE_EXTENSION);
     string const osmToFeatureFilename = dataFile + OSM2FEATURE_FILE_EXTENSION;
 
+    // A stage is skipped if the previous stage of the mwm returns false.
+    std::optional<TaskId> lastTask;
+    auto const addStage = [&](string const & stage, StageScheduler::Task && task,
+                              std::vector<TaskId> const & waitFor = {}) {
+      std::vector<TaskId> dependencies;
+      if (lastTask)
+        dependencies.push_back(*lastTask);
+      lastTask = scheduler.AddTask(stage, std::move(task), dependencies, waitFor);
+    };
+
     if (FLAGS_generate_geometry)
     {
-      using MapType = feature::DataHeader::MapType;
+      addStage("geometry", [&, country, dataFile, osmToFeatureFilename]() {
+        using MapType = feature::DataHeader::MapType;
 
-      MapType mapType = MapType::Country;
-      if (country == WORLD_FILE_NAME)
-        mapType = MapType::World;
-      if (country == WORLD_COASTS_FILE_NAME)
-        mapType = MapType::WorldCoasts;
+        MapType mapType = MapType::Country;
+        if (country == WORLD_FILE_NAME)
+          mapType = MapType::World;
+        if (country == WORLD_COASTS_FILE_NAME)
+          mapType = MapType::WorldCoasts;
 
-      // On error move to the next bucket without index generation.
+        // On error move to the next bucket without index generation.
 
-      LOG(LINFO, ("Generating result features for", country));
-      if (!feature::GenerateFinalFeatures(genInfo, country, mapType))
-        continue;
+        LOG(LINFO, ("Generating result features for", country));
+        if (!feature::GenerateFinalFeatures(mwmGenInfo, country, mapType))
+          return false;
 
-      LOG(LINFO, ("Generating offsets table for", dataFile));
-      if (!feature::BuildOffsetsTable(dataFile))
-        continue;
+        LOG(LINFO, ("Generating offsets table for", dataFile));
+        if (!feature::BuildOffsetsTable(dataFile))
+          return false;
 
-      if (mapType == MapType::Country)
-      {
-        string const metalinesFilename = genInfo.GetIntermediateFileName(METALINES_FILENAME);
+        if (mapType == MapType::Country)
+        {
+          string const metalinesFilename = genInfo.GetIntermediateFileName(METALINES_FILENAME);
 
-        LOG(LINFO, ("Processing metalines from", metalinesFilename));
-        if (!feature::WriteMetalinesSection(dataFile, metalinesFilename, osmToFeatureFilename))
-          LOG(LCRITICAL, ("Error generating metalines section."));
-      }
+          LOG(LINFO, ("Processing metalines from", metalinesFilename));
+          if (!feature::WriteMetalinesSection(dataFile, metalinesFilename, osmToFeatureFilename))
+            LOG(LCRITICAL, ("Error generating metalines section."));
+        }
+        return true;
+      });
     }
 
     if (FLAGS_generate_index)
     {
-      LOG(LINFO, ("Generating index for", dataFile));
+      addStage("index", [country, dataFile]() {
+        LOG(LINFO, ("Generating index for", dataFile));
 
-      if (!indexer::BuildIndexFromDataFile(dataFile, FLAGS_intermediate_data_path + country))
-        LOG(LCRITICAL, ("Error generating index."));
+        if (!indexer::BuildIndexFromDataFile(dataFile, FLAGS_intermediate_data_path + country))
+          LOG(LCRITICAL, ("Error generating index."));
+        return true;
+      });
     }
 
     if (FLAGS_generate_search_index)
     {
-      LOG(LINFO, ("Generating search index for", dataFile));
+      addStage("search_index", [&, country, dataFile]() {
+        LOG(LINFO, ("Generating search index for", dataFile));
 
-      /// @todo Make threads count according to environment (single mwm build or planet build).
-      if (!indexer::BuildSearchIndexFromDataFile(country, genInfo, true /* forceRebuild */,
-                                                 threadsCount))
-      {
-        LOG(LCRITICAL, ("Error generating search index."));
-      }
-
-      if (!FLAGS_uk_postcodes_dataset.empty() || !FLAGS_us_postcodes_dataset.empty())
-      {
-        if (!countryParentGetter)
+        if (!indexer::BuildSearchIndexFromDataFile(country, genInfo, true /* forceRebuild */,
+                                                   searchIndexThreadsCount))
         {
-          LOG(LCRITICAL,
-              ("Countries file is needed. Please set countries file name (countries.txt). "
-               "File must be located in data directory."));
-          return EXIT_FAILURE;
+          LOG(LCRITICAL, ("Error generating search index."));
         }
+        return true;
+      });
 
-        auto const topmostCountry = (*countryParentGetter)(country);
-        bool res = true;
-        if (topmostCountry == "United Kingdom" && !FLAGS_uk_postcodes_dataset.empty())
-        {
-          res = indexer::BuildPostcodePoints(path, country, indexer::PostcodePointsDatasetType::UK,
-                                             FLAGS_uk_postcodes_dataset, true /*forceRebuild*/);
-        }
-        else if (topmostCountry == "United States of America" &&
-                 !FLAGS_us_postcodes_dataset.empty())
-        {
-          res = indexer::BuildPostcodePoints(path, country, indexer::PostcodePointsDatasetType::US,
-                                             FLAGS_us_postcodes_dataset, true /*forceRebuild*/);
-        }
-
-        if (!res)
-          LOG(LCRITICAL, ("Error generating postcodes section for", country));
+      if (!FLAGS_uk_postcodes_dataset.empty() || !FLAGS_us_postcodes_dataset.empty())
+      {
+        addStage("postcodes", [&, country]() {
+          auto const topmostCountry = (*countryParentGetter)(country);
+          bool res = true;
+          if (topmostCountry == "United Kingdom" && !FLAGS_uk_postcodes_dataset.empty())
+          {
+            res = indexer::BuildPostcodePoints(path, country, indexer::PostcodePointsDatasetType::UK,
+                                               FLAGS_uk_postcodes_dataset, true /*forceRebuild*/);
+          }
+          else if (topmostCountry == "United States of America" &&
+                   !FLAGS_us_postcodes_dataset.empty())
+          {
+            res = indexer::BuildPostcodePoints(path, country, indexer::PostcodePointsDatasetType::US,
+                                               FLAGS_us_postcodes_dataset, true /*forceRebuild*/);
+          }
+
+          if (!res)
+            LOG(LCRITICAL, ("Error generating postcodes section for", country));
+          return true;
+        });
       }
 
-      LOG(LINFO, ("Generating rank table for", dataFile));
-      if (!search::SearchRankTableBuilder::CreateIfNotExists(dataFile))
-        LOG(LCRITICAL, ("Error generating rank table."));
-
-      LOG(LINFO, ("Generating centers table for", dataFile));
-      if (!indexer::BuildCentersTableFromDataFile(dataFile, true /* forceRebuild */))
-        LOG(LCRITICAL, ("Error generating centers table."));
+      addStage("rank_table", [dataFile]() {
+        LOG(LINFO, ("Generating rank table for", dataFile));
+        if (!search::SearchRankTableBuilder::CreateIfNotExists(dataFile))
+          LOG(LCRITICAL, ("Error generating rank table."));
+        return true;
+      });
+
+      addStage("centers_table", [dataFile]() {
+        LOG(LINFO, ("Generating centers table for", dataFile));
+        if (!indexer::BuildCentersTableFromDataFile(dataFile, true /* forceRebuild */))
+          LOG(LCRITICAL, ("Error generating centers table."));
+        return true;
+      });
+
+      addStage("address_points", [dataFile]() {
+        LOG(LINFO, ("Generating address points for", dataFile));
+        if (!indexer::BuildAddressPointsFromDataFile(dataFile, true /* forceRebuild */))
+          LOG(LCRITICAL, ("Error generating address points."));
+        return true;
+      });
     }
 
     if (FLAGS_generate_cities_boundaries)
     {
       CHECK(!FLAGS_cities_boundaries_data.empty(), ());
-      LOG(LINFO, ("Generating cities boundaries for", dataFile));
-      generator::OsmIdToBoundariesTable table;
-      if (!generator::DeserializeBoundariesTable(FLAGS_cities_boundaries_data, table))
-        LOG(LCRITICAL, ("Error deserializing boundaries table"));
-      if (!generator::BuildCitiesBoundaries(dataFile, table))
-        LOG(LCRITICAL, ("Error generating cities boundaries."));
+      addStage("cities_boundaries", [dataFile]() {
+        LOG(LINFO, ("Generating cities boundaries for", dataFile));
+        generator::OsmIdToBoundariesTable table;
+        if (!generator::DeserializeBoundariesTable(FLAGS_cities_boundaries_data, table))
+          LOG(LCRITICAL, ("Error deserializing boundaries table"));
+        if (!generator::BuildCitiesBoundaries(dataFile, table))
+          LOG(LCRITICAL, ("Error generating cities boundaries."));
+        return true;
+      });
     }
 
     if (FLAGS_generate_cities_ids)
     {
-      LOG(LINFO, ("Generating cities ids for", dataFile));
-      if (!generator::BuildCitiesIds(dataFile, osmToFeatureFilename))
-        LOG(LCRITICAL, ("Error generating cities ids."));
+      addStage("cities_ids", [dataFile, osmToFeatureFilename]() {
+        LOG(LINFO, ("Generating cities ids for", dataFile));
+        if (!generator::BuildCitiesIds(dataFile, osmToFeatureFilename))
+          LOG(LCRITICAL, ("Error generating cities ids."));
+        return true;
+      });
     }
 
     if (!FLAGS_srtm_path.empty())
-      routing::BuildRoadAltitudes(dataFile, FLAGS_srtm_path);
+    {
+      addStage("altitudes", [dataFile]() {
+        routing::BuildRoadAltitudes(dataFile, FLAGS_srtm_path);
+        return true;
+      });
+    }
 
-    transit::experimental::EdgeIdToFeatureId transitEdgeFeatureIds;
+    // Is filled by the transit stage and is used by the transit cross mwm stage.
+    auto const transitEdgeFeatureIds =
+        std::make_shared<transit::experimental::EdgeIdToFeatureId>();
 
     if (!FLAGS_transit_path_experimental.empty())
     {
-      transitEdgeFeatureIds = transit::experimental::BuildTransit(
-          path, country, osmToFeatureFilename, FLAGS_transit_path_experimental);
+      addStage("transit", [&, country, osmToFeatureFilename, transitEdgeFeatureIds]() {
+        *transitEdgeFeatureIds = transit::experimental::BuildTransit(
+            path, country, osmToFeatureFilename, FLAGS_transit_path_experimental);
+        return true;
+      });
     }
     else if (!FLAGS_transit_path.empty())
     {
-      routing::transit::BuildTransit(path, country, osmToFeatureFilename, FLAGS_transit_path);
+      addStage("transit", [&, country, osmToFeatureFilename]() {
+        routing::transit::BuildTransit(path, country, osmToFeatureFilename, FLAGS_transit_path);
+        return true;
+      });
     }
 
     if (FLAGS_generate_cameras)
     {
-//      if (routing::AreSpeedCamerasProhibited(platform::CountryFile(country)))
-//      {
-//        LOG(LINFO,
-//            ("Cameras info is prohibited for", country, "and speedcams section is not generated."));
-//      }
-//      else
-//      {
-        string const camerasFilename = genInfo.GetIntermediateFileName(CAMERAS_TO_WAYS_FILENAME);
-
-        BuildCamerasInfo(dataFile, camerasFilename, osmToFeatureFilename);
-//      }
+      addStage("cameras", [&, dataFile, osmToFeatureFilename]() {
+//        if (routing::AreSpeedCamerasProhibited(platform::CountryFile(country)))
+//        {
+//          LOG(LINFO,
+//              ("Cameras info is prohibited for", country, "and speedcams section is not generated."));
+//        }
+//        else
+//        {
+          string const camerasFilename = genInfo.GetIntermediateFileName(CAMERAS_TO_WAYS_FILENAME);
+
+          BuildCamerasInfo(dataFile, camerasFilename, osmToFeatureFilename);
+//        }
+        return true;
+      });
     }
 
     if (country == WORLD_FILE_NAME && !FLAGS_world_roads_path.empty())
     {
-      LOG(LINFO, ("Generating routing section for World."));
-      if (!routing::BuildWorldRoads(dataFile, FLAGS_world_roads_path))
-      {
-        LOG(LCRITICAL, ("Generating routing section for World has failed."));
-        return EXIT_FAILURE;
-      }
+      addStage("world_roads", [&, dataFile]() {
+        LOG(LINFO, ("Generating routing section for World."));
+        if (!routing::BuildWorldRoads(dataFile, FLAGS_world_roads_path))
+        {
+          LOG(LCRITICAL, ("Generating routing section for World has failed."));
+          failed = true;
+          return false;
+        }
+        return true;
+      });
     }
 
     using namespace routing_builder;
 
-    if (FLAGS_make_routing_index)
+    if (country == WORLD_FILE_NAME && FLAGS_make_cross_mwm_overlay)
     {
-      if (!countryParentGetter)
-      {
-        // All the mwms should use proper VehicleModels.
-        LOG(LCRITICAL,
-            ("Countries file is needed. Please set countries file name (countries.txt). "
-             "File must be located in data directory."));
-        return EXIT_FAILURE;
-      }
+      addStage("cross_mwm_overlay", [&, dataFile]() {
+        if (!BuildCrossMwmOverlaySection(path, dataFile, *countryParentGetter))
+        {
+          LOG(LCRITICAL, ("Generating cross mwm overlay section for World has failed."));
+          failed = true;
+          return false;
+        }
+        return true;
+      }, countriesTasks);
+    }
 
+    if (FLAGS_make_routing_index)
+    {
       // Order is important: city roads first, routing graph, maxspeeds then (to check inside/outside a city).
       if (FLAGS_make_city_roads)
       {
-        auto const boundariesPath = genInfo.GetIntermediateFileName(CITY_BOUNDARIES_COLLECTOR_FILENAME);
-        LOG(LINFO, ("Generating", CITY_ROADS_FILE_TAG, "for", dataFile, "using", boundariesPath));
-        if (!BuildCityRoads(dataFile, boundariesPath))
-          LOG(LCRITICAL, ("Generating city roads error."));
+        addStage("city_roads", [&, dataFile]() {
+          auto const boundariesPath = genInfo.GetIntermediateFileName(CITY_BOUNDARIES_COLLECTOR_FILENAME);
+          LOG(LINFO, ("Generating", CITY_ROADS_FILE_TAG, "for", dataFile, "using", boundariesPath));
+          if (!BuildCityRoads(dataFile, boundariesPath))
+            LOG(LCRITICAL, ("Generating city roads error."));
+          return true;
+        });
       }
 
-      string const restrictionsFilename = genInfo.GetIntermediateFileName(RESTRICTIONS_FILENAME);
-      string const roadAccessFilename = genInfo.GetIntermediateFileName(ROAD_ACCESS_FILENAME);
+      addStage("routing_index", [&, country, dataFile, osmToFeatureFilename]() {
+        string const restrictionsFilename = genInfo.GetIntermediateFileName(RESTRICTIONS_FILENAME);
+        string const roadAccessFilename = genInfo.GetIntermediateFileName(ROAD_ACCESS_FILENAME);
 
-      BuildRoutingIndex(dataFile, country, *countryParentGetter);
-      auto routingGraph = CreateIndexGraph(dataFile, country, *countryParentGetter);
-      CHECK(routingGraph, ());
+        BuildRoutingIndex(dataFile, country, *countryParentGetter);
+        auto routingGraph = CreateIndexGraph(dataFile, country, *countryParentGetter);
+        CHECK(routingGraph, ());
 
-      auto osm2feature = routing::CreateWay2FeatureMapper(dataFile, osmToFeatureFilename);
+        auto osm2feature = routing::CreateWay2FeatureMapper(dataFile, osmToFeatureFilename);
 
-      /// @todo CHECK return result doesn't work now for some small countries like Somalie.
-      if (!BuildRoadRestrictions(*routingGraph, dataFile, restrictionsFilename, osmToFeatureFilename) ||
-          !BuildRoadAccessInfo(dataFile, roadAccessFilename, *osm2feature))
-      {
-        LOG(LERROR, ("Routing build failed for", dataFile));
-      }
+        /// @todo CHECK return result doesn't work now for some small countries like Somalie.
+        if (!BuildRoadRestrictions(*routingGraph, dataFile, restrictionsFilename, osmToFeatureFilename) ||
+            !BuildRoadAccessInfo(dataFile, roadAccessFilename, *osm2feature))
+        {
+          LOG(LERROR, ("Routing build failed for", dataFile));
+        }
 
-      if (FLAGS_generate_maxspeed)
-      {
-        string const maxspeedsFilename = genInfo.GetIntermediateFileName(MAXSPEEDS_FILENAME);
-        LOG(LINFO, ("Generating maxspeeds section for", dataFile, "using", maxspeedsFilename));
-        BuildMaxspeedsSection(routingGraph.get(), dataFile, osmToFeatureFilename, maxspeedsFilename);
-      }
+        if (FLAGS_generate_maxspeed)
+        {
+          string const maxspeedsFilename = genInfo.GetIntermediateFileName(MAXSPEEDS_FILENAME);
+          LOG(LINFO, ("Generating maxspeeds section for", dataFile, "using", maxspeedsFilename));
+          BuildMaxspeedsSection(routingGraph.get(), dataFile, osmToFeatureFilename, maxspeedsFilename);
+        }
+        return true;
+      });
     }
 
     if (FLAGS_make_cross_mwm || FLAGS_make_transit_cross_mwm || FLAGS_make_transit_cross_mwm_experimental)
     {
-      if (!countryParentGetter)
-      {
-        // All the mwms should use proper VehicleModels.
-        LOG(LCRITICAL,
-            ("Countries file is needed. Please set countries file name (countries.txt). "
-             "File must be located in data directory."));
-        return EXIT_FAILURE;
-      }
-
-      if (FLAGS_make_cross_mwm)
-      {
-        BuildRoutingCrossMwmSection(path, dataFile, country, genInfo.m_intermediateDir,
-                                    *countryParentGetter, osmToFeatureFilename);
-      }
+      addStage("cross_mwm", [&, country, dataFile, osmToFeatureFilename, transitEdgeFeatureIds]() {
+        if (FLAGS_make_cross_mwm)
+        {
+          BuildRoutingCrossMwmSection(path, dataFile, country, genInfo.m_intermediateDir,
+                                      *countryParentGetter, osmToFeatureFilename);
+        }
 
-      if (FLAGS_make_transit_cross_mwm_experimental)
-      {
-        if (!transitEdgeFeatureIds.empty())
+        if (FLAGS_make_transit_cross_mwm_experimental)
+        {
+          if (!transitEdgeFeatureIds->empty())
+          {
+            BuildTransitCrossMwmSection(path, dataFile, country, *countryParentGetter,
+                                        *transitEdgeFeatureIds,
+                                        true /* experimentalTransit */);
+          }
+        }
+        else if (FLAGS_make_transit_cross_mwm)
         {
           BuildTransitCrossMwmSection(path, dataFile, country, *countryParentGetter,
-                                      transitEdgeFeatureIds,
-                                      true /* experimentalTransit */);
+                                      *transitEdgeFeatureIds,
+                                      false /* experimentalTransit */);
         }
-      }
-      else if (FLAGS_make_transit_cross_mwm)
-      {
-        BuildTransitCrossMwmSection(path, dataFile, country, *countryParentGetter,
-                                    transitEdgeFeatureIds,
-                                    false /* experimentalTransit */);
-      }
+        return true;
+      });
     }
 
     if (!FLAGS_wikipedia_pages.empty())
     {
-      // FLAGS_idToWikidata maybe empty.
-      DescriptionsSectionBuilder::CollectAndBuild(FLAGS_wikipedia_pages, dataFile, FLAGS_idToWikidata);
+      addStage("descriptions", [dataFile]() {
+        // FLAGS_idToWikidata maybe empty.
+        DescriptionsSectionBuilder::CollectAndBuild(FLAGS_wikipedia_pages, dataFile, FLAGS_idToWikidata);
+        return true;
+      });
     }
 
     // This section must be built with the same isolines file as had been used at the features stage.
     if (FLAGS_generate_isolines_info)
-      BuildIsolinesInfoSection(FLAGS_isolines_path, country, dataFile);
+    {
+      addStage("isolines_info", [country, dataFile]() {
+        BuildIsolinesInfoSection(FLAGS_isolines_path, country, dataFile);
+        return true;
+      });
+    }
 
     if (FLAGS_generate_popular_places)
     {
-      if (!BuildPopularPlacesMwmSection(genInfo.m_popularPlacesFilename, dataFile,
-                                        osmToFeatureFilename))
-      {
-        LOG(LCRITICAL, ("Error generating popular places mwm section."));
-      }
+      addStage("popular_places", [&, dataFile, osmToFeatureFilename]() {
+        if (!BuildPopularPlacesMwmSection(genInfo.m_popularPlacesFilename, dataFile,
+                                          osmToFeatureFilename))
+        {
+          LOG(LCRITICAL, ("Error generating popular places mwm section."));
+        }
+        return true;
+      });
     }
 
     if (FLAGS_generate_traffic_keys)
     {
-      if (!traffic::GenerateTrafficKeysFromDataFile(dataFile))
-        LOG(LCRITICAL, ("Error generating traffic keys."));
+      addStage("traffic_keys", [dataFile]() {
+        if (!traffic::GenerateTrafficKeysFromDataFile(dataFile))
+          LOG(LCRITICAL, ("Error generating traffic keys."));
+        return true;
+      });
     }
+
+    if (lastTask && country != WORLD_FILE_NAME)
+      countriesTasks.push_back(*lastTask);
   }
 
+  scheduler.Run();
+  scheduler.LogStats();
+  if (failed)
+    return EXIT_FAILURE;
+
   string const dataFile = base::JoinPath(path, FLAGS_output + DATA_FILE_EXTENSION);
 
   if (FLAGS_stats_general || FLAGS_stats_geometry || FLAGS_stats_types)
@@ -1,13 +1,23 @@
 #include "generator/intermediate_data.hpp"
 
-#include <new>
-#include <set>
-#include <string>
+#include "coding/byte_stream.hpp"
+#include "coding/file_sort.hpp"
+#include "coding/read_write_utils.hpp"
+#include "coding/reader.hpp"
+#include "coding/varint.hpp"
+#include "coding/write_to_sink.hpp"
 
 #include "base/assert.hpp"
 #include "base/checked_cast.hpp"
 #include "base/logging.hpp"
 
+#include <algorithm>
+#include <functional>
+#include <new>
+#include <queue>
+#include <set>
+#include <string>
+
 #include "defines.hpp"
 
 namespace generator::cache
@@ -59,13 +69,73 @@ void AddToIndex(Index & index, Key relationId, Container const & values)
     index.Add(v.first, relationId);
 }
 
+string GetShardFileName(string const & name, std::optional<size_t> shard)
+{
+  return shard ? name + "." + std::to_string(*shard) : name;
+}
+
+// Appends |parts| to |name| in the given order and removes them.
+void ConcatenateFiles(std::vector<string> const & parts, string const & name)
+{
+  FileWriter writer(name);
+  for (auto const & part : parts)
+  {
+    {
+      FileReader reader(part);
+      ReaderSource<FileReader> src(reader);
+      rw::ReadAndWrite(src, writer, 1 << 20 /* bufferSize */);
+    }
+    FileWriter::DeleteFileX(part);
+  }
+}
+
+// Merges |runs| of IndexFileWriter into a single sorted file |name|, |shifts[i]| is added to
+// the values of the i-th run. Runs are sorted externally within the budget of |info| and removed.
+void MergeIndexFiles(std::vector<string> const & runs, std::vector<uint64_t> const & shifts,
+                     string const & name, feature::GenerateInfo const & info)
+{
+  CHECK_EQUAL(runs.size(), shifts.size(), ());
+  using Element = std::pair<Key, IndexFileReader::Value>;
+  using Sink = WriterFunctor<FileWriter>;
+
+  {
+    FileWriter writer(name);
+    Sink sink(writer);
+    FileSorter<Element, Sink> sorter(info.m_sortMemoryBytes, name + ".sort", sink,
+                                     std::less<Element>(), info.m_threadsCount,
+                                     true /* compressRuns */);
+
+    std::vector<Element> elements(1 << 16);
+    for (size_t i = 0; i < runs.size(); ++i)
+    {
+      ReaderSource<FileReader> src{FileReader(runs[i])};
+      CHECK_EQUAL(0, src.Size() % sizeof(Element), ("Damaged file."));
+      while (src.Size() > 0)
+      {
+        auto const count = static_cast<size_t>(
+            std::min<uint64_t>(elements.size(), src.Size() / sizeof(Element)));
+        src.Read(elements.data(), count * sizeof(Element));
+        for (size_t j = 0; j < count; ++j)
+        {
+          elements[j].second += shifts[i];
+          sorter.Add(elements[j]);
+        }
+      }
+    }
+    sorter.SortAndFinish();
+  }
+
+  for (auto const & run : runs)
+    FileWriter::DeleteFileX(run);
+}
+
 class PointStorageWriterBase : public PointStorageWriterInterface
 {
 public:
   // PointStorageWriterInterface overrides:
   uint64_t GetNumProcessedPoints() const override { return m_numProcessedPoints; }
 
-private:
+protected:
   uint64_t m_numProcessedPoints{0};
 };
 
@@ -97,8 +167,9 @@ private:
 class RawFilePointStorageWriter : public PointStorageWriterBase
 {
 public:
-  explicit RawFilePointStorageWriter(string const & name) :
-    m_fileWriter(name)
+  explicit RawFilePointStorageWriter(string const & name,
+                                     FileWriter::Op op = FileWriter::OP_WRITE_TRUNCATE)
+    : m_fileWriter(name, op)
   {}
 
   // PointStorageWriterInterface overrides:
@@ -115,7 +186,6 @@ public:
 
 private:
   FileWriter m_fileWriter;
-  uint64_t m_numProcessedPoints = 0;
 };
 
 // RawMemPointStorageReader ------------------------------------------------------------------------
@@ -149,33 +219,43 @@ private:
 class RawMemPointStorageWriter : public PointStorageWriterBase
 {
 public:
-  explicit RawMemPointStorageWriter(string const & name) :
-    m_fileWriter(name),
-    m_data(kMaxNodesInOSM)
+  // The nodes array is shared by the shards of the storage and is written to the file
+  // when the last of them is destroyed.
+  struct Data
   {
-  }
+    explicit Data(string const & name) : m_fileWriter(name), m_data(kMaxNodesInOSM) {}
 
-  ~RawMemPointStorageWriter() noexcept(false) override
+    ~Data() noexcept(false)
+    {
+      m_fileWriter.Write(m_data.data(), m_data.size() * sizeof(LatLon));
+    }
+
+    FileWriter m_fileWriter;
+    std::vector<LatLon> m_data;
+  };
+
+  explicit RawMemPointStorageWriter(string const & name)
+    : m_data(std::make_shared<Data>(name))
   {
-    m_fileWriter.Write(m_data.data(), m_data.size() * sizeof(LatLon));
   }
 
+  explicit RawMemPointStorageWriter(std::shared_ptr<Data> data) : m_data(std::move(data)) {}
+
   // PointStorageWriterInterface overrides:
   void AddPoint(uint64_t id, double lat, double lon) override
   {
-    CHECK_LESS(id, m_data.size(),
+    auto & data = m_data->m_data;
+    CHECK_LESS(id, data.size(),
                ("Found node with id", id, "which is bigger than the allocated cache size"));
 
-    LatLon & ll = m_data[id];
+    LatLon & ll = data[id];
     ToLatLon(lat, lon, ll);
 
     ++m_numProcessedPoints;
   }
 
 private:
-  FileWriter m_fileWriter;
-  std::vector<LatLon> m_data;
-  uint64_t m_numProcessedPoints = 0;
+  std::shared_ptr<Data> m_data;
 };
 
 // MapFilePointStorageReader -----------------------------------------------------------------------
@@ -229,11 +309,35 @@ private:
 class MapFilePointStorageWriter : public PointStorageWriterBase
 {
 public:
+  // Concatenates files of the shards of the storage when the last of them is destroyed.
+  class ShardsMerger
+  {
+  public:
+    ShardsMerger(string const & name, size_t shardsCount) : m_name(name + kShortExtension)
+    {
+      for (size_t i = 0; i < shardsCount; ++i)
+        m_shards.emplace_back(GetShardFileName(m_name, i));
+    }
+
+    ~ShardsMerger() noexcept(false) { ConcatenateFiles(m_shards, m_name); }
+
+    string const & GetShardName(size_t shard) const { return m_shards[shard]; }
+
+  private:
+    string m_name;
+    std::vector<string> m_shards;
+  };
+
   explicit MapFilePointStorageWriter(string const & name) :
     m_fileWriter(name + kShortExtension)
   {
   }
 
+  MapFilePointStorageWriter(std::shared_ptr<ShardsMerger> merger, size_t shard)
+    : m_merger(std::move(merger)), m_fileWriter(m_merger->GetShardName(shard))
+  {
+  }
+
   // PointStorageWriterInterface overrides:
   void AddPoint(uint64_t id, double lat, double lon) override
   {
@@ -251,8 +355,259 @@ public:
   }
 
 private:
+  // Declared before |m_fileWriter| to merge the shards after the file is flushed.
+  std::shared_ptr<ShardsMerger> m_merger;
   FileWriter m_fileWriter;
-  uint64_t m_numProcessedPoints = 0;
+};
+
+// Compact point storage ---------------------------------------------------------------------------
+// Points are stored in blocks of up to kCompactBlockSize points sorted by id. Every point of a block
+// is encoded as varint deltas of its id and of its fixed point coordinates from the previous point.
+// Blocks are followed by the index of the blocks and by the footer.
+size_t constexpr kCompactBlockSize = 256;
+
+struct CompactBlockInfo
+{
+  uint64_t m_firstId = 0;
+  uint64_t m_offset = 0;
+};
+static_assert(sizeof(CompactBlockInfo) == 16, "Invalid structure size");
+
+struct CompactFooter
+{
+  uint64_t m_indexOffset = 0;
+  uint64_t m_blocksCount = 0;
+};
+static_assert(sizeof(CompactFooter) == 16, "Invalid structure size");
+
+template <typename Source>
+class CompactBlockDecoder
+{
+public:
+  explicit CompactBlockDecoder(Source & src) : m_src(src), m_count(ReadVarUint<uint64_t>(m_src)) {}
+
+  bool Next(uint64_t & id, LatLon & ll)
+  {
+    if (m_count == 0)
+      return false;
+    --m_count;
+
+    m_id += ReadVarUint<uint64_t>(m_src);
+    m_ll.m_lat = static_cast<int32_t>(m_ll.m_lat + ReadVarInt<int64_t>(m_src));
+    m_ll.m_lon = static_cast<int32_t>(m_ll.m_lon + ReadVarInt<int64_t>(m_src));
+    id = m_id;
+    ll = m_ll;
+    return true;
+  }
+
+private:
+  Source & m_src;
+  uint64_t m_count;
+  uint64_t m_id = 0;
+  LatLon m_ll;
+};
+
+// CompactPointStorageReader -----------------------------------------------------------------------
+class CompactPointStorageReader : public PointStorageReaderInterface
+{
+public:
+  explicit CompactPointStorageReader(string const & name)
+    : m_mmapReader(name, MmapReader::Advice::Random)
+  {
+    CHECK_GREATER_OR_EQUAL(m_mmapReader.Size(), sizeof(CompactFooter), ("Damaged file:", name));
+    CompactFooter footer;
+    m_mmapReader.Read(m_mmapReader.Size() - sizeof(footer), &footer, sizeof(footer));
+    CHECK_EQUAL(footer.m_indexOffset % alignof(CompactBlockInfo), 0, ("Damaged file:", name));
+    CHECK_EQUAL(footer.m_indexOffset + footer.m_blocksCount * sizeof(CompactBlockInfo) +
+                    sizeof(footer), m_mmapReader.Size(), ("Damaged file:", name));
+
+    m_index = reinterpret_cast<CompactBlockInfo const *>(m_mmapReader.Data() + footer.m_indexOffset);
+    m_blocksCount = footer.m_blocksCount;
+  }
+
+  // PointStorageReaderInterface overrides:
+  bool GetPoint(uint64_t id, double & lat, double & lon) const override
+  {
+    auto const it = std::upper_bound(m_index, m_index + m_blocksCount, id,
+                                     [](uint64_t id, CompactBlockInfo const & block) {
+                                       return id < block.m_firstId;
+                                     });
+    if (it == m_index)
+      return false;
+
+    ArrayByteSource src(m_mmapReader.Data() + std::prev(it)->m_offset);
+    CompactBlockDecoder<ArrayByteSource> decoder(src);
+    uint64_t currId = 0;
+    LatLon ll;
+    while (decoder.Next(currId, ll) && currId <= id)
+    {
+      if (currId != id)
+        continue;
+
+      bool ret = FromLatLon(ll, lat, lon);
+      if (!ret)
+        LOG(LERROR, ("Node with id =", id, "not found!"));
+      return ret;
+    }
+    return false;
+  }
+
+private:
+  MmapReader m_mmapReader;
+  CompactBlockInfo const * m_index = nullptr;
+  uint64_t m_blocksCount = 0;
+};
+
+// CompactPointStorageWriter -----------------------------------------------------------------------
+class CompactPointStorageWriter : public PointStorageWriterBase
+{
+public:
+  // Merges files of the shards of the storage when the last of them is destroyed.
+  // Every shard is sorted, so they are merged without loading into memory.
+  class ShardsMerger
+  {
+  public:
+    ShardsMerger(string const & name, size_t shardsCount) : m_name(name)
+    {
+      for (size_t i = 0; i < shardsCount; ++i)
+        m_shards.emplace_back(GetShardFileName(m_name, i));
+    }
+
+    ~ShardsMerger() noexcept(false)
+    {
+      using Source = ReaderSource<FileReader>;
+      using Decoder = CompactBlockDecoder<Source>;
+
+      std::vector<Source> sources;
+      std::vector<uint64_t> blocksLeft;
+      std::vector<std::unique_ptr<Decoder>> decoders(m_shards.size());
+      sources.reserve(m_shards.size());
+
+      using Item = std::pair<uint64_t, size_t>;
+      std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+      std::vector<LatLon> points(m_shards.size());
+      auto const readNext = [&](size_t i) {
+        uint64_t id = 0;
+        while (!decoders[i] || !decoders[i]->Next(id, points[i]))
+        {
+          if (blocksLeft[i] == 0)
+            return;
+          --blocksLeft[i];
+          decoders[i] = std::make_unique<Decoder>(sources[i]);
+        }
+        queue.emplace(id, i);
+      };
+
+      for (size_t i = 0; i < m_shards.size(); ++i)
+      {
+        FileReader reader(m_shards[i]);
+        CompactFooter footer;
+        reader.Read(reader.Size() - sizeof(footer), &footer, sizeof(footer));
+        blocksLeft.emplace_back(footer.m_blocksCount);
+        sources.emplace_back(reader);
+        readNext(i);
+      }
+
+      {
+        CompactPointStorageWriter writer(m_name);
+        while (!queue.empty())
+        {
+          auto const [id, i] = queue.top();
+          queue.pop();
+          writer.AddPoint(id, points[i]);
+          readNext(i);
+        }
+      }
+
+      decoders.clear();
+      sources.clear();
+      for (auto const & shard : m_shards)
+        FileWriter::DeleteFileX(shard);
+    }
+
+    string const & GetShardName(size_t shard) const { return m_shards[shard]; }
+
+  private:
+    string m_name;
+    std::vector<string> m_shards;
+  };
+
+  explicit CompactPointStorageWriter(string const & name) : m_fileWriter(name) {}
+
+  CompactPointStorageWriter(std::shared_ptr<ShardsMerger> merger, size_t shard)
+    : m_merger(std::move(merger)), m_fileWriter(m_merger->GetShardName(shard))
+  {
+  }
+
+  ~CompactPointStorageWriter() noexcept(false) override
+  {
+    FlushBlock();
+
+    // Aligns the index to read it from the mapped file.
+    auto constexpr kAlignment = alignof(CompactBlockInfo);
+    uint8_t const zeros[kAlignment] = {};
+    m_fileWriter.Write(zeros, (kAlignment - m_fileWriter.Pos() % kAlignment) % kAlignment);
+
+    CompactFooter footer;
+    footer.m_indexOffset = m_fileWriter.Pos();
+    footer.m_blocksCount = m_index.size();
+    m_fileWriter.Write(m_index.data(), m_index.size() * sizeof(CompactBlockInfo));
+    m_fileWriter.Write(&footer, sizeof(footer));
+  }
+
+  // PointStorageWriterInterface overrides:
+  void AddPoint(uint64_t id, double lat, double lon) override
+  {
+    LatLon ll;
+    ToLatLon(lat, lon, ll);
+    AddPoint(id, ll);
+  }
+
+  void AddPoint(uint64_t id, LatLon const & ll)
+  {
+    CHECK(m_numProcessedPoints == 0 || id > m_lastId,
+          ("Compact node storage requires nodes sorted by id, found", id, "after", m_lastId));
+    // Deltas of the first point of a block are taken from zeros.
+    uint64_t const prevId = m_blockSize == 0 ? 0 : m_lastId;
+    LatLon const prevLatLon = m_blockSize == 0 ? LatLon() : m_lastLatLon;
+    if (m_blockSize == 0)
+      m_index.push_back({id, m_fileWriter.Pos()});
+
+    PushBackByteSink<std::vector<uint8_t>> sink(m_block);
+    WriteVarUint(sink, id - prevId);
+    WriteVarInt(sink, int64_t{ll.m_lat} - prevLatLon.m_lat);
+    WriteVarInt(sink, int64_t{ll.m_lon} - prevLatLon.m_lon);
+    m_lastId = id;
+    m_lastLatLon = ll;
+
+    ++m_numProcessedPoints;
+    if (++m_blockSize == kCompactBlockSize)
+      FlushBlock();
+  }
+
+private:
+  void FlushBlock()
+  {
+    if (m_blockSize == 0)
+      return;
+
+    std::vector<uint8_t> header;
+    PushBackByteSink<std::vector<uint8_t>> sink(header);
+    WriteVarUint(sink, m_blockSize);
+    m_fileWriter.Write(header.data(), header.size());
+    m_fileWriter.Write(m_block.data(), m_block.size());
+    m_block.clear();
+    m_blockSize = 0;
+  }
+
+  // Declared before |m_fileWriter| to merge the shards after the file is flushed.
+  std::shared_ptr<ShardsMerger> m_merger;
+  FileWriter m_fileWriter;
+  std::vector<CompactBlockInfo> m_index;
+  std::vector<uint8_t> m_block;
+  uint64_t m_blockSize = 0;
+  uint64_t m_lastId = 0;
+  LatLon m_lastLatLon;
 };
 }  // namespace
 
@@ -386,13 +741,15 @@ IntermediateDataReader::IntermediateDataReader(
 
 // IntermediateDataWriter
 IntermediateDataWriter::IntermediateDataWriter(PointStorageWriterInterface & nodes,
-                                               feature::GenerateInfo const & info)
+                                               feature::GenerateInfo const & info,
+                                               std::optional<size_t> shard)
   : m_nodes(nodes)
-  , m_ways(info.GetCacheFileName(WAYS_FILE))
-  , m_relations(info.GetCacheFileName(RELATIONS_FILE))
-  , m_nodeToRelations(info.GetCacheFileName(NODES_FILE, ID2REL_EXT))
-  , m_wayToRelations(info.GetCacheFileName(WAYS_FILE, ID2REL_EXT))
-  , m_relationToRelations(info.GetCacheFileName(RELATIONS_FILE, ID2REL_EXT))
+  , m_ways(GetShardFileName(info.GetCacheFileName(WAYS_FILE), shard))
+  , m_relations(GetShardFileName(info.GetCacheFileName(RELATIONS_FILE), shard))
+  , m_nodeToRelations(GetShardFileName(info.GetCacheFileName(NODES_FILE, ID2REL_EXT), shard))
+  , m_wayToRelations(GetShardFileName(info.GetCacheFileName(WAYS_FILE, ID2REL_EXT), shard))
+  , m_relationToRelations(
+        GetShardFileName(info.GetCacheFileName(RELATIONS_FILE, ID2REL_EXT), shard))
 {}
 
 void IntermediateDataWriter::AddRelation(Key id, RelationElement const & e)
@@ -419,6 +776,40 @@ void IntermediateDataWriter::SaveIndex()
   m_relationToRelations.WriteAll();
 }
 
+// static
+void IntermediateDataWriter::MergeShards(feature::GenerateInfo const & info, size_t shardsCount)
+{
+  LOG(LINFO, ("Merging", shardsCount, "shards of the intermediate data"));
+
+  for (auto const & name : {info.GetCacheFileName(WAYS_FILE), info.GetCacheFileName(RELATIONS_FILE)})
+  {
+    // Offsets of the elements are shifted by the positions of the shards in the merged file.
+    std::vector<string> dataShards;
+    std::vector<string> offsetsShards;
+    std::vector<uint64_t> shifts;
+    uint64_t size = 0;
+    for (size_t i = 0; i < shardsCount; ++i)
+    {
+      dataShards.emplace_back(GetShardFileName(name, i));
+      offsetsShards.emplace_back(dataShards.back() + OFFSET_EXT);
+      shifts.emplace_back(size);
+      size += FileReader(dataShards.back()).Size();
+    }
+    ConcatenateFiles(dataShards, name);
+    MergeIndexFiles(offsetsShards, shifts, name + OFFSET_EXT, info);
+  }
+
+  for (auto const & name : {info.GetCacheFileName(NODES_FILE, ID2REL_EXT),
+                            info.GetCacheFileName(WAYS_FILE, ID2REL_EXT),
+                            info.GetCacheFileName(RELATIONS_FILE, ID2REL_EXT)})
+  {
+    std::vector<string> runs;
+    for (size_t i = 0; i < shardsCount; ++i)
+      runs.emplace_back(GetShardFileName(name, i));
+    MergeIndexFiles(runs, std::vector<uint64_t>(shardsCount, 0), name, info);
+  }
+}
+
 // Functions
 std::unique_ptr<PointStorageReaderInterface>
 CreatePointStorageReader(feature::GenerateInfo::NodeStorageType type, string const & name)
@@ -431,6 +822,8 @@ CreatePointStorageReader(feature::GenerateInfo::NodeStorageType type, string con
     return std::make_unique<MapFilePointStorageReader>(name);
   case feature::GenerateInfo::NodeStorageType::Memory:
     return std::make_unique<RawMemPointStorageReader>(name);
+  case feature::GenerateInfo::NodeStorageType::Compact:
+    return std::make_unique<CompactPointStorageReader>(name);
   }
   UNREACHABLE();
 }
@@ -446,10 +839,60 @@ CreatePointStorageWriter(feature::GenerateInfo::NodeStorageType type, string con
     return std::make_unique<MapFilePointStorageWriter>(name);
   case feature::GenerateInfo::NodeStorageType::Memory:
     return std::make_unique<RawMemPointStorageWriter>(name);
+  case feature::GenerateInfo::NodeStorageType::Compact:
+    return std::make_unique<CompactPointStorageWriter>(name);
   }
   UNREACHABLE();
 }
 
+std::vector<std::unique_ptr<PointStorageWriterInterface>>
+CreatePointStorageWriters(feature::GenerateInfo::NodeStorageType type, string const & name,
+                          size_t shardsCount)
+{
+  CHECK_GREATER_OR_EQUAL(shardsCount, 1, ());
+
+  std::vector<std::unique_ptr<PointStorageWriterInterface>> writers;
+  switch (type)
+  {
+  case feature::GenerateInfo::NodeStorageType::File:
+  {
+    // Shards write to disjoint positions of the same file.
+    FileWriter(name).Flush();
+    for (size_t i = 0; i < shardsCount; ++i)
+    {
+      writers.emplace_back(
+          std::make_unique<RawFilePointStorageWriter>(name, FileWriter::OP_WRITE_EXISTING));
+    }
+    break;
+  }
+  case feature::GenerateInfo::NodeStorageType::Index:
+  {
+    auto const merger =
+        std::make_shared<MapFilePointStorageWriter::ShardsMerger>(name, shardsCount);
+    for (size_t i = 0; i < shardsCount; ++i)
+      writers.emplace_back(std::make_unique<MapFilePointStorageWriter>(merger, i));
+    break;
+  }
+  case feature::GenerateInfo::NodeStorageType::Memory:
+  {
+    auto const data = std::make_shared<RawMemPointStorageWriter::Data>(name);
+    for (size_t i = 0; i < shardsCount; ++i)
+      writers.emplace_back(std::make_unique<RawMemPointStorageWriter>(data));
+    break;
+  }
+  case feature::GenerateInfo::NodeStorageType::Compact:
+  {
+    // Every shard gets increasing ids as chunks of a sorted input are distributed in order.
+    auto const merger =
+        std::make_shared<CompactPointStorageWriter::ShardsMerger>(name, shardsCount);
+    for (size_t i = 0; i < shardsCount; ++i)
+      writers.emplace_back(std::make_unique<CompactPointStorageWriter>(merger, i));
+    break;
+  }
+  }
+  return writers;
+}
+
 IntermediateData::IntermediateData(IntermediateDataObjectsCache & objectsCache,
                                    feature::GenerateInfo const & info)
   : m_objectsCache(objectsCache)
@@ -18,6 +18,7 @@
 #include <limits>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
 #include <type_traits>
 #include <unordered_map>
@@ -341,7 +342,9 @@ private:
 class IntermediateDataWriter
 {
 public:
-  IntermediateDataWriter(PointStorageWriterInterface & nodes, feature::GenerateInfo const & info);
+  // When |shard| is set, the data is written to the shard files which are merged by MergeShards.
+  IntermediateDataWriter(PointStorageWriterInterface & nodes, feature::GenerateInfo const & info,
+                         std::optional<size_t> shard = {});
 
   /// \a x \a y are in mercator projection coordinates. @see IntermediateDataReaderInterface::GetNode.
   void AddNode(Key id, double y, double x) { m_nodes.AddPoint(id, y, x); }
@@ -350,6 +353,10 @@ public:
   void AddRelation(Key id, RelationElement const & e);
   void SaveIndex();
 
+  // Merges the files of |shardsCount| shards into the files read by IntermediateDataReader.
+  // Writers of the shards must be destroyed before.
+  static void MergeShards(feature::GenerateInfo const & info, size_t shardsCount);
+
   static void AddToIndex(cache::IndexFileWriter & index, Key relationId, std::vector<uint64_t> const & values)
   {
     for (auto const v : values)
@@ -378,6 +385,12 @@ CreatePointStorageReader(feature::GenerateInfo::NodeStorageType type, std::strin
 std::unique_ptr<PointStorageWriterInterface>
 CreatePointStorageWriter(feature::GenerateInfo::NodeStorageType type, std::string const & name);
 
+// Creates |shardsCount| writers of the same storage which may be used on different threads,
+// every node must be added to one of them. The storage is complete when all of them are destroyed.
+std::vector<std::unique_ptr<PointStorageWriterInterface>>
+CreatePointStorageWriters(feature::GenerateInfo::NodeStorageType type, std::string const & name,
+                          size_t shardsCount);
+
 class IntermediateData
 {
 public:
@@ -0,0 +1,523 @@
+#include "generator/osm_pbf_source.hpp"
+
+#include "coding/zlib.hpp"
+
+#include "base/assert.hpp"
+#include "base/logging.hpp"
+
+#include <iterator>
+
+namespace generator
+{
+namespace pbf
+{
+namespace
+{
+// Limits from the format specification.
+uint32_t constexpr kMaxBlobHeaderSize = 64 * 1024;
+uint32_t constexpr kMaxBlobSize = 32 * 1024 * 1024;
+
+// Reader of the protobuf wire format, see https://protobuf.dev/programming-guides/encoding.
+// Only the subset used by the format is supported.
+class ProtoReader
+{
+public:
+  enum WireType : uint8_t
+  {
+    Varint = 0,
+    Fixed64 = 1,
+    Length = 2,
+    Fixed32 = 5
+  };
+
+  ProtoReader(uint8_t const * data, size_t size) : m_cur(data), m_end(data + size) {}
+  explicit ProtoReader(std::vector<uint8_t> const & data) : ProtoReader(data.data(), data.size()) {}
+
+  // Reads the key of the next field, returns false at the end of the message.
+  bool Next()
+  {
+    if (m_cur == m_end)
+      return false;
+
+    auto const key = ReadVarint();
+    m_field = static_cast<uint32_t>(key >> 3);
+    m_wireType = static_cast<WireType>(key & 0x7);
+    return true;
+  }
+
+  uint32_t Field() const { return m_field; }
+
+  uint8_t const * Data() const { return m_cur; }
+  size_t Size() const { return static_cast<size_t>(m_end - m_cur); }
+
+  uint64_t GetVarint()
+  {
+    CHECK_EQUAL(m_wireType, Varint, (m_field));
+    return ReadVarint();
+  }
+
+  int64_t GetSVarint() { return DecodeZigZag(GetVarint()); }
+
+  // Returns the reader of a length-delimited field: a nested message, bytes or a packed array.
+  ProtoReader GetMessage()
+  {
+    CHECK_EQUAL(m_wireType, Length, (m_field));
+    auto const size = ReadVarint();
+    CHECK_LESS_OR_EQUAL(size, static_cast<uint64_t>(m_end - m_cur), ("Truncated field", m_field));
+    ProtoReader reader(m_cur, static_cast<size_t>(size));
+    m_cur += size;
+    return reader;
+  }
+
+  std::string GetString()
+  {
+    auto const reader = GetMessage();
+    return std::string(reinterpret_cast<char const *>(reader.Data()), reader.Size());
+  }
+
+  std::vector<uint8_t> GetBytes()
+  {
+    auto const reader = GetMessage();
+    return std::vector<uint8_t>(reader.Data(), reader.Data() + reader.Size());
+  }
+
+  // Calls |fn| for every value of a repeated varint field, which may be packed or not.
+  template <typename Fn>
+  void ForEachVarint(Fn && fn)
+  {
+    if (m_wireType == Varint)
+    {
+      fn(ReadVarint());
+      return;
+    }
+
+    auto reader = GetMessage();
+    while (reader.m_cur != reader.m_end)
+      fn(reader.ReadVarint());
+  }
+
+  void Skip()
+  {
+    switch (m_wireType)
+    {
+    case Varint: ReadVarint(); break;
+    case Fixed64: Advance(8); break;
+    case Length: GetMessage(); break;
+    case Fixed32: Advance(4); break;
+    default: CHECK(false, ("Unsupported wire type", static_cast<int>(m_wireType), m_field));
+    }
+  }
+
+  static int64_t DecodeZigZag(uint64_t value)
+  {
+    return static_cast<int64_t>((value >> 1) ^ (0 - (value & 1)));
+  }
+
+private:
+  uint64_t ReadVarint()
+  {
+    uint64_t result = 0;
+    for (uint32_t shift = 0;; shift += 7)
+    {
+      CHECK(m_cur != m_end, ("Truncated varint"));
+      CHECK_LESS(shift, 64, ("Malformed varint"));
+      uint8_t const byte = *m_cur++;
+      result |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0)
+        return result;
+    }
+  }
+
+  void Advance(size_t size)
+  {
+    CHECK_LESS_OR_EQUAL(size, static_cast<size_t>(m_end - m_cur), ("Truncated field", m_field));
+    m_cur += size;
+  }
+
+  uint8_t const * m_cur;
+  uint8_t const * m_end;
+  uint32_t m_field = 0;
+  WireType m_wireType = Varint;
+};
+
+bool ReadExactly(ReadFn const & read, uint8_t * buffer, size_t size)
+{
+  size_t total = 0;
+  while (total < size)
+  {
+    auto const n = read(buffer + total, size - total);
+    if (n == 0)
+      break;
+    total += n;
+  }
+  CHECK(total == 0 || total == size, ("Unexpected end of the stream"));
+  return total == size;
+}
+
+// Decoding context of a PrimitiveBlock.
+class PrimitiveBlockDecoder
+{
+public:
+  PrimitiveBlockDecoder(std::vector<uint8_t> const & data, std::vector<OsmElement> & elements)
+    : m_elements(elements)
+  {
+    // Fields are written in the order of their numbers, so granularity and offsets
+    // follow the groups, which are decoded after the block fields.
+    std::vector<ProtoReader> groups;
+    ProtoReader reader(data);
+    while (reader.Next())
+    {
+      switch (reader.Field())
+      {
+      case 1: ReadStringTable(reader.GetMessage()); break;
+      case 2: groups.push_back(reader.GetMessage()); break;
+      case 17: m_granularity = static_cast<int32_t>(reader.GetVarint()); break;
+      case 19: m_latOffset = static_cast<int64_t>(reader.GetVarint()); break;
+      case 20: m_lonOffset = static_cast<int64_t>(reader.GetVarint()); break;
+      default: reader.Skip();
+      }
+    }
+
+    for (auto & group : groups)
+      DecodeGroup(group);
+  }
+
+private:
+  void ReadStringTable(ProtoReader reader)
+  {
+    while (reader.Next())
+    {
+      if (reader.Field() == 1)
+        m_strings.push_back(reader.GetString());
+      else
+        reader.Skip();
+    }
+  }
+
+  std::string const & GetString(uint64_t index) const
+  {
+    CHECK_LESS(index, m_strings.size(), ("Invalid string index"));
+    return m_strings[index];
+  }
+
+  double ToDegrees(int64_t offset, int64_t value) const
+  {
+    return 1e-9 * static_cast<double>(offset + m_granularity * value);
+  }
+
+  void DecodeGroup(ProtoReader reader)
+  {
+    while (reader.Next())
+    {
+      switch (reader.Field())
+      {
+      case 1: DecodeNode(reader.GetMessage()); break;
+      case 2: DecodeDenseNodes(reader.GetMessage()); break;
+      case 3: DecodeWay(reader.GetMessage()); break;
+      case 4: DecodeRelation(reader.GetMessage()); break;
+      default: reader.Skip();
+      }
+    }
+  }
+
+  void AddTags(OsmElement & element, std::vector<uint32_t> const & keys,
+               std::vector<uint32_t> const & values) const
+  {
+    CHECK_EQUAL(keys.size(), values.size(), (element.m_id));
+    for (size_t i = 0; i < keys.size(); ++i)
+      element.AddTag(GetString(keys[i]), GetString(values[i]));
+  }
+
+  void DecodeNode(ProtoReader reader)
+  {
+    OsmElement element;
+    element.m_type = OsmElement::EntityType::Node;
+
+    std::vector<uint32_t> keys;
+    std::vector<uint32_t> values;
+    int64_t lat = 0;
+    int64_t lon = 0;
+    while (reader.Next())
+    {
+      switch (reader.Field())
+      {
+      case 1: element.m_id = static_cast<uint64_t>(reader.GetSVarint()); break;
+      case 2: reader.ForEachVarint([&](uint64_t v) { keys.push_back(static_cast<uint32_t>(v)); }); break;
+      case 3: reader.ForEachVarint([&](uint64_t v) { values.push_back(static_cast<uint32_t>(v)); }); break;
+      case 8: lat = reader.GetSVarint(); break;
+      case 9: lon = reader.GetSVarint(); break;
+      default: reader.Skip();
+      }
+    }
+
+    element.m_lat = ToDegrees(m_latOffset, lat);
+    element.m_lon = ToDegrees(m_lonOffset, lon);
+    AddTags(element, keys, values);
+    Emit(std::move(element));
+  }
+
+  void DecodeDenseNodes(ProtoReader reader)
+  {
+    std::vector<int64_t> ids;
+    std::vector<int64_t> lats;
+    std::vector<int64_t> lons;
+    std::vector<uint32_t> keysValues;
+    auto const pushSigned = [](std::vector<int64_t> & v)
+    {
+      return [&v](uint64_t value) { v.push_back(ProtoReader::DecodeZigZag(value)); };
+    };
+
+    while (reader.Next())
+    {
+      switch (reader.Field())
+      {
+      case 1: reader.ForEachVarint(pushSigned(ids)); break;
+      case 8: reader.ForEachVarint(pushSigned(lats)); break;
+      case 9: reader.ForEachVarint(pushSigned(lons)); break;
+      case 10: reader.ForEachVarint([&](uint64_t v) { keysValues.push_back(static_cast<uint32_t>(v)); }); break;
+      default: reader.Skip();
+      }
+    }
+
+    CHECK_EQUAL(ids.size(), lats.size(), ());
+    CHECK_EQUAL(ids.size(), lons.size(), ());
+
+    // Ids and coordinates are delta coded, tags of all nodes are stored in |keysValues|
+    // as (key, value) pairs, tags of every node end with zero. There are no tags at all
+    // when |keysValues| is empty.
+    int64_t id = 0;
+    int64_t lat = 0;
+    int64_t lon = 0;
+    size_t kv = 0;
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+      id += ids[i];
+      lat += lats[i];
+      lon += lons[i];
+
+      OsmElement element;
+      element.m_type = OsmElement::EntityType::Node;
+      element.m_id = static_cast<uint64_t>(id);
+      element.m_lat = ToDegrees(m_latOffset, lat);
+      element.m_lon = ToDegrees(m_lonOffset, lon);
+
+      while (kv < keysValues.size() && keysValues[kv] != 0)
+      {
+        CHECK_LESS(kv + 1, keysValues.size(), ("Key without value", id));
+        element.AddTag(GetString(keysValues[kv]), GetString(keysValues[kv + 1]));
+        kv += 2;
+      }
+      // Skips the end of the node tags.
+      ++kv;
+
+      Emit(std::move(element));
+    }
+  }
+
+  void DecodeWay(ProtoReader reader)
+  {
+    OsmElement element;
+    element.m_type = OsmElement::EntityType::Way;
+
+    std::vector<uint32_t> keys;
+    std::vector<uint32_t> values;
+    while (reader.Next())
+    {
+      switch (reader.Field())
+      {
+      case 1: element.m_id = reader.GetVarint(); break;
+      case 2: reader.ForEachVarint([&](uint64_t v) { keys.push_back(static_cast<uint32_t>(v)); }); break;
+      case 3: reader.ForEachVarint([&](uint64_t v) { values.push_back(static_cast<uint32_t>(v)); }); break;
+      case 8:
+      {
+        int64_t ref = 0;
+        reader.ForEachVarint([&](uint64_t v)
+        {
+          ref += ProtoReader::DecodeZigZag(v);
+          element.AddNd(static_cast<uint64_t>(ref));
+        });
+        break;
+      }
+      default: reader.Skip();
+      }
+    }
+
+    AddTags(element, keys, values);
+    Emit(std::move(element));
+  }
+
+  void DecodeRelation(ProtoReader reader)
+  {
+    OsmElement element;
+    element.m_type = OsmElement::EntityType::Relation;
+
+    std::vector<uint32_t> keys;
+    std::vector<uint32_t> values;
+    std::vector<uint32_t> roles;
+    std::vector<int64_t> refs;
+    std::vector<uint64_t> types;
+    while (reader.Next())
+    {
+      switch (reader.Field())
+      {
+      case 1: element.m_id = reader.GetVarint(); break;
+      case 2: reader.ForEachVarint([&](uint64_t v) { keys.push_back(static_cast<uint32_t>(v)); }); break;
+      case 3: reader.ForEachVarint([&](uint64_t v) { values.push_back(static_cast<uint32_t>(v)); }); break;
+      case 8: reader.ForEachVarint([&](uint64_t v) { roles.push_back(static_cast<uint32_t>(v)); }); break;
+      case 9:
+      {
+        int64_t ref = 0;
+        reader.ForEachVarint([&](uint64_t v)
+        {
+          ref += ProtoReader::DecodeZigZag(v);
+          refs.push_back(ref);
+        });
+        break;
+      }
+      case 10: reader.ForEachVarint([&](uint64_t v) { types.push_back(v); }); break;
+      default: reader.Skip();
+      }
+    }
+
+    CHECK_EQUAL(refs.size(), roles.size(), (element.m_id));
+    CHECK_EQUAL(refs.size(), types.size(), (element.m_id));
+    for (size_t i = 0; i < refs.size(); ++i)
+    {
+      auto type = OsmElement::EntityType::Unknown;
+      switch (types[i])
+      {
+      case 0: type = OsmElement::EntityType::Node; break;
+      case 1: type = OsmElement::EntityType::Way; break;
+      case 2: type = OsmElement::EntityType::Relation; break;
+      default: LOG(LWARNING, ("Unknown member type", types[i], "of relation", element.m_id));
+      }
+      element.AddMember(static_cast<uint64_t>(refs[i]), type, GetString(roles[i]));
+    }
+
+    AddTags(element, keys, values);
+    Emit(std::move(element));
+  }
+
+  void Emit(OsmElement && element)
+  {
+    element.Validate();
+    m_elements.push_back(std::move(element));
+  }
+
+  std::vector<OsmElement> & m_elements;
+  std::vector<std::string> m_strings;
+  int64_t m_granularity = 100;
+  int64_t m_latOffset = 0;
+  int64_t m_lonOffset = 0;
+};
+}  // namespace
+
+bool ReadFileBlock(ReadFn const & read, FileBlock & block)
+{
+  uint8_t sizeBuffer[4];
+  if (!ReadExactly(read, sizeBuffer, sizeof(sizeBuffer)))
+    return false;
+
+  // Size of the BlobHeader is in network byte order.
+  uint32_t const headerSize = (static_cast<uint32_t>(sizeBuffer[0]) << 24) |
+                              (static_cast<uint32_t>(sizeBuffer[1]) << 16) |
+                              (static_cast<uint32_t>(sizeBuffer[2]) << 8) |
+                              static_cast<uint32_t>(sizeBuffer[3]);
+  CHECK_LESS_OR_EQUAL(headerSize, kMaxBlobHeaderSize, ());
+
+  std::vector<uint8_t> header(headerSize);
+  CHECK(ReadExactly(read, header.data(), header.size()), ("Unexpected end of the stream"));
+
+  block.m_type.clear();
+  uint64_t blobSize = 0;
+  ProtoReader reader(header);
+  while (reader.Next())
+  {
+    switch (reader.Field())
+    {
+    case 1: block.m_type = reader.GetString(); break;
+    case 3: blobSize = reader.GetVarint(); break;
+    default: reader.Skip();
+    }
+  }
+  CHECK_LESS_OR_EQUAL(blobSize, kMaxBlobSize, (block.m_type));
+
+  block.m_blob.resize(static_cast<size_t>(blobSize));
+  CHECK(blobSize == 0 || ReadExactly(read, block.m_blob.data(), block.m_blob.size()),
+        ("Unexpected end of the stream"));
+  return true;
+}
+
+std::vector<uint8_t> UnpackBlob(std::vector<uint8_t> const & blob)
+{
+  std::vector<uint8_t> data;
+  uint64_t rawSize = 0;
+  ProtoReader reader(blob);
+  while (reader.Next())
+  {
+    switch (reader.Field())
+    {
+    // raw
+    case 1: data = reader.GetBytes(); break;
+    // raw_size
+    case 2: rawSize = reader.GetVarint(); break;
+    // zlib_data
+    case 3:
+    {
+      auto const compressed = reader.GetMessage();
+      CHECK_LESS_OR_EQUAL(rawSize, kMaxBlobSize, ());
+      data.reserve(static_cast<size_t>(rawSize));
+      coding::ZLib::Inflate inflate(coding::ZLib::Inflate::Format::ZLib);
+      CHECK(inflate(compressed.Data(), compressed.Size(), std::back_inserter(data)),
+            ("Can't inflate blob"));
+      break;
+    }
+    // lzma_data, OBSOLETE_bzip2_data, lz4_data, zstd_data
+    case 4:
+    case 5:
+    case 6:
+    case 7: CHECK(false, ("Unsupported blob compression", reader.Field())); break;
+    default: reader.Skip();
+    }
+  }
+  CHECK(rawSize == 0 || rawSize == data.size(), (rawSize, data.size()));
+  return data;
+}
+
+void CheckHeaderBlock(std::vector<uint8_t> const & data)
+{
+  ProtoReader reader(data);
+  while (reader.Next())
+  {
+    // required_features
+    if (reader.Field() == 4)
+    {
+      auto const feature = reader.GetString();
+      CHECK(feature == "OsmSchema-V0.6" || feature == "DenseNodes",
+            ("Unsupported required feature", feature));
+    }
+    else
+    {
+      reader.Skip();
+    }
+  }
+}
+
+void DecodePrimitiveBlock(std::vector<uint8_t> const & data, std::vector<OsmElement> & elements)
+{
+  PrimitiveBlockDecoder decoder(data, elements);
+}
+
+std::vector<OsmElement> DecodeFileBlock(FileBlock const & block)
+{
+  std::vector<OsmElement> elements;
+  if (block.m_type == kHeaderBlockType)
+    CheckHeaderBlock(UnpackBlob(block.m_blob));
+  else if (block.m_type == kDataBlockType)
+    DecodePrimitiveBlock(UnpackBlob(block.m_blob), elements);
+  else
+    LOG(LWARNING, ("Skipped block of unknown type", block.m_type));
+  return elements;
+}
+}  // namespace pbf
+}  // namespace generator
@@ -0,0 +1,48 @@
+// See PBF Format definition at https://wiki.openstreetmap.org/wiki/PBF_Format
+#pragma once
+
+#include "generator/osm_element.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace generator
+{
+namespace pbf
+{
+// Reads up to |size| bytes into |buffer| and returns the number of read bytes,
+// zero at the end of the stream.
+using ReadFn = std::function<size_t(uint8_t *, size_t)>;
+
+// Block types of the file.
+std::string const kHeaderBlockType = "OSMHeader";
+std::string const kDataBlockType = "OSMData";
+
+// A fileblock of the file: the type from BlobHeader and the serialized Blob message.
+struct FileBlock
+{
+  std::string m_type;
+  std::vector<uint8_t> m_blob;
+};
+
+// Reads the next fileblock, returns false at the end of the stream.
+// Reading is sequential and cheap, so it is done on a single thread while
+// blobs are unpacked and decoded by workers, see ProcessorOsmElementsFromPbf.
+bool ReadFileBlock(ReadFn const & read, FileBlock & block);
+
+// Returns the data of a Blob message. Only raw and zlib compressed blobs are supported.
+std::vector<uint8_t> UnpackBlob(std::vector<uint8_t> const & blob);
+
+// Checks that all the features required by the HeaderBlock |data| are supported.
+void CheckHeaderBlock(std::vector<uint8_t> const & data);
+
+// Appends elements of the PrimitiveBlock |data| to |elements| in the order they are stored.
+void DecodePrimitiveBlock(std::vector<uint8_t> const & data, std::vector<OsmElement> & elements);
+
+// Decodes the fileblock of OSMData type, elements of other blocks are not returned.
+std::vector<OsmElement> DecodeFileBlock(FileBlock const & block);
+}  // namespace pbf
+}  // namespace generator
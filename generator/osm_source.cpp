@@ -9,9 +9,13 @@
 
 #include "base/assert.hpp"
 #include "base/stl_helpers.hpp"
+#include "base/thread_pool_computational.hpp"
+#include "base/thread_safe_queue.hpp"
 
 #include <fstream>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "defines.hpp"
 
@@ -124,6 +128,19 @@ void ProcessOsmElementsFromO5M(SourceReader & stream, std::function<void(OsmElem
   }
 }
 
+void ProcessOsmElementsFromPbf(SourceReader & stream, std::function<void(OsmElement &&)> const & processor,
+                               size_t threadsCount)
+{
+  ProcessorOsmElementsFromPbf processorOsmElementsFromPbf(stream, threadsCount);
+  OsmElement element;
+  while (processorOsmElementsFromPbf.TryRead(element))
+  {
+    processor(std::move(element));
+    // It is safe to use `element` here as `Clear` will restore the state after the move.
+    element.Clear();
+  }
+}
+
 ProcessorOsmElementsFromO5M::ProcessorOsmElementsFromO5M(SourceReader & stream)
   : m_stream(stream)
   , m_dataset([&](uint8_t * buffer, size_t size) {
@@ -190,6 +207,55 @@ bool ProcessorOsmElementsFromO5M::TryRead(OsmElement & element)
   return true;
 }
 
+ProcessorOsmElementsFromPbf::ProcessorOsmElementsFromPbf(SourceReader & stream, size_t threadsCount)
+  : m_stream(stream)
+  , m_threadPool(threadsCount)
+  // Keeps all threads busy while the next block in the file order is being decoded.
+  , m_maxBlocksInProgress(2 * threadsCount)
+{
+  SubmitBlocks();
+}
+
+void ProcessorOsmElementsFromPbf::SubmitBlocks()
+{
+  auto const read = [this](uint8_t * buffer, size_t size)
+  {
+    return static_cast<size_t>(m_stream.Read(reinterpret_cast<char *>(buffer), size));
+  };
+
+  while (!m_endOfStream && m_blocks.size() < m_maxBlocksInProgress)
+  {
+    pbf::FileBlock block;
+    if (!pbf::ReadFileBlock(read, block))
+    {
+      m_endOfStream = true;
+      break;
+    }
+
+    m_blocks.push_back(m_threadPool.Submit([block = std::move(block)]()
+    {
+      return pbf::DecodeFileBlock(block);
+    }));
+  }
+}
+
+bool ProcessorOsmElementsFromPbf::TryRead(OsmElement & element)
+{
+  while (m_pos == m_elements.size())
+  {
+    if (m_blocks.empty())
+      return false;
+
+    m_elements = m_blocks.front().get();
+    m_blocks.pop_front();
+    m_pos = 0;
+    SubmitBlocks();
+  }
+
+  element = std::move(m_elements[m_pos++]);
+  return true;
+}
+
 ProcessorOsmElementsFromXml::ProcessorOsmElementsFromXml(SourceReader & stream)
   : m_xmlSource([&, this](OsmElement && e)
     {
@@ -226,22 +292,71 @@ bool ProcessorOsmElementsFromXml::TryRead(OsmElement & element)
 // Generate functions implementations.
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
-bool GenerateIntermediateData(feature::GenerateInfo & info)
+namespace
 {
-  auto nodes =
-      cache::CreatePointStorageWriter(info.m_nodeStorageType, info.GetCacheFileName(NODES_FILE));
-  cache::IntermediateDataWriter cache(*nodes, info);
-  TownsDumper towns;
-  SourceReader reader = info.m_osmFileName.empty() ? SourceReader() : SourceReader(info.m_osmFileName);
+size_t constexpr kElementsChunkSize = 1 << 14;
 
-  LOG(LINFO, ("Data source:", info.m_osmFileName));
+// Adds chunks of elements to the intermediate data on several threads, every thread writes
+// its own shard of the cache files.
+class IntermediateDataWritersPool
+{
+public:
+  IntermediateDataWritersPool(feature::GenerateInfo const & info, size_t threadsCount)
+    : m_info(info)
+    , m_threadPool(threadsCount)
+    , m_nodes(cache::CreatePointStorageWriters(info.m_nodeStorageType,
+                                               info.GetCacheFileName(NODES_FILE), threadsCount))
+  {
+    for (size_t i = 0; i < threadsCount; ++i)
+    {
+      m_writers.emplace_back(std::make_unique<cache::IntermediateDataWriter>(*m_nodes[i], info, i));
+      m_freeWriters.Push(m_writers.back().get());
+    }
+  }
 
-  auto const processor = [&](OsmElement && element)
+  void Emit(std::vector<OsmElement> && elements)
   {
-    towns.CheckElement(element);
-    AddElementToCache(cache, std::move(element));
-  };
+    cache::IntermediateDataWriter * writer = nullptr;
+    m_freeWriters.WaitAndPop(writer);
+    m_threadPool.SubmitWork([&, writer, elements = std::move(elements)]() mutable
+    {
+      for (auto & element : elements)
+        AddElementToCache(*writer, std::move(element));
+
+      m_freeWriters.Push(writer);
+    });
+  }
+
+  // Returns the number of added points.
+  uint64_t Finish()
+  {
+    m_threadPool.WaitingStop();
+
+    uint64_t numPoints = 0;
+    for (auto const & nodes : m_nodes)
+      numPoints += nodes->GetNumProcessedPoints();
+
+    for (auto & writer : m_writers)
+      writer->SaveIndex();
 
+    auto const shardsCount = m_writers.size();
+    m_writers.clear();
+    m_nodes.clear();
+    cache::IntermediateDataWriter::MergeShards(m_info, shardsCount);
+    return numPoints;
+  }
+
+private:
+  feature::GenerateInfo const & m_info;
+  base::thread_pool::computational::ThreadPool m_threadPool;
+  std::vector<std::unique_ptr<cache::PointStorageWriterInterface>> m_nodes;
+  std::vector<std::unique_ptr<cache::IntermediateDataWriter>> m_writers;
+  threads::ThreadSafeQueue<cache::IntermediateDataWriter *> m_freeWriters;
+};
+
+void ProcessOsmElements(feature::GenerateInfo const & info, SourceReader & reader,
+                        std::function<void(OsmElement &&)> const & processor)
+{
   switch (info.m_osmFileType)
   {
   case feature::GenerateInfo::OsmSourceType::XML:
@@ -250,11 +365,54 @@ bool GenerateIntermediateData(feature::GenerateInfo & info)
   case feature::GenerateInfo::OsmSourceType::O5M:
     ProcessOsmElementsFromO5M(reader, processor);
     break;
+  case feature::GenerateInfo::OsmSourceType::PBF:
+    ProcessOsmElementsFromPbf(reader, processor, info.m_threadsCount);
+    break;
+  }
+}
+}  // namespace
+
+bool GenerateIntermediateData(feature::GenerateInfo & info)
+{
+  TownsDumper towns;
+  SourceReader reader = info.m_osmFileName.empty() ? SourceReader() : SourceReader(info.m_osmFileName);
+
+  LOG(LINFO, ("Data source:", info.m_osmFileName));
+
+  uint64_t numPoints = 0;
+  if (info.m_threadsCount <= 1)
+  {
+    auto nodes =
+        cache::CreatePointStorageWriter(info.m_nodeStorageType, info.GetCacheFileName(NODES_FILE));
+    cache::IntermediateDataWriter cache(*nodes, info);
+    ProcessOsmElements(info, reader, [&](OsmElement && element)
+    {
+      towns.CheckElement(element);
+      AddElementToCache(cache, std::move(element));
+    });
+
+    cache.SaveIndex();
+    numPoints = nodes->GetNumProcessedPoints();
+  }
+  else
+  {
+    // Elements are read on this thread and are added to the shards of the cache by chunks.
+    IntermediateDataWritersPool pool(info, info.m_threadsCount);
+    std::vector<OsmElement> elements;
+    ProcessOsmElements(info, reader, [&](OsmElement && element)
+    {
+      towns.CheckElement(element);
+      elements.emplace_back(std::move(element));
+      if (elements.size() == kElementsChunkSize)
+        pool.Emit(std::exchange(elements, {}));
+    });
+
+    pool.Emit(std::move(elements));
+    numPoints = pool.Finish();
   }
 
-  cache.SaveIndex();
   towns.Dump(info.GetIntermediateFileName(TOWNS_FILE));
-  LOG(LINFO, ("Added points count =", nodes->GetNumProcessedPoints()));
+  LOG(LINFO, ("Added points count =", numPoints));
   return true;
 }
 }  // namespace generator
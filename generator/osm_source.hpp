@@ -3,17 +3,24 @@
 #include "generator/generate_info.hpp"
 #include "generator/intermediate_data.hpp"
 #include "generator/osm_o5m_source.hpp"
+#include "generator/osm_pbf_source.hpp"
 #include "generator/osm_xml_source.hpp"
 #include "generator/translator_interface.hpp"
 
 #include "coding/parse_xml.hpp"
 
+#include "base/thread_pool_computational.hpp"
+
+#include <cstddef>
+#include <deque>
 #include <functional>
+#include <future>
 #include <iostream>
 #include <memory>
 #include <queue>
 #include <sstream>
 #include <string>
+#include <vector>
 
 struct OsmElement;
 class FeatureParams;
@@ -49,6 +56,8 @@ bool GenerateIntermediateData(feature::GenerateInfo & info);
 
 void ProcessOsmElementsFromO5M(SourceReader & stream, std::function<void (OsmElement &&)> const & processor);
 void ProcessOsmElementsFromXML(SourceReader & stream, std::function<void (OsmElement &&)> const & processor);
+void ProcessOsmElementsFromPbf(SourceReader & stream, std::function<void (OsmElement &&)> const & processor,
+                               size_t threadsCount);
 
 class ProcessorOsmElementsInterface
 {
@@ -72,6 +81,29 @@ private:
   osm::O5MSource::Iterator m_pos;
 };
 
+// Blocks of the file are read sequentially and are unpacked and decoded on |threadsCount|
+// threads, elements are returned in the order they are stored in the file.
+class ProcessorOsmElementsFromPbf : public ProcessorOsmElementsInterface
+{
+public:
+  ProcessorOsmElementsFromPbf(SourceReader & stream, size_t threadsCount);
+
+  // ProcessorOsmElementsInterface overrides:
+  bool TryRead(OsmElement & element) override;
+
+private:
+  // Reads blocks until |m_maxBlocksInProgress| of them are being decoded.
+  void SubmitBlocks();
+
+  SourceReader & m_stream;
+  base::thread_pool::computational::ThreadPool m_threadPool;
+  size_t const m_maxBlocksInProgress;
+  bool m_endOfStream = false;
+  std::deque<std::future<std::vector<OsmElement>>> m_blocks;
+  std::vector<OsmElement> m_elements;
+  size_t m_pos = 0;
+};
+
 class ProcessorOsmElementsFromXml : public ProcessorOsmElementsInterface
 {
 public:
@@ -9,11 +9,13 @@
 #include "routing/cross_mwm_connector.hpp"
 #include "routing/cross_mwm_connector_serialization.hpp"
 #include "routing/cross_mwm_ids.hpp"
+#include "routing/cross_mwm_overlay.hpp"
 #include "routing/index_graph.hpp"
 #include "routing/index_graph_loader.hpp"
 #include "routing/index_graph_serialization.hpp"
 #include "routing/index_graph_starter_joints.hpp"
 #include "routing/joint_segment.hpp"
+#include "routing/mwm_hierarchy_handler.hpp"
 #include "routing/vehicle_mask.hpp"
 #include "routing/world_graph.hpp"
 
@@ -27,6 +29,8 @@
 #include "indexer/feature.hpp"
 #include "indexer/feature_processor.hpp"
 
+#include "platform/platform.hpp"
+
 #include "coding/files_container.hpp"
 #include "coding/point_coding.hpp"
 #include "coding/reader.hpp"
@@ -41,6 +45,7 @@
 #include "base/timer.hpp"
 
 #include <algorithm>
+#include <limits>
 #include <map>
 #include <memory>
 #include <unordered_map>
@@ -502,8 +507,9 @@ void FillWeights(string const & path, string const & mwmFile, string const & cou
       CarModelFactory(countryParentNameGetterFn).GetVehicleModelForCountry(country);
 
   MwmValue mwmValue(LocalCountryFile(path, platform::CountryFile(country), 0 /* version */));
-  uint32_t mwmNumRoads = DeserializeIndexGraphNumRoads(mwmValue, vhType);
-  IndexGraph graph(std::make_shared<Geometry>(GeometryLoader::CreateFromFile(mwmFile, vehicleModel), mwmNumRoads),
+  // Cross mwm weights are calculated for the whole mwm, so all its roads are kept in memory.
+  IndexGraph graph(std::make_shared<Geometry>(GeometryLoader::CreateFromFile(mwmFile, vehicleModel),
+                                              std::numeric_limits<size_t>::max()),
                                               EdgeEstimator::Create(vhType, *vehicleModel,
                                                                     nullptr /* trafficStash */,
                                                                     nullptr /* dataSource */,
@@ -687,6 +693,153 @@ void BuildRoutingCrossMwmSection(string const & path, string const & mwmFile,
   SerializeCrossMwm(mwmFile, CROSS_MWM_FILE_TAG, builder);
 }
 
+/// Leaps of country mwms, read from their cross mwm sections. Has the same interface as
+/// CrossMwmGraph for the overlay builder, but doesn't need a DataSource.
+class CrossMwmLeaps
+{
+public:
+  using EdgeListT = CrossMwmConnector<base::GeoObjectId>::EdgeListT;
+
+  void AddMwm(NumMwmId numMwmId, FilesContainerR const & cont)
+  {
+    auto & connector =
+        m_connectors.emplace(numMwmId, CrossMwmConnector<base::GeoObjectId>(numMwmId)).first->second;
+
+    CrossMwmConnectorBuilder<base::GeoObjectId> builder(connector);
+    builder.ApplyNumerationOffset();
+
+    auto reader = cont.GetReader(CROSS_MWM_FILE_TAG);
+    builder.DeserializeTransitions(VehicleType::Car, reader);
+    if (!connector.WeightsWereLoaded())
+      builder.DeserializeWeights(reader);
+
+    auto const addTransition = [&](uint32_t, Segment const & s)
+    {
+      auto & mwms = m_crossMwmIdToMwms[connector.GetCrossMwmId(s)];
+      if (mwms.empty() || mwms.back() != numMwmId)
+        mwms.push_back(numMwmId);
+    };
+    connector.ForEachEnter(addTransition);
+    connector.ForEachExit(addTransition);
+  }
+
+  template <class FnT>
+  void ForEachTransition(NumMwmId numMwmId, bool isEnter, FnT && fn) const
+  {
+    auto const & connector = GetConnector(numMwmId);
+    auto const wrapper = [&fn](uint32_t, Segment const & s) { fn(s); };
+    return isEnter ? connector.ForEachEnter(wrapper) : connector.ForEachExit(wrapper);
+  }
+
+  void GetOutgoingEdgeList(Segment const & enter, EdgeListT & edges) const
+  {
+    GetConnector(enter.GetMwmId()).GetOutgoingEdgeList(enter, edges);
+  }
+
+  /// See CrossMwmGraph::GetTwins() and CrossMwmIndexGraph::GetTwinsByCrossMwmId().
+  void GetTwins(Segment const & s, bool isOutgoing, vector<Segment> & twins) const
+  {
+    auto const & connector = GetConnector(s.GetMwmId());
+    if (connector.IsTransition(s, !isOutgoing))
+      return;
+
+    auto const & crossMwmId = connector.GetCrossMwmId(s);
+    auto const it = m_crossMwmIdToMwms.find(crossMwmId);
+    CHECK(it != m_crossMwmIdToMwms.end(), (s));
+
+    for (NumMwmId const neighbor : it->second)
+    {
+      if (neighbor == s.GetMwmId())
+        continue;
+
+      auto const twin = GetConnector(neighbor).GetTransition(crossMwmId, s.GetSegmentIdx(), isOutgoing);
+      if (twin && twin->IsForward() == s.IsForward())
+        twins.push_back(*twin);
+    }
+  }
+
+private:
+  CrossMwmConnector<base::GeoObjectId> const & GetConnector(NumMwmId numMwmId) const
+  {
+    auto const it = m_connectors.find(numMwmId);
+    CHECK(it != m_connectors.end(), (numMwmId));
+    return it->second;
+  }
+
+  std::map<NumMwmId, CrossMwmConnector<base::GeoObjectId>> m_connectors;
+  std::unordered_map<base::GeoObjectId, vector<NumMwmId>, connector::HashKey> m_crossMwmIdToMwms;
+};
+
+bool BuildCrossMwmOverlaySection(string const & path, string const & worldMwmFile,
+                                 CountryParentNameGetterFn const & countryParentNameGetterFn)
+{
+  LOG(LINFO, ("Building cross mwm overlay section for", worldMwmFile, "from mwms in", path));
+  base::Timer timer;
+
+  try
+  {
+    Platform::FilesList files;
+    Platform::GetFilesByExt(path, DATA_FILE_EXTENSION, files);
+    std::sort(files.begin(), files.end());
+
+    NumMwmIds numMwmIds;
+    CrossMwmLeaps leaps;
+    std::map<string, vector<NumMwmId>> countryToMwms;
+    for (auto const & file : files)
+    {
+      string name = file;
+      base::GetNameWithoutExt(name);
+      if (name == WORLD_FILE_NAME || name == WORLD_COASTS_FILE_NAME)
+        continue;
+
+      FilesContainerR cont(base::JoinPath(path, file));
+      if (!cont.IsExist(CROSS_MWM_FILE_TAG))
+      {
+        LOG(LWARNING, ("No", CROSS_MWM_FILE_TAG, "section in", file));
+        continue;
+      }
+
+      CountryFile const countryFile(name);
+      numMwmIds.RegisterFile(countryFile);
+      NumMwmId const numMwmId = numMwmIds.GetId(countryFile);
+      leaps.AddMwm(numMwmId, cont);
+
+      auto const country = GetCountryByMwmName(name, countryParentNameGetterFn);
+      if (!country.empty())
+        countryToMwms[country].push_back(numMwmId);
+    }
+
+    CrossMwmOverlay overlay;
+    for (auto const & [country, mwms] : countryToMwms)
+    {
+      // Shortcuts of a single mwm country are its own leaps.
+      if (mwms.size() < 2)
+        continue;
+
+      auto cell = cross_mwm_overlay::BuildCell(leaps, mwms);
+      LOG(LINFO, ("Cell", country, "mwms:", mwms.size(), "enters:", cell.m_enters.size(),
+                  "exits:", cell.m_exits.size()));
+      overlay.AddCell(std::move(cell));
+    }
+
+    FilesContainerW cont(worldMwmFile, FileWriter::OP_WRITE_EXISTING);
+    auto writer = cont.GetWriter(CROSS_MWM_OVERLAY_FILE_TAG);
+    auto const startPos = writer->Pos();
+    CrossMwmOverlaySerializer::Serialize(overlay, *writer, numMwmIds);
+    auto const sectionSize = writer->Pos() - startPos;
+
+    LOG(LINFO, ("Cross mwm overlay section generated, cells:", overlay.GetCells().size(),
+                "size:", sectionSize, "bytes, elapsed:", timer.ElapsedSeconds(), "seconds"));
+    return true;
+  }
+  catch (RootException const & e)
+  {
+    LOG(LERROR, ("An exception happened while creating", CROSS_MWM_OVERLAY_FILE_TAG, "section:",
+                 e.what()));
+    return false;
+  }
+}
+
 void BuildTransitCrossMwmSection(
     string const & path, string const & mwmFile, string const & country,
     CountryParentNameGetterFn const & countryParentNameGetterFn,
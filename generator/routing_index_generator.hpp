@@ -22,6 +22,12 @@ void BuildRoutingCrossMwmSection(std::string const & path, std::string const & m
                                  CountryParentNameGetterFn const & countryParentNameGetterFn,
                                  std::string const & osmToFeatureFile);
 
+/// \brief Builds CROSS_MWM_OVERLAY_FILE_TAG section of |worldMwmFile|: shortcuts through
+/// countries of the country mwms from |path|, see routing::CrossMwmOverlay.
+/// \note Before call of this method CROSS_MWM_FILE_TAG should be built for all the countries.
+bool BuildCrossMwmOverlaySection(std::string const & path, std::string const & worldMwmFile,
+                                 CountryParentNameGetterFn const & countryParentNameGetterFn);
+
 /// \brief Builds TRANSIT_CROSS_MWM_FILE_TAG section.
 /// \note Before a call of this method TRANSIT_FILE_TAG should be built.
 void BuildTransitCrossMwmSection(
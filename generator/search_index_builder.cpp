@@ -3,6 +3,7 @@
 #include "search/common.hpp"
 #include "search/house_to_street_table.hpp"
 #include "search/mwm_context.hpp"
+#include "search/popular_prefixes.hpp"
 #include "search/reverse_geocoder.hpp"
 #include "search/search_index_header.hpp"
 #include "search/search_index_values.hpp"
@@ -17,6 +18,7 @@
 #include "indexer/feature_visibility.hpp"
 #include "indexer/features_vector.hpp"
 #include "indexer/postcodes_matcher.hpp"
+#include "indexer/rank_table.hpp"
 #include "indexer/road_shields_parser.hpp"
 #include "indexer/scales_patch.hpp"
 #include "indexer/search_string_utils.hpp"
@@ -34,6 +36,7 @@
 #include "base/logging.hpp"
 #include "base/scope_guard.hpp"
 #include "base/stats.hpp"
+#include "base/stl_helpers.hpp"
 #include "base/string_utils.hpp"
 #include "base/timer.hpp"
 
@@ -589,7 +592,7 @@ void BuildAddressTable(FilesContainerR & container, std::string const & addressD
 }  // namespace
 
 
-void BuildSearchIndex(FilesContainerR & container, Writer & indexWriter);
+void BuildSearchIndex(FilesContainerR & container, Writer & indexWriter, Writer & prefixesWriter);
 
 bool BuildSearchIndexFromDataFile(std::string const & country, feature::GenerateInfo const & info,
                                   bool forceRebuild, uint32_t threadsCount)
@@ -602,9 +605,11 @@ bool BuildSearchIndexFromDataFile(std::string const & country, feature::Generate
     return true;
 
   auto const indexFilePath = filename + "." + SEARCH_INDEX_FILE_TAG EXTENSION_TMP;
+  auto const prefixesFilePath = filename + "." + SEARCH_PREFIXES_FILE_TAG EXTENSION_TMP;
   auto const streetsFilePath = filename + "." + FEATURE2STREET_FILE_TAG EXTENSION_TMP;
   auto const placesFilePath = filename + "." + FEATURE2PLACE_FILE_TAG EXTENSION_TMP;
   SCOPE_GUARD(indexFileGuard, std::bind(&FileWriter::DeleteFileX, indexFilePath));
+  SCOPE_GUARD(prefixesFileGuard, std::bind(&FileWriter::DeleteFileX, prefixesFilePath));
   SCOPE_GUARD(streetsFileGuard, std::bind(&FileWriter::DeleteFileX, streetsFilePath));
   SCOPE_GUARD(placesFileGuard, std::bind(&FileWriter::DeleteFileX, placesFilePath));
 
@@ -612,8 +617,10 @@ bool BuildSearchIndexFromDataFile(std::string const & country, feature::Generate
   {
     {
       FileWriter writer(indexFilePath);
-      BuildSearchIndex(readContainer, writer);
-      LOG(LINFO, ("Search index size =", writer.Size()));
+      FileWriter prefixesWriter(prefixesFilePath);
+      BuildSearchIndex(readContainer, writer, prefixesWriter);
+      LOG(LINFO, ("Search index size =", writer.Size(), "; Popular prefixes size =",
+                  prefixesWriter.Size()));
     }
 
     if (filename != WORLD_FILE_NAME && filename != WORLD_COASTS_FILE_NAME)
@@ -650,6 +657,7 @@ bool BuildSearchIndexFromDataFile(std::string const & country, feature::Generate
 
     {
       FilesContainerW writeContainer(readContainer.GetFileName(), FileWriter::OP_WRITE_EXISTING);
+      writeContainer.Write(prefixesFilePath, SEARCH_PREFIXES_FILE_TAG);
       writeContainer.Write(streetsFilePath, FEATURE2STREET_FILE_TAG);
       writeContainer.Write(placesFilePath, FEATURE2PLACE_FILE_TAG);
     }
@@ -668,7 +676,70 @@ bool BuildSearchIndexFromDataFile(std::string const & country, feature::Generate
   return true;
 }
 
-void BuildSearchIndex(FilesContainerR & container, Writer & indexWriter)
+// Writes lists of the top ranked features for the popular name prefixes, see search::PopularPrefixes.
+template <typename Key, typename Value>
+void BuildPopularPrefixes(FilesContainerR & container,
+                          std::vector<std::pair<Key, Value>> const & sortedKeyValuePairs,
+                          Writer & writer)
+{
+  using search::PopularPrefixes;
+
+  std::vector<uint8_t> ranks;
+  search::SearchRankTableBuilder::CalcSearchRanks(container, ranks);
+  auto const getRank = [&ranks](uint32_t id) { return id < ranks.size() ? ranks[id] : 0; };
+
+  std::vector<PopularPrefixes::Entry> entries;
+  std::vector<uint32_t> features;
+  for (size_t length = 1; length <= PopularPrefixes::kMaxPrefixLength; ++length)
+  {
+    // Keys are sorted, so keys with the same lang and prefix are adjacent.
+    size_t i = 0;
+    while (i < sortedKeyValuePairs.size())
+    {
+      // The first symbol of a key is its lang.
+      auto const & key = sortedKeyValuePairs[i].first;
+      if (key.size() <= length || key[0] >= search::kCategoriesLang)
+      {
+        ++i;
+        continue;
+      }
+
+      auto const isSamePrefix = [&key, length](Key const & k) {
+        return k.size() > length && std::equal(key.begin(), key.begin() + length + 1, k.begin());
+      };
+
+      features.clear();
+      for (; i < sortedKeyValuePairs.size() && isSamePrefix(sortedKeyValuePairs[i].first); ++i)
+        features.push_back(base::asserted_cast<uint32_t>(sortedKeyValuePairs[i].second.m_featureId));
+
+      base::SortUnique(features);
+      if (features.size() <= PopularPrefixes::kMaxNumFeatures)
+        continue;
+
+      auto const byRank = [&getRank](uint32_t lhs, uint32_t rhs) {
+        auto const lhsRank = getRank(lhs);
+        auto const rhsRank = getRank(rhs);
+        return lhsRank != rhsRank ? lhsRank > rhsRank : lhs < rhs;
+      };
+      std::nth_element(features.begin(), features.begin() + PopularPrefixes::kMaxNumFeatures,
+                       features.end(), byRank);
+      features.resize(PopularPrefixes::kMaxNumFeatures);
+      std::sort(features.begin(), features.end());
+
+      PopularPrefixes::Entry entry;
+      entry.m_lang = static_cast<int8_t>(key[0]);
+      entry.m_prefix.assign(key.begin() + 1, key.begin() + length + 1);
+      entry.m_features = features;
+      entries.push_back(std::move(entry));
+    }
+  }
+
+  std::sort(entries.begin(), entries.end());
+  PopularPrefixes::Serialize(entries, writer);
+  LOG(LINFO, ("Popular prefixes:", entries.size()));
+}
+
+void BuildSearchIndex(FilesContainerR & container, Writer & indexWriter, Writer & prefixesWriter)
 {
   using Key = strings::UniString;
   using Value = Uint64IndexValue;
@@ -690,6 +761,8 @@ void BuildSearchIndex(FilesContainerR & container, Writer & indexWriter)
   trie::Build<Writer, Key, ValueList<Value>, SingleValueSerializer<Value>>(
       indexWriter, serializer, searchIndexKeyValuePairs);
 
+  BuildPopularPrefixes(container, searchIndexKeyValuePairs, prefixesWriter);
+
   LOG(LINFO, ("End building search index, elapsed seconds:", timer.ElapsedSeconds()));
 }
 }  // namespace indexer
@@ -0,0 +1,169 @@
+#include "generator/stage_scheduler.hpp"
+
+#include "base/assert.hpp"
+#include "base/logging.hpp"
+#include "base/thread_pool_computational.hpp"
+#include "base/timer.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+#include <utility>
+
+namespace generator
+{
+StageScheduler::StageScheduler(size_t threadsCount) : m_threadsCount(threadsCount)
+{
+  CHECK_GREATER(m_threadsCount, 0, ());
+}
+
+StageScheduler::TaskId StageScheduler::AddTask(std::string const & stage, Task && task,
+                                               std::vector<TaskId> const & dependencies,
+                                               std::vector<TaskId> const & waitFor)
+{
+  TaskId const id = m_tasks.size();
+
+  TaskInfo info;
+  auto const it = std::find(m_stages.cbegin(), m_stages.cend(), stage);
+  info.m_stage = static_cast<size_t>(std::distance(m_stages.cbegin(), it));
+  if (it == m_stages.cend())
+    m_stages.push_back(stage);
+  info.m_task = std::move(task);
+  info.m_dependenciesCount = dependencies.size() + waitFor.size();
+
+  for (auto const dependency : dependencies)
+  {
+    CHECK_LESS(dependency, id, ("Dependencies must be added before the task."));
+    m_tasks[dependency].m_dependents.push_back({id, true /* skipOnFailure */});
+  }
+  for (auto const dependency : waitFor)
+  {
+    CHECK_LESS(dependency, id, ("Dependencies must be added before the task."));
+    m_tasks[dependency].m_dependents.push_back({id, false /* skipOnFailure */});
+  }
+
+  m_tasks.push_back(std::move(info));
+  return id;
+}
+
+bool StageScheduler::Run()
+{
+  base::Timer timer;
+  std::mutex mutex;
+  std::condition_variable finishedCondition;
+  size_t finishedCount = 0;
+
+  std::vector<size_t> dependenciesLeft(m_tasks.size());
+  std::vector<bool> dependencyFailed(m_tasks.size(), false);
+  for (size_t i = 0; i < m_tasks.size(); ++i)
+  {
+    dependenciesLeft[i] = m_tasks[i].m_dependenciesCount;
+    m_tasks[i].m_state = State::Pending;
+  }
+
+  // Both functions are called under |mutex|.
+  std::function<void(TaskId)> start;
+  std::function<void(TaskId, State)> finish = [&](TaskId id, State state) {
+    m_tasks[id].m_state = state;
+    ++finishedCount;
+    for (auto const & dependent : m_tasks[id].m_dependents)
+    {
+      if (state != State::Succeeded && dependent.m_skipOnFailure)
+        dependencyFailed[dependent.m_id] = true;
+      if (--dependenciesLeft[dependent.m_id] == 0)
+        start(dependent.m_id);
+    }
+  };
+
+  base::thread_pool::computational::ThreadPool threadPool(m_threadsCount);
+  start = [&](TaskId id) {
+    if (dependencyFailed[id])
+    {
+      finish(id, State::Skipped);
+      return;
+    }
+
+    threadPool.SubmitWork([&, id]() {
+      // The task may wait in the queue of the pool, it's not counted as the running time.
+      m_tasks[id].m_startSeconds = timer.ElapsedSeconds();
+      auto state = State::Failed;
+      std::exception_ptr exception;
+      try
+      {
+        if (m_tasks[id].m_task())
+          state = State::Succeeded;
+      }
+      catch (...)
+      {
+        exception = std::current_exception();
+      }
+
+      std::lock_guard lock(mutex);
+      if (exception && !m_exception)
+        m_exception = exception;
+      m_tasks[id].m_finishSeconds = timer.ElapsedSeconds();
+      finish(id, state);
+      finishedCondition.notify_all();
+    });
+  };
+
+  {
+    std::unique_lock lock(mutex);
+    std::vector<TaskId> ready;
+    for (TaskId id = 0; id < m_tasks.size(); ++id)
+    {
+      if (dependenciesLeft[id] == 0)
+        ready.push_back(id);
+    }
+    for (auto const id : ready)
+      start(id);
+
+    finishedCondition.wait(lock, [&]() { return finishedCount == m_tasks.size(); });
+  }
+  threadPool.WaitingStop();
+
+  if (m_exception)
+    std::rethrow_exception(std::exchange(m_exception, nullptr));
+
+  return std::all_of(m_tasks.cbegin(), m_tasks.cend(),
+                     [](TaskInfo const & task) { return task.m_state == State::Succeeded; });
+}
+
+std::vector<StageScheduler::StageStats> StageScheduler::GetStats() const
+{
+  std::vector<StageStats> stats(m_stages.size());
+  std::vector<double> starts(m_stages.size(), std::numeric_limits<double>::max());
+  std::vector<double> finishes(m_stages.size(), 0.0);
+  for (size_t i = 0; i < m_stages.size(); ++i)
+    stats[i].m_stage = m_stages[i];
+
+  for (auto const & task : m_tasks)
+  {
+    if (task.m_state != State::Succeeded && task.m_state != State::Failed)
+      continue;
+
+    auto & s = stats[task.m_stage];
+    ++s.m_tasksCount;
+    s.m_totalSeconds += task.m_finishSeconds - task.m_startSeconds;
+    starts[task.m_stage] = std::min(starts[task.m_stage], task.m_startSeconds);
+    finishes[task.m_stage] = std::max(finishes[task.m_stage], task.m_finishSeconds);
+  }
+
+  for (size_t i = 0; i < stats.size(); ++i)
+  {
+    if (stats[i].m_tasksCount != 0)
+      stats[i].m_wallSeconds = finishes[i] - starts[i];
+  }
+  return stats;
+}
+
+void StageScheduler::LogStats() const
+{
+  for (auto const & s : GetStats())
+  {
+    LOG(LINFO, ("Stage", s.m_stage, "tasks:", s.m_tasksCount, "total time:", s.m_totalSeconds,
+                "s, wall time:", s.m_wallSeconds, "s"));
+  }
+}
+}  // namespace generator
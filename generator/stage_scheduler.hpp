@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace generator
+{
+// Runs tasks which depend on each other on a pool of threads. A task is started when all of its
+// dependencies have succeeded, tasks which depend on a failed task are skipped.
+// It is used to build sections of several mwms at once, sections of one mwm are written to the
+// same file and must depend on each other.
+class StageScheduler
+{
+public:
+  using TaskId = size_t;
+  // Returns false when the dependent tasks must be skipped.
+  using Task = std::function<bool()>;
+
+  struct StageStats
+  {
+    std::string m_stage;
+    size_t m_tasksCount = 0;
+    // Sum of the running times of the tasks of the stage.
+    double m_totalSeconds = 0.0;
+    // Time from the start of the first task of the stage to the end of the last one.
+    double m_wallSeconds = 0.0;
+  };
+
+  explicit StageScheduler(size_t threadsCount);
+
+  // |stage| is a name of the stage which is used in the statistics. The task is skipped if one of
+  // |dependencies| fails, |waitFor| tasks are only waited for.
+  TaskId AddTask(std::string const & stage, Task && task,
+                 std::vector<TaskId> const & dependencies = {},
+                 std::vector<TaskId> const & waitFor = {});
+
+  // Runs all the added tasks and waits for them. Returns false if some task has failed
+  // or has been skipped. An exception thrown by a task is rethrown when all the other tasks
+  // are finished.
+  bool Run();
+
+  // Returns statistics of the stages in the order of their first tasks.
+  std::vector<StageStats> GetStats() const;
+  void LogStats() const;
+
+private:
+  enum class State
+  {
+    Pending,
+    Succeeded,
+    Failed,
+    Skipped
+  };
+
+  struct Dependent
+  {
+    TaskId m_id = 0;
+    bool m_skipOnFailure = true;
+  };
+
+  struct TaskInfo
+  {
+    size_t m_stage = 0;
+    Task m_task;
+    std::vector<Dependent> m_dependents;
+    size_t m_dependenciesCount = 0;
+    State m_state = State::Pending;
+    // Times since the start of Run().
+    double m_startSeconds = 0.0;
+    double m_finishSeconds = 0.0;
+  };
+
+  size_t const m_threadsCount;
+  std::vector<std::string> m_stages;
+  std::vector<TaskInfo> m_tasks;
+  std::exception_ptr m_exception;
+};
+}  // namespace generator
@@ -0,0 +1,133 @@
+#include "indexer/address_points.hpp"
+
+#include "coding/varint.hpp"
+#include "coding/writer.hpp"
+
+#include "base/checked_cast.hpp"
+#include "base/logging.hpp"
+
+#include <tuple>
+
+using namespace std;
+
+namespace search
+{
+// AddressPoints::Header ---------------------------------------------------------------------------
+void AddressPoints::Header::Read(Reader & reader)
+{
+  NonOwningReaderSource source(reader);
+  m_version = static_cast<Version>(ReadPrimitiveFromSource<uint8_t>(source));
+  CHECK_EQUAL(static_cast<uint8_t>(m_version), static_cast<uint8_t>(Version::V0), ());
+  m_cellBits = ReadPrimitiveFromSource<uint8_t>(source);
+  m_cellsOffset = ReadPrimitiveFromSource<uint32_t>(source);
+  m_cellsSize = ReadPrimitiveFromSource<uint32_t>(source);
+  m_pointsOffset = ReadPrimitiveFromSource<uint32_t>(source);
+  m_pointsSize = ReadPrimitiveFromSource<uint32_t>(source);
+}
+
+// AddressPoints -----------------------------------------------------------------------------------
+// static
+unique_ptr<AddressPoints> AddressPoints::Load(unique_ptr<Reader> reader)
+{
+  auto points = make_unique<AddressPoints>();
+  try
+  {
+    points->m_header.Read(*reader);
+
+    auto const cellsReader =
+        reader->CreateSubReader(points->m_header.m_cellsOffset, points->m_header.m_cellsSize);
+    NonOwningReaderSource src(*cellsReader);
+    auto const numCells = ReadVarUint<uint32_t>(src);
+    points->m_cells.reserve(numCells);
+    points->m_offsets.reserve(numCells + 1);
+
+    uint64_t key = 0;
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < numCells; ++i)
+    {
+      key += ReadVarUint<uint64_t>(src);
+      points->m_cells.push_back(key);
+      points->m_offsets.push_back(offset);
+      offset += ReadVarUint<uint32_t>(src);
+    }
+    points->m_offsets.push_back(offset);
+
+    points->m_pointsReader =
+        reader->CreateSubReader(points->m_header.m_pointsOffset, points->m_header.m_pointsSize);
+    CHECK_EQUAL(points->m_pointsReader->Size(), offset * kPointSize, ());
+  }
+  catch (Reader::Exception const & e)
+  {
+    LOG(LERROR, ("Can't load address points:", e.Msg()));
+    return {};
+  }
+
+  points->m_reader = std::move(reader);
+  return points;
+}
+
+// AddressPointsBuilder ----------------------------------------------------------------------------
+AddressPointsBuilder::AddressPointsBuilder(uint8_t cellBits) : m_cellBits(cellBits)
+{
+  CHECK_LESS(m_cellBits, kPointCoordBits, ());
+}
+
+void AddressPointsBuilder::Put(uint32_t featureId, m2::PointD const & center)
+{
+  Point point;
+  point.m_featureId = featureId;
+  point.m_center = PointDToPointU(center, kPointCoordBits);
+  point.m_key = AddressPoints::MakeKey(point.m_center.x >> m_cellBits,
+                                       point.m_center.y >> m_cellBits);
+  m_points.push_back(point);
+}
+
+void AddressPointsBuilder::Freeze(Writer & writer)
+{
+  sort(m_points.begin(), m_points.end(), [](Point const & lhs, Point const & rhs) {
+    return tie(lhs.m_key, lhs.m_featureId) < tie(rhs.m_key, rhs.m_featureId);
+  });
+
+  auto const startOffset = writer.Pos();
+  AddressPoints::Header header;
+  header.m_cellBits = m_cellBits;
+  header.Serialize(writer);
+
+  header.m_cellsOffset = base::asserted_cast<uint32_t>(writer.Pos() - startOffset);
+  {
+    vector<pair<uint64_t, uint32_t>> cells;
+    for (auto const & point : m_points)
+    {
+      if (cells.empty() || cells.back().first != point.m_key)
+        cells.emplace_back(point.m_key, 0);
+      ++cells.back().second;
+    }
+
+    WriteVarUint(writer, base::asserted_cast<uint32_t>(cells.size()));
+    uint64_t prevKey = 0;
+    for (auto const & cell : cells)
+    {
+      WriteVarUint(writer, cell.first - prevKey);
+      WriteVarUint(writer, cell.second);
+      prevKey = cell.first;
+    }
+  }
+  header.m_cellsSize =
+      base::asserted_cast<uint32_t>(writer.Pos() - startOffset - header.m_cellsOffset);
+
+  header.m_pointsOffset = base::asserted_cast<uint32_t>(writer.Pos() - startOffset);
+  for (auto const & point : m_points)
+  {
+    WriteToSink(writer, point.m_featureId);
+    WriteToSink(writer, point.m_center.x);
+    WriteToSink(writer, point.m_center.y);
+  }
+  header.m_pointsSize =
+      base::asserted_cast<uint32_t>(writer.Pos() - startOffset - header.m_pointsOffset);
+
+  auto const endOffset = writer.Pos();
+  writer.Seek(startOffset);
+  header.Serialize(writer);
+  writer.Seek(endOffset);
+}
+}  // namespace search
@@ -0,0 +1,150 @@
+#pragma once
+
+#include "coding/point_coding.hpp"
+#include "coding/reader.hpp"
+#include "coding/write_to_sink.hpp"
+
+#include "geometry/point2d.hpp"
+#include "geometry/rect2d.hpp"
+
+#include "base/assert.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+class Writer;
+
+namespace search
+{
+// A spatial index of the features with house numbers (address points) used by the
+// reverse geocoder. Points are bucketed into cells of a fixed grid over the whole world
+// and stored as (feature id, center) triples sorted by cell, row by row, so the points of
+// consecutive cells of a row are contiguous and a row of a lookup rect is read at once.
+// Only the list of non-empty cells is kept in memory, points are read on demand.
+class AddressPoints
+{
+public:
+  enum class Version : uint8_t
+  {
+    V0 = 0,
+    Latest = V0
+  };
+
+  struct Header
+  {
+    template <typename Sink>
+    void Serialize(Sink & sink) const
+    {
+      CHECK_EQUAL(static_cast<uint8_t>(m_version), static_cast<uint8_t>(Version::V0), ());
+      WriteToSink(sink, static_cast<uint8_t>(m_version));
+      WriteToSink(sink, m_cellBits);
+      WriteToSink(sink, m_cellsOffset);
+      WriteToSink(sink, m_cellsSize);
+      WriteToSink(sink, m_pointsOffset);
+      WriteToSink(sink, m_pointsSize);
+    }
+
+    void Read(Reader & reader);
+
+    Version m_version = Version::Latest;
+    // Cells are squares of (1 << m_cellBits) units of the kPointCoordBits grid.
+    uint8_t m_cellBits = 0;
+    // All offsets are relative to the start of the section (offset of header is zero).
+    uint32_t m_cellsOffset = 0;
+    uint32_t m_cellsSize = 0;
+    uint32_t m_pointsOffset = 0;
+    uint32_t m_pointsSize = 0;
+  };
+
+  // About 300 meters at the equator.
+  static uint8_t constexpr kDefaultCellBits = 13;
+
+  // Loads the index from |reader| which is kept till destruction.
+  // Returns nullptr if the index can't be loaded.
+  static std::unique_ptr<AddressPoints> Load(std::unique_ptr<Reader> reader);
+
+  // Calls |fn(featureId, center)| for every point inside |rect|.
+  template <typename Fn>
+  void ForEachInRect(m2::RectD const & rect, Fn && fn) const
+  {
+    auto const minCell = GetCell(PointDToPointU(rect.LeftBottom(), kPointCoordBits));
+    auto const maxCell = GetCell(PointDToPointU(rect.RightTop(), kPointCoordBits));
+    for (auto y = minCell.y; y <= maxCell.y; ++y)
+    {
+      auto const begin = std::lower_bound(m_cells.begin(), m_cells.end(), MakeKey(minCell.x, y));
+      auto const end = std::upper_bound(begin, m_cells.end(), MakeKey(maxCell.x, y));
+      if (begin == end)
+        continue;
+
+      ReadPoints(m_offsets[begin - m_cells.begin()], m_offsets[end - m_cells.begin()],
+                 [&](uint32_t featureId, m2::PointD const & center) {
+                   if (rect.IsPointInside(center))
+                     fn(featureId, center);
+                 });
+    }
+  }
+
+  size_t GetNumPoints() const { return m_offsets.empty() ? 0 : m_offsets.back(); }
+
+private:
+  friend class AddressPointsBuilder;
+
+  // Size of a serialized point: feature id and two coordinates.
+  static size_t constexpr kPointSize = 3 * sizeof(uint32_t);
+
+  static uint64_t MakeKey(uint32_t x, uint32_t y) { return (static_cast<uint64_t>(y) << 32) | x; }
+
+  m2::PointU GetCell(m2::PointU const & p) const
+  {
+    return {p.x >> m_header.m_cellBits, p.y >> m_header.m_cellBits};
+  }
+
+  template <typename Fn>
+  void ReadPoints(uint32_t begin, uint32_t end, Fn && fn) const
+  {
+    std::vector<uint8_t> buffer((end - begin) * kPointSize);
+    m_pointsReader->Read(begin * kPointSize, buffer.data(), buffer.size());
+
+    MemReader reader(buffer.data(), buffer.size());
+    NonOwningReaderSource src(reader);
+    for (auto i = begin; i < end; ++i)
+    {
+      auto const featureId = ReadPrimitiveFromSource<uint32_t>(src);
+      auto const x = ReadPrimitiveFromSource<uint32_t>(src);
+      auto const y = ReadPrimitiveFromSource<uint32_t>(src);
+      fn(featureId, PointUToPointD(m2::PointU(x, y), kPointCoordBits));
+    }
+  }
+
+  Header m_header;
+  // Sorted keys of non-empty cells.
+  std::vector<uint64_t> m_cells;
+  // Index of the first point of each cell in |m_cells| followed by the number of points.
+  std::vector<uint32_t> m_offsets;
+  std::unique_ptr<Reader> m_reader;
+  std::unique_ptr<Reader> m_pointsReader;
+};
+
+class AddressPointsBuilder
+{
+public:
+  explicit AddressPointsBuilder(uint8_t cellBits = AddressPoints::kDefaultCellBits);
+
+  void Put(uint32_t featureId, m2::PointD const & center);
+  void Freeze(Writer & writer);
+
+private:
+  struct Point
+  {
+    uint64_t m_key = 0;
+    uint32_t m_featureId = 0;
+    m2::PointU m_center;
+  };
+
+  uint8_t const m_cellBits;
+  std::vector<Point> m_points;
+};
+}  // namespace search
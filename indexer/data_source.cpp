@@ -1,9 +1,12 @@
 #include "indexer/data_source.hpp"
+#include "indexer/feature_arena.hpp"
 #include "indexer/scale_index.hpp"
 #include "indexer/unique_index.hpp"
 
 #include "platform/mwm_version.hpp"
 
+#include "base/scope_guard.hpp"
+
 #include <algorithm>
 #include <limits>
 
@@ -79,9 +82,12 @@ private:
   DataSource::StopSearchCallback m_stop;
 };
 
-void ReadFeatureType(std::function<void(FeatureType &)> const & fn, FeatureSource & src, uint32_t index)
+// Features are decoded into |arena|, which is reset after every |fn| call, so the same
+// FeatureType object and its buffers are reused for all features of the reading.
+void ReadFeatureType(std::function<void(FeatureType &)> const & fn, FeatureSource & src,
+                     uint32_t index, FeatureArena & arena)
 {
-  std::unique_ptr<FeatureType> ft;
+  FeatureType * ft = nullptr;
   switch (src.GetFeatureStatus(index))
   {
   case FeatureStatus::Deleted:
@@ -89,16 +95,19 @@ void ReadFeatureType(std::function<void(FeatureType &)> const & fn, FeatureSourc
   case FeatureStatus::Created:
   case FeatureStatus::Modified:
   {
-    ft = src.GetModifiedFeature(index);
+    auto modified = src.GetModifiedFeature(index);
+    CHECK(modified, ());
+    ft = &arena.Adopt(std::move(modified));
     break;
   }
   case FeatureStatus::Untouched:
   {
-    ft = src.GetOriginalFeature(index);
+    ft = &src.GetOriginalFeature(index, arena);
     break;
   }
   }
   CHECK(ft, ());
+  SCOPE_GUARD(resetArena, [&arena]() { arena.Reset(); });
   fn(*ft);
 }
 }  //  namespace
@@ -142,6 +151,20 @@ std::unique_ptr<FeatureType> FeaturesLoaderGuard::GetFeatureByIndex(uint32_t ind
   return GetOriginalFeatureByIndex(index);
 }
 
+FeatureType * FeaturesLoaderGuard::GetFeatureByIndex(uint32_t index, FeatureArena & arena) const
+{
+  if (!m_handle.IsAlive())
+    return nullptr;
+
+  ASSERT_NOT_EQUAL(FeatureStatus::Deleted, m_source->GetFeatureStatus(index),
+                   ("Deleted feature was cached. It should not be here. Please review your code."));
+
+  if (auto ft = m_source->GetModifiedFeature(index))
+    return &arena.Adopt(std::move(ft));
+
+  return &m_source->GetOriginalFeature(index, arena);
+}
+
 std::unique_ptr<FeatureType> FeaturesLoaderGuard::GetOriginalFeatureByIndex(uint32_t index) const
 {
   return m_handle.IsAlive() ? m_source->GetOriginalFeature(index) : nullptr;
@@ -150,7 +173,7 @@ std::unique_ptr<FeatureType> FeaturesLoaderGuard::GetOriginalFeatureByIndex(uint
 // DataSource ----------------------------------------------------------------------------------
 std::unique_ptr<MwmInfo> DataSource::CreateInfo(platform::LocalCountryFile const & localFile) const
 {
-  MwmValue value(localFile);
+  MwmValue value(localFile, GetReaderMode());
 
   feature::DataHeader const & h = value.GetHeader();
 
@@ -168,8 +191,8 @@ std::unique_ptr<MwmInfo> DataSource::CreateInfo(platform::LocalCountryFile const
 
 std::unique_ptr<MwmValue> DataSource::CreateValue(MwmInfo & info) const
 {
-  platform::LocalCountryFile const & localFile = info.GetLocalFile();
-  auto p = std::make_unique<MwmValue>(localFile);
+  platform::LocalCountryFile const localFile = info.GetLocalFile();
+  auto p = std::make_unique<MwmValue>(localFile, GetReaderMode());
 
   p->SetTable(dynamic_cast<MwmInfoEx &>(info));
 
@@ -232,8 +255,9 @@ void DataSource::ForEachFeatureIDInRect(FeatureIdCallback const & f, m2::RectD c
 
 void DataSource::ForEachInRect(FeatureCallback const & f, m2::RectD const & rect, int scale) const
 {
-  auto readFeatureType = [&f](uint32_t index, FeatureSource & src) {
-    ReadFeatureType(f, src, index);
+  FeatureArena arena;
+  auto readFeatureType = [&f, &arena](uint32_t index, FeatureSource & src) {
+    ReadFeatureType(f, src, index, arena);
   };
 
   ReadMWMFunctor readFunctor(*m_factory, readFeatureType);
@@ -245,8 +269,9 @@ void DataSource::ForClosestToPoint(FeatureCallback const & f, StopSearchCallback
 {
   auto const rect = mercator::RectByCenterXYAndSizeInMeters(center, sizeM);
 
-  auto readFeatureType = [&f](uint32_t index, FeatureSource & src) {
-    ReadFeatureType(f, src, index);
+  FeatureArena arena;
+  auto readFeatureType = [&f, &arena](uint32_t index, FeatureSource & src) {
+    ReadFeatureType(f, src, index, arena);
   };
   ReadMWMFunctor readFunctor(*m_factory, readFeatureType, stop);
   ForEachInIntervals(readFunctor, covering::CoveringMode::Spiral, rect, scale);
@@ -254,8 +279,9 @@ void DataSource::ForClosestToPoint(FeatureCallback const & f, StopSearchCallback
 
 void DataSource::ForEachInScale(FeatureCallback const & f, int scale) const
 {
-  auto readFeatureType = [&f](uint32_t index, FeatureSource & src) {
-    ReadFeatureType(f, src, index);
+  FeatureArena arena;
+  auto readFeatureType = [&f, &arena](uint32_t index, FeatureSource & src) {
+    ReadFeatureType(f, src, index, arena);
   };
 
   ReadMWMFunctor readFunctor(*m_factory, readFeatureType);
@@ -269,8 +295,9 @@ void DataSource::ForEachInRectForMWM(FeatureCallback const & f, m2::RectD const
   if (handle.IsAlive())
   {
     covering::CoveringGetter cov(rect, covering::ViewportWithLowLevels);
-    auto readFeatureType = [&f](uint32_t index, FeatureSource & src) {
-      ReadFeatureType(f, src, index);
+    FeatureArena arena;
+    auto readFeatureType = [&f, &arena](uint32_t index, FeatureSource & src) {
+      ReadFeatureType(f, src, index, arena);
     };
 
     ReadMWMFunctor readFunctor(*m_factory, readFeatureType);
@@ -282,6 +309,8 @@ void DataSource::ReadFeatures(FeatureCallback const & fn, std::vector<FeatureID>
 {
   ASSERT(is_sorted(features.begin(), features.end()), ());
 
+  // One feature object (with its buffers) is reused for all features of the tile.
+  FeatureArena arena;
   auto fidIter = features.begin();
   auto const endIter = features.end();
   while (fidIter != endIter)
@@ -298,13 +327,19 @@ void DataSource::ReadFeatures(FeatureCallback const & fn, std::vector<FeatureID>
         ASSERT_NOT_EQUAL(
             FeatureStatus::Deleted, fts,
             ("Deleted feature was cached. It should not be here. Please review your code."));
-        std::unique_ptr<FeatureType> ft;
+        FeatureType * ft = nullptr;
         if (fts == FeatureStatus::Modified || fts == FeatureStatus::Created)
-          ft = src->GetModifiedFeature(fidIter->m_index);
+        {
+          if (auto modified = src->GetModifiedFeature(fidIter->m_index))
+            ft = &arena.Adopt(std::move(modified));
+        }
         else
-          ft = src->GetOriginalFeature(fidIter->m_index);
+        {
+          ft = &src->GetOriginalFeature(fidIter->m_index, arena);
+        }
 
         CHECK(ft, ());
+        SCOPE_GUARD(resetArena, [&arena]() { arena.Reset(); });
         fn(*ft);
       } while (++fidIter != endIter && id == fidIter->m_mwmId);
     }
@@ -104,6 +104,8 @@ public:
   std::unique_ptr<FeatureType> GetOriginalOrEditedFeatureByIndex(uint32_t index) const;
   /// Everyone, except Editor core, should use this method.
   std::unique_ptr<FeatureType> GetFeatureByIndex(uint32_t index) const;
+  /// The same as above, but the feature is owned by |arena| and is valid until arena.Reset().
+  FeatureType * GetFeatureByIndex(uint32_t index, FeatureArena & arena) const;
   size_t GetNumFeatures() const { return m_source->GetNumFeatures(); }
 
 private:
@@ -198,6 +198,35 @@ FeatureType::FeatureType(SharedLoadInfo const * loadInfo, vector<uint8_t> && buf
   m_header = Header(m_data); // Parse the header and optional name/layer/addinfo.
 }
 
+void FeatureType::Reset(SharedLoadInfo const * loadInfo,
+                        indexer::MetadataDeserializer * metadataDeserializer)
+{
+  CHECK(loadInfo, ());
+
+  m_loadInfo = loadInfo;
+  m_metadataDeserializer = metadataDeserializer;
+
+  m_types = {};
+  m_id = FeatureID();
+  m_params.MakeZero();
+  m_center = m2::PointD();
+  m_limitRect = m2::RectD();
+
+  // clear() keeps the heap storage of buffer_vector, so big geometry is decoded without
+  // reallocations after the first use of the feature object.
+  m_points.clear();
+  m_triangles.clear();
+  m_metadata.Clear();
+  m_metaIds.clear();
+
+  m_parsed.Reset();
+  m_offsets.Reset();
+  m_ptsSimpMask = 0;
+  m_innerStats = InnerGeomStat();
+
+  m_header = Header(m_data);
+}
+
 std::unique_ptr<FeatureType> FeatureType::CreateFromMapObject(osm::MapObject const & emo)
 {
   auto ft = std::unique_ptr<FeatureType>(new FeatureType());
@@ -224,6 +224,13 @@ private:
     }
   };
 
+  friend class FeatureArena;
+
+  // Prepares the feature, which is reused by FeatureArena, for the new record in |m_data|.
+  // Keeps allocated memory of the record and geometry buffers.
+  void Reset(feature::SharedLoadInfo const * loadInfo,
+             indexer::MetadataDeserializer * metadataDeserializer);
+
   void ParseTypes();
   void ParseCommon();
   void ParseMetadata();
@@ -0,0 +1,56 @@
+#include "indexer/feature_arena.hpp"
+
+#include "base/assert.hpp"
+
+#include <utility>
+
+FeatureType & FeatureArena::Adopt(std::unique_ptr<FeatureType> && ft)
+{
+  CHECK(ft, ());
+  m_adopted.push_back(std::move(ft));
+  return *m_adopted.back();
+}
+
+void FeatureArena::Reset()
+{
+  for (size_t i = 0; i < m_used; ++i)
+  {
+    auto const & before = m_capacities[i];
+    auto const after = GetCapacities(*m_features[i]);
+    m_allocations += (after.m_data > before.m_data ? 1 : 0) +
+                     (after.m_points > before.m_points ? 1 : 0) +
+                     (after.m_triangles > before.m_triangles ? 1 : 0);
+  }
+
+  m_used = 0;
+  m_adopted.clear();
+}
+
+// static
+uint64_t FeatureArena::GetAllocationsCount(FeatureType const & ft)
+{
+  // A new feature has empty record buffer and geometry buffers of the static size.
+  Capacities const empty = GetCapacities(FeatureType());
+  auto const capacities = GetCapacities(ft);
+  return 1 /* feature object */ + (capacities.m_data > empty.m_data ? 1 : 0) +
+         (capacities.m_points > empty.m_points ? 1 : 0) +
+         (capacities.m_triangles > empty.m_triangles ? 1 : 0);
+}
+
+// static
+FeatureArena::Capacities FeatureArena::GetCapacities(FeatureType const & ft)
+{
+  return {ft.m_data.capacity(), ft.m_points.capacity(), ft.m_triangles.capacity()};
+}
+
+FeatureType & FeatureArena::Allocate()
+{
+  if (m_used == m_features.size())
+  {
+    m_features.emplace_back(new FeatureType());
+    m_capacities.emplace_back();
+    ++m_allocations;
+  }
+  m_capacities[m_used] = GetCapacities(*m_features[m_used]);
+  return *m_features[m_used++];
+}
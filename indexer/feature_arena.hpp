@@ -0,0 +1,72 @@
+#pragma once
+
+#include "indexer/feature.hpp"
+
+#include "base/macros.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/// Owns decoded features and reuses them, with their record and geometry buffers, after Reset().
+/// One arena per tile or per query removes the heap allocations which are made for every
+/// feature otherwise. Features are valid until the next Reset() or the arena destruction.
+/// Note! This class is NOT Thread-Safe.
+class FeatureArena
+{
+public:
+  FeatureArena() = default;
+
+  /// Returns the feature for the record which is read by |readRecord(std::vector<uint8_t> &)|.
+  template <typename ReadRecordFn>
+  FeatureType & Create(feature::SharedLoadInfo const * loadInfo,
+                       indexer::MetadataDeserializer * metadataDeserializer,
+                       ReadRecordFn && readRecord)
+  {
+    FeatureType & ft = Allocate();
+    readRecord(ft.m_data);
+    ft.Reset(loadInfo, metadataDeserializer);
+    return ft;
+  }
+
+  /// Keeps the feature created outside of the arena (e.g. an edited one) until Reset().
+  FeatureType & Adopt(std::unique_ptr<FeatureType> && ft);
+
+  /// Makes all features of the arena available for reuse.
+  void Reset();
+
+  /// Number of features handed out since the last Reset().
+  size_t GetUsedCount() const { return m_used + m_adopted.size(); }
+  /// Number of reusable feature objects owned by the arena.
+  size_t GetCapacity() const { return m_features.size(); }
+
+  /// Heap allocations made by the arena since its creation: feature objects and growths of their
+  /// record and geometry buffers. Buffers are checked on Reset(), so one growth is counted for
+  /// several reallocations of a buffer while a feature is decoded.
+  uint64_t GetAllocationsCount() const { return m_allocations; }
+  /// Allocations of the same kinds which are made by |ft| decoded without an arena.
+  static uint64_t GetAllocationsCount(FeatureType const & ft);
+
+private:
+  struct Capacities
+  {
+    size_t m_data = 0;
+    size_t m_points = 0;
+    size_t m_triangles = 0;
+  };
+
+  static Capacities GetCapacities(FeatureType const & ft);
+
+  FeatureType & Allocate();
+
+  std::vector<std::unique_ptr<FeatureType>> m_features;
+  // Capacities of the buffers of |m_features| when they were handed out.
+  std::vector<Capacities> m_capacities;
+  size_t m_used = 0;
+  uint64_t m_allocations = 0;
+
+  std::vector<std::unique_ptr<FeatureType>> m_adopted;
+
+  DISALLOW_COPY_AND_MOVE(FeatureArena);
+};
@@ -41,6 +41,15 @@ std::unique_ptr<FeatureType> FeatureSource::GetOriginalFeature(uint32_t index) c
   return ft;
 }
 
+FeatureType & FeatureSource::GetOriginalFeature(uint32_t index, FeatureArena & arena) const
+{
+  ASSERT(m_handle.IsAlive(), ());
+  ASSERT(m_vector, ());
+  auto & ft = m_vector->GetByIndex(index, arena);
+  ft.SetID({ GetMwmId(), index });
+  return ft;
+}
+
 FeatureStatus FeatureSource::GetFeatureStatus(uint32_t index) const
 {
   return FeatureStatus::Untouched;
@@ -34,6 +34,7 @@ public:
   size_t GetNumFeatures() const;
 
   std::unique_ptr<FeatureType> GetOriginalFeature(uint32_t index) const;
+  FeatureType & GetOriginalFeature(uint32_t index, FeatureArena & arena) const;
 
   MwmSet::MwmId const & GetMwmId() const { return m_handle.GetId(); }
 
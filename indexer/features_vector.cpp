@@ -32,6 +32,15 @@ std::unique_ptr<FeatureType> FeaturesVector::GetByIndex(uint32_t index) const
   return std::make_unique<FeatureType>(&m_loadInfo, m_recordReader->ReadRecord(ftOffset), m_metaDeserializer);
 }
 
+FeatureType & FeaturesVector::GetByIndex(uint32_t index, FeatureArena & arena) const
+{
+  auto const ftOffset = m_table ? m_table->GetFeatureOffset(index) : index;
+  return arena.Create(&m_loadInfo, m_metaDeserializer, [&](std::vector<uint8_t> & buffer)
+  {
+    m_recordReader->ReadRecord(ftOffset, buffer);
+  });
+}
+
 size_t FeaturesVector::GetNumFeatures() const
 {
   return m_table ? m_table->size() : 0;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "indexer/feature.hpp"
+#include "indexer/feature_arena.hpp"
 #include "indexer/metadata_serdes.hpp"
 #include "indexer/shared_load_info.hpp"
 
@@ -24,6 +25,8 @@ public:
                  indexer::MetadataDeserializer * metaDeserializer);
 
   std::unique_ptr<FeatureType> GetByIndex(uint32_t index) const;
+  /// Decodes the feature into the object owned by |arena|, see FeatureArena.
+  FeatureType & GetByIndex(uint32_t index, FeatureArena & arena) const;
 
   size_t GetNumFeatures() const;
 
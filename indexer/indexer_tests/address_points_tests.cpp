@@ -0,0 +1,94 @@
+#include "testing/testing.hpp"
+
+#include "indexer/address_points.hpp"
+
+#include "coding/point_coding.hpp"
+#include "coding/reader.hpp"
+#include "coding/writer.hpp"
+
+#include "geometry/mercator.hpp"
+#include "geometry/point2d.hpp"
+#include "geometry/rect2d.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace address_points_tests
+{
+using namespace search;
+using namespace std;
+
+using Buffer = vector<uint8_t>;
+
+unique_ptr<AddressPoints> Build(vector<m2::PointD> const & points, uint8_t cellBits,
+                                Buffer & buffer)
+{
+  AddressPointsBuilder builder(cellBits);
+  for (size_t i = 0; i < points.size(); ++i)
+    builder.Put(static_cast<uint32_t>(i), points[i]);
+
+  MemWriter<Buffer> writer(buffer);
+  builder.Freeze(writer);
+  return AddressPoints::Load(make_unique<MemReader>(buffer.data(), buffer.size()));
+}
+
+vector<uint32_t> GetInRect(AddressPoints const & index, m2::RectD const & rect)
+{
+  vector<uint32_t> ids;
+  index.ForEachInRect(rect, [&](uint32_t id, m2::PointD const & center) {
+    TEST(rect.IsPointInside(center), (id, center));
+    ids.push_back(id);
+  });
+  sort(ids.begin(), ids.end());
+  return ids;
+}
+
+UNIT_TEST(AddressPoints_Empty)
+{
+  Buffer buffer;
+  auto const index = Build({}, AddressPoints::kDefaultCellBits, buffer);
+  TEST(index, ());
+  TEST_EQUAL(index->GetNumPoints(), 0, ());
+  TEST(GetInRect(*index, m2::RectD(-10, -10, 10, 10)).empty(), ());
+}
+
+UNIT_TEST(AddressPoints_Smoke)
+{
+  mt19937 rng(0);
+  uniform_real_distribution<double> coord(-0.05, 0.05);
+
+  vector<m2::PointD> points;
+  for (size_t i = 0; i < 2000; ++i)
+    points.emplace_back(coord(rng), coord(rng));
+
+  for (uint8_t const cellBits : {uint8_t(8), AddressPoints::kDefaultCellBits, uint8_t(20)})
+  {
+    Buffer buffer;
+    auto const index = Build(points, cellBits, buffer);
+    TEST(index, ());
+    TEST_EQUAL(index->GetNumPoints(), points.size(), ());
+
+    for (size_t i = 0; i < 100; ++i)
+    {
+      auto const center = m2::PointD(coord(rng), coord(rng));
+      auto const rect = mercator::RectByCenterXYAndSizeInMeters(center, 500 /* sizeInMeters */);
+
+      vector<uint32_t> expected;
+      for (size_t j = 0; j < points.size(); ++j)
+      {
+        // Points are stored with kPointCoordBits precision.
+        auto const stored =
+            PointUToPointD(PointDToPointU(points[j], kPointCoordBits), kPointCoordBits);
+        if (rect.IsPointInside(stored))
+          expected.push_back(static_cast<uint32_t>(j));
+      }
+
+      TEST_EQUAL(GetInRect(*index, rect), expected, (cellBits, rect));
+    }
+  }
+}
+}  // namespace address_points_tests
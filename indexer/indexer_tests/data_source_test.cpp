@@ -5,7 +5,10 @@
 #include "indexer/feature_source.hpp"
 #include "indexer/mwm_set.hpp"
 
+#include "coding/file_writer.hpp"
+#include "coding/files_container.hpp"
 #include "coding/internal/file_data.hpp"
+#include "coding/reader.hpp"
 
 #include "platform/country_file.hpp"
 #include "platform/local_country_file.hpp"
@@ -19,6 +22,9 @@
 
 #include <algorithm>
 #include <string>
+#include <vector>
+
+#include "defines.hpp"
 
 namespace data_source_test
 {
@@ -154,4 +160,51 @@ UNIT_CLASS_TEST(DataSourceTest, StatusNotifications)
     TEST(CheckExpectations(), ());
   }
 }
+
+UNIT_TEST(DataSource_SharedCacheReadsUpdatedFile)
+{
+  std::string const mapsDir = GetPlatform().WritableDir();
+  CountryFile const country("minsk-pass-shared-cache");
+  LocalCountryFile const file(mapsDir, country, 0 /* version */);
+  std::string const path = file.GetPath(MapFileType::Map);
+
+  TEST(base::CopyFileX(base::JoinPath(mapsDir, "minsk-pass" DATA_FILE_EXTENSION), path), ());
+  SCOPE_GUARD(removeFile, [&path]() { base::DeleteFileX(path); });
+
+  FrozenDataSource dataSource;
+  dataSource.SetReaderMode(MapReaderMode::SharedCache);
+
+  auto const readSection = [&dataSource, &country]()
+  {
+    auto const handle = dataSource.GetMwmHandleByCountryFile(country);
+    TEST(handle.IsAlive(), ());
+    auto reader = handle.GetValue()->m_cont.GetReader(SEARCH_INDEX_FILE_TAG);
+    std::vector<uint8_t> data(static_cast<size_t>(reader.Size()));
+    reader.Read(0, data.data(), data.size());
+    return data;
+  };
+
+  TEST_EQUAL(dataSource.RegisterMap(file).second, MwmSet::RegResult::Success, ());
+  auto const oldData = readSection();
+  TEST(!oldData.empty(), ());
+
+  // Updates the section in place, the size of the file is not changed.
+  TEST(dataSource.DeregisterMap(country), ());
+  uint64_t offset = 0;
+  {
+    FilesContainerR const cont(path);
+    offset = cont.GetAbsoluteOffsetAndSize(SEARCH_INDEX_FILE_TAG).first;
+  }
+  std::vector<uint8_t> newData(oldData.size());
+  for (size_t i = 0; i < newData.size(); ++i)
+    newData[i] = static_cast<uint8_t>(~oldData[i]);
+  {
+    FileWriter writer(path, FileWriter::OP_WRITE_EXISTING);
+    writer.Seek(offset);
+    writer.Write(newData.data(), newData.size());
+  }
+
+  TEST_EQUAL(dataSource.RegisterMap(file).second, MwmSet::RegResult::Success, ());
+  TEST(readSection() == newData, ());
+}
 }  // namespace data_source_test
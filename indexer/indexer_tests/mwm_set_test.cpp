@@ -8,7 +8,9 @@
 #include "base/macros.hpp"
 
 #include <initializer_list>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 namespace mwm_set_test
 {
@@ -169,4 +171,66 @@ UNIT_TEST(MwmSetLockAndIdTest)
   TEST(!handle.GetId().IsAlive(), ());
   TEST(!handle.GetId().GetInfo().get(), ());
 }
+
+// Hammers handle acquisition from several threads, while one of mwms is deregistered.
+UNIT_TEST(MwmSetConcurrentHandlesTest)
+{
+  ScopedMwm mwm0("0.mwm");
+  ScopedMwm mwm1("1.mwm");
+  ScopedMwm mwm2("2.mwm");
+  ScopedMwm mwm3("3.mwm");
+
+  TestMwmSet mwmSet;
+  vector<MwmSet::MwmId> ids;
+  for (auto const & name : {"0", "1", "2", "3"})
+  {
+    auto const p = mwmSet.Register(LocalCountryFile::MakeForTesting(name));
+    TEST_EQUAL(p.second, MwmSet::RegResult::Success, (name));
+    ids.push_back(p.first);
+  }
+
+  size_t const kThreadsCount = 8;
+  size_t const kIterations = 20000;
+  vector<size_t> errors(kThreadsCount, 0);
+  vector<thread> threads;
+
+  for (size_t t = 0; t < kThreadsCount; ++t)
+  {
+    threads.emplace_back([&, t]()
+    {
+      for (size_t i = 0; i < kIterations; ++i)
+      {
+        auto const & id = ids[(t + i) % ids.size()];
+        MwmSet::MwmHandle const handle = mwmSet.GetMwmHandleById(id);
+        // Only mwm 3 may be deregistered concurrently.
+        if (!handle.IsAlive() && id != ids.back())
+          ++errors[t];
+        if (handle.IsAlive() && handle.GetValue()->GetCountryFileName() != id.GetInfo()->GetCountryName())
+          ++errors[t];
+      }
+    });
+  }
+
+  // Files of the same version are replaced while values are created from them.
+  for (size_t i = 0; i < 100; ++i)
+  {
+    TEST_EQUAL(mwmSet.Register(LocalCountryFile::MakeForTesting("0")).second,
+               MwmSet::RegResult::VersionAlreadyExists, ());
+  }
+  mwmSet.Deregister(CountryFile("3"));
+
+  for (auto & thread : threads)
+    thread.join();
+
+  for (size_t t = 0; t < kThreadsCount; ++t)
+    TEST_EQUAL(errors[t], 0, (t));
+
+  for (auto const & id : ids)
+    TEST_EQUAL(id.GetInfo()->GetNumRefs(), 0, (id));
+
+  // The last handle of mwm 3 has completed its deregistration.
+  TEST_EQUAL(ids.back().GetInfo()->GetStatus(), MwmInfo::STATUS_DEREGISTERED, ());
+  TEST(!mwmSet.GetMwmHandleById(ids.back()).IsAlive(), ());
+  TEST(mwmSet.GetMwmHandleById(ids.front()).IsAlive(), ());
+}
 }  // namespace mwm_set_test
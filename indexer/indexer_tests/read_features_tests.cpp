@@ -2,6 +2,7 @@
 
 #include "indexer/classificator_loader.hpp"
 #include "indexer/data_source.hpp"
+#include "indexer/feature_arena.hpp"
 
 #include "platform/local_country_file.hpp"
 
@@ -35,3 +36,44 @@ UNIT_TEST(ReadFeatures_Smoke)
     ft1->ForEachType([](auto const /* t */) {});
   }
 }
+
+UNIT_TEST(ReadFeatures_Arena)
+{
+  classificator::Load();
+
+  FrozenDataSource dataSource;
+  auto const res = dataSource.RegisterMap(platform::LocalCountryFile::MakeForTesting("minsk-pass"));
+  CHECK_EQUAL(res.second, MwmSet::RegResult::Success, ());
+
+  FeaturesLoaderGuard const guard(dataSource, res.first);
+  FeatureArena arena;
+  uint64_t heapAllocations = 0;
+  for (uint32_t i = 0; i + 1 < guard.GetNumFeatures(); ++i)
+  {
+    // Two features are alive at the same time, as in the test above.
+    arena.Reset();
+    auto * ft1 = guard.GetFeatureByIndex(i, arena);
+    auto * ft2 = guard.GetFeatureByIndex(i + 1, arena);
+    TEST(ft1 && ft2, ());
+    TEST_EQUAL(ft1->GetID(), FeatureID(res.first, i), ());
+    TEST_EQUAL(ft2->GetID(), FeatureID(res.first, i + 1), ());
+
+    auto expected = guard.GetFeatureByIndex(i);
+    TEST_EQUAL(expected->GetTypesCount(), ft1->GetTypesCount(), ());
+    TEST_EQUAL(expected->GetNames(), ft1->GetNames(), ());
+    TEST_EQUAL(expected->GetLimitRect(FeatureType::BEST_GEOMETRY),
+               ft1->GetLimitRect(FeatureType::BEST_GEOMETRY), ());
+    TEST_EQUAL(expected->GetPointsCount(), ft1->GetPointsCount(), ());
+    TEST_EQUAL(expected->GetTrgVerticesCount(FeatureType::BEST_GEOMETRY),
+               ft1->GetTrgVerticesCount(FeatureType::BEST_GEOMETRY), ());
+    heapAllocations += FeatureArena::GetAllocationsCount(*expected);
+  }
+
+  // Feature objects are reused after Reset().
+  TEST_EQUAL(arena.GetCapacity(), 2, ());
+
+  // Reused buffers are reallocated for the biggest features only.
+  arena.Reset();
+  TEST_GREATER_OR_EQUAL(arena.GetAllocationsCount(), 2, ());
+  TEST_LESS(arena.GetAllocationsCount() * 10, heapAllocations, ());
+}
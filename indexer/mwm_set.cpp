@@ -4,13 +4,13 @@
 #include "indexer/scales.hpp"
 
 #include "coding/reader.hpp"
+#include "coding/shared_page_cache.hpp"
 
 #include "platform/local_country_file_utils.hpp"
 
 #include "base/assert.hpp"
 #include "base/exception.hpp"
 #include "base/logging.hpp"
-#include "base/stl_helpers.hpp"
 
 #include <algorithm>
 #include <exception>
@@ -21,8 +21,63 @@ using namespace std;
 using platform::CountryFile;
 using platform::LocalCountryFile;
 
+namespace
+{
+// Pages of a deregistered or replaced file must not be read by the readers of a new file
+// which has the same path and size.
+void DropSharedPages(LocalCountryFile const & localFile)
+{
+  SharedPageCache::Instance().DropFile(localFile.GetPath(MapFileType::Map));
+}
+}  // namespace
+
 MwmInfo::MwmInfo() : m_minScale(0), m_maxScale(0), m_status(STATUS_DEREGISTERED), m_numRefs(0) {}
 
+bool MwmInfo::TryAddRef()
+{
+  uint32_t numRefs = m_numRefs.load();
+  do
+  {
+    if (numRefs & kDeregisterFlag)
+      return false;
+    CHECK_LESS(numRefs, kNumRefsMask, ());
+  } while (!m_numRefs.compare_exchange_weak(numRefs, numRefs + 1));
+  return true;
+}
+
+uint32_t MwmInfo::ReleaseRef()
+{
+  uint32_t const numRefs = m_numRefs.fetch_sub(1);
+  ASSERT_GREATER(numRefs & kNumRefsMask, 0, ());
+  return (numRefs - 1) & kNumRefsMask;
+}
+
+LocalCountryFile MwmInfo::GetLocalFile() const
+{
+  lock_guard<mutex> lock(m_fileMutex);
+  return m_file;
+}
+
+void MwmInfo::SetLocalFile(LocalCountryFile const & localFile)
+{
+  lock_guard<mutex> lock(m_fileMutex);
+  if (m_countryName.empty())
+  {
+    m_countryName = localFile.GetCountryName();
+    m_fileVersion = localFile.GetVersion();
+  }
+  ASSERT_EQUAL(m_countryName, localFile.GetCountryName(), ());
+  ASSERT_EQUAL(m_fileVersion, localFile.GetVersion(), ());
+  m_file = localFile;
+}
+
+bool MwmInfo::TryLockForDeregister()
+{
+  uint32_t numRefs = 0;
+  return m_numRefs.compare_exchange_strong(numRefs, kDeregisterFlag) ||
+         numRefs == kDeregisterFlag;
+}
+
 MwmInfo::MwmTypeT MwmInfo::GetType() const
 {
   if (m_minScale > 0)
@@ -124,7 +179,10 @@ pair<MwmSet::MwmId, MwmSet::RegResult> MwmSet::Register(LocalCountryFile const &
     {
       LOG(LINFO, ("Updating already registered mwm:", name));
       SetStatus(*info, MwmInfo::STATUS_REGISTERED, events);
-      info->m_file = localFile;
+      // The file may be replaced by a new one of the same version.
+      ClearCache(id);
+      DropSharedPages(info->GetLocalFile());
+      info->SetLocalFile(localFile);
       result = make_pair(id, RegResult::VersionAlreadyExists);
       return;
     }
@@ -147,7 +205,7 @@ pair<MwmSet::MwmId, MwmSet::RegResult> MwmSet::RegisterImpl(LocalCountryFile con
   if (!info)
     return make_pair(MwmId(), RegResult::UnsupportedFileFormat);
 
-  info->m_file = localFile;
+  info->SetLocalFile(localFile);
   SetStatus(*info, MwmInfo::STATUS_REGISTERED, events);
   m_info[localFile.GetCountryName()].push_back(info);
 
@@ -160,24 +218,20 @@ bool MwmSet::DeregisterImpl(MwmId const & id, EventList & events)
     return false;
 
   shared_ptr<MwmInfo> const & info = id.GetInfo();
-  if (info->m_numRefs == 0)
+  if (!info->TryLockForDeregister())
   {
-    SetStatus(*info, MwmInfo::STATUS_DEREGISTERED, events);
-    vector<shared_ptr<MwmInfo>> & infos = m_info[info->GetCountryName()];
-    infos.erase(remove(infos.begin(), infos.end(), info), infos.end());
-    for (auto it = m_cache.begin(); it != m_cache.end(); ++it)
-    {
-      if (it->first == id)
-      {
-        m_cache.erase(it);
-        break;
-      }
-    }
-    return true;
+    SetStatus(*info, MwmInfo::STATUS_MARKED_TO_DEREGISTER, events);
+    // The last handle may be released concurrently before the mark is visible for it.
+    if (!info->TryLockForDeregister())
+      return false;
   }
 
-  SetStatus(*info, MwmInfo::STATUS_MARKED_TO_DEREGISTER, events);
-  return false;
+  SetStatus(*info, MwmInfo::STATUS_DEREGISTERED, events);
+  vector<shared_ptr<MwmInfo>> & infos = m_info[info->GetCountryName()];
+  infos.erase(remove(infos.begin(), infos.end(), info), infos.end());
+  ClearCache(id);
+  DropSharedPages(info->GetLocalFile());
+  return true;
 }
 
 bool MwmSet::Deregister(CountryFile const & countryFile)
@@ -195,9 +249,7 @@ bool MwmSet::DeregisterImpl(CountryFile const & countryFile, EventList & events)
   MwmId const id = GetMwmIdByCountryFileImpl(countryFile);
   if (!id.IsAlive())
     return false;
-  bool const deregistered = DeregisterImpl(id, events);
-  ClearCache(id);
-  return deregistered;
+  return DeregisterImpl(id, events);
 }
 
 bool MwmSet::IsLoaded(CountryFile const & countryFile) const
@@ -256,37 +308,21 @@ void MwmSet::ProcessEventList(EventList & events)
 }
 
 unique_ptr<MwmValue> MwmSet::LockValue(MwmId const & id)
-{
-  unique_ptr<MwmValue> result;
-  WithEventLog([&](EventList & events)
-               {
-                 result = LockValueImpl(id, events);
-               });
-  return result;
-}
-
-unique_ptr<MwmValue> MwmSet::LockValueImpl(MwmId const & id, EventList & events)
 {
   if (!id.IsAlive())
     return nullptr;
-  shared_ptr<MwmInfo> info = id.GetInfo();
+  shared_ptr<MwmInfo> const & info = id.GetInfo();
 
   // It's better to return valid "value pointer" even for "out-of-date" files,
   // because they can be locked for a long time by other algos.
-  //if (!info->IsUpToDate())
-  //  return TMwmValuePtr();
-
-  ++info->m_numRefs;
+  if (!info->TryAddRef())
+    return nullptr;
 
-  // Search in cache.
-  for (auto it = m_cache.begin(); it != m_cache.end(); ++it)
+  unique_ptr<MwmValue> result = GetCacheShard(id).Pop(id);
+  if (result)
   {
-    if (it->first == id)
-    {
-      unique_ptr<MwmValue> result = std::move(it->second);
-      m_cache.erase(it);
-      return result;
-    }
+    --m_cacheTotalSize;
+    return result;
   }
 
   try
@@ -296,28 +332,20 @@ unique_ptr<MwmValue> MwmSet::LockValueImpl(MwmId const & id, EventList & events)
   catch (Reader::TooManyFilesException const & ex)
   {
     LOG(LERROR, ("Too many open files, can't open:", info->GetCountryName()));
-    --info->m_numRefs;
+    info->ReleaseRef();
     return nullptr;
   }
   catch (exception const & ex)
   {
     LOG(LERROR, ("Can't create MWMValue for", info->GetCountryName(), "Reason", ex.what()));
 
-    --info->m_numRefs;
-    DeregisterImpl(id, events);
+    info->ReleaseRef();
+    WithEventLog([&](EventList & events) { DeregisterImpl(id, events); });
     return nullptr;
   }
 }
 
 void MwmSet::UnlockValue(MwmId const & id, unique_ptr<MwmValue> p)
-{
-  WithEventLog([&](EventList & events)
-               {
-                 UnlockValueImpl(id, std::move(p), events);
-               });
-}
-
-void MwmSet::UnlockValueImpl(MwmId const & id, unique_ptr<MwmValue> p, EventList & events)
 {
   ASSERT(id.IsAlive(), (id));
   ASSERT(p.get() != nullptr, ());
@@ -325,22 +353,40 @@ void MwmSet::UnlockValueImpl(MwmId const & id, unique_ptr<MwmValue> p, EventList
     return;
 
   shared_ptr<MwmInfo> const & info = id.GetInfo();
-  ASSERT_GREATER(info->m_numRefs, 0, ());
-  --info->m_numRefs;
-  if (info->m_numRefs == 0 && info->GetStatus() == MwmInfo::STATUS_MARKED_TO_DEREGISTER)
-    VERIFY(DeregisterImpl(id, events), ());
-
-  if (info->IsUpToDate())
+  if (info->ReleaseRef() == 0 && info->GetStatus() == MwmInfo::STATUS_MARKED_TO_DEREGISTER)
   {
-    /// @todo Probably, it's better to store only "unique by id" free caches here.
-    /// But it's no obvious if we have many threads working with the single mwm.
+    // The value keeps the file opened, so it's closed before observers are notified that
+    // the mwm is deregistered and its file may be deleted. Such a value is not cached anyway.
+    p.reset();
+    WithEventLog([&](EventList & events)
+                 {
+                   // Mwm may be already deregistered or locked again by another thread.
+                   if (id.IsAlive() && info->GetStatus() == MwmInfo::STATUS_MARKED_TO_DEREGISTER)
+                     DeregisterImpl(id, events);
+                 });
+    return;
+  }
+
+  /// @todo Probably, it's better to store only "unique by id" free caches here.
+  /// But it's no obvious if we have many threads working with the single mwm.
+  CacheShard & shard = GetCacheShard(id);
+  if (shard.Push(id, std::move(p)) == 0)
+    return;
+
+  if (++m_cacheTotalSize <= m_cacheSize)
+    return;
 
-    m_cache.push_back(make_pair(id, std::move(p)));
-    if (m_cache.size() > m_cacheSize)
+  // Evict the oldest value of the current shard, or of the other ones in round robin order,
+  // so the total cache size stays bounded by |m_cacheSize|.
+  LOG(LDEBUG, ("MwmValue max cache size reached! Added", id));
+  size_t const start = m_cacheEvictShard++;
+  for (size_t i = 0; i <= kCacheShardsCount; ++i)
+  {
+    CacheShard & victim = i == 0 ? shard : m_cacheShards[(start + i) % kCacheShardsCount];
+    if (victim.PopOldest())
     {
-      LOG(LDEBUG, ("MwmValue max cache size reached! Added", id, "removed", m_cache.front().first));
-      ASSERT_EQUAL(m_cache.size(), m_cacheSize + 1, ());
-      m_cache.pop_front();
+      --m_cacheTotalSize;
+      return;
     }
   }
 }
@@ -348,14 +394,21 @@ void MwmSet::UnlockValueImpl(MwmId const & id, unique_ptr<MwmValue> p, EventList
 void MwmSet::Clear()
 {
   lock_guard<mutex> lock(m_lock);
-  ClearCacheImpl(m_cache.begin(), m_cache.end());
+  ClearCacheImpl();
   m_info.clear();
 }
 
 void MwmSet::ClearCache()
 {
   lock_guard<mutex> lock(m_lock);
-  ClearCacheImpl(m_cache.begin(), m_cache.end());
+  ClearCacheImpl();
+}
+
+void MwmSet::SetReaderMode(MapReaderMode mode)
+{
+  lock_guard<mutex> lock(m_lock);
+  m_readerMode = mode;
+  ClearCacheImpl();
 }
 
 MwmSet::MwmId MwmSet::GetMwmIdByCountryFile(CountryFile const & countryFile) const
@@ -366,53 +419,91 @@ MwmSet::MwmId MwmSet::GetMwmIdByCountryFile(CountryFile const & countryFile) con
 
 MwmSet::MwmHandle MwmSet::GetMwmHandleByCountryFile(CountryFile const & countryFile)
 {
-  MwmSet::MwmHandle handle;
-  WithEventLog([&](EventList & events)
-               {
-                 handle = GetMwmHandleByIdImpl(GetMwmIdByCountryFileImpl(countryFile), events);
-               });
-  return handle;
+  return GetMwmHandleById(GetMwmIdByCountryFile(countryFile));
 }
 
 MwmSet::MwmHandle MwmSet::GetMwmHandleById(MwmId const & id)
 {
-  MwmSet::MwmHandle handle;
-  WithEventLog([&](EventList & events)
-               {
-                 handle = GetMwmHandleByIdImpl(id, events);
-               });
-  return handle;
+  return MwmHandle(*this, id, LockValue(id));
 }
 
-MwmSet::MwmHandle MwmSet::GetMwmHandleByIdImpl(MwmId const & id, EventList & events)
+void MwmSet::ClearCacheImpl()
 {
-  unique_ptr<MwmValue> value;
-  if (id.IsAlive())
-    value = LockValueImpl(id, events);
-  return MwmHandle(*this, id, std::move(value));
+  for (auto & shard : m_cacheShards)
+    m_cacheTotalSize -= shard.Clear();
 }
 
-void MwmSet::ClearCacheImpl(Cache::iterator beg, Cache::iterator end) { m_cache.erase(beg, end); }
-
 void MwmSet::ClearCache(MwmId const & id)
 {
-  auto sameId = [&id](pair<MwmSet::MwmId, unique_ptr<MwmValue>> const & p)
+  m_cacheTotalSize -= GetCacheShard(id).Clear(id);
+}
+
+// MwmSet::CacheShard ------------------------------------------------------------------------------
+
+unique_ptr<MwmValue> MwmSet::CacheShard::Pop(MwmId const & id)
+{
+  lock_guard<mutex> lock(m_mutex);
+  for (auto it = m_cache.begin(); it != m_cache.end(); ++it)
   {
-    return (p.first == id);
-  };
-  ClearCacheImpl(base::RemoveIfKeepValid(m_cache.begin(), m_cache.end(), sameId), m_cache.end());
+    if (it->first == id)
+    {
+      unique_ptr<MwmValue> result = std::move(it->second);
+      m_cache.erase(it);
+      return result;
+    }
+  }
+  return nullptr;
+}
+
+size_t MwmSet::CacheShard::Push(MwmId const & id, unique_ptr<MwmValue> && p)
+{
+  lock_guard<mutex> lock(m_mutex);
+  // Status is checked under the shard lock, so a concurrent deregistration either
+  // sees the value in the shard or prevents it from being cached.
+  if (!id.GetInfo()->IsUpToDate())
+    return 0;
+  m_cache.emplace_back(id, std::move(p));
+  return m_cache.size();
+}
+
+bool MwmSet::CacheShard::PopOldest()
+{
+  lock_guard<mutex> lock(m_mutex);
+  if (m_cache.empty())
+    return false;
+  m_cache.pop_front();
+  return true;
+}
+
+size_t MwmSet::CacheShard::Clear(MwmId const & id)
+{
+  lock_guard<mutex> lock(m_mutex);
+  size_t const size = m_cache.size();
+  m_cache.erase(remove_if(m_cache.begin(), m_cache.end(),
+                          [&id](pair<MwmId, unique_ptr<MwmValue>> const & p) { return p.first == id; }),
+                m_cache.end());
+  return size - m_cache.size();
+}
+
+size_t MwmSet::CacheShard::Clear()
+{
+  lock_guard<mutex> lock(m_mutex);
+  size_t const size = m_cache.size();
+  m_cache.clear();
+  return size;
 }
 
 // MwmValue ----------------------------------------------------------------------------------------
 
-MwmValue::MwmValue(LocalCountryFile const & localFile)
-  : m_cont(platform::GetCountryReader(localFile, MapFileType::Map)), m_file(localFile)
+MwmValue::MwmValue(LocalCountryFile const & localFile, MapReaderMode readerMode)
+  : m_cont(platform::GetCountryReader(localFile, MapFileType::Map, readerMode)), m_file(localFile)
 {
   m_factory.Load(m_cont);
 }
 
 void MwmValue::SetTable(MwmInfoEx & info)
 {
+  lock_guard<mutex> lock(info.m_tableMutex);
   m_table = info.m_table.lock();
   if (m_table)
     return;
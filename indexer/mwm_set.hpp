@@ -1,7 +1,9 @@
 #pragma once
+#include "indexer/address_points.hpp"
 #include "indexer/data_factory.hpp"
 #include "indexer/house_to_street_iface.hpp"
 
+#include "platform/country_defines.hpp"
 #include "platform/local_country_file.hpp"
 #include "platform/mwm_version.hpp"
 
@@ -12,6 +14,7 @@
 
 #include "defines.hpp"
 
+#include <array>
 #include <atomic>
 #include <deque>
 #include <map>
@@ -63,32 +66,56 @@ public:
 
   bool IsRegistered() const { return m_status == STATUS_REGISTERED; }
 
-  platform::LocalCountryFile const & GetLocalFile() const { return m_file; }
+  /// Returns a copy because the file may be replaced concurrently by a file of the same version,
+  /// see MwmSet::Register().
+  platform::LocalCountryFile GetLocalFile() const;
 
-  std::string const & GetCountryName() const { return m_file.GetCountryName(); }
+  /// Country name and version are the same for all the files of the mwm.
+  std::string const & GetCountryName() const { return m_countryName; }
 
-  int64_t GetVersion() const { return m_file.GetVersion(); }
+  int64_t GetVersion() const { return m_fileVersion; }
 
   MwmTypeT GetType() const;
 
   feature::RegionData const & GetRegionData() const { return m_data; }
 
   /// Returns the lock counter value for test needs.
-  uint8_t GetNumRefs() const { return m_numRefs; }
+  uint8_t GetNumRefs() const { return static_cast<uint8_t>(m_numRefs & kNumRefsMask); }
 
 protected:
   Status SetStatus(Status status)
   {
-    Status result = m_status;
-    m_status = status;
-    return result;
+    return m_status.exchange(status);
   }
 
+  /// Increments the number of active handles.
+  /// @return false if the mwm is being deregistered and can't be locked.
+  bool TryAddRef();
+  /// Decrements the number of active handles, returns the new value.
+  uint32_t ReleaseRef();
+  /// Forbids new handles when there are no active ones.
+  /// @return false if there are active handles.
+  bool TryLockForDeregister();
+
+  /// Must be called under MwmSet::m_lock.
+  void SetLocalFile(platform::LocalCountryFile const & localFile);
+
   feature::RegionData m_data;
 
-  platform::LocalCountryFile m_file;  ///< Path to the mwm file.
   std::atomic<Status> m_status;       ///< Current country status.
-  uint32_t m_numRefs;                 ///< Number of active handles.
+
+private:
+  /// Guards |m_file| which is read when values are created, outside of MwmSet::m_lock.
+  mutable std::mutex m_fileMutex;
+  platform::LocalCountryFile m_file;  ///< Path to the mwm file.
+  std::string m_countryName;
+  int64_t m_fileVersion = 0;
+
+  static uint32_t constexpr kDeregisterFlag = 1U << 31;
+  static uint32_t constexpr kNumRefsMask = kDeregisterFlag - 1;
+
+  /// Number of active handles and kDeregisterFlag, modified without MwmSet::m_lock.
+  std::atomic<uint32_t> m_numRefs;
 };
 
 class MwmInfoEx : public MwmInfo
@@ -102,10 +129,10 @@ private:
   // MwmSet's cache. We can't use shared_ptr because of offsets table
   // must be removed as soon as the last corresponding MwmValue is
   // destroyed. Also, note that this value must be used and modified
-  // only in MwmValue::SetTable() method, which, in turn, is called
-  // only in the MwmSet critical section, protected by a lock.  So,
-  // there's an implicit synchronization on this field.
+  // only in MwmValue::SetTable() method under |m_tableMutex|, because
+  // values are created concurrently, outside of the MwmSet lock.
   std::weak_ptr<feature::FeaturesOffsetsTable> m_table;
+  std::mutex m_tableMutex;
 };
 
 class MwmValue;
@@ -295,6 +322,11 @@ public:
 
   void ClearCache();
 
+  /// Sets the backend for mwm readers, see MapReaderMode. Cached values are dropped,
+  /// so the mode takes effect for all handles acquired after the call.
+  void SetReaderMode(MapReaderMode mode);
+  MapReaderMode GetReaderMode() const { return m_readerMode; }
+
   MwmId GetMwmIdByCountryFile(platform::CountryFile const & countryFile) const;
 
   MwmHandle GetMwmHandleByCountryFile(platform::CountryFile const & countryFile);
@@ -340,23 +372,44 @@ private:
   // Triggers observers on each event in |events|.
   void ProcessEventList(EventList & events);
 
-  /// @precondition This function is always called under mutex m_lock.
-  MwmHandle GetMwmHandleByIdImpl(MwmId const & id, EventList & events);
-
+  // Handles are acquired and released without |m_lock|: MwmInfo keeps an atomic
+  // counter of active handles and unlocked values are cached in shards by MwmId.
+  // |m_lock| is taken only to create or deregister mwms.
   std::unique_ptr<MwmValue> LockValue(MwmId const & id);
-  std::unique_ptr<MwmValue> LockValueImpl(MwmId const & id, EventList & events);
   void UnlockValue(MwmId const & id, std::unique_ptr<MwmValue> p);
-  void UnlockValueImpl(MwmId const & id, std::unique_ptr<MwmValue> p, EventList & events);
 
-  /// Do the cleaning for [beg, end) without acquiring the mutex.
-  /// @precondition This function is always called under mutex m_lock.
-  void ClearCacheImpl(Cache::iterator beg, Cache::iterator end);
+  class CacheShard
+  {
+  public:
+    std::unique_ptr<MwmValue> Pop(MwmId const & id);
+    /// Caches |p| if mwm |id| is up to date, returns the new shard size.
+    size_t Push(MwmId const & id, std::unique_ptr<MwmValue> && p);
+    /// Removes the least recently used value, returns false if the shard is empty.
+    bool PopOldest();
+    /// Clear methods return the number of removed values.
+    size_t Clear(MwmId const & id);
+    size_t Clear();
+
+  private:
+    std::mutex m_mutex;
+    Cache m_cache;
+  };
+
+  static size_t constexpr kCacheShardsCount = 16;
 
-  Cache m_cache;
+  CacheShard & GetCacheShard(MwmId const & id)
+  {
+    return m_cacheShards[std::hash<std::shared_ptr<MwmInfo>>()(id.GetInfo()) % kCacheShardsCount];
+  }
+
+  void ClearCacheImpl();
+
+  std::array<CacheShard, kCacheShardsCount> m_cacheShards;
+  std::atomic<size_t> m_cacheTotalSize{0};
+  std::atomic<size_t> m_cacheEvictShard{0};
   size_t const m_cacheSize;
 
 protected:
-  /// @precondition This function is always called under mutex m_lock.
   void ClearCache(MwmId const & id);
 
   /// Find mwm with a given name.
@@ -368,6 +421,8 @@ protected:
   mutable std::mutex m_lock;
 
 private:
+  std::atomic<MapReaderMode> m_readerMode{MapReaderMode::Cached};
+
   base::ObserverListSafe<Observer> m_observers;
 }; // class MwmSet
 
@@ -381,8 +436,10 @@ public:
   std::shared_ptr<feature::FeaturesOffsetsTable> m_table;
   std::unique_ptr<indexer::MetadataDeserializer> m_metaDeserializer;
   std::unique_ptr<HouseToStreetTable> m_house2street, m_house2place;
+  std::unique_ptr<search::AddressPoints> m_addressPoints;
 
-  explicit MwmValue(platform::LocalCountryFile const & localFile);
+  explicit MwmValue(platform::LocalCountryFile const & localFile,
+                    MapReaderMode readerMode = MapReaderMode::Cached);
   void SetTable(MwmInfoEx & info);
 
   feature::DataHeader const & GetHeader() const  { return m_factory.GetHeader(); }
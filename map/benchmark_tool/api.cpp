@@ -34,6 +34,21 @@ void Result::CalcMetrics()
     m_all = -1.0;
 }
 
+void DecodingResult::Print(string const & name) const
+{
+  if (m_features == 0)
+  {
+    cout << "No features" << endl;
+    return;
+  }
+
+  cout << fixed << setprecision(2);
+  cout << "DECODING[ mode:" << name << " features:" << m_features
+       << " features/sec:" << (m_seconds > 0.0 ? m_features / m_seconds : 0.0)
+       << " allocations/feature:" << static_cast<double>(m_allocations) / m_features << " ]"
+       << endl;
+}
+
 void AllResult::Print()
 {
   //m_reading.PrintAllTimes();
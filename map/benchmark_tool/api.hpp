@@ -1,5 +1,7 @@
 #pragma once
 
+#include "platform/country_defines.hpp"
+
 #include <string>
 #include <utility>
 #include <vector>
@@ -43,6 +45,25 @@ namespace bench
     double m_all = 0.0;
   };
 
+  class DecodingResult
+  {
+  public:
+    void Print(std::string const & name) const;
+
+    size_t m_features = 0;
+    uint64_t m_allocations = 0;
+    double m_seconds = 0.0;
+  };
+
   /// @param[in] count number of times to run benchmark
-  void RunFeaturesLoadingBenchmark(std::string filePath, std::pair<int, int> scaleR, AllResult & res);
+  void RunFeaturesLoadingBenchmark(std::string filePath, std::pair<int, int> scaleR,
+                                   MapReaderMode readerMode, AllResult & res);
+
+  /// Decodes all features of the mwm one by one with the best geometry.
+  /// @param[in] useArena decode features into a reusable FeatureArena instead of
+  ///            allocating a new FeatureType for every feature.
+  /// Allocations of feature objects and of their record and geometry buffers are counted,
+  /// see FeatureArena::GetAllocationsCount().
+  void RunFeaturesDecodingBenchmark(std::string filePath, MapReaderMode readerMode, bool useArena,
+                                    DecodingResult & res);
 }  // namespace bench
@@ -2,6 +2,8 @@
 
 #include "map/features_fetcher.hpp"
 
+#include "indexer/data_source.hpp"
+#include "indexer/feature_arena.hpp"
 #include "indexer/feature_visibility.hpp"
 #include "indexer/scales.hpp"
 
@@ -11,6 +13,7 @@
 #include "base/macros.hpp"
 #include "base/timer.hpp"
 
+#include <cstdint>
 #include <utility>
 #include <vector>
 
@@ -99,12 +102,59 @@ namespace
   }
 }
 
-void RunFeaturesLoadingBenchmark(string fileName, pair<int, int> scaleRange, AllResult & res)
+void RunFeaturesDecodingBenchmark(string fileName, MapReaderMode readerMode, bool useArena,
+                                  DecodingResult & res)
 {
   base::GetNameFromFullPath(fileName);
   base::GetNameWithoutExt(fileName);
 
   FeaturesFetcher src;
+  src.GetDataSource().SetReaderMode(readerMode);
+  auto const r = src.RegisterMap(platform::LocalCountryFile::MakeForTesting(std::move(fileName)));
+  if (r.second != MwmSet::RegResult::Success)
+    return;
+
+  auto const decode = [](FeatureType & ft)
+  {
+    ft.ForEachType([](uint32_t) {});
+    UNUSED_VALUE(ft.GetNames());
+    UNUSED_VALUE(ft.IsEmptyGeometry(FeatureType::BEST_GEOMETRY));
+  };
+
+  FeaturesLoaderGuard const guard(src.GetDataSource(), r.first);
+  FeatureArena arena;
+  auto const count = static_cast<uint32_t>(guard.GetNumFeatures());
+
+  uint64_t heapAllocations = 0;
+  base::Timer timer;
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    if (useArena)
+    {
+      arena.Reset();
+      decode(*guard.GetFeatureByIndex(i, arena));
+    }
+    else
+    {
+      auto ft = guard.GetFeatureByIndex(i);
+      decode(*ft);
+      heapAllocations += FeatureArena::GetAllocationsCount(*ft);
+    }
+  }
+  res.m_seconds = timer.ElapsedSeconds();
+  arena.Reset();
+  res.m_allocations = useArena ? arena.GetAllocationsCount() : heapAllocations;
+  res.m_features = count;
+}
+
+void RunFeaturesLoadingBenchmark(string fileName, pair<int, int> scaleRange,
+                                 MapReaderMode readerMode, AllResult & res)
+{
+  base::GetNameFromFullPath(fileName);
+  base::GetNameWithoutExt(fileName);
+
+  FeaturesFetcher src;
+  src.GetDataSource().SetReaderMode(readerMode);
   auto const r = src.RegisterMap(platform::LocalCountryFile::MakeForTesting(std::move(fileName)));
   if (r.second != MwmSet::RegResult::Success)
     return;
@@ -3,8 +3,16 @@
 #include "indexer/classificator_loader.hpp"
 #include "indexer/data_header.hpp"
 
+#include "coding/shared_page_cache.hpp"
+
+#include "std/target_os.hpp"
+
 #include <iostream>
 
+#ifndef OMIM_OS_WINDOWS
+#include <sys/resource.h>
+#endif
+
 #include <gflags/gflags.h>
 
 using namespace std;
@@ -13,6 +21,41 @@ DEFINE_string(input, "", "MWM file name in the data directory");
 DEFINE_int32(lowS, 10, "Low processing scale");
 DEFINE_int32(highS, 17, "High processing scale");
 DEFINE_bool(print_scales, false, "Print geometry scales for MWM and exit");
+DEFINE_string(reader_mode, "cached", "MWM reader backend: cached, shared or mmap");
+DEFINE_bool(decoding, false, "Decode all features one by one with and without FeatureArena");
+
+namespace
+{
+bool ParseReaderMode(std::string const & s, MapReaderMode & mode)
+{
+  if (s == "cached")
+    mode = MapReaderMode::Cached;
+  else if (s == "shared")
+    mode = MapReaderMode::SharedCache;
+  else if (s == "mmap")
+    mode = MapReaderMode::Mmap;
+  else
+    return false;
+  return true;
+}
+
+// Peak resident set size in kilobytes.
+long GetMaxRssKb()
+{
+#ifndef OMIM_OS_WINDOWS
+  rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0)
+  {
+#ifdef OMIM_OS_MAC
+    return usage.ru_maxrss / 1024;  // Bytes on Mac OS X.
+#else
+    return usage.ru_maxrss;
+#endif
+  }
+#endif
+  return -1;
+}
+}  // namespace
 
 int main(int argc, char ** argv)
 {
@@ -41,10 +84,32 @@ int main(int argc, char ** argv)
   {
     using namespace bench;
 
+    MapReaderMode readerMode;
+    if (!ParseReaderMode(FLAGS_reader_mode, readerMode))
+    {
+      cerr << "Unknown reader mode: " << FLAGS_reader_mode << endl;
+      return -1;
+    }
+
+    if (FLAGS_decoding)
+    {
+      for (bool const useArena : {false, true})
+      {
+        DecodingResult res;
+        RunFeaturesDecodingBenchmark(FLAGS_input, readerMode, useArena, res);
+        res.Print(useArena ? "arena" : "heap");
+      }
+      return 0;
+    }
+
     AllResult res;
-    RunFeaturesLoadingBenchmark(FLAGS_input, make_pair(FLAGS_lowS, FLAGS_highS), res);
+    RunFeaturesLoadingBenchmark(FLAGS_input, make_pair(FLAGS_lowS, FLAGS_highS), readerMode, res);
 
+    cout << "READER[ mode:" << DebugPrint(readerMode) << " maxRssKb:" << GetMaxRssKb() << " ] ";
     res.Print();
+
+    if (readerMode == MapReaderMode::SharedCache)
+      cout << DebugPrint(SharedPageCache::Instance().GetStats()) << endl;
   }
 
   return 0;
@@ -12,3 +12,14 @@ std::string DebugPrint(MapFileType type)
   }
   UNREACHABLE();
 }
+
+std::string DebugPrint(MapReaderMode mode)
+{
+  switch (mode)
+  {
+  case MapReaderMode::Cached: return "Cached";
+  case MapReaderMode::SharedCache: return "SharedCache";
+  case MapReaderMode::Mmap: return "Mmap";
+  }
+  UNREACHABLE();
+}
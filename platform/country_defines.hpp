@@ -13,8 +13,20 @@ enum class MapFileType : uint8_t
   Count
 };
 
+// Backend which is used to read map files.
+enum class MapReaderMode : uint8_t
+{
+  // FileReader with a private page cache per reader.
+  Cached,
+  // FileReader with the process-wide SharedPageCache, pages are shared between readers.
+  SharedCache,
+  // MmapReader, pages are shared through the OS page cache and reads are lock-free.
+  Mmap
+};
+
 using MwmCounter = uint32_t;
 using MwmSize = uint64_t;
 using LocalAndRemoteSize = std::pair<MwmSize, MwmSize>;
 
 std::string DebugPrint(MapFileType type);
+std::string DebugPrint(MapReaderMode mode);
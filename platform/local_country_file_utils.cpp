@@ -5,8 +5,11 @@
 #include "platform/platform.hpp"
 #include "platform/settings.hpp"
 
+#include "coding/file_reader.hpp"
 #include "coding/internal/file_data.hpp"
+#include "coding/mmap_reader.hpp"
 #include "coding/reader.hpp"
+#include "coding/shared_page_cache.hpp"
 
 #include "base/assert.hpp"
 #include "base/file_name_utils.hpp"
@@ -14,6 +17,8 @@
 #include "base/stl_helpers.hpp"
 #include "base/string_utils.hpp"
 
+#include "std/target_os.hpp"
+
 #include <algorithm>
 #include <cctype>
 #include <memory>
@@ -331,13 +336,29 @@ string GetFileDownloadPath(int64_t version, string const & dataDir, string const
   return GetFilePath(version, dataDir, countryName, type) + READY_FILE_EXTENSION;
 }
 
-unique_ptr<ModelReader> GetCountryReader(LocalCountryFile const & file, MapFileType type)
+unique_ptr<ModelReader> GetCountryReader(LocalCountryFile const & file, MapFileType type,
+                                         MapReaderMode mode)
 {
   Platform & platform = GetPlatform();
   if (file.IsInBundle())
+  {
+    // Bundled files may be packed into the application archive, use the platform reader.
     return platform.GetReader(file.GetFileName(type), GetAdditionalWorldScope());
-  else
-    return platform.GetReader(file.GetPath(type), "f");
+  }
+
+  switch (mode)
+  {
+  case MapReaderMode::Cached: break;
+  case MapReaderMode::SharedCache:
+    return make_unique<FileReader>(file.GetPath(type), SharedPageCache::Instance());
+  case MapReaderMode::Mmap:
+#ifndef OMIM_OS_WINDOWS
+    return make_unique<MmapReader>(file.GetPath(type), MmapReader::Advice::Random);
+#else
+    break;
+#endif
+  }
+  return platform.GetReader(file.GetPath(type), "f");
 }
 
 // static
@@ -90,7 +90,8 @@ inline std::string GetFileDownloadPath(int64_t version, std::string const & mwmN
 }
 /// @}
 
-std::unique_ptr<ModelReader> GetCountryReader(LocalCountryFile const & file, MapFileType type);
+std::unique_ptr<ModelReader> GetCountryReader(LocalCountryFile const & file, MapFileType type,
+                                              MapReaderMode mode = MapReaderMode::Cached);
 
 /// An API for managing country indexes.
 /// Not used now (except tests), but will be usefull for the Terrain index in future.
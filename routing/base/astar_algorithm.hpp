@@ -8,11 +8,15 @@
 #include "base/assert.hpp"
 #include "base/cancellable.hpp"
 #include "base/logging.hpp"
+#include "base/thread.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <exception>
 #include <functional>
 #include <iostream>
 #include <map>
+#include <mutex>
 #include <optional>
 #include <queue>
 #include <type_traits>
@@ -87,6 +91,10 @@ public:
     // Used for AdjustRoute.
     base::Cancellable const & m_cancellable;
     std::function<bool(Weight, Weight)> m_badReducedWeight = [](Weight, Weight) { return true; };
+    // Used for FindPathBidirectional. If set, the backward wave is propagated over this graph on
+    // a separate thread, see FindPathBidirectionalParallel. The graph must not share any mutable
+    // state (e.g. geometry caches) with |m_graph|.
+    Graph * m_backwardGraph = nullptr;
   };
 
   // |LengthChecker| callback used to check path length from start/finish to the edge (including the
@@ -214,6 +222,9 @@ public:
   template <class P>
   Result FindPathBidirectional(P & params, RoutingResult<Vertex, Weight> & result) const
   {
+    if (params.m_backwardGraph)
+      return FindPathBidirectionalParallel(params, result);
+
     return FindPathBidirectionalEx(params, [&result](RoutingResult<Vertex, Weight> && res)
     {
       // Fetch first (best) route and stop.
@@ -222,6 +233,15 @@ public:
     });
   }
 
+  /// Propagates forward and backward waves concurrently: the forward one on the calling thread
+  /// over |params.m_graph| and the backward one on a worker thread over |params.m_backwardGraph|.
+  /// The waves share only the best meeting point and the top distances of their queues,
+  /// so the result is as good as the one of FindPathBidirectional.
+  /// |params.m_onVisitedVertexCallback| is called for the forward wave only, other callbacks
+  /// of |params| must be thread-safe.
+  template <class P>
+  Result FindPathBidirectionalParallel(P & params, RoutingResult<Vertex, Weight> & result) const;
+
   // Adjust route to the previous one.
   // Expects |params.m_checkLengthCallback| to check wave propagation limit.
   template <typename P>
@@ -383,6 +403,41 @@ private:
     Weight pS;
   };
 
+  // Wave of FindPathBidirectionalParallel. |bestDistance| and |parent| are written by the owner
+  // thread only, under |mutex|, and are read by the other wave under |mutex|.
+  struct ParallelStepContext : public BidirectionalStepContext
+  {
+    using BidirectionalStepContext::BidirectionalStepContext;
+
+    std::mutex mutex;
+  };
+
+  // The best meeting point of the parallel waves and their progress.
+  struct ParallelMeeting
+  {
+    ParallelMeeting(Vertex const & startVertex, Vertex const & finalVertex)
+      : forwardVertex(startVertex), backwardVertex(finalVertex)
+    {
+    }
+
+    std::mutex mutex;
+    std::atomic<bool> stop{false};
+
+    bool cancelled = false;
+    bool foundAnyPath = false;
+    Weight bestPathReducedLength = kZeroDistance;
+    Weight bestPathRealLength = kZeroDistance;
+    Vertex forwardVertex;
+    Vertex backwardVertex;
+    // Distances of the queue tops of the forward and backward waves. They only grow, so stale
+    // values make the stop condition more strict, not less.
+    Weight topDistance[2] = {kZeroDistance, kZeroDistance};
+  };
+
+  template <class P>
+  void PropagateParallelWave(P & params, ParallelStepContext & cur, ParallelStepContext & nxt,
+                             ParallelMeeting & meeting) const;
+
   static void ReconstructPath(Vertex const & v,
                               typename BidirectionalStepContext::Parents const & parent,
                               std::vector<Vertex> & path);
@@ -737,6 +792,199 @@ AStarAlgorithm<Vertex, Edge, Weight>::FindPathBidirectionalEx(P & params, Emitte
   return Result::NoPath;
 }
 
+template <typename Vertex, typename Edge, typename Weight>
+template <class P>
+typename AStarAlgorithm<Vertex, Edge, Weight>::Result
+AStarAlgorithm<Vertex, Edge, Weight>::FindPathBidirectionalParallel(
+    P & params, RoutingResult<Vertex, Weight> & result) const
+{
+  CHECK(params.m_backwardGraph, ());
+  CHECK_NOT_EQUAL(&params.m_graph, params.m_backwardGraph, ("Waves can't share a graph."));
+
+  auto const & finalVertex = params.m_finalVertex;
+  auto const & startVertex = params.m_startVertex;
+
+  ParallelStepContext forward(true /* forward */, startVertex, finalVertex, params.m_graph);
+  ParallelStepContext backward(false /* forward */, startVertex, finalVertex,
+                               *params.m_backwardGraph);
+
+  // Graphs expect parents of both waves, though each graph reads the parents of its own wave.
+  params.m_graph.SetAStarParents(false /* forward */, backward.GetParents());
+  params.m_backwardGraph->SetAStarParents(true /* forward */, forward.GetParents());
+
+  forward.UpdateDistance(State(startVertex, kZeroDistance));
+  forward.queue.push(State(startVertex, kZeroDistance, forward.ConsistentHeuristic(startVertex)));
+
+  backward.UpdateDistance(State(finalVertex, kZeroDistance));
+  backward.queue.push(State(finalVertex, kZeroDistance, backward.ConsistentHeuristic(finalVertex)));
+
+  ParallelMeeting meeting(startVertex, finalVertex);
+
+  std::exception_ptr backwardException;
+  threads::SimpleThread backwardThread([&]()
+  {
+    try
+    {
+      PropagateParallelWave(params, backward, forward, meeting);
+    }
+    catch (...)
+    {
+      backwardException = std::current_exception();
+      meeting.stop = true;
+    }
+  });
+
+  try
+  {
+    PropagateParallelWave(params, forward, backward, meeting);
+  }
+  catch (...)
+  {
+    meeting.stop = true;
+    backwardThread.join();
+    throw;
+  }
+
+  backwardThread.join();
+  if (backwardException)
+    std::rethrow_exception(backwardException);
+
+  if (meeting.cancelled)
+    return Result::Cancelled;
+
+  if (!meeting.foundAnyPath)
+    return Result::NoPath;
+
+  ReconstructPathBidirectional(meeting.forwardVertex, meeting.backwardVertex, forward.GetParents(),
+                               backward.GetParents(), result.m_path);
+  result.m_distance = meeting.bestPathRealLength;
+  return Result::OK;
+}
+
+template <typename Vertex, typename Edge, typename Weight>
+template <class P>
+void AStarAlgorithm<Vertex, Edge, Weight>::PropagateParallelWave(
+    P & params, ParallelStepContext & cur, ParallelStepContext & nxt, ParallelMeeting & meeting) const
+{
+  auto const epsilon = params.m_weightEpsilon;
+  auto & forwardParents = cur.forward ? cur.GetParents() : nxt.GetParents();
+  auto & backwardParents = cur.forward ? nxt.GetParents() : cur.GetParents();
+  size_t const curSide = cur.forward ? 0 : 1;
+
+  typename Graph::EdgeListT adj;
+  PeriodicPollCancellable periodicCancellable(params.m_cancellable);
+
+  while (!meeting.stop.load(std::memory_order_relaxed))
+  {
+    if (periodicCancellable.IsCancelled())
+    {
+      std::lock_guard<std::mutex> lock(meeting.mutex);
+      meeting.cancelled = true;
+      meeting.stop = true;
+      break;
+    }
+
+    // As in FindPathBidirectionalEx, if we have not found a path by the time one of the queues
+    // is exhausted, we never will.
+    if (cur.queue.empty())
+    {
+      meeting.stop = true;
+      break;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(meeting.mutex);
+      meeting.topDistance[curSide] = cur.TopDistance();
+      // See the stop condition of FindPathBidirectionalEx.
+      if (meeting.foundAnyPath && meeting.topDistance[0] + meeting.topDistance[1] >=
+                                      meeting.bestPathReducedLength - epsilon)
+      {
+        meeting.stop = true;
+        break;
+      }
+    }
+
+    State const stateV = cur.queue.top();
+    cur.queue.pop();
+
+    // Only this thread modifies |cur|, so it is read without the lock.
+    if (cur.ExistsStateWithBetterDistance(stateV))
+      continue;
+
+    auto const endV = cur.forward ? cur.finalVertex : cur.startVertex;
+    if (cur.forward)
+    {
+      params.m_onVisitedVertexCallback(
+          std::make_pair(stateV, static_cast<BidirectionalStepContext *>(&cur)), endV);
+    }
+
+    cur.GetAdjacencyList(stateV, adj);
+    auto const & pV = stateV.heuristic;
+    for (auto const & edge : adj)
+    {
+      State stateW(edge.GetTarget(), kZeroDistance);
+
+      if (stateV.vertex == stateW.vertex)
+        continue;
+
+      auto const weight = edge.GetWeight();
+      auto const pW = cur.ConsistentHeuristic(stateW.vertex);
+      auto const reducedWeight = weight + pW - pV;
+
+      if (reducedWeight < -epsilon && params.m_badReducedWeight(reducedWeight, std::max(pW, pV)))
+      {
+        LOG(LERROR, ("Invariant violated for:", "v =", stateV.vertex, "w =", stateW.vertex,
+                     "reduced weight =", reducedWeight));
+      }
+
+      stateW.distance = stateV.distance + std::max(reducedWeight, kZeroDistance);
+
+      auto const fullLength = weight + stateV.distance + cur.pS - pV;
+      if (!params.m_checkLengthCallback(fullLength))
+        continue;
+
+      if (cur.ExistsStateWithBetterDistance(stateW, epsilon))
+        continue;
+
+      stateW.heuristic = pW;
+      {
+        std::lock_guard<std::mutex> lock(cur.mutex);
+        cur.UpdateDistance(stateW);
+        cur.UpdateParent(stateW.vertex, stateV.vertex);
+      }
+
+      {
+        // Lock order is always: wave, then meeting.
+        std::lock_guard<std::mutex> nxtLock(nxt.mutex);
+        if (auto op = nxt.GetDistance(stateW.vertex); op)
+        {
+          auto const & distW = *op;
+          auto const curPathReducedLength = stateW.distance + distW;
+
+          std::lock_guard<std::mutex> meetingLock(meeting.mutex);
+          if ((!meeting.foundAnyPath || meeting.bestPathReducedLength > curPathReducedLength) &&
+              cur.graph.AreWavesConnectible(forwardParents, stateW.vertex, backwardParents))
+          {
+            meeting.bestPathReducedLength = curPathReducedLength;
+
+            // Potential of the other wave is p_r(w) = -p_f(w), see ConsistentHeuristic.
+            meeting.bestPathRealLength = stateV.distance + weight + distW;
+            meeting.bestPathRealLength += cur.pS - pV;
+            meeting.bestPathRealLength += nxt.pS + pW;
+
+            meeting.foundAnyPath = true;
+            meeting.forwardVertex = cur.forward ? stateV.vertex : stateW.vertex;
+            meeting.backwardVertex = cur.forward ? stateW.vertex : stateV.vertex;
+          }
+        }
+      }
+
+      if (stateW.vertex != endV)
+        cur.queue.push(stateW);
+    }
+  }
+}
+
 template <typename Vertex, typename Edge, typename Weight>
 template <typename P>
 typename AStarAlgorithm<Vertex, Edge, Weight>::Result
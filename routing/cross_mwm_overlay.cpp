@@ -0,0 +1,60 @@
+#include "routing/cross_mwm_overlay.hpp"
+
+namespace routing
+{
+void CrossMwmOverlay::AddCell(Cell && cell)
+{
+  CHECK_EQUAL(cell.m_weights.size(), cell.m_enters.size() * cell.m_exits.size(), ());
+
+  auto const cellId = base::checked_cast<CellId>(m_cells.size());
+  for (NumMwmId const mwmId : cell.m_mwms)
+    CHECK(m_mwmToCell.emplace(mwmId, cellId).second, ("Mwm", mwmId, "is in several cells."));
+
+  for (uint32_t i = 0; i < cell.m_enters.size(); ++i)
+    m_enterToIdx.emplace(cell.m_enters[i], i);
+  for (uint32_t i = 0; i < cell.m_exits.size(); ++i)
+    m_exitToIdx.emplace(cell.m_exits[i], i);
+
+  m_cells.push_back(std::move(cell));
+}
+
+CrossMwmOverlay::CellId CrossMwmOverlay::GetCell(NumMwmId mwmId) const
+{
+  auto const it = m_mwmToCell.find(mwmId);
+  return it != m_mwmToCell.end() ? it->second : kNoCell;
+}
+
+bool CrossMwmOverlay::GetShortcuts(Segment const & segment, bool isOutgoing,
+                                   EdgeListT & edges) const
+{
+  CellId const cellId = GetCell(segment.GetMwmId());
+  if (cellId == kNoCell)
+    return false;
+
+  auto const & index = isOutgoing ? m_enterToIdx : m_exitToIdx;
+  auto const it = index.find(segment);
+  if (it == index.end())
+    return false;
+
+  Cell const & cell = m_cells[cellId];
+  if (isOutgoing)
+  {
+    for (size_t exitIdx = 0; exitIdx < cell.m_exits.size(); ++exitIdx)
+    {
+      auto const weight = cell.GetWeight(it->second, exitIdx);
+      if (weight != connector::kNoRouteStored)
+        edges.emplace_back(cell.m_exits[exitIdx], RouteWeight::FromCrossMwmWeight(weight));
+    }
+  }
+  else
+  {
+    for (size_t enterIdx = 0; enterIdx < cell.m_enters.size(); ++enterIdx)
+    {
+      auto const weight = cell.GetWeight(enterIdx, it->second);
+      if (weight != connector::kNoRouteStored)
+        edges.emplace_back(cell.m_enters[enterIdx], RouteWeight::FromCrossMwmWeight(weight));
+    }
+  }
+  return true;
+}
+}  // namespace routing
@@ -0,0 +1,387 @@
+#pragma once
+
+#include "routing/cross_mwm_connector.hpp"
+#include "routing/route_weight.hpp"
+#include "routing/routing_exceptions.hpp"
+#include "routing/segment.hpp"
+
+#include "routing/base/small_list.hpp"
+
+#include "routing_common/num_mwm_id.hpp"
+
+#include "platform/country_file.hpp"
+
+#include "coding/read_write_utils.hpp"
+#include "coding/reader.hpp"
+#include "coding/varint.hpp"
+#include "coding/write_to_sink.hpp"
+
+#include "base/assert.hpp"
+#include "base/checked_cast.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <queue>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace routing
+{
+/// Precomputed level over the cross-mwm leaps graph, in the manner of CRP overlays.
+/// Mwms are grouped into cells, one cell per top level country of the mwm hierarchy.
+/// For every cell the overlay keeps the weights of the shortest leaps routes between
+/// its boundary transitions, i.e. enters from and exits to mwms of other cells.
+/// So a route through a cell which contains neither start nor finish takes one hop
+/// instead of exploring all the transitions of all the mwms of the cell.
+class CrossMwmOverlay
+{
+public:
+  using CellId = uint32_t;
+  static CellId constexpr kNoCell = std::numeric_limits<CellId>::max();
+
+  struct Cell
+  {
+    connector::Weight GetWeight(size_t enterIdx, size_t exitIdx) const
+    {
+      return m_weights[enterIdx * m_exits.size() + exitIdx];
+    }
+
+    std::vector<NumMwmId> m_mwms;
+    // Boundary transitions of the cell mwms.
+    std::vector<Segment> m_enters;
+    std::vector<Segment> m_exits;
+    // |m_enters| x |m_exits| matrix of route weights in seconds, connector::kNoRouteStored if
+    // an exit can't be reached from an enter without leaving the cell.
+    std::vector<connector::Weight> m_weights;
+  };
+
+  using EdgeListT = SmallList<SegmentEdge>;
+
+  void AddCell(Cell && cell);
+
+  bool IsEmpty() const { return m_cells.empty(); }
+  std::vector<Cell> const & GetCells() const { return m_cells; }
+
+  /// @return kNoCell if |mwmId| is not covered by the overlay.
+  CellId GetCell(NumMwmId mwmId) const;
+
+  /// Fills |edges| with shortcuts from a boundary enter (|isOutgoing| == true) to all the
+  /// boundary exits of its cell or from all the boundary enters to a boundary exit.
+  /// @return false if |segment| is not a boundary enter (exit) of its cell.
+  bool GetShortcuts(Segment const & segment, bool isOutgoing, EdgeListT & edges) const;
+
+private:
+  std::vector<Cell> m_cells;
+  std::unordered_map<NumMwmId, CellId> m_mwmToCell;
+  // Boundary transition -> its index in Cell::m_enters (Cell::m_exits).
+  std::unordered_map<Segment, uint32_t> m_enterToIdx;
+  std::unordered_map<Segment, uint32_t> m_exitToIdx;
+};
+
+namespace cross_mwm_overlay
+{
+/// Dijkstra over the leaps of the mwms of one cell. Vertices are transition segments,
+/// edges are leaps from enters to exits of the same mwm and zero weight edges from exits to
+/// their twins (enters of the neighbouring mwms) inside the cell.
+/// Crossing borders inside a cell is never penalized: all the mwms of a cell are of one country.
+/// |Graph| is CrossMwmGraph or any class with the same GetOutgoingEdgeList() and GetTwins().
+template <class Graph>
+class CellRouter
+{
+public:
+  CellRouter(Graph & graph, std::vector<NumMwmId> const & mwms)
+    : m_graph(graph), m_mwms(mwms.begin(), mwms.end())
+  {
+  }
+
+  /// Finds routes from |enter| to all the transitions of the cell or to |target| only.
+  void Run(Segment const & enter, std::optional<Segment> const & target = {})
+  {
+    m_distances.clear();
+    m_parents.clear();
+
+    using State = std::pair<double, Segment>;
+    std::priority_queue<State, std::vector<State>, std::greater<State>> queue;
+
+    m_distances[enter] = 0.0;
+    queue.emplace(0.0, enter);
+
+    // Enters are reached from the twin exits only, so whether a vertex is an enter
+    // is known from the edge it was reached by.
+    std::set<Segment> enters = {enter};
+
+    typename Graph::EdgeListT edges;
+    std::vector<Segment> twins;
+    while (!queue.empty())
+    {
+      double const distance = queue.top().first;
+      Segment const v = queue.top().second;
+      queue.pop();
+
+      if (distance > m_distances[v])
+        continue;
+
+      if (target && v == *target)
+        return;
+
+      auto const relax = [&](Segment const & w, double weight)
+      {
+        auto const it = m_distances.find(w);
+        if (it != m_distances.end() && it->second <= distance + weight)
+          return;
+
+        m_distances[w] = distance + weight;
+        m_parents[w] = v;
+        queue.emplace(distance + weight, w);
+      };
+
+      if (enters.count(v) != 0)
+      {
+        edges.clear();
+        m_graph.GetOutgoingEdgeList(v, edges);
+        for (auto const & edge : edges)
+        {
+          if (edge.GetTarget() != v)
+            relax(edge.GetTarget(), edge.GetWeight().GetWeight());
+        }
+        continue;
+      }
+
+      twins.clear();
+      m_graph.GetTwins(v, true /* isOutgoing */, twins);
+      for (auto const & twin : twins)
+      {
+        if (m_mwms.count(twin.GetMwmId()) == 0)
+          continue;
+
+        enters.insert(twin);
+        relax(twin, 0.0);
+      }
+    }
+  }
+
+  std::optional<double> GetDistance(Segment const & s) const
+  {
+    auto const it = m_distances.find(s);
+    if (it == m_distances.end())
+      return {};
+    return it->second;
+  }
+
+  /// Appends to |path| the route of the last Run() to |exit| as a list of
+  /// (enter, exit) pairs, starting from the Run() enter.
+  bool GetPath(Segment const & exit, std::vector<Segment> & path) const
+  {
+    if (m_distances.count(exit) == 0)
+      return false;
+
+    std::vector<Segment> reversed = {exit};
+    for (auto it = m_parents.find(exit); it != m_parents.end(); it = m_parents.find(it->second))
+      reversed.push_back(it->second);
+
+    path.insert(path.end(), reversed.rbegin(), reversed.rend());
+    return true;
+  }
+
+private:
+  Graph & m_graph;
+  std::set<NumMwmId> const m_mwms;
+
+  std::unordered_map<Segment, double> m_distances;
+  std::unordered_map<Segment, Segment> m_parents;
+};
+
+/// Builds a cell of |mwms| with shortcuts between all its boundary transitions.
+/// |Graph| should also have ForEachTransition() like CrossMwmGraph.
+template <class Graph>
+CrossMwmOverlay::Cell BuildCell(Graph & graph, std::vector<NumMwmId> mwms)
+{
+  std::sort(mwms.begin(), mwms.end());
+  std::set<NumMwmId> const inCell(mwms.begin(), mwms.end());
+
+  CrossMwmOverlay::Cell cell;
+  cell.m_mwms = mwms;
+
+  std::vector<Segment> twins;
+  auto const isBoundary = [&](Segment const & s, bool isOutgoing)
+  {
+    twins.clear();
+    graph.GetTwins(s, isOutgoing, twins);
+    return std::any_of(twins.begin(), twins.end(), [&](Segment const & twin)
+    {
+      return inCell.count(twin.GetMwmId()) == 0;
+    });
+  };
+
+  for (NumMwmId const mwmId : mwms)
+  {
+    graph.ForEachTransition(mwmId, true /* isEnter */, [&](Segment const & enter)
+    {
+      if (isBoundary(enter, false /* isOutgoing */))
+        cell.m_enters.push_back(enter);
+    });
+    graph.ForEachTransition(mwmId, false /* isEnter */, [&](Segment const & exit)
+    {
+      if (isBoundary(exit, true /* isOutgoing */))
+        cell.m_exits.push_back(exit);
+    });
+  }
+
+  std::sort(cell.m_enters.begin(), cell.m_enters.end());
+  std::sort(cell.m_exits.begin(), cell.m_exits.end());
+
+  cell.m_weights.assign(cell.m_enters.size() * cell.m_exits.size(), connector::kNoRouteStored);
+
+  CellRouter<Graph> router(graph, mwms);
+  for (size_t i = 0; i < cell.m_enters.size(); ++i)
+  {
+    router.Run(cell.m_enters[i]);
+    for (size_t j = 0; j < cell.m_exits.size(); ++j)
+    {
+      auto const distance = router.GetDistance(cell.m_exits[j]);
+      if (!distance)
+        continue;
+
+      // Leap weights are integer seconds, so is their sum. Zero weight is reserved for "no route".
+      auto const weight = std::max<uint64_t>(std::llround(*distance), 1);
+      cell.m_weights[i * cell.m_exits.size() + j] =
+          base::checked_cast<connector::Weight>(weight);
+    }
+  }
+
+  return cell;
+}
+}  // namespace cross_mwm_overlay
+
+class CrossMwmOverlaySerializer
+{
+public:
+  CrossMwmOverlaySerializer() = delete;
+
+  template <class Sink>
+  static void Serialize(CrossMwmOverlay const & overlay, Sink & sink, NumMwmIds const & numMwmIds)
+  {
+    WriteToSink(sink, kVersion);
+
+    std::vector<NumMwmId> mwms;
+    for (auto const & cell : overlay.GetCells())
+      mwms.insert(mwms.end(), cell.m_mwms.begin(), cell.m_mwms.end());
+    std::sort(mwms.begin(), mwms.end());
+    mwms.erase(std::unique(mwms.begin(), mwms.end()), mwms.end());
+
+    // Mwms are stored by names, so the overlay doesn't depend on NumMwmId numeration.
+    WriteVarUint(sink, base::checked_cast<uint32_t>(mwms.size()));
+    for (NumMwmId const mwmId : mwms)
+      rw::Write(sink, numMwmIds.GetFile(mwmId).GetName());
+
+    auto const getIdx = [&mwms](NumMwmId mwmId)
+    {
+      auto const it = std::lower_bound(mwms.begin(), mwms.end(), mwmId);
+      CHECK(it != mwms.end() && *it == mwmId, (mwmId));
+      return base::checked_cast<uint32_t>(std::distance(mwms.begin(), it));
+    };
+
+    auto const writeSegments = [&](std::vector<Segment> const & segments)
+    {
+      WriteVarUint(sink, base::checked_cast<uint32_t>(segments.size()));
+      for (auto const & s : segments)
+      {
+        WriteVarUint(sink, getIdx(s.GetMwmId()));
+        WriteVarUint(sink, s.GetFeatureId());
+        WriteVarUint(sink, s.GetSegmentIdx());
+        WriteToSink(sink, static_cast<uint8_t>(s.IsForward() ? 1 : 0));
+      }
+    };
+
+    WriteVarUint(sink, base::checked_cast<uint32_t>(overlay.GetCells().size()));
+    for (auto const & cell : overlay.GetCells())
+    {
+      WriteVarUint(sink, base::checked_cast<uint32_t>(cell.m_mwms.size()));
+      for (NumMwmId const mwmId : cell.m_mwms)
+        WriteVarUint(sink, getIdx(mwmId));
+
+      writeSegments(cell.m_enters);
+      writeSegments(cell.m_exits);
+      for (auto const weight : cell.m_weights)
+        WriteVarUint(sink, weight);
+    }
+  }
+
+  /// Cells with mwms which are absent in |numMwmIds| are skipped.
+  template <class Source>
+  static void Deserialize(CrossMwmOverlay & overlay, Source & src, NumMwmIds const & numMwmIds)
+  {
+    auto const version = ReadPrimitiveFromSource<uint32_t>(src);
+    if (version != kVersion)
+      MYTHROW(CorruptedDataException, ("Unknown cross mwm overlay version:", version));
+
+    auto const mwmsCount = ReadVarUint<uint32_t>(src);
+    std::vector<std::optional<NumMwmId>> mwms(mwmsCount);
+    for (auto & mwmId : mwms)
+    {
+      std::string name;
+      rw::Read(src, name);
+      platform::CountryFile const file(name);
+      if (numMwmIds.ContainsFile(file))
+        mwmId = numMwmIds.GetId(file);
+    }
+
+    bool valid = true;
+    auto const readMwm = [&]() -> NumMwmId
+    {
+      auto const idx = ReadVarUint<uint32_t>(src);
+      CHECK_LESS(idx, mwms.size(), ());
+      if (!mwms[idx])
+      {
+        valid = false;
+        return kFakeNumMwmId;
+      }
+      return *mwms[idx];
+    };
+
+    auto const readSegments = [&](std::vector<Segment> & segments)
+    {
+      segments.resize(ReadVarUint<uint32_t>(src));
+      for (auto & s : segments)
+      {
+        auto const mwmId = readMwm();
+        auto const featureId = ReadVarUint<uint32_t>(src);
+        auto const segmentIdx = ReadVarUint<uint32_t>(src);
+        bool const forward = ReadPrimitiveFromSource<uint8_t>(src) != 0;
+        s = Segment(mwmId, featureId, segmentIdx, forward);
+      }
+    };
+
+    auto const cellsCount = ReadVarUint<uint32_t>(src);
+    for (uint32_t i = 0; i < cellsCount; ++i)
+    {
+      valid = true;
+
+      CrossMwmOverlay::Cell cell;
+      cell.m_mwms.resize(ReadVarUint<uint32_t>(src));
+      for (auto & mwmId : cell.m_mwms)
+        mwmId = readMwm();
+
+      readSegments(cell.m_enters);
+      readSegments(cell.m_exits);
+
+      cell.m_weights.resize(cell.m_enters.size() * cell.m_exits.size());
+      for (auto & weight : cell.m_weights)
+        weight = ReadVarUint<connector::Weight>(src);
+
+      if (valid)
+        overlay.AddCell(std::move(cell));
+    }
+  }
+
+private:
+  static uint32_t constexpr kVersion = 0;
+};
+}  // namespace routing
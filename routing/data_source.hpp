@@ -4,6 +4,7 @@
 #include "routing_common/num_mwm_id.hpp"
 
 #include "indexer/data_source.hpp"
+#include "indexer/utils.hpp"
 
 #include "base/lru_cache.hpp"
 
@@ -55,8 +56,27 @@ public:
     m_handles2.clear();
   }
 
+  /// @return false if some mwm of the held handles is going to be deregistered, e.g. updated.
+  bool AreHandlesUpToDate() const
+  {
+    for (auto const & [_, handle] : m_handles)
+    {
+      if (!handle.GetInfo()->IsUpToDate())
+        return false;
+    }
+    for (auto const & [_, handle] : m_handles2)
+    {
+      if (!handle.GetInfo()->IsUpToDate())
+        return false;
+    }
+    return true;
+  }
+
   bool IsLoaded(platform::CountryFile const & file) const { return m_dataSource.IsLoaded(file); }
 
+  /// @return World mwm handle, not alive if World is not registered.
+  MwmSet::MwmHandle GetWorldHandle() const { return indexer::FindWorld(m_dataSource); }
+
   enum SectionStatus
   {
     MwmNotLoaded,
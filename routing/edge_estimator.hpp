@@ -18,6 +18,11 @@ namespace routing
 class RoadGeometry;
 class TrafficStash;
 
+/// Estimators have no mutable state, so one estimator may be used by several threads, e.g. by
+/// the waves of IndexRouter::CalculateSubrouteParallelMode(). Speeds are taken from RoadGeometry
+/// of the caller's graph, and TrafficStash is only read while a route is built: it's filled
+/// and cleared by TrafficStash::Guard around the route calculation. Per-mwm caches which are
+/// added here (see the commented out leap speeds) must be filled before A* or be guarded.
 class EdgeEstimator
 {
 public:
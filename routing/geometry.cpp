@@ -14,7 +14,12 @@
 #include "base/string_utils.hpp"
 
 #include <algorithm>
+#include <list>
+#include <sstream>
 #include <string>
+#include <utility>
+
+#include "3party/skarupke/bytell_hash_map.hpp"
 
 namespace routing
 {
@@ -185,6 +190,8 @@ void RoadGeometry::Load(VehicleModelInterface const & vehicleModel, FeatureType
   params.m_forward = false;
   m_backwardSpeed = vehicleModel.GetSpeed(feature, params);
 
+  // Road may be reused by the cache, so all the fields should be reset.
+  m_routingOptions = RoutingOptions();
   feature::TypesHolder types(feature);
   auto const & optionsClassfier = RoutingOptionsClassifier::Instance();
   for (uint32_t type : types)
@@ -217,7 +224,7 @@ void RoadGeometry::Load(VehicleModelInterface const & vehicleModel, FeatureType
     }
 #endif
   }
-  m_distances.resize(count - 1, -1);
+  m_distances.assign(count - 1, -1);
 
   bool const isFerry = m_routingOptions.Has(RoutingOptions::Road::Ferry);
   /// @todo Add RouteShuttleTrain into RoutingOptions?
@@ -275,24 +282,149 @@ double RoadGeometry::GetRoadLengthM() const
   return lenM;
 }
 
+size_t RoadGeometry::GetMemorySize() const
+{
+  return sizeof(RoadGeometry) + m_junctions.capacity() * sizeof(LatLonWithAltitude) +
+         m_distances.capacity() * sizeof(double);
+}
+
+// RoadsCacheStats ---------------------------------------------------------------------------------
+void RoadsCacheStats::Add(RoadsCacheStats const & rhs)
+{
+  m_hits += rhs.m_hits;
+  m_misses += rhs.m_misses;
+  m_evictions += rhs.m_evictions;
+  m_roads += rhs.m_roads;
+  m_bytes += rhs.m_bytes;
+}
+
+double RoadsCacheStats::GetHitRate() const
+{
+  auto const total = m_hits + m_misses;
+  return total == 0 ? 0.0 : static_cast<double>(m_hits) / total;
+}
+
+string DebugPrint(RoadsCacheStats const & stats)
+{
+  ostringstream out;
+  out << "RoadsCacheStats [ hits: " << stats.m_hits << ", misses: " << stats.m_misses
+      << ", hit rate: " << stats.GetHitRate() << ", evictions: " << stats.m_evictions
+      << ", roads: " << stats.m_roads << ", bytes: " << stats.m_bytes << " ]";
+  return out.str();
+}
+
+// Geometry::RoadsCache ----------------------------------------------------------------------------
+/// LRU cache of roads bounded by their memory size.
+/// Nodes of evicted roads are reused for new ones, so vectors capacity is reused too.
+class Geometry::RoadsCache
+{
+public:
+  explicit RoadsCache(size_t bytesLimit) : m_bytesLimit(bytesLimit) {}
+
+  template <class LoaderT>
+  RoadGeometry const & GetValue(uint32_t featureId, LoaderT && loader)
+  {
+    auto const it = m_index.find(featureId);
+    if (it != m_index.end())
+    {
+      ++m_stats.m_hits;
+      if (it->second != m_lru.begin())
+        m_lru.splice(m_lru.begin(), m_lru, it->second);
+      return it->second->m_road;
+    }
+
+    ++m_stats.m_misses;
+    if (!m_lru.empty() && m_stats.m_bytes >= m_bytesLimit)
+    {
+      // Reuse the least recently used node.
+      Evict();
+      m_lru.splice(m_lru.begin(), m_lru, prev(m_lru.end()));
+    }
+    else
+    {
+      m_lru.emplace_front();
+    }
+
+    auto & node = m_lru.front();
+    node.m_featureId = featureId;
+    try
+    {
+      loader(featureId, node.m_road);
+    }
+    catch (...)
+    {
+      m_lru.pop_front();
+      throw;
+    }
+    node.m_bytes = node.m_road.GetMemorySize();
+    m_stats.m_bytes += node.m_bytes;
+    m_index.emplace(featureId, m_lru.begin());
+
+    // The just loaded road is never evicted to keep the returned reference valid.
+    while (m_stats.m_bytes > m_bytesLimit && m_lru.size() > 1)
+    {
+      Evict();
+      m_lru.pop_back();
+    }
+
+    m_stats.m_roads = m_index.size();
+    return node.m_road;
+  }
+
+  RoadsCacheStats const & GetStats() const { return m_stats; }
+
+private:
+  struct Node
+  {
+    uint32_t m_featureId = 0;
+    size_t m_bytes = 0;
+    RoadGeometry m_road;
+  };
+
+  using LruListT = list<Node>;
+
+  // Unregisters the least recently used node, the node itself stays in |m_lru|.
+  void Evict()
+  {
+    auto const & node = m_lru.back();
+    m_index.erase(node.m_featureId);
+    ASSERT_GREATER_OR_EQUAL(m_stats.m_bytes, node.m_bytes, ());
+    m_stats.m_bytes -= node.m_bytes;
+    ++m_stats.m_evictions;
+  }
+
+  size_t const m_bytesLimit;
+  LruListT m_lru;
+  ska::bytell_hash_map<uint32_t, LruListT::iterator> m_index;
+  RoadsCacheStats m_stats;
+};
+
 // Geometry ----------------------------------------------------------------------------------------
-Geometry::Geometry(unique_ptr<GeometryLoader> loader, size_t roadsCacheSize)
+Geometry::Geometry() = default;
+
+Geometry::Geometry(unique_ptr<GeometryLoader> loader, size_t roadsCacheBytes)
   : m_loader(std::move(loader))
+  , m_featureIdToRoad(make_unique<RoadsCache>(roadsCacheBytes))
 {
   CHECK(m_loader, ());
-
-  m_featureIdToRoad = make_unique<RoutingCacheT>(roadsCacheSize, [this](uint32_t featureId, RoadGeometry & road)
-  {
-    m_loader->Load(featureId, road);
-  });
 }
 
+Geometry::~Geometry() = default;
+
 RoadGeometry const & Geometry::GetRoad(uint32_t featureId)
 {
   ASSERT(m_featureIdToRoad, ());
   ASSERT(m_loader, ());
 
-  return m_featureIdToRoad->GetValue(featureId);
+  return m_featureIdToRoad->GetValue(featureId, [this](uint32_t featureId, RoadGeometry & road)
+  {
+    m_loader->Load(featureId, road);
+  });
+}
+
+RoadsCacheStats Geometry::GetCacheStats() const
+{
+  return m_featureIdToRoad ? m_featureIdToRoad->GetStats() : RoadsCacheStats();
 }
 
 SpeedInUnits GeometryLoader::GetSavedMaxspeed(uint32_t featureId, bool forward)
@@ -10,21 +10,19 @@
 
 #include "geometry/latlon.hpp"
 
-#include "base/fifo_cache.hpp"
-
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
 
-#include "3party/skarupke/bytell_hash_map.hpp"
-
 class DataSource;
 
 namespace routing
 {
 // @TODO(bykoianko) Consider setting cache size based on available memory.
-// Maximum road geometry cache size in items.
-size_t constexpr kRoadsCacheSize = 10000;
+// Maximum road geometry cache size in bytes, it's about 10000 roads of an average size.
+size_t constexpr kRoadsCacheBytes = 4 * 1024 * 1024;
 
 class RoadAttrsGetter;
 
@@ -84,6 +82,9 @@ public:
 
   RoutingOptions GetRoutingOptions() const { return m_routingOptions; }
 
+  /// \returns approximate heap and object size in bytes, used for cache accounting.
+  size_t GetMemorySize() const;
+
 private:
   std::vector<LatLonWithAltitude> m_junctions;
   mutable std::vector<double> m_distances;    ///< as cache, @see GetDistance()
@@ -121,8 +122,23 @@ public:
       std::string const & filePath, VehicleModelPtrT const & vehicleModel);
 };
 
+struct RoadsCacheStats
+{
+  void Add(RoadsCacheStats const & rhs);
+  double GetHitRate() const;
+
+  uint64_t m_hits = 0;
+  uint64_t m_misses = 0;
+  uint64_t m_evictions = 0;
+  size_t m_roads = 0;
+  size_t m_bytes = 0;
+};
+
+std::string DebugPrint(RoadsCacheStats const & stats);
+
 /// \brief This class supports loading geometry of roads for routing.
-/// \note Loaded information about road geometry is kept in a fixed-size cache |m_featureIdToRoad|.
+/// \note Loaded information about road geometry is kept in a LRU cache |m_featureIdToRoad|
+/// which is bounded by the memory size of roads, not by their number.
 /// On the other hand methods GetRoad() and GetPoint() return geometry information by reference.
 /// The reference may be invalid after the next call of GetRoad() or GetPoint() because the cache
 /// item which is referred by returned reference may be evicted. It's done for performance reasons.
@@ -132,10 +148,12 @@ public:
 class Geometry final
 {
 public:
-  Geometry() = default;
+  Geometry();
   /// \brief Geometry constructor
-  /// \param roadsCacheSize in-memory geometry elements count limit
-  Geometry(std::unique_ptr<GeometryLoader> loader, size_t roadsCacheSize = kRoadsCacheSize);
+  /// \param roadsCacheBytes in-memory geometry size limit in bytes. The most recently used road
+  /// is kept in the cache even if it's bigger than the limit.
+  Geometry(std::unique_ptr<GeometryLoader> loader, size_t roadsCacheBytes = kRoadsCacheBytes);
+  ~Geometry();
 
   /// \note The reference returned by the method is valid until the next call of GetRoad()
   /// of GetPoint() methods.
@@ -153,11 +171,12 @@ public:
     return m_loader->GetSavedMaxspeed(featureId, forward);
   }
 
+  RoadsCacheStats GetCacheStats() const;
+
 private:
-  /// @todo Use LRU cache?
-  using RoutingCacheT = FifoCache<uint32_t, RoadGeometry, ska::bytell_hash_map<uint32_t, RoadGeometry>>;
+  class RoadsCache;
 
   std::unique_ptr<GeometryLoader> m_loader;
-  std::unique_ptr<RoutingCacheT> m_featureIdToRoad;
+  std::unique_ptr<RoadsCache> m_featureIdToRoad;
 };
 }  // namespace routing
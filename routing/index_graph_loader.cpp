@@ -30,9 +30,10 @@ public:
   IndexGraphLoaderImpl(VehicleType vehicleType, bool loadAltitudes,
                        shared_ptr<VehicleModelFactoryInterface> vehicleModelFactory,
                        shared_ptr<EdgeEstimator> estimator, MwmDataSource & dataSource,
-                       RoutingOptions routingOptions = RoutingOptions())
+                       RoutingOptions routingOptions, size_t roadsCacheBytes)
     : m_vehicleType(vehicleType)
     , m_loadAltitudes(loadAltitudes)
+    , m_roadsCacheBytes(roadsCacheBytes)
     , m_dataSource(dataSource)
     , m_vehicleModelFactory(std::move(vehicleModelFactory))
     , m_estimator(std::move(estimator))
@@ -47,6 +48,8 @@ public:
   Geometry & GetGeometry(NumMwmId numMwmId) override;
   vector<RouteSegment::SpeedCamera> GetSpeedCameraInfo(Segment const & segment) override;
   void Clear() override;
+  RoadsCacheStats GetRoadsCacheStats() const override;
+  double GetGraphsLoadSeconds() const override { return m_graphsLoadSeconds; }
 
 private:
   using GeometryPtrT = shared_ptr<Geometry>;
@@ -56,6 +59,7 @@ private:
 
   VehicleType m_vehicleType;
   bool m_loadAltitudes;
+  size_t m_roadsCacheBytes;
   MwmDataSource & m_dataSource;
   shared_ptr<VehicleModelFactoryInterface> m_vehicleModelFactory;
   shared_ptr<EdgeEstimator> m_estimator;
@@ -67,6 +71,7 @@ private:
     GraphPtrT m_graph;
   };
   unordered_map<NumMwmId, GraphAttrs> m_graphs;
+  double m_graphsLoadSeconds = 0.0;
 
   unordered_map<NumMwmId, SpeedCamerasMapT> m_cachedCameras;
   SpeedCamerasMapT const & ReceiveSpeedCamsFromMwm(NumMwmId numMwmId);
@@ -136,7 +141,8 @@ IndexGraphLoaderImpl::GraphPtrT IndexGraphLoaderImpl::CreateIndexGraph(NumMwmId
   if (!geometry)
   {
     auto vehicleModel = m_vehicleModelFactory->GetVehicleModelForCountry(value->GetCountryFileName());
-    geometry = make_shared<Geometry>(GeometryLoader::Create(handle, std::move(vehicleModel), m_loadAltitudes));
+    geometry = make_shared<Geometry>(GeometryLoader::Create(handle, std::move(vehicleModel), m_loadAltitudes),
+                                     m_roadsCacheBytes);
   }
 
   auto graph = make_unique<IndexGraph>(geometry, m_estimator, m_avoidRoutingOptions);
@@ -144,7 +150,9 @@ IndexGraphLoaderImpl::GraphPtrT IndexGraphLoaderImpl::CreateIndexGraph(NumMwmId
 
   base::Timer timer;
   DeserializeIndexGraph(*value, m_vehicleType, *graph);
-  LOG(LINFO, (ROUTING_FILE_TAG, "section for", value->GetCountryFileName(), "loaded in", timer.ElapsedSeconds(), "seconds"));
+  double const loadSeconds = timer.ElapsedSeconds();
+  m_graphsLoadSeconds += loadSeconds;
+  LOG(LINFO, (ROUTING_FILE_TAG, "section for", value->GetCountryFileName(), "loaded in", loadSeconds, "seconds"));
 
   return graph;
 }
@@ -155,11 +163,23 @@ IndexGraphLoaderImpl::GeometryPtrT IndexGraphLoaderImpl::CreateGeometry(NumMwmId
   MwmValue const * value = handle.GetValue();
 
   auto vehicleModel = m_vehicleModelFactory->GetVehicleModelForCountry(value->GetCountryFileName());
-  return make_shared<Geometry>(GeometryLoader::Create(handle, std::move(vehicleModel), m_loadAltitudes));
+  return make_shared<Geometry>(GeometryLoader::Create(handle, std::move(vehicleModel), m_loadAltitudes),
+                               m_roadsCacheBytes);
 }
 
 void IndexGraphLoaderImpl::Clear() { m_graphs.clear(); }
 
+RoadsCacheStats IndexGraphLoaderImpl::GetRoadsCacheStats() const
+{
+  RoadsCacheStats stats;
+  for (auto const & graph : m_graphs)
+  {
+    if (graph.second.m_geometry)
+      stats.Add(graph.second.m_geometry->GetCacheStats());
+  }
+  return stats;
+}
+
 } // namespace
 
 bool ReadSpeedCamsFromMwm(MwmValue const & mwmValue, SpeedCamerasMapT & camerasMap)
@@ -207,10 +227,10 @@ unique_ptr<IndexGraphLoader> IndexGraphLoader::Create(
     VehicleType vehicleType, bool loadAltitudes,
     shared_ptr<VehicleModelFactoryInterface> vehicleModelFactory,
     shared_ptr<EdgeEstimator> estimator, MwmDataSource & dataSource,
-    RoutingOptions routingOptions)
+    RoutingOptions routingOptions, size_t roadsCacheBytes)
 {
   return make_unique<IndexGraphLoaderImpl>(vehicleType, loadAltitudes, vehicleModelFactory,
-                                           estimator, dataSource, routingOptions);
+                                           estimator, dataSource, routingOptions, roadsCacheBytes);
 }
 
 void DeserializeIndexGraph(MwmValue const & mwmValue, VehicleType vehicleType, IndexGraph & graph)
@@ -239,11 +259,4 @@ void DeserializeIndexGraph(MwmValue const & mwmValue, VehicleType vehicleType, I
   if (ReadRoadAccessFromMwm(mwmValue, vehicleType, roadAccess))
     graph.SetRoadAccess(std::move(roadAccess));
 }
-
-uint32_t DeserializeIndexGraphNumRoads(MwmValue const & mwmValue, VehicleType vehicleType)
-{
-  FilesContainerR::TReader reader(mwmValue.m_cont.GetReader(ROUTING_FILE_TAG));
-  ReaderSource<FilesContainerR::TReader> src(reader);
-  return IndexGraphSerializer::DeserializeNumRoads(src, GetVehicleMask(vehicleType));
-}
 }  // namespace routing
@@ -30,17 +30,21 @@ public:
   virtual std::vector<RouteSegment::SpeedCamera> GetSpeedCameraInfo(Segment const & segment) = 0;
   virtual void Clear() = 0;
 
+  /// \returns road geometry cache counters summed over all loaded mwms.
+  virtual RoadsCacheStats GetRoadsCacheStats() const = 0;
+  /// \returns time spent on deserialization of index graph sections.
+  virtual double GetGraphsLoadSeconds() const = 0;
+
+  /// \param roadsCacheBytes road geometry cache size limit for every mwm, see Geometry.
   static std::unique_ptr<IndexGraphLoader> Create(
       VehicleType vehicleType, bool loadAltitudes,
       std::shared_ptr<VehicleModelFactoryInterface> vehicleModelFactory,
       std::shared_ptr<EdgeEstimator> estimator, MwmDataSource & dataSource,
-      RoutingOptions routingOptions = RoutingOptions());
+      RoutingOptions routingOptions = RoutingOptions(), size_t roadsCacheBytes = kRoadsCacheBytes);
 };
 
 void DeserializeIndexGraph(MwmValue const & mwmValue, VehicleType vehicleType, IndexGraph & graph);
 
-uint32_t DeserializeIndexGraphNumRoads(MwmValue const & mwmValue, VehicleType vehicleType);
-
 bool ReadRoadAccessFromMwm(MwmValue const & mwmValue, VehicleType vehicleType, RoadAccess & roadAccess);
 bool ReadSpeedCamsFromMwm(MwmValue const & mwmValue, SpeedCamerasMapT & camerasMap);
 }  // namespace routing
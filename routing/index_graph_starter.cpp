@@ -55,6 +55,19 @@ IndexGraphStarter::IndexGraphStarter(FakeEnding const & startEnding,
   m_startToFinishDistanceM = ms::DistanceOnEarth(startPoint, finishPoint);
 }
 
+IndexGraphStarter::IndexGraphStarter(IndexGraphStarter const & starter, WorldGraph & graph)
+  : m_graph(graph)
+  , m_start(starter.m_start)
+  , m_finish(starter.m_finish)
+  , m_startToFinishDistanceM(starter.m_startToFinishDistanceM)
+  , m_fake(starter.m_fake)
+  , m_guides(starter.m_guides)
+  , m_fakeNumerationStart(starter.m_fakeNumerationStart)
+  , m_otherEndings(starter.m_otherEndings)
+{
+  CHECK(!starter.IsRegionsGraphMode(), ());
+}
+
 void IndexGraphStarter::Append(FakeEdgesContainer const & container)
 {
   m_finish = container.m_finish;
@@ -165,12 +178,21 @@ bool IndexGraphStarter::CheckLength(RouteWeight const & weight)
   /// This additional penalty will be included in RouteWeight::GetIntegratedWeight().
   /// @see RussiaMoscowNotCrossingTollRoadTest
 
-  int8_t const changesAllowed = 2 + (HasNoPassThroughAllowed(m_start) ? 1 : 0) + (HasNoPassThroughAllowed(m_finish) ? 1 : 0);
+  return CheckLength(weight, GetPassThroughChangesAllowed());
+}
 
-  return weight.GetNumPassThroughChanges() <= changesAllowed &&
+bool IndexGraphStarter::CheckLength(RouteWeight const & weight,
+                                    int8_t passThroughChangesAllowed) const
+{
+  return weight.GetNumPassThroughChanges() <= passThroughChangesAllowed &&
          m_graph.CheckLength(weight, m_startToFinishDistanceM);
 }
 
+int8_t IndexGraphStarter::GetPassThroughChangesAllowed() const
+{
+  return 2 + (HasNoPassThroughAllowed(m_start) ? 1 : 0) + (HasNoPassThroughAllowed(m_finish) ? 1 : 0);
+}
+
 void IndexGraphStarter::GetEdgesList(astar::VertexData<Vertex, Weight> const & vertexData,
                                      bool isOutgoing, bool useAccessConditional,
                                      EdgeListT & edges) const
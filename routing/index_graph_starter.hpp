@@ -60,6 +60,9 @@ public:
   // place two fake edges to the m_segment with both directions.
   IndexGraphStarter(FakeEnding const & startEnding, FakeEnding const & finishEnding,
                     uint32_t fakeNumerationStart, bool strictForward, WorldGraph & graph);
+  // Copies fake edges and endings of |starter|, but routes over |graph|. Used to propagate
+  // the backward wave of the parallel bidirectional A* over its own graph.
+  IndexGraphStarter(IndexGraphStarter const & starter, WorldGraph & graph);
 
   void Append(FakeEdgesContainer const & container);
 
@@ -98,6 +101,10 @@ public:
   // Checks whether |weight| meets non-pass-through crossing restrictions according to placement of
   // start and finish in pass-through/non-pass-through area and number of non-pass-through crosses.
   bool CheckLength(RouteWeight const & weight);
+  // Same as CheckLength(weight), but with the number of pass-through/non-pass-through zone
+  // changes precomputed by GetPassThroughChangesAllowed(). Doesn't touch road geometry.
+  bool CheckLength(RouteWeight const & weight, int8_t passThroughChangesAllowed) const;
+  int8_t GetPassThroughChangesAllowed() const;
 
   void GetEdgeList(astar::VertexData<JointSegment, Weight> const & parentVertexData,
                    Segment const & segment, bool isOutgoing, JointEdgeListT & edges,
@@ -44,6 +44,7 @@
 #include "base/logging.hpp"
 #include "base/scope_guard.hpp"
 #include "base/stl_helpers.hpp"
+#include "base/timer.hpp"
 
 #include "defines.hpp"
 
@@ -72,6 +73,9 @@ double constexpr kAdjustRangeM = 5000.0;
 double constexpr kMinDistanceToFinishM = 10000;
 // Near MWMs criteria when choosing routing mode.
 double constexpr kCloseMwmPointsDistanceM = 300000;
+// Pass-through <-> non-pass-through zone changes allowed for a matrix route, the same as for
+// IndexGraphStarter::CheckLength() with start and finish both in non-pass-through zones.
+int8_t constexpr kMatrixPassThroughChangesAllowed = 4;
 
 double CalcMaxSpeed(NumMwmIds const & numMwmIds,
                     VehicleModelFactoryInterface const & vehicleModelFactory,
@@ -191,6 +195,20 @@ bool IsDeadEndCached(Segment const & segment, bool isOutgoing, bool useRoutingOp
 
   return false;
 }
+
+// Returns true if |lhs| and |rhs| have projections to the same segment in any direction.
+bool HaveCommonSegment(FakeEnding const & lhs, FakeEnding const & rhs)
+{
+  for (auto const & l : lhs.m_projections)
+  {
+    for (auto const & r : rhs.m_projections)
+    {
+      if (l.m_segment == r.m_segment || l.m_segment == r.m_segment.GetReversed())
+        return true;
+    }
+  }
+  return false;
+}
 }  // namespace
 
 
@@ -248,6 +266,7 @@ IndexRouter::IndexRouter(VehicleType vehicleType, bool loadAltitudes,
   , m_loadAltitudes(loadAltitudes)
   , m_name("astar-bidirectional-" + ToString(m_vehicleType))
   , m_dataSource(dataSource, numMwmIds)
+  , m_backwardDataSource(dataSource, numMwmIds)
   , m_vehicleModelFactory(CreateVehicleModelFactory(m_vehicleType, countryParentNameGetterFn))
   , m_countryFileFn(countryFileFn)
   , m_countryRectFn(countryRectFn)
@@ -281,10 +300,108 @@ unique_ptr<WorldGraph> IndexRouter::MakeSingleMwmWorldGraph()
 }
 
 void IndexRouter::ClearState()
+{
+  ClearRouteState();
+  // The graphs hold the handles.
+  m_keptGraph.reset();
+  m_keptBackwardGraph.reset();
+  m_dataSource.FreeHandles();
+  m_backwardDataSource.FreeHandles();
+}
+
+void IndexRouter::ClearRouteState()
 {
   m_roadGraph.ClearState();
   m_directionsEngine->Clear();
-  m_dataSource.FreeHandles();
+  m_crossMwmOverlayInvalidCells.reset();
+}
+
+void IndexRouter::CheckKeptWorldGraphs()
+{
+  if (!m_keptGraph && !m_keptBackwardGraph)
+    return;
+
+  if (!m_keepWorldGraph ||
+      RoutingOptions::LoadCarOptionsFromSettings().GetOptions() != m_keptGraphsOptions.GetOptions() ||
+      !m_dataSource.AreHandlesUpToDate() || !m_backwardDataSource.AreHandlesUpToDate())
+  {
+    ClearState();
+  }
+}
+
+CrossMwmOverlay const * IndexRouter::GetCrossMwmOverlay()
+{
+  if (!m_crossMwmOverlayEnabled || m_vehicleType != VehicleType::Car)
+    return nullptr;
+
+  // Shortcuts don't respect avoided roads.
+  if (RoutingOptions::LoadCarOptionsFromSettings().GetOptions() != 0)
+    return nullptr;
+
+  // The overlay is built for a certain World, which may be updated while the router is alive.
+  auto const world = m_dataSource.GetWorldHandle();
+  auto const worldVersion = world.IsAlive() ? world.GetInfo()->GetVersion() : 0;
+  if (m_crossMwmOverlay &&
+      (m_crossMwmOverlayWorldId != world.GetId() || m_crossMwmOverlayWorldVersion != worldVersion))
+  {
+    m_crossMwmOverlay.reset();
+    m_crossMwmOverlayInvalidCells.reset();
+  }
+
+  if (!m_crossMwmOverlay)
+  {
+    m_crossMwmOverlay = make_unique<CrossMwmOverlay>();
+    m_crossMwmOverlayWorldId = world.GetId();
+    m_crossMwmOverlayWorldVersion = worldVersion;
+
+    if (!world.IsAlive() || !world.GetValue()->m_cont.IsExist(CROSS_MWM_OVERLAY_FILE_TAG))
+    {
+      LOG(LINFO, ("No", CROSS_MWM_OVERLAY_FILE_TAG, "section in World mwm."));
+      return nullptr;
+    }
+
+    try
+    {
+      ReaderSource<FilesContainerR::TReader> src(
+          world.GetValue()->m_cont.GetReader(CROSS_MWM_OVERLAY_FILE_TAG));
+      CrossMwmOverlaySerializer::Deserialize(*m_crossMwmOverlay, src, *m_numMwmIds);
+    }
+    catch (RootException const & e)
+    {
+      LOG(LERROR, ("Error while reading", CROSS_MWM_OVERLAY_FILE_TAG, "section:", e.Msg()));
+      m_crossMwmOverlay = make_unique<CrossMwmOverlay>();
+    }
+
+    LOG(LINFO, ("Cross mwm overlay cells:", m_crossMwmOverlay->GetCells().size()));
+  }
+
+  return m_crossMwmOverlay->IsEmpty() ? nullptr : m_crossMwmOverlay.get();
+}
+
+set<CrossMwmOverlay::CellId> const & IndexRouter::GetCrossMwmOverlayInvalidCells()
+{
+  CHECK(m_crossMwmOverlay, ());
+  if (m_crossMwmOverlayInvalidCells)
+    return *m_crossMwmOverlayInvalidCells;
+
+  m_crossMwmOverlayInvalidCells.emplace();
+
+  // Shortcuts are built for mwms of the same version as World.
+  auto const & cells = m_crossMwmOverlay->GetCells();
+  for (CrossMwmOverlay::CellId cellId = 0; cellId < cells.size(); ++cellId)
+  {
+    for (NumMwmId const numMwmId : cells[cellId].m_mwms)
+    {
+      auto const mwmId = m_dataSource.GetMwmId(numMwmId);
+      if (!mwmId.IsAlive() || mwmId.GetInfo()->GetVersion() != m_crossMwmOverlayWorldVersion)
+      {
+        m_crossMwmOverlayInvalidCells->insert(cellId);
+        break;
+      }
+    }
+  }
+
+  return *m_crossMwmOverlayInvalidCells;
 }
 
 bool IndexRouter::FindClosestProjectionToRoad(m2::PointD const & point,
@@ -336,11 +453,17 @@ RouterResultCode IndexRouter::CalculateRoute(Checkpoints const & checkpoints,
   auto const & startPoint = checkpoints.GetStart();
   auto const & finalPoint = checkpoints.GetFinish();
 
+  m_lastTimings = {};
+  m_lastRoadsCacheStats = {};
+
   try
   {
     SCOPE_GUARD(featureRoadGraphClear, [this]
     {
-      ClearState();
+      if (m_keepWorldGraph)
+        ClearRouteState();
+      else
+        ClearState();
     });
 
     if (adjustToPrevRoute && m_lastRoute && m_lastFakeEdges &&
@@ -547,7 +670,43 @@ RouterResultCode IndexRouter::DoCalculateRoute(Checkpoints const & checkpoints,
     return RouterResultCode::NeedMoreMaps;
 
   TrafficStash::Guard guard(m_trafficStash);
-  unique_ptr<WorldGraph> graph = MakeWorldGraph();
+  CheckKeptWorldGraphs();
+  if (!m_keptGraph)
+    m_keptGraphsOptions = RoutingOptions::LoadCarOptionsFromSettings();
+  unique_ptr<WorldGraph> graph = m_keptGraph ? std::move(m_keptGraph) : MakeWorldGraph();
+  unique_ptr<WorldGraph> backwardGraph;
+  if (m_parallelWavesEnabled)
+  {
+    backwardGraph = m_keptBackwardGraph ? std::move(m_keptBackwardGraph)
+                                        : MakeWorldGraph(m_backwardDataSource);
+  }
+
+  auto const getRoadsCacheStats = [&]()
+  {
+    auto stats = graph->GetRoadsCacheStats();
+    if (backwardGraph)
+      stats.Add(backwardGraph->GetRoadsCacheStats());
+    return stats;
+  };
+
+  // The load time and the cache counters are accumulated by a kept graph.
+  double const graphLoadSec = graph->GetGraphsLoadSeconds();
+  auto const roadsCacheStats = getRoadsCacheStats();
+  SCOPE_GUARD(keepGraphs, [&]()
+  {
+    m_lastTimings.m_graphLoadSec = graph->GetGraphsLoadSeconds() - graphLoadSec;
+    m_lastRoadsCacheStats = getRoadsCacheStats();
+    m_lastRoadsCacheStats.m_hits -= roadsCacheStats.m_hits;
+    m_lastRoadsCacheStats.m_misses -= roadsCacheStats.m_misses;
+    m_lastRoadsCacheStats.m_evictions -= roadsCacheStats.m_evictions;
+    LOG(LDEBUG, ("Roads cache:", m_lastRoadsCacheStats));
+
+    if (m_keepWorldGraph)
+    {
+      m_keptGraph = std::move(graph);
+      m_keptBackwardGraph = std::move(backwardGraph);
+    }
+  });
 
   vector<Segment> segments;
 
@@ -583,8 +742,11 @@ RouterResultCode IndexRouter::DoCalculateRoute(Checkpoints const & checkpoints,
       bool const isLastSubroute = (i == subroutesCount - 1);
 
       bool startIsCodirectional = false;
-      switch (snapping.Snap(startCheckpoint, finishCheckpoint, startDirection,
-                            startFakeEnding, finishFakeEnding, startIsCodirectional))
+      base::Timer snappingTimer;
+      int const snappingResult = snapping.Snap(startCheckpoint, finishCheckpoint, startDirection,
+                                               startFakeEnding, finishFakeEnding, startIsCodirectional);
+      m_lastTimings.m_snappingSec += snappingTimer.ElapsedSeconds();
+      switch (snappingResult)
       {
       case 1: return RouterResultCode::StartPointNotFound;
       case 2: return isLastSubroute ? RouterResultCode::EndPointNotFound : RouterResultCode::IntermediatePointNotFound;
@@ -617,8 +779,10 @@ RouterResultCode IndexRouter::DoCalculateRoute(Checkpoints const & checkpoints,
     progress->AppendSubProgress(subProgress);
     SCOPE_GUARD(eraseProgress, [&progress]() { progress->PushAndDropLastSubProgress(); });
 
+    base::Timer aStarTimer;
     auto const result = CalculateSubroute(checkpoints, i, delegate, progress, subrouteStarter,
-                                          subroute, m_guides.IsAttached());
+                                          subroute, m_guides.IsAttached(), backwardGraph.get());
+    m_lastTimings.m_aStarSec += aStarTimer.ElapsedSeconds();
 
     if (result != RouterResultCode::NoError)
       return result;
@@ -653,7 +817,9 @@ RouterResultCode IndexRouter::DoCalculateRoute(Checkpoints const & checkpoints,
 
   // TODO (@gmoryes) https://jira.mail.ru/browse/MAPSME-10694
   //  We should do RedressRoute for each subroute separately.
+  base::Timer directionsTimer;
   auto redressResult = RedressRoute(segments, delegate.GetCancellable(), *starter, route);
+  m_lastTimings.m_directionsSec = directionsTimer.ElapsedSeconds();
   if (redressResult != RouterResultCode::NoError)
     return redressResult;
 
@@ -702,7 +868,8 @@ RouterResultCode IndexRouter::CalculateSubroute(Checkpoints const & checkpoints,
                                                 shared_ptr<AStarProgress> const & progress,
                                                 IndexGraphStarter & starter,
                                                 vector<Segment> & subroute,
-                                                bool guidesActive /* = false */)
+                                                bool guidesActive /* = false */,
+                                                WorldGraph * backwardGraph /* = nullptr */)
 {
   subroute.clear();
 
@@ -712,6 +879,9 @@ RouterResultCode IndexRouter::CalculateSubroute(Checkpoints const & checkpoints,
   LOG(LINFO, ("Routing in mode:", mode));
 
   base::ScopedTimerWithLog timer("Route build");
+  if (backwardGraph && (mode == WorldGraphMode::Joints || mode == WorldGraphMode::NoLeaps))
+    return CalculateSubrouteParallelMode(starter, *backwardGraph, delegate, progress, subroute);
+
   switch (mode)
   {
   case WorldGraphMode::Joints:
@@ -783,6 +953,42 @@ RouterResultCode IndexRouter::CalculateSubrouteNoLeapsMode(
   return result;
 }
 
+RouterResultCode IndexRouter::CalculateSubrouteParallelMode(
+    IndexGraphStarter & starter, WorldGraph & backwardGraph, RouterDelegate const & delegate,
+    shared_ptr<AStarProgress> const & progress, vector<Segment> & subroute)
+{
+  // IndexGraphStarterJoints creates fake joints while the wave is propagated, so it can't be
+  // shared by the waves. Both waves go by segments.
+  starter.GetGraph().SetMode(WorldGraphMode::NoLeaps);
+  backwardGraph.SetMode(WorldGraphMode::NoLeaps);
+  // Every wave reads roads by its own graph, the graphs share |m_estimator|, which has no
+  // mutable state, see EdgeEstimator.
+  IndexGraphStarter backwardStarter(starter, backwardGraph);
+
+  using Vertex = IndexGraphStarter::Vertex;
+  using Edge = IndexGraphStarter::Edge;
+  using Weight = IndexGraphStarter::Weight;
+
+  using Visitor = JunctionVisitor<IndexGraphStarter>;
+  Visitor visitor(starter, delegate, kVisitPeriod, progress);
+
+  AStarAlgorithm<Vertex, Edge, Weight>::Params<Visitor, AStarParallelLengthChecker> params(
+      starter, starter.GetStartSegment(), starter.GetFinishSegment(),
+      delegate.GetCancellable(), std::move(visitor), AStarParallelLengthChecker(starter));
+  params.m_backwardGraph = &backwardStarter;
+
+  RoutingResult<Vertex, Weight> routingResult;
+  set<NumMwmId> const mwmIds = starter.GetMwms();
+  RouterResultCode const result = FindPath<Vertex, Edge, Weight>(params, mwmIds, routingResult);
+
+  if (result != RouterResultCode::NoError)
+    return result;
+
+  LOG(LDEBUG, ("Result route weight:", routingResult.m_distance));
+  subroute = std::move(routingResult.m_path);
+  return result;
+}
+
 namespace
 {
 void CollapseForward_ReverseLoops(std::vector<Segment> & path)
@@ -812,9 +1018,15 @@ RouterResultCode IndexRouter::CalculateSubrouteLeapsOnlyMode(
   // Get cross-mwm routes-candidates.
   std::vector<RoutingResultT> candidates;
   std::vector<RouteWeight> candidateMidWeights;
+  // Set if a shortcut of the overlay can't be unpacked. The cell of the shortcut is invalidated
+  // then and the leaps are searched again.
+  bool overlayIsStale = false;
 
   {
-    LeapsGraph leapsGraph(starter, MwmHierarchyHandler(m_numMwmIds, m_countryParentNameGetterFn));
+    auto const * overlay = GetCrossMwmOverlay();
+    LeapsGraph leapsGraph(starter, MwmHierarchyHandler(m_numMwmIds, m_countryParentNameGetterFn),
+                          overlay, overlay ? GetCrossMwmOverlayInvalidCells()
+                                           : set<CrossMwmOverlay::CellId>());
 
     AStarSubProgress leapsProgress(mercator::ToLatLon(checkpoints.GetPoint(subrouteIdx)),
                                    mercator::ToLatLon(checkpoints.GetPoint(subrouteIdx + 1)),
@@ -863,6 +1075,15 @@ RouterResultCode IndexRouter::CalculateSubrouteLeapsOnlyMode(
     using AlgoT = AStarAlgorithm<Vertex, Edge, Weight>;
     auto const result = AlgoT().FindPathBidirectionalEx(params, [&](RoutingResultT && route)
     {
+      CrossMwmOverlay::CellId brokenCell = CrossMwmOverlay::kNoCell;
+      if (!leapsGraph.UnpackShortcuts(route.m_path, brokenCell))
+      {
+        CHECK(m_crossMwmOverlayInvalidCells, ());
+        m_crossMwmOverlayInvalidCells->insert(brokenCell);
+        overlayIsStale = true;
+        return true;
+      }
+
       // Take unique routes by key vertices.
       auto const be = getBegEnd(route);
       if (edges.insert(be).second)
@@ -880,9 +1101,13 @@ RouterResultCode IndexRouter::CalculateSubrouteLeapsOnlyMode(
       return (!routes.empty() && timer.ElapsedMilliseconds() > kTimeoutMilliS);
     });
 
-    if (routes.empty() || result == AlgoT::Result::Cancelled)
+    if (result == AlgoT::Result::Cancelled || (routes.empty() && !overlayIsStale))
       return ConvertResult<Vertex, Edge, Weight>(result);
 
+    // Routes found before the broken shortcut may be worse than the ones the search is rerun for.
+    if (overlayIsStale)
+      routes.clear();
+
     sort(routes.begin(), routes.end(), [](RoutingResultT const & l, RoutingResultT const & r)
     {
       return l.m_distance < r.m_distance;
@@ -949,6 +1174,11 @@ RouterResultCode IndexRouter::CalculateSubrouteLeapsOnlyMode(
     }
   }
 
+  // Every rerun invalidates one more cell, so the reruns are bounded by the number of cells.
+  if (overlayIsStale)
+    return CalculateSubrouteLeapsOnlyMode(checkpoints, subrouteIdx, starter, delegate, progress,
+                                          subroute);
+
   // Purge cross-mwm-graph cache memory before calculating subroutes for each MWM.
   // CrossMwmConnector takes a lot of memory with its weights matrix now.
   starter.GetGraph().GetCrossMwmGraph().Purge();
@@ -1009,6 +1239,164 @@ RouterResultCode IndexRouter::CalculateSubrouteLeapsOnlyMode(
   return RouterResultCode::NoError;
 }
 
+RouterResultCode IndexRouter::CalculateMatrix(vector<m2::PointD> const & sources,
+                                              vector<m2::PointD> const & destinations,
+                                              RouterDelegate const & delegate, Matrix & matrix,
+                                              double maxWeightSec)
+{
+  matrix.assign(sources.size(), vector<MatrixItem>(destinations.size()));
+  if (sources.empty() || destinations.empty())
+    return RouterResultCode::NoError;
+
+  base::ScopedTimerWithLog timer("Matrix build");
+
+  TrafficStash::Guard guard(m_trafficStash);
+  unique_ptr<WorldGraph> graph = MakeWorldGraph();
+  graph->SetMode(WorldGraphMode::NoLeaps);
+
+  PointsOnEdgesSnapping snapping(*this, *graph);
+  auto const snap = [&](m2::PointD const & point, bool isOutgoing)
+  {
+    vector<Segment> segments;
+    bool dummy;
+    if (!snapping.FindBestSegments(point, {} /* direction */, isOutgoing, segments, dummy))
+    {
+      LOG(LWARNING, ("Can't snap matrix point", mercator::ToLatLon(point), "to roads."));
+      return FakeEnding();
+    }
+    return MakeFakeEnding(segments, point, *graph);
+  };
+
+  vector<FakeEnding> finishEndings;
+  finishEndings.reserve(destinations.size());
+  for (auto const & point : destinations)
+    finishEndings.push_back(snap(point, false /* isOutgoing */));
+
+  RouteWeight const maxWeight =
+      maxWeightSec > 0.0 ? RouteWeight(maxWeightSec) : GetAStarWeightMax<RouteWeight>();
+
+  for (size_t i = 0; i < sources.size(); ++i)
+  {
+    FakeEnding const startEnding = snap(sources[i], true /* isOutgoing */);
+    if (startEnding.m_projections.empty())
+      continue;
+
+    // Fake graphs of all (source, destination) pairs are merged as for a route with
+    // intermediate points, so the start of the first pair is connected to all the finishes.
+    unique_ptr<IndexGraphStarter> starter;
+    vector<pair<Segment, size_t>> targets;
+    for (size_t j = 0; j < destinations.size(); ++j)
+    {
+      auto const & finishEnding = finishEndings[j];
+      if (finishEnding.m_projections.empty())
+        continue;
+
+      if (HaveCommonSegment(startEnding, finishEnding))
+      {
+        // Fake edges between projections to the same segment are built for the own start
+        // of a starter only, so such pair needs a separate wave.
+        IndexGraphStarter pairStarter(startEnding, finishEnding, 0 /* fakeNumerationStart */,
+                                      false /* strictForward */, *graph);
+        if (!CalculateMatrixRow(pairStarter, {{pairStarter.GetFinishSegment(), j}}, delegate,
+                                maxWeight, matrix[i]))
+        {
+          return RouterResultCode::Cancelled;
+        }
+        continue;
+      }
+
+      uint32_t const fakeNumerationStart = starter ? starter->GetNumFakeSegments() : 0;
+      IndexGraphStarter pairStarter(startEnding, finishEnding, fakeNumerationStart,
+                                    false /* strictForward */, *graph);
+      targets.emplace_back(pairStarter.GetFinishSegment(), j);
+
+      if (!starter)
+        starter = make_unique<IndexGraphStarter>(std::move(pairStarter));
+      else
+        starter->Append(FakeEdgesContainer(std::move(pairStarter)));
+    }
+
+    if (starter && !CalculateMatrixRow(*starter, targets, delegate, maxWeight, matrix[i]))
+      return RouterResultCode::Cancelled;
+  }
+
+  return RouterResultCode::NoError;
+}
+
+bool IndexRouter::CalculateMatrixRow(IndexGraphStarter & starter,
+                                     vector<pair<Segment, size_t>> const & targets,
+                                     RouterDelegate const & delegate, RouteWeight const & maxWeight,
+                                     vector<MatrixItem> & row) const
+{
+  using Algorithm = AStarAlgorithm<Segment, SegmentEdge, RouteWeight>;
+
+  map<Segment, size_t> finishToTarget;
+  for (auto const & target : targets)
+    finishToTarget.emplace(target.first, target.second);
+
+  Algorithm algorithm;
+  Algorithm::Context context(starter);
+
+  size_t notReached = finishToTarget.size();
+  uint32_t visitCount = 0;
+  bool cancelled = false;
+  auto const visitVertex = [&](Segment const & vertex)
+  {
+    if (++visitCount % kVisitPeriod == 0 && delegate.IsCancelled())
+    {
+      cancelled = true;
+      return false;
+    }
+
+    if (context.GetDistance(vertex) > maxWeight)
+      return false;
+
+    if (finishToTarget.count(vertex) != 0)
+      --notReached;
+    return notReached != 0;
+  };
+
+  auto const adjustEdgeWeight = [](Segment const & /* vertex */, SegmentEdge const & edge)
+  {
+    return edge.GetWeight();
+  };
+  auto const filterStates = [](auto const & state)
+  {
+    return state.distance.GetNumPassThroughChanges() <= kMatrixPassThroughChangesAllowed;
+  };
+  auto const reducedToRealLength = [](auto const & state) { return state.distance; };
+
+  algorithm.PropagateWave(starter, starter.GetStartSegment(), visitVertex, adjustEdgeWeight,
+                          filterStates, reducedToRealLength, context);
+  if (cancelled)
+    return false;
+
+  vector<Segment> path;
+  for (auto const & [finish, idx] : finishToTarget)
+  {
+    if (!context.HasDistance(finish) || context.GetDistance(finish) > maxWeight)
+      continue;
+
+    context.ReconstructPath(finish, path);
+    CHECK(!path.empty(), ());
+
+    auto & item = row[idx];
+    item.m_found = true;
+    item.m_etaSec = starter.CalculateETAWithoutPenalty(path.front());
+    item.m_distanceM = 0.0;
+    for (size_t i = 1; i < path.size(); ++i)
+      item.m_etaSec += starter.CalculateETA(path[i - 1], path[i]);
+
+    for (size_t i = 0; i < path.size(); ++i)
+    {
+      item.m_distanceM += ms::DistanceOnEarth(starter.GetRouteJunction(path, i).GetLatLon(),
+                                              starter.GetRouteJunction(path, i + 1).GetLatLon());
+    }
+  }
+
+  return true;
+}
+
 RouterResultCode IndexRouter::AdjustRoute(Checkpoints const & checkpoints,
                                           m2::PointD const & startDirection,
                                           RouterDelegate const & delegate, Route & route)
@@ -1107,7 +1495,7 @@ RouterResultCode IndexRouter::AdjustRoute(Checkpoints const & checkpoints,
   return RouterResultCode::NoError;
 }
 
-unique_ptr<WorldGraph> IndexRouter::MakeWorldGraph()
+unique_ptr<WorldGraph> IndexRouter::MakeWorldGraph(MwmDataSource & dataSource)
 {
   // Use saved routing options for all types (car, bicycle, pedestrian).
   RoutingOptions const routingOptions = RoutingOptions::LoadCarOptionsFromSettings();
@@ -1119,11 +1507,11 @@ unique_ptr<WorldGraph> IndexRouter::MakeWorldGraph()
   auto crossMwmGraph = make_unique<CrossMwmGraph>(
       m_numMwmIds, m_numMwmTree,
       m_vehicleType == VehicleType::Transit ? VehicleType::Pedestrian : m_vehicleType,
-      m_countryRectFn, m_dataSource);
+      m_countryRectFn, dataSource);
 
   auto indexGraphLoader = IndexGraphLoader::Create(
       m_vehicleType == VehicleType::Transit ? VehicleType::Pedestrian : m_vehicleType,
-      m_loadAltitudes, m_vehicleModelFactory, m_estimator, m_dataSource, routingOptions);
+      m_loadAltitudes, m_vehicleModelFactory, m_estimator, dataSource, routingOptions);
 
   if (m_vehicleType != VehicleType::Transit)
   {
@@ -1134,7 +1522,7 @@ unique_ptr<WorldGraph> IndexRouter::MakeWorldGraph()
     return graph;
   }
 
-  auto transitGraphLoader = TransitGraphLoader::Create(m_dataSource, m_estimator);
+  auto transitGraphLoader = TransitGraphLoader::Create(dataSource, m_estimator);
   return make_unique<TransitWorldGraph>(std::move(crossMwmGraph), std::move(indexGraphLoader),
                                         std::move(transitGraphLoader), m_estimator);
 }
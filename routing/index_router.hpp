@@ -4,16 +4,19 @@
 #include "routing/base/astar_progress.hpp"
 #include "routing/base/routing_result.hpp"
 
+#include "routing/cross_mwm_overlay.hpp"
 #include "routing/data_source.hpp"
 #include "routing/directions_engine.hpp"
 #include "routing/edge_estimator.hpp"
 #include "routing/fake_edges_container.hpp"
 #include "routing/features_road_graph.hpp"
+#include "routing/geometry.hpp"
 #include "routing/guides_connections.hpp"
 #include "routing/nearest_edge_finder.hpp"
 #include "routing/regions_decl.hpp"
 #include "routing/router.hpp"
 #include "routing/routing_callbacks.hpp"
+#include "routing/routing_options.hpp"
 #include "routing/segment.hpp"
 #include "routing/segmented_route.hpp"
 
@@ -27,6 +30,7 @@
 
 #include <functional>
 #include <memory>
+#include <optional>
 #include <set>
 #include <string>
 #include <vector>
@@ -89,6 +93,62 @@ public:
 
   VehicleType GetVehicleType() const { return m_vehicleType; }
 
+  /// Switches LeapsOnly mode to pass countries by precomputed shortcuts from the cross mwm
+  /// overlay section of World mwm (see CrossMwmOverlay). Disabled by default. Has no effect
+  /// if the section is absent or some roads are avoided by routing options.
+  void SetCrossMwmOverlayEnabled(bool enabled) { m_crossMwmOverlayEnabled = enabled; }
+
+  /// Propagates the forward and backward A* waves on two threads, see
+  /// AStarAlgorithm::FindPathBidirectionalParallel. The backward wave reads roads by its own
+  /// WorldGraph and mwm handles, so road caches take twice as much memory. Routes of Joints
+  /// mode are built in NoLeaps mode then, LeapsOnly routes are built as usual.
+  /// Disabled by default.
+  void SetParallelWavesEnabled(bool enabled) { m_parallelWavesEnabled = enabled; }
+
+  /// Keeps the world graphs with their index graphs and road caches, and the mwm handles
+  /// between CalculateRoute() calls, only the state of the last route is cleared. It's used when
+  /// many routes are built by one router, the memory is freed by ClearState() then. The graphs
+  /// are rebuilt if routing options are changed or an mwm is going to be updated.
+  /// Disabled by default.
+  void SetKeepWorldGraph(bool keep) { m_keepWorldGraph = keep; }
+
+  /// Wall time of the stages of the last CalculateRoute() call, in seconds.
+  /// Index graphs are loaded lazily while snapping and A* are running, so |m_graphLoadSec|
+  /// is a part of |m_snappingSec| and |m_aStarSec|.
+  struct Timings
+  {
+    double m_snappingSec = 0.0;
+    double m_aStarSec = 0.0;
+    double m_directionsSec = 0.0;
+    double m_graphLoadSec = 0.0;
+  };
+  Timings const & GetLastTimings() const { return m_lastTimings; }
+
+  /// Road geometry cache stats of the last CalculateRoute() call. The hits, misses and evictions
+  /// are counted during the call only, the roads and bytes are left in the caches after it.
+  RoadsCacheStats const & GetLastRoadsCacheStats() const { return m_lastRoadsCacheStats; }
+
+  /// Travel time and length of the best route between two points.
+  struct MatrixItem
+  {
+    bool m_found = false;
+    double m_etaSec = 0.0;
+    double m_distanceM = 0.0;
+  };
+  /// |matrix[i][j]| describes the route from |sources[i]| to |destinations[j]|.
+  using Matrix = std::vector<std::vector<MatrixItem>>;
+
+  /// \brief Calculates travel times and distances from every source to every destination.
+  /// One Dijkstra wave is propagated from every source until all the destinations are reached,
+  /// routes are not redressed, so no Route objects and turns are built.
+  /// \param maxWeightSec limits the weight of every route, 0 means no limit. Without the limit
+  /// the wave from a source covers all the reachable roads if some destination is unreachable.
+  /// \note Points which can't be snapped to roads leave their rows or columns not found.
+  RouterResultCode CalculateMatrix(std::vector<m2::PointD> const & sources,
+                                   std::vector<m2::PointD> const & destinations,
+                                   RouterDelegate const & delegate, Matrix & matrix,
+                                   double maxWeightSec = 0.0);
+
 private:
   RouterResultCode CalculateSubrouteJointsMode(IndexGraphStarter & starter,
                                                RouterDelegate const & delegate,
@@ -98,6 +158,11 @@ private:
                                                 RouterDelegate const & delegate,
                                                 std::shared_ptr<AStarProgress> const & progress,
                                                 std::vector<Segment> & subroute);
+  RouterResultCode CalculateSubrouteParallelMode(IndexGraphStarter & starter,
+                                                 WorldGraph & backwardGraph,
+                                                 RouterDelegate const & delegate,
+                                                 std::shared_ptr<AStarProgress> const & progress,
+                                                 std::vector<Segment> & subroute);
   RouterResultCode CalculateSubrouteLeapsOnlyMode(Checkpoints const & checkpoints,
                                                   size_t subrouteIdx, IndexGraphStarter & starter,
                                                   RouterDelegate const & delegate,
@@ -111,13 +176,26 @@ private:
                                      RouterDelegate const & delegate,
                                      std::shared_ptr<AStarProgress> const & progress,
                                      IndexGraphStarter & graph, std::vector<Segment> & subroute,
-                                     bool guidesActive = false);
+                                     bool guidesActive = false, WorldGraph * backwardGraph = nullptr);
 
   RouterResultCode AdjustRoute(Checkpoints const & checkpoints,
                                m2::PointD const & startDirection,
                                RouterDelegate const & delegate, Route & route);
 
-  std::unique_ptr<WorldGraph> MakeWorldGraph();
+  /// Fills |row[j]| for all the |targets| (finish segment, j) reachable from the start of |starter|.
+  /// \returns false if the calculation is cancelled.
+  bool CalculateMatrixRow(IndexGraphStarter & starter,
+                          std::vector<std::pair<Segment, size_t>> const & targets,
+                          RouterDelegate const & delegate, RouteWeight const & maxWeight,
+                          std::vector<MatrixItem> & row) const;
+
+  /// Clears the state of the last route, the kept world graphs and mwm handles are not touched.
+  void ClearRouteState();
+  /// Drops the kept world graphs if they can't be used for the next route.
+  void CheckKeptWorldGraphs();
+
+  std::unique_ptr<WorldGraph> MakeWorldGraph() { return MakeWorldGraph(m_dataSource); }
+  std::unique_ptr<WorldGraph> MakeWorldGraph(MwmDataSource & dataSource);
 
   using EdgeProjectionT = IRoadGraph::EdgeProjectionT;
   class PointsOnEdgesSnapping
@@ -221,6 +299,11 @@ private:
                                 base::Cancellable const & cancellable, IndexGraphStarter & starter,
                                 Route & route);
 
+  /// @return nullptr if the overlay is disabled or unavailable.
+  CrossMwmOverlay const * GetCrossMwmOverlay();
+  /// @return Overlay cells with mwms which are not downloaded or are of other version than World.
+  std::set<CrossMwmOverlay::CellId> const & GetCrossMwmOverlayInvalidCells();
+
   bool AreSpeedCamerasProhibited(NumMwmId mwmID) const;
   bool AreMwmsNear(IndexGraphStarter const & starter) const;
   bool DoesTransitSectionExist(NumMwmId numMwmId);
@@ -273,6 +356,8 @@ private:
   bool m_loadAltitudes;
   std::string const m_name;
   MwmDataSource m_dataSource;
+  // Used by the backward wave if |m_parallelWavesEnabled|.
+  MwmDataSource m_backwardDataSource;
   std::shared_ptr<VehicleModelFactoryInterface> m_vehicleModelFactory;
 
   TCountryFileFn const m_countryFileFn;
@@ -286,10 +371,29 @@ private:
   std::unique_ptr<DirectionsEngine> m_directionsEngine;
   std::unique_ptr<SegmentedRoute> m_lastRoute;
   std::unique_ptr<FakeEdgesContainer> m_lastFakeEdges;
+  Timings m_lastTimings;
+  RoadsCacheStats m_lastRoadsCacheStats;
 
   // If a ckeckpoint is near to the guide track we need to build route through this track.
   GuidesConnections m_guides;
 
   CountryParentNameGetterFn m_countryParentNameGetterFn;
+
+  bool m_crossMwmOverlayEnabled = false;
+  bool m_parallelWavesEnabled = false;
+  bool m_keepWorldGraph = false;
+  // Graphs of the last route if |m_keepWorldGraph|, they hold handles of |m_dataSource| and
+  // |m_backwardDataSource|. Are built with |m_keptGraphsOptions|.
+  std::unique_ptr<WorldGraph> m_keptGraph;
+  std::unique_ptr<WorldGraph> m_keptBackwardGraph;
+  RoutingOptions m_keptGraphsOptions;
+  // Loaded on demand, empty if there is no overlay section.
+  std::unique_ptr<CrossMwmOverlay> m_crossMwmOverlay;
+  // World mwm |m_crossMwmOverlay| is loaded from, the overlay is reloaded if World is changed.
+  MwmSet::MwmId m_crossMwmOverlayWorldId;
+  int64_t m_crossMwmOverlayWorldVersion = 0;
+  // Depend on downloaded mwms, so are updated on ClearState(). Cells with shortcuts which
+  // can't be unpacked are added while routing.
+  std::optional<std::set<CrossMwmOverlay::CellId>> m_crossMwmOverlayInvalidCells;
 };
 }  // namespace routing
@@ -4,19 +4,34 @@
 #include "routing/index_graph_starter.hpp"
 
 #include "base/assert.hpp"
+#include "base/logging.hpp"
 
 #include <set>
 #include <utility>
 
 namespace routing
 {
-LeapsGraph::LeapsGraph(IndexGraphStarter & starter, MwmHierarchyHandler && hierarchyHandler)
-  : m_starter(starter), m_hierarchyHandler(std::move(hierarchyHandler))
+LeapsGraph::LeapsGraph(IndexGraphStarter & starter, MwmHierarchyHandler && hierarchyHandler,
+                       CrossMwmOverlay const * overlay,
+                       std::set<CrossMwmOverlay::CellId> noShortcutCells)
+  : m_starter(starter)
+  , m_hierarchyHandler(std::move(hierarchyHandler))
+  , m_overlay(overlay)
+  , m_noShortcutCells(std::move(noShortcutCells))
 {
   m_startPoint = m_starter.GetPoint(m_starter.GetStartSegment(), true /* front */);
   m_finishPoint = m_starter.GetPoint(m_starter.GetFinishSegment(), true /* front */);
   m_startSegment = m_starter.GetStartSegment();
   m_finishSegment = m_starter.GetFinishSegment();
+
+  if (m_overlay)
+  {
+    for (auto const & mwms : {m_starter.GetStartMwms(), m_starter.GetFinishMwms()})
+    {
+      for (NumMwmId const mwmId : mwms)
+        m_noShortcutCells.insert(m_overlay->GetCell(mwmId));
+    }
+  }
 }
 
 void LeapsGraph::GetOutgoingEdgesList(astar::VertexData<Vertex, Weight> const & vertexData,
@@ -74,6 +89,9 @@ void LeapsGraph::GetEdgesList(Segment const & segment, bool isOutgoing, EdgeList
     return;
   }
 
+  if (IsInSkippedCell(segment) && m_overlay->GetShortcuts(segment, isOutgoing, edges))
+    return;
+
   if (isOutgoing)
     crossMwmGraph.GetOutgoingEdgeList(segment, edges);
   else
@@ -110,6 +128,15 @@ void LeapsGraph::GetEdgesListToFinish(EdgeListT & edges) const
   }
 }
 
+bool LeapsGraph::IsInSkippedCell(Segment const & segment) const
+{
+  if (!m_overlay)
+    return false;
+
+  auto const cellId = m_overlay->GetCell(segment.GetMwmId());
+  return cellId != CrossMwmOverlay::kNoCell && m_noShortcutCells.count(cellId) == 0;
+}
+
 ms::LatLon const & LeapsGraph::GetPoint(Segment const & segment, bool front) const
 {
   return m_starter.GetPoint(segment, front);
@@ -120,6 +147,48 @@ RouteWeight LeapsGraph::GetAStarWeightEpsilon()
   return m_starter.GetAStarWeightEpsilon();
 }
 
+bool LeapsGraph::UnpackShortcuts(std::vector<Segment> & path, CrossMwmOverlay::CellId & brokenCell)
+{
+  if (!m_overlay)
+    return true;
+
+  // |path| is {start, exit, enter, exit, enter, ..., exit, enter, finish}.
+  std::vector<Segment> unpacked;
+  unpacked.reserve(path.size());
+
+  size_t i = 0;
+  for (; i + 1 < path.size(); ++i)
+  {
+    Segment const & enter = path[i];
+    Segment const & exit = path[i + 1];
+    if (i % 2 == 1 || i + 2 == path.size() || !IsInSkippedCell(enter))
+    {
+      unpacked.push_back(enter);
+      continue;
+    }
+
+    auto const cellId = m_overlay->GetCell(enter.GetMwmId());
+    ASSERT_EQUAL(cellId, m_overlay->GetCell(exit.GetMwmId()), (enter, exit));
+
+    cross_mwm_overlay::CellRouter<CrossMwmGraph> router(m_starter.GetGraph().GetCrossMwmGraph(),
+                                                       m_overlay->GetCells()[cellId].m_mwms);
+    router.Run(enter, exit);
+    if (!router.GetPath(exit, unpacked))
+    {
+      LOG(LWARNING, ("Shortcut", enter, exit, "of cell", cellId, "can't be unpacked."));
+      brokenCell = cellId;
+      return false;
+    }
+    ++i;
+  }
+
+  if (i < path.size())
+    unpacked.push_back(path[i]);
+
+  path = std::move(unpacked);
+  return true;
+}
+
 RouteWeight LeapsGraph::CalcMiddleCrossMwmWeight(std::vector<Segment> const & path)
 {
   ASSERT_GREATER(path.size(), 1, ());
@@ -2,12 +2,14 @@
 
 #include "routing/base/astar_graph.hpp"
 #include "routing/base/astar_vertex_data.hpp"
+#include "routing/cross_mwm_overlay.hpp"
 #include "routing/mwm_hierarchy_handler.hpp"
 #include "routing/route_weight.hpp"
 #include "routing/segment.hpp"
 
 #include "geometry/latlon.hpp"
 
+#include <set>
 #include <vector>
 
 namespace routing
@@ -17,7 +19,11 @@ class IndexGraphStarter;
 class LeapsGraph : public AStarGraph<Segment, SegmentEdge, RouteWeight>
 {
 public:
-  LeapsGraph(IndexGraphStarter & starter, MwmHierarchyHandler && hierarchyHandler);
+  /// If |overlay| is set, cells of the overlay without start and finish are passed
+  /// by shortcuts, see UnpackShortcuts(). Cells from |noShortcutCells| are never passed by them.
+  LeapsGraph(IndexGraphStarter & starter, MwmHierarchyHandler && hierarchyHandler,
+             CrossMwmOverlay const * overlay = nullptr,
+             std::set<CrossMwmOverlay::CellId> noShortcutCells = {});
 
   // AStarGraph overrides:
   // @{
@@ -35,12 +41,20 @@ public:
 
   RouteWeight CalcMiddleCrossMwmWeight(std::vector<Segment> const & path);
 
+  /// Replaces overlay shortcuts in |path| found by A* with the leaps they consist of,
+  /// so the path consists of (enter, exit) pairs of the same mwm again.
+  /// @return false if a shortcut can't be unpacked, e.g. the overlay doesn't match the cross mwm
+  /// sections of the mwms. |brokenCell| is the cell of the shortcut then.
+  bool UnpackShortcuts(std::vector<Segment> & path, CrossMwmOverlay::CellId & brokenCell);
+
 private:
   void GetEdgesList(Segment const & segment, bool isOutgoing, EdgeListT & edges);
 
   void GetEdgesListFromStart(EdgeListT & edges) const;
   void GetEdgesListToFinish(EdgeListT & edges) const;
 
+  bool IsInSkippedCell(Segment const & segment) const;
+
 private:
   ms::LatLon m_startPoint;
   ms::LatLon m_finishPoint;
@@ -51,5 +65,9 @@ private:
   IndexGraphStarter & m_starter;
 
   MwmHierarchyHandler m_hierarchyHandler;
+
+  CrossMwmOverlay const * m_overlay;
+  // Overlay cells which should be routed through without shortcuts, e.g. with start or finish.
+  std::set<CrossMwmOverlay::CellId> m_noShortcutCells;
 };
 }  // namespace routing
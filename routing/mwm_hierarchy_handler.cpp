@@ -43,8 +43,6 @@ bool IsInSet(CountrySetT const & theSet, std::string const & country)
 } // namespace
 
 
-/// @return Top level hierarchy name for MWMs \a mwmName.
-/// @note May be empty for the disputed territories.
 std::string GetCountryByMwmName(std::string const & mwmName, CountryParentNameGetterFn const & fn)
 {
   std::string country = mwmName;
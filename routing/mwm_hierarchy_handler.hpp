@@ -11,6 +11,9 @@
 
 namespace routing
 {
+/// @return Top level hierarchy name for MWMs \a mwmName.
+/// @note May be empty for the disputed territories.
+std::string GetCountryByMwmName(std::string const & mwmName, CountryParentNameGetterFn const & fn);
 
 /// Class for calculating penalty while crossing country borders. Also finds parent country for mwm.
 class MwmHierarchyHandler
@@ -142,6 +142,50 @@ std::future<RoutesBuilder::Result> RoutesBuilder::ProcessTaskAsync(Params const
   return m_threadPool.Submit(std::move(processor), params);
 }
 
+RoutesBuilder::MatrixResult RoutesBuilder::ProcessMatrixTask(MatrixParams const & params)
+{
+  Processor processor(m_numMwmIds, m_dataSourcesStorage, m_cpg, m_cig);
+  return processor(params);
+}
+
+std::future<RoutesBuilder::MatrixResult> RoutesBuilder::ProcessMatrixTaskAsync(MatrixParams const & params)
+{
+  Processor processor(m_numMwmIds, m_dataSourcesStorage, m_cpg, m_cig);
+  return m_threadPool.Submit(std::move(processor), params);
+}
+
+std::future<RoutesBuilder::Result> RoutesBuilder::ProcessTaskWarmAsync(Params const & params)
+{
+  return m_threadPool.Submit([this](Params const & params) {
+    auto processor = GetWarmProcessor();
+    SCOPE_GUARD(returnProcessor, [&]() { PushWarmProcessor(std::move(processor)); });
+    return (*processor)(params);
+  }, params);
+}
+
+std::unique_ptr<RoutesBuilder::Processor> RoutesBuilder::GetWarmProcessor()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_warmProcessorsMutex);
+    if (!m_warmProcessors.empty())
+    {
+      auto processor = std::move(m_warmProcessors.back());
+      m_warmProcessors.pop_back();
+      return processor;
+    }
+  }
+
+  // No more tasks than threads are in progress, so a free data source exists.
+  return std::make_unique<Processor>(m_numMwmIds, m_dataSourcesStorage, m_cpg, m_cig,
+                                     true /* keepDataSource */);
+}
+
+void RoutesBuilder::PushWarmProcessor(std::unique_ptr<Processor> && processor)
+{
+  std::lock_guard<std::mutex> lock(m_warmProcessorsMutex);
+  m_warmProcessors.emplace_back(std::move(processor));
+}
+
 // RoutesBuilder::Result ---------------------------------------------------------------------------
 
 // static
@@ -228,8 +272,10 @@ std::vector<ms::LatLon> RoutesBuilder::Route::GetWaypoints() const
 RoutesBuilder::Processor::Processor(std::shared_ptr<NumMwmIds> numMwmIds,
                                     DataSourceStorage & dataSourceStorage,
                                     std::weak_ptr<storage::CountryParentGetter> cpg,
-                                    std::weak_ptr<storage::CountryInfoGetter> cig)
-    : m_numMwmIds(std::move(numMwmIds))
+                                    std::weak_ptr<storage::CountryInfoGetter> cig,
+                                    bool keepDataSource)
+    : m_keepDataSource(keepDataSource)
+    , m_numMwmIds(std::move(numMwmIds))
     , m_dataSourceStorage(dataSourceStorage)
     , m_cpg(std::move(cpg))
     , m_cig(std::move(cig))
@@ -242,13 +288,20 @@ RoutesBuilder::Processor::Processor(Processor && rhs) noexcept
   m_start = rhs.m_start;
   m_finish = rhs.m_finish;
 
+  m_dataSource = std::move(rhs.m_dataSource);
+  m_keepDataSource = rhs.m_keepDataSource;
   m_router = std::move(rhs.m_router);
   m_delegate = std::move(rhs.m_delegate);
   m_numMwmIds = std::move(rhs.m_numMwmIds);
   m_trafficCache = std::move(rhs.m_trafficCache);
   m_cpg = std::move(rhs.m_cpg);
   m_cig = std::move(rhs.m_cig);
-  m_dataSource = std::move(rhs.m_dataSource);
+}
+
+void RoutesBuilder::Processor::ReleaseDataSource()
+{
+  if (!m_keepDataSource)
+    m_dataSourceStorage.PushDataSource(std::move(m_dataSource));
 }
 
 void RoutesBuilder::Processor::InitRouter(VehicleType type)
@@ -280,15 +333,14 @@ void RoutesBuilder::Processor::InitRouter(VehicleType type)
                                            MakeNumMwmTree(*m_numMwmIds, *m_cig.lock()),
                                            *m_trafficCache,
                                            *m_dataSource);
+  m_router->SetKeepWorldGraph(m_keepDataSource);
 }
 
 RoutesBuilder::Result
 RoutesBuilder::Processor::operator()(Params const & params)
 {
   InitRouter(params.m_type);
-  SCOPE_GUARD(returnDataSource, [&]() {
-    m_dataSourceStorage.PushDataSource(std::move(m_dataSource));
-  });
+  SCOPE_GUARD(returnDataSource, [&]() { ReleaseDataSource(); });
 
   LOG(LINFO, ("Start building route, checkpoints:", params.m_checkpoints));
 
@@ -312,6 +364,8 @@ RoutesBuilder::Processor::operator()(Params const & params)
   }
 
   Result result;
+  result.m_timings = m_router->GetLastTimings();
+  result.m_roadsCacheStats = m_router->GetLastRoadsCacheStats();
   result.m_params.m_checkpoints = params.m_checkpoints;
   result.m_code = resultCode;
   result.m_buildTimeSeconds = timeSum / static_cast<double>(params.m_launchesNumber);
@@ -326,5 +380,26 @@ RoutesBuilder::Processor::operator()(Params const & params)
 
   return result;
 }
+
+RoutesBuilder::MatrixResult
+RoutesBuilder::Processor::operator()(MatrixParams const & params)
+{
+  InitRouter(params.m_type);
+  SCOPE_GUARD(returnDataSource, [&]() { ReleaseDataSource(); });
+
+  LOG(LINFO, ("Start building matrix, sources:", params.m_sources.size(),
+              "destinations:", params.m_destinations.size()));
+
+  CHECK(m_dataSource, ());
+
+  MatrixResult result;
+  m_delegate->SetTimeout(params.m_timeoutSeconds);
+  base::Timer timer;
+  result.m_code = m_router->CalculateMatrix(params.m_sources, params.m_destinations, *m_delegate,
+                                            result.m_matrix, params.m_maxWeightSec);
+  result.m_buildTimeSeconds = timer.ElapsedSeconds();
+
+  return result;
+}
 }  // namespace routes_builder
 }  // namespace routing
@@ -32,6 +32,7 @@
 #include <cstddef>
 #include <future>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -93,31 +94,70 @@ public:
     Params m_params;
     std::vector<Route> m_routes;
     double m_buildTimeSeconds = 0.0;
+    // Stages and roads cache stats of the last launch, are not dumped.
+    IndexRouter::Timings m_timings;
+    RoadsCacheStats m_roadsCacheStats;
+  };
+
+  struct MatrixParams
+  {
+    VehicleType m_type = VehicleType::Car;
+    std::vector<m2::PointD> m_sources;
+    std::vector<m2::PointD> m_destinations;
+    uint32_t m_timeoutSeconds = RouterDelegate::kNoTimeout;
+    // See IndexRouter::CalculateMatrix().
+    double m_maxWeightSec = 0.0;
+  };
+
+  struct MatrixResult
+  {
+    RouterResultCode m_code = RouterResultCode::RouteNotFound;
+    IndexRouter::Matrix m_matrix;
+    double m_buildTimeSeconds = 0.0;
   };
 
   Result ProcessTask(Params const & params);
   std::future<Result> ProcessTaskAsync(Params const & params);
 
+  /// Same as ProcessTaskAsync() but routers are not destroyed after tasks. Every router keeps
+  /// its data source and world graph, so opened mwms, loaded index graphs and road caches are
+  /// reused by the next tasks, see IndexRouter::SetKeepWorldGraph().
+  /// Routers hold data sources all the time, so these methods must not be mixed with the other
+  /// Process* methods in one RoutesBuilder.
+  std::future<Result> ProcessTaskWarmAsync(Params const & params);
+
+  MatrixResult ProcessMatrixTask(MatrixParams const & params);
+  std::future<MatrixResult> ProcessMatrixTaskAsync(MatrixParams const & params);
+
 private:
 
   class Processor
   {
   public:
+    /// \param keepDataSource if true, the data source is not returned to |dataSourceStorage|
+    /// after a task and is owned by the processor until its destruction.
     Processor(std::shared_ptr<NumMwmIds> numMwmIds,
               DataSourceStorage & dataSourceStorage,
               std::weak_ptr<storage::CountryParentGetter> cpg,
-              std::weak_ptr<storage::CountryInfoGetter> cig);
+              std::weak_ptr<storage::CountryInfoGetter> cig,
+              bool keepDataSource = false);
 
     Processor(Processor && rhs) noexcept;
 
     Result operator()(Params const & params);
+    MatrixResult operator()(MatrixParams const & params);
 
   private:
     void InitRouter(VehicleType type);
+    void ReleaseDataSource();
 
     ms::LatLon m_start;
     ms::LatLon m_finish;
 
+    // Declared before |m_router| which uses it, so it is destroyed after the router.
+    std::unique_ptr<FrozenDataSource> m_dataSource;
+    bool m_keepDataSource = false;
+
     std::unique_ptr<IndexRouter> m_router;
     std::shared_ptr<RouterDelegate> m_delegate = std::make_shared<RouterDelegate>();
 
@@ -126,9 +166,11 @@ private:
     DataSourceStorage & m_dataSourceStorage;
     std::weak_ptr<storage::CountryParentGetter> m_cpg;
     std::weak_ptr<storage::CountryInfoGetter> m_cig;
-    std::unique_ptr<FrozenDataSource> m_dataSource;
   };
 
+  std::unique_ptr<Processor> GetWarmProcessor();
+  void PushWarmProcessor(std::unique_ptr<Processor> && processor);
+
   base::thread_pool::computational::ThreadPool m_threadPool;
 
   std::shared_ptr<storage::CountryParentGetter> m_cpg =
@@ -140,6 +182,9 @@ private:
   std::shared_ptr<NumMwmIds> m_numMwmIds = std::make_shared<NumMwmIds>();
 
   DataSourceStorage m_dataSourcesStorage;
+
+  std::mutex m_warmProcessorsMutex;
+  std::vector<std::unique_ptr<Processor>> m_warmProcessors;
 };
 }  // namespace routes_builder
 }  // namespace routing
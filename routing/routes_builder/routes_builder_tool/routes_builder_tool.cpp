@@ -8,6 +8,7 @@
 #include "base/logging.hpp"
 
 #include <exception>
+#include <iostream>
 #include <string>
 #include <utility>
 #include <vector>
@@ -22,6 +23,21 @@ DEFINE_string(routes_file, "", "Path to file with routes in format: \n\t"
                                "second_start_lat second_start_lon second_finish_lat second_finish_lon\n\t"
                                "...");
 
+DEFINE_string(matrix_file, "", "Path to file with points in format: \n\t"
+                               "first_lat first_lon\n\t"
+                               "second_lat second_lon\n\t"
+                               "...\n"
+                               "Travel times and distances between all pairs of points are calculated "
+                               "instead of routes. Only for mapsme.");
+
+DEFINE_double(matrix_max_weight, 0.0, "Max route weight in seconds for --matrix_file, "
+                                      "0 means without limit (default: 0).");
+
+DEFINE_bool(service, false, "Service mode: read route requests from stdin and write responses to "
+                            "stdout, one JSON per line. Request format:\n\t"
+                            "{\"id\": 1, \"points\": [[lat, lon], [lat, lon]], \"vehicle_type\": \"car\"}\n"
+                            "Routers are kept between requests. Only for mapsme.");
+
 DEFINE_string(dump_path, "", "Path where routes will be dumped after building."
                              "Useful for intermediate results, because routes building "
                              "is a long process.");
@@ -58,6 +74,11 @@ bool IsApiBuild()
   return !FLAGS_routes_file.empty() && !FLAGS_api_name.empty() && !FLAGS_api_token.empty();
 }
 
+bool IsMatrixBuild()
+{
+  return FLAGS_routes_file.empty() && !FLAGS_matrix_file.empty() && FLAGS_api_name.empty();
+}
+
 void CheckDirExistence(std::string const & dir)
 {
   CHECK(Platform::IsDirectory(dir), ("Can not find directory:", dir));
@@ -71,8 +92,8 @@ int Main(int argc, char ** argv)
 
   CHECK_GREATER_OR_EQUAL(FLAGS_timeout, 0, ("Timeout should be greater than zero."));
 
-  CHECK(!FLAGS_routes_file.empty(),
-        ("\n\n\t--routes_file is required.",
+  CHECK(!FLAGS_routes_file.empty() || !FLAGS_matrix_file.empty() || FLAGS_service,
+        ("\n\n\t--routes_file, --matrix_file or --service is required.",
          "\n\nType --help for usage."));
 
   if (!FLAGS_data_path.empty())
@@ -81,8 +102,16 @@ int Main(int argc, char ** argv)
   if (!FLAGS_resources_path.empty())
     GetPlatform().SetResourceDir(FLAGS_resources_path);
 
-  CHECK(IsLocalBuild() || IsApiBuild(),
+  if (FLAGS_service)
+  {
+    ServeRoutes(std::cin, std::cout, FLAGS_threads, FLAGS_timeout, FLAGS_vehicle_type,
+                FLAGS_verbose);
+    return 0;
+  }
+
+  CHECK(IsLocalBuild() || IsApiBuild() || IsMatrixBuild(),
         ("\n\n\t--routes_file empty is:", FLAGS_routes_file.empty(),
+         "\n\t--matrix_file empty is:", FLAGS_matrix_file.empty(),
          "\n\t--api_name empty is:", FLAGS_api_name.empty(),
          "\n\t--api_token empty is:", FLAGS_api_token.empty(),
          "\n\nType --help for usage."));
@@ -111,6 +140,12 @@ int Main(int argc, char ** argv)
                 FLAGS_vehicle_type, FLAGS_verbose, launchesNumber);
   }
 
+  if (IsMatrixBuild())
+  {
+    BuildMatrix(FLAGS_matrix_file, FLAGS_dump_path, FLAGS_threads, FLAGS_timeout,
+                FLAGS_vehicle_type, FLAGS_matrix_max_weight, FLAGS_verbose);
+  }
+
   if (IsApiBuild())
   {
     auto api = CreateRoutingApi(FLAGS_api_name, FLAGS_api_token);
@@ -14,13 +14,19 @@
 #include "base/assert.hpp"
 #include "base/file_name_utils.hpp"
 #include "base/logging.hpp"
+#include "base/string_utils.hpp"
 #include "base/timer.hpp"
 
+#include "cppjansson/cppjansson.hpp"
+
 #include <algorithm>
 #include <array>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <future>
 #include <iostream>
+#include <mutex>
 #include <optional>
 #include <thread>
 #include <tuple>
@@ -47,7 +53,7 @@ size_t GetNumberOfLines(std::string const & filename)
   return count;
 }
 
-routing::VehicleType ConvertVehicleTypeFromString(std::string const & str)
+std::optional<routing::VehicleType> ParseVehicleType(std::string const & str)
 {
   if (str == "car")
     return routing::VehicleType::Car;
@@ -58,8 +64,132 @@ routing::VehicleType ConvertVehicleTypeFromString(std::string const & str)
   if (str == "transit")
     return routing::VehicleType::Transit;
 
-  CHECK(false, ("Unknown vehicle type:", str));
-  UNREACHABLE();
+  return {};
+}
+
+routing::VehicleType ConvertVehicleTypeFromString(std::string const & str)
+{
+  auto const type = ParseVehicleType(str);
+  CHECK(type, ("Unknown vehicle type:", str));
+  return *type;
+}
+
+struct ServiceRequest
+{
+  uint64_t m_id = 0;
+  // Set if the request can not be parsed.
+  std::optional<std::string> m_error;
+  RoutesBuilder::Params m_params;
+};
+
+ServiceRequest ParseServiceRequest(std::string const & line, uint64_t defaultId,
+                                   VehicleType defaultType, uint32_t timeoutSeconds)
+{
+  ServiceRequest request;
+  request.m_id = defaultId;
+
+  try
+  {
+    base::Json json(line);
+    json_t const * root = json.get();
+
+    if (auto const id = FromJSONObjectOptional<uint64_t>(root, "id"))
+      request.m_id = *id;
+
+    auto type = defaultType;
+    if (auto const typeStr = FromJSONObjectOptional<std::string>(root, "vehicle_type"))
+    {
+      auto const parsedType = ParseVehicleType(*typeStr);
+      if (!parsedType)
+        MYTHROW(base::Json::Exception, ("Unknown vehicle type:", *typeStr));
+      type = *parsedType;
+    }
+
+    json_t const * points = base::GetJSONObligatoryField(root, "points");
+    if (!json_is_array(points) || json_array_size(points) < 2)
+      MYTHROW(base::Json::Exception, ("The field points must contain at least two points."));
+
+    std::vector<m2::PointD> checkpoints;
+    for (size_t i = 0; i < json_array_size(points); ++i)
+    {
+      json_t const * point = json_array_get(points, i);
+      if (!json_is_array(point) || json_array_size(point) != 2)
+        MYTHROW(base::Json::Exception, ("A point must be an array [lat, lon]."));
+
+      double lat = 0.0;
+      double lon = 0.0;
+      FromJSON(json_array_get(point, 0), lat);
+      FromJSON(json_array_get(point, 1), lon);
+      checkpoints.push_back(mercator::FromLatLon(lat, lon));
+    }
+
+    request.m_params = RoutesBuilder::Params(type, std::move(checkpoints));
+    request.m_params.m_timeoutSeconds = timeoutSeconds;
+  }
+  catch (base::Json::Exception const & e)
+  {
+    request.m_error = e.Msg();
+  }
+
+  return request;
+}
+
+std::string MakeServiceResponse(uint64_t id, RoutesBuilder::Result const & result,
+                                double latencySeconds)
+{
+  auto root = base::NewJSONObject();
+  ToJSONObject(*root, "id", id);
+  ToJSONObject(*root, "code", DebugPrint(result.m_code));
+  if (result.IsCodeOK())
+  {
+    auto const & route = result.GetRoutes().front();
+    ToJSONObject(*root, "eta", route.m_eta);
+    ToJSONObject(*root, "distance", route.m_distance);
+  }
+
+  auto timings = base::NewJSONObject();
+  ToJSONObject(*timings, "latency", latencySeconds);
+  ToJSONObject(*timings, "build", result.m_buildTimeSeconds);
+  ToJSONObject(*timings, "snapping", result.m_timings.m_snappingSec);
+  ToJSONObject(*timings, "graph_load", result.m_timings.m_graphLoadSec);
+  ToJSONObject(*timings, "astar", result.m_timings.m_aStarSec);
+  ToJSONObject(*timings, "directions", result.m_timings.m_directionsSec);
+  ToJSONObject(*root, "timings", timings);
+
+  auto roadsCache = base::NewJSONObject();
+  ToJSONObject(*roadsCache, "hits", result.m_roadsCacheStats.m_hits);
+  ToJSONObject(*roadsCache, "misses", result.m_roadsCacheStats.m_misses);
+  ToJSONObject(*roadsCache, "evictions", result.m_roadsCacheStats.m_evictions);
+  ToJSONObject(*roadsCache, "bytes", result.m_roadsCacheStats.m_bytes);
+  ToJSONObject(*root, "roads_cache", roadsCache);
+
+  return base::DumpToString(root, JSON_COMPACT);
+}
+
+std::string MakeServiceError(uint64_t id, std::string const & error)
+{
+  auto root = base::NewJSONObject();
+  ToJSONObject(*root, "id", id);
+  ToJSONObject(*root, "error", error);
+  return base::DumpToString(root, JSON_COMPACT);
+}
+
+// |values| must be sorted.
+double GetPercentile(std::vector<double> const & values, double percent)
+{
+  if (values.empty())
+    return 0.0;
+
+  auto const index = static_cast<size_t>(percent / 100.0 * static_cast<double>(values.size()));
+  return values[std::min(index, values.size() - 1)];
+}
+
+void LogPercentiles(std::string const & name, std::vector<double> & values)
+{
+  std::sort(values.begin(), values.end());
+  LOG_FORCE(LINFO, (name, "seconds, p50:", GetPercentile(values, 50.0),
+                    "p90:", GetPercentile(values, 90.0), "p99:", GetPercentile(values, 99.0),
+                    "max:", values.empty() ? 0.0 : values.back()));
 }
 }  // namespace
 
@@ -145,6 +275,199 @@ void BuildRoutes(std::string const & routesPath,
   }
 }
 
+void BuildMatrix(std::string const & pointsPath,
+                 std::string const & dumpPath,
+                 uint64_t threadsNumber,
+                 uint32_t timeoutSeconds,
+                 std::string const & vehicleTypeStr,
+                 double maxWeightSec,
+                 bool verbose)
+{
+  CHECK(Platform::IsFileExistsByFullPath(pointsPath), ("Can not find file:", pointsPath));
+  CHECK(!dumpPath.empty(), ("Empty dumpPath."));
+
+  std::ifstream input(pointsPath);
+  CHECK(input.good(), ("Error during opening:", pointsPath));
+
+  std::vector<m2::PointD> points;
+  ms::LatLon latLon;
+  while (input >> latLon.m_lat >> latLon.m_lon)
+    points.push_back(mercator::FromLatLon(latLon));
+
+  if (!threadsNumber)
+  {
+    auto const hardwareConcurrency = std::thread::hardware_concurrency();
+    threadsNumber = hardwareConcurrency > 0 ? hardwareConcurrency : 2;
+  }
+
+  RoutesBuilder routesBuilder(threadsNumber);
+
+  // Every task calculates a block of rows, all the blocks share the destinations.
+  size_t const rowsPerTask = std::max<size_t>(1, (points.size() + threadsNumber - 1) / threadsNumber);
+  std::vector<std::future<RoutesBuilder::MatrixResult>> tasks;
+
+  auto const vehicleType = ConvertVehicleTypeFromString(vehicleTypeStr);
+  base::ScopedLogLevelChanger changer(verbose ? base::LogLevel::LINFO : base::LogLevel::LERROR);
+
+  RoutesBuilder::MatrixParams params;
+  params.m_type = vehicleType;
+  params.m_timeoutSeconds = timeoutSeconds;
+  params.m_maxWeightSec = maxWeightSec;
+  params.m_destinations = points;
+  for (size_t begin = 0; begin < points.size(); begin += rowsPerTask)
+  {
+    auto const end = std::min(points.size(), begin + rowsPerTask);
+    params.m_sources.assign(points.begin() + begin, points.begin() + end);
+    tasks.emplace_back(routesBuilder.ProcessMatrixTaskAsync(params));
+  }
+
+  LOG_FORCE(LINFO, ("Created:", tasks.size(), "tasks for", points.size(), "x", points.size(),
+                    "matrix, vehicle type:", vehicleType));
+
+  std::string const fullPath = base::JoinPath(dumpPath, "matrix.csv");
+  std::ofstream output(fullPath);
+  CHECK(output.good(), ("Error during opening:", fullPath));
+  output << "source,destination,eta_sec,distance_m\n";
+
+  base::Timer timer;
+  size_t found = 0;
+  size_t source = 0;
+  for (auto & task : tasks)
+  {
+    auto const result = task.get();
+    if (result.m_code != RouterResultCode::NoError)
+      LOG_FORCE(LWARNING, ("Matrix rows from:", source, "are not built, code:", result.m_code));
+
+    for (auto const & row : result.m_matrix)
+    {
+      for (size_t destination = 0; destination < row.size(); ++destination)
+      {
+        auto const & item = row[destination];
+        if (!item.m_found)
+          continue;
+
+        ++found;
+        output << source << ',' << destination << ',' << item.m_etaSec << ','
+               << item.m_distanceM << '\n';
+      }
+      ++source;
+    }
+  }
+
+  LOG_FORCE(LINFO, ("BuildMatrix() took:", timer.ElapsedSeconds(), "seconds, found:", found,
+                    "of", points.size() * points.size(), "routes."));
+}
+
+void ServeRoutes(std::istream & input,
+                 std::ostream & output,
+                 uint64_t threadsNumber,
+                 uint32_t timeoutSeconds,
+                 std::string const & vehicleTypeStr,
+                 bool verbose)
+{
+  if (!threadsNumber)
+  {
+    auto const hardwareConcurrency = std::thread::hardware_concurrency();
+    threadsNumber = hardwareConcurrency > 0 ? hardwareConcurrency : 2;
+  }
+
+  RoutesBuilder routesBuilder(threadsNumber);
+  auto const vehicleType = ConvertVehicleTypeFromString(vehicleTypeStr);
+  base::ScopedLogLevelChanger changer(verbose ? base::LogLevel::LINFO : base::LogLevel::LERROR);
+
+  struct Task
+  {
+    uint64_t m_id = 0;
+    std::optional<std::string> m_error;
+    std::future<RoutesBuilder::Result> m_result;
+    base::Timer m_timer;
+  };
+
+  // Responses are written by a separate thread in the order of requests, so a client
+  // gets a response without sending the next request.
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<Task> tasks;
+  bool inputFinished = false;
+
+  size_t errors = 0;
+  std::vector<double> buildTimes;
+  std::vector<double> latencies;
+  std::thread writer([&]() {
+    while (true)
+    {
+      Task task;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&]() { return !tasks.empty() || inputFinished; });
+        if (tasks.empty())
+          return;
+
+        task = std::move(tasks.front());
+        tasks.pop_front();
+      }
+
+      if (task.m_error)
+      {
+        ++errors;
+        output << MakeServiceError(task.m_id, *task.m_error) << std::endl;
+        continue;
+      }
+
+      auto const result = task.m_result.get();
+      double const latency = task.m_timer.ElapsedSeconds();
+      latencies.push_back(latency);
+      if (result.IsCodeOK())
+        buildTimes.push_back(result.m_buildTimeSeconds);
+
+      output << MakeServiceResponse(task.m_id, result, latency) << std::endl;
+    }
+  });
+
+  LOG_FORCE(LINFO, ("Waiting for requests, threads:", threadsNumber, "default vehicle type:",
+                    vehicleType));
+
+  base::Timer timer;
+  uint64_t requestsNumber = 0;
+  std::string line;
+  while (std::getline(input, line))
+  {
+    strings::Trim(line);
+    if (line.empty())
+      continue;
+
+    auto request = ParseServiceRequest(line, requestsNumber, vehicleType, timeoutSeconds);
+    ++requestsNumber;
+
+    Task task;
+    task.m_id = request.m_id;
+    task.m_error = std::move(request.m_error);
+    if (!task.m_error)
+      task.m_result = routesBuilder.ProcessTaskWarmAsync(request.m_params);
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      tasks.push_back(std::move(task));
+    }
+    cv.notify_one();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    inputFinished = true;
+  }
+  cv.notify_one();
+  writer.join();
+
+  double const elapsed = timer.ElapsedSeconds();
+  LOG_FORCE(LINFO, ("Served:", requestsNumber, "requests in", elapsed, "seconds,",
+                    elapsed > 0.0 ? static_cast<double>(requestsNumber) / elapsed : 0.0,
+                    "requests per second. Invalid requests:", errors, "found routes:",
+                    buildTimes.size()));
+  LogPercentiles("Build time of found routes,", buildTimes);
+  LogPercentiles("Latency,", latencies);
+}
+
 std::optional<std::tuple<ms::LatLon, ms::LatLon, int32_t>> ParseApiLine(std::ifstream & input)
 {
   std::string line;
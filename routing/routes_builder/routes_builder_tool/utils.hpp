@@ -5,6 +5,7 @@
 #include "routing/routes_builder/routes_builder.hpp"
 
 #include <cstdint>
+#include <iostream>
 #include <memory>
 #include <string>
 #include <vector>
@@ -22,6 +23,29 @@ void BuildRoutes(std::string const & routesPath,
                  bool verbose,
                  uint32_t launchesNumber);
 
+/// Calculates travel times and distances between all pairs of points from |pointsPath|
+/// and writes them to |dumpPath|/matrix.csv.
+void BuildMatrix(std::string const & pointsPath,
+                 std::string const & dumpPath,
+                 uint64_t threadsNumber,
+                 uint32_t timeoutSeconds,
+                 std::string const & vehicleType,
+                 double maxWeightSec,
+                 bool verbose);
+
+/// Builds routes for requests read from |input|, one JSON per line:
+///   {"id": 1, "points": [[lat, lon], [lat, lon], ...], "vehicle_type": "car"}
+/// "id" and "vehicle_type" are optional. A response is written to |output| as one JSON line per
+/// request in the same order, with the route ETA, distance and timings of the stages.
+/// Routers keep their data sources and world graphs between requests, so steady-state
+/// performance is measured. Throughput and latency percentiles are logged when |input| is over.
+void ServeRoutes(std::istream & input,
+                 std::ostream & output,
+                 uint64_t threadsNumber,
+                 uint32_t timeoutSeconds,
+                 std::string const & vehicleType,
+                 bool verbose);
+
 void BuildRoutesWithApi(std::unique_ptr<routing_quality::api::RoutingApi> routingApi,
                         std::string const & routesPath,
                         std::string const & dumpPath,
@@ -178,6 +178,18 @@ bool AStarLengthChecker::operator()(RouteWeight const & weight) const
   return m_starter.CheckLength(weight);
 }
 
+// AStarParallelLengthChecker ----------------------------------------------------------------------
+
+AStarParallelLengthChecker::AStarParallelLengthChecker(IndexGraphStarter const & starter)
+  : m_starter(starter), m_passThroughChangesAllowed(starter.GetPassThroughChangesAllowed())
+{
+}
+
+bool AStarParallelLengthChecker::operator()(RouteWeight const & weight) const
+{
+  return m_starter.CheckLength(weight, m_passThroughChangesAllowed);
+}
+
 // AdjustLengthChecker -----------------------------------------------------------------------------
 
 AdjustLengthChecker::AdjustLengthChecker(IndexGraphStarter & starter) : m_starter(starter) {}
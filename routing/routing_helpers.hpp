@@ -91,6 +91,16 @@ struct AStarLengthChecker
   IndexGraphStarter & m_starter;
 };
 
+// Used by both waves of the parallel bidirectional A*, so the pass-through restriction
+// of |starter| is evaluated once, before the waves touch the road geometry.
+struct AStarParallelLengthChecker
+{
+  explicit AStarParallelLengthChecker(IndexGraphStarter const & starter);
+  bool operator()(RouteWeight const & weight) const;
+  IndexGraphStarter const & m_starter;
+  int8_t const m_passThroughChangesAllowed;
+};
+
 struct AdjustLengthChecker
 {
   explicit AdjustLengthChecker(IndexGraphStarter & starter);
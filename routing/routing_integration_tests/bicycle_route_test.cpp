@@ -1,11 +1,14 @@
 #include "testing/testing.hpp"
 
+#include "routing/index_router.hpp"
 #include "routing/routing_callbacks.hpp"
 
 #include "routing/routing_integration_tests/routing_test_tools.hpp"
 
 #include "geometry/mercator.hpp"
 
+#include "base/math.hpp"
+
 
 namespace bicycle_route_test
 {
@@ -300,4 +303,26 @@ UNIT_TEST(IgnoreCycleBarrier_WithoutAccess)
                                    mercator::FromLatLon(51.3576973, -2.31416085), 11131.6);
 }
 
+// The route crosses several countries. Parallel waves go by segments instead of joints,
+// but should find a route as good as the sequential A*.
+UNIT_TEST(NetherlandsGermany_AmsterdamBerlin_ParallelWaves)
+{
+  auto const start = mercator::FromLatLon(52.37306, 4.89248);
+  auto const finish = mercator::FromLatLon(52.51668, 13.37760);
+
+  TRouteResult const expected =
+      CalculateRoute(GetVehicleComponents(VehicleType::Bicycle), start, {0.0, 0.0}, finish);
+  TEST_EQUAL(expected.second, RouterResultCode::NoError, ());
+
+  auto const components = CreateAllMapsComponents(VehicleType::Bicycle, {} /* skipMaps */);
+  dynamic_cast<IndexRouter &>(components->GetRouter()).SetParallelWavesEnabled(true);
+
+  TRouteResult const actual = CalculateRoute(*components, start, {0.0, 0.0}, finish);
+  TEST_EQUAL(actual.second, RouterResultCode::NoError, ());
+
+  TEST(base::AlmostEqualRel(actual.first->GetTotalTimeSec(), expected.first->GetTotalTimeSec(), 1e-3),
+       (actual.first->GetTotalTimeSec(), expected.first->GetTotalTimeSec()));
+  TestRouteLength(*actual.first, expected.first->GetTotalDistanceMeters());
+}
+
 } // namespace bicycle_route_test
@@ -0,0 +1,72 @@
+#include "testing/testing.hpp"
+
+#include "routing/routing_integration_tests/routing_test_tools.hpp"
+
+#include "routing/index_router.hpp"
+#include "routing/router_delegate.hpp"
+
+#include "geometry/mercator.hpp"
+
+#include "base/math.hpp"
+
+#include <vector>
+
+namespace matrix_tests
+{
+using namespace routing;
+using namespace std;
+
+using mercator::FromLatLon;
+
+UNIT_TEST(Matrix_MoscowCarRoutes)
+{
+  auto & components = integration::GetVehicleComponents(VehicleType::Car);
+  auto & router = dynamic_cast<IndexRouter &>(components.GetRouter());
+
+  vector<m2::PointD> const points = {FromLatLon(55.66216, 37.63259), FromLatLon(55.66237, 37.63560),
+                                     FromLatLon(55.77398, 37.68469), FromLatLon(55.77201, 37.68789)};
+
+  RouterDelegate delegate;
+  IndexRouter::Matrix matrix;
+  TEST_EQUAL(router.CalculateMatrix(points, points, delegate, matrix), RouterResultCode::NoError, ());
+  TEST_EQUAL(matrix.size(), points.size(), ());
+
+  for (size_t i = 0; i < points.size(); ++i)
+  {
+    TEST_EQUAL(matrix[i].size(), points.size(), ());
+    for (size_t j = 0; j < points.size(); ++j)
+    {
+      auto const & item = matrix[i][j];
+      TEST(item.m_found, (i, j));
+      if (i == j)
+      {
+        TEST_LESS(item.m_distanceM, 10.0, (i));
+        continue;
+      }
+
+      auto const [route, code] =
+          integration::CalculateRoute(components, points[i], m2::PointD::Zero(), points[j]);
+      TEST_EQUAL(code, RouterResultCode::NoError, (i, j));
+      TEST(base::AlmostEqualRel(item.m_distanceM, route->GetTotalDistanceMeters(), 0.05),
+           (i, j, item.m_distanceM, route->GetTotalDistanceMeters()));
+      TEST(base::AlmostEqualRel(item.m_etaSec, route->GetTotalTimeSec(), 0.05),
+           (i, j, item.m_etaSec, route->GetTotalTimeSec()));
+    }
+  }
+}
+
+UNIT_TEST(Matrix_MaxWeight)
+{
+  auto & router = dynamic_cast<IndexRouter &>(integration::GetVehicleComponents(VehicleType::Car).GetRouter());
+
+  vector<m2::PointD> const sources = {FromLatLon(55.75100, 37.61790)};
+  vector<m2::PointD> const destinations = {FromLatLon(55.75060, 37.62100), FromLatLon(55.97310, 37.41460)};
+
+  RouterDelegate delegate;
+  IndexRouter::Matrix matrix;
+  TEST_EQUAL(router.CalculateMatrix(sources, destinations, delegate, matrix, 600.0 /* maxWeightSec */),
+             RouterResultCode::NoError, ());
+  TEST(matrix[0][0].m_found, ());
+  TEST(!matrix[0][1].m_found, ());
+}
+}  // namespace matrix_tests
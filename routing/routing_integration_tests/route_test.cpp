@@ -1,5 +1,6 @@
 #include "testing/testing.hpp"
 
+#include "routing/index_router.hpp"
 #include "routing/routing_callbacks.hpp"
 #include "routing/routing_options.hpp"
 
@@ -7,6 +8,8 @@
 
 #include "geometry/mercator.hpp"
 
+#include "base/math.hpp"
+
 #include <limits>
 
 namespace route_test
@@ -985,4 +988,29 @@ UNIT_TEST(Spain_NoMaxSpeeds_KeepTrunk_NotTrunkLink)
                                    FromLatLon(43.3685773, -3.42580007), 1116.79);
 }
 
+// The second route is built by the world graph which is kept after the first one.
+UNIT_TEST(MoscowToSVOAirport_KeptWorldGraph)
+{
+  auto const start = FromLatLon(55.75100, 37.61790);
+  auto const finish = FromLatLon(55.97310, 37.41460);
+
+  auto const components = CreateAllMapsComponents(VehicleType::Car, {} /* skipMaps */);
+  auto & router = dynamic_cast<IndexRouter &>(components->GetRouter());
+  router.SetKeepWorldGraph(true);
+
+  TRouteResult const first = CalculateRoute(*components, start, {0.0, 0.0}, finish);
+  TEST_EQUAL(first.second, RouterResultCode::NoError, ());
+
+  TRouteResult const second = CalculateRoute(*components, start, {0.0, 0.0}, finish);
+  TEST_EQUAL(second.second, RouterResultCode::NoError, ());
+  // All the index graphs are loaded by the first route.
+  TEST_EQUAL(router.GetLastTimings().m_graphLoadSec, 0.0, ());
+
+  TEST(base::AlmostEqualAbs(second.first->GetTotalTimeSec(), first.first->GetTotalTimeSec(), 1e-6),
+       (second.first->GetTotalTimeSec(), first.first->GetTotalTimeSec()));
+  TEST(base::AlmostEqualAbs(second.first->GetTotalDistanceMeters(),
+                            first.first->GetTotalDistanceMeters(), 1e-6),
+       (second.first->GetTotalDistanceMeters(), first.first->GetTotalDistanceMeters()));
+}
+
 } // namespace route_test
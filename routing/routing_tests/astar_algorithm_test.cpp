@@ -6,8 +6,10 @@
 
 #include "routing/routing_tests/routing_algorithm.hpp"
 
+#include <algorithm>
 #include <cstdint>
 #include <map>
+#include <random>
 #include <utility>
 #include <vector>
 
@@ -52,6 +54,115 @@ UNIT_TEST(AStarAlgorithm_Sample)
   TestAStar(graph, expectedRoute, 23);
 }
 
+UNIT_TEST(AStarAlgorithm_ParallelBidirectional_Sample)
+{
+  UndirectedGraph forwardGraph;
+  UndirectedGraph backwardGraph;
+  for (auto * graph : {&forwardGraph, &backwardGraph})
+  {
+    graph->AddEdge(0, 1, 10);
+    graph->AddEdge(1, 2, 5);
+    graph->AddEdge(2, 3, 5);
+    graph->AddEdge(2, 4, 10);
+    graph->AddEdge(3, 4, 3);
+  }
+
+  Algorithm algo;
+  Algorithm::ParamsForTests<> params(forwardGraph, 0u /* startVertex */, 4u /* finishVertex */);
+  params.m_backwardGraph = &backwardGraph;
+
+  RoutingResult<unsigned /* Vertex */, double /* Weight */> actualRoute;
+  TEST_EQUAL(Algorithm::Result::OK, algo.FindPathBidirectional(params, actualRoute), ());
+  TEST_EQUAL(vector<unsigned>({0, 1, 2, 3, 4}), actualRoute.m_path, ());
+  TEST_ALMOST_EQUAL_ULPS(23.0, actualRoute.m_distance, ());
+}
+
+UNIT_TEST(AStarAlgorithm_ParallelBidirectional_Grid)
+{
+  // Grid of |kSide| x |kSide| vertices with random weights of edges.
+  uint32_t constexpr kSide = 40;
+  UndirectedGraph sequentialGraph;
+  UndirectedGraph forwardGraph;
+  UndirectedGraph backwardGraph;
+
+  mt19937 rng(42);
+  uniform_int_distribution<int> weightDist(1, 100);
+  auto const addEdge = [&](uint32_t u, uint32_t v)
+  {
+    double const w = weightDist(rng);
+    for (auto * graph : {&sequentialGraph, &forwardGraph, &backwardGraph})
+      graph->AddEdge(u, v, w);
+  };
+
+  for (uint32_t i = 0; i < kSide; ++i)
+  {
+    for (uint32_t j = 0; j < kSide; ++j)
+    {
+      uint32_t const v = i * kSide + j;
+      if (j + 1 < kSide)
+        addEdge(v, v + 1);
+      if (i + 1 < kSide)
+        addEdge(v, v + kSide);
+    }
+  }
+
+  Algorithm algo;
+  uniform_int_distribution<uint32_t> vertexDist(0, kSide * kSide - 1);
+  for (size_t i = 0; i < 20; ++i)
+  {
+    uint32_t const start = vertexDist(rng);
+    uint32_t const finish = vertexDist(rng);
+
+    Algorithm::ParamsForTests<> sequentialParams(sequentialGraph, start, finish);
+    RoutingResult<unsigned /* Vertex */, double /* Weight */> expected;
+    TEST_EQUAL(Algorithm::Result::OK, algo.FindPathBidirectional(sequentialParams, expected), ());
+
+    Algorithm::ParamsForTests<> parallelParams(forwardGraph, start, finish);
+    parallelParams.m_backwardGraph = &backwardGraph;
+    RoutingResult<unsigned /* Vertex */, double /* Weight */> actual;
+    TEST_EQUAL(Algorithm::Result::OK, algo.FindPathBidirectional(parallelParams, actual), ());
+
+    // Equal shortest paths may differ, but their lengths may not.
+    TEST_ALMOST_EQUAL_ULPS(expected.m_distance, actual.m_distance, (start, finish));
+    TEST_EQUAL(actual.m_path.front(), start, ());
+    TEST_EQUAL(actual.m_path.back(), finish, ());
+
+    double length = 0.0;
+    for (size_t k = 0; k + 1 < actual.m_path.size(); ++k)
+    {
+      UndirectedGraph::EdgeListT adj;
+      sequentialGraph.GetEdgesList(actual.m_path[k], true /* isOutgoing */, adj);
+      auto const it = find_if(adj.begin(), adj.end(), [&](SimpleEdge const & e)
+      {
+        return e.GetTarget() == actual.m_path[k + 1];
+      });
+      TEST(it != adj.end(), (actual.m_path));
+      length += it->GetWeight();
+    }
+    TEST_ALMOST_EQUAL_ULPS(length, actual.m_distance, (actual.m_path));
+  }
+}
+
+UNIT_TEST(AStarAlgorithm_ParallelBidirectional_NoPath)
+{
+  UndirectedGraph forwardGraph;
+  UndirectedGraph backwardGraph;
+  for (auto * graph : {&forwardGraph, &backwardGraph})
+  {
+    graph->AddEdge(0, 1, 10);
+    graph->AddEdge(1, 2, 5);
+    graph->AddEdge(3, 4, 3);
+  }
+
+  Algorithm algo;
+  Algorithm::ParamsForTests<> params(forwardGraph, 0u /* startVertex */, 4u /* finishVertex */);
+  params.m_backwardGraph = &backwardGraph;
+
+  RoutingResult<unsigned /* Vertex */, double /* Weight */> routingResult;
+  TEST_EQUAL(Algorithm::Result::NoPath, algo.FindPathBidirectional(params, routingResult), ());
+  TEST(routingResult.m_path.empty(), ());
+}
+
 UNIT_TEST(AStarAlgorithm_CheckLength)
 {
   UndirectedGraph graph;
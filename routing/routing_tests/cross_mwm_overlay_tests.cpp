@@ -0,0 +1,220 @@
+#include "testing/testing.hpp"
+
+#include "routing/cross_mwm_overlay.hpp"
+
+#include "routing_common/num_mwm_id.hpp"
+
+#include "platform/country_file.hpp"
+
+#include "coding/reader.hpp"
+#include "coding/writer.hpp"
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace cross_mwm_overlay_tests
+{
+using namespace routing;
+using namespace std;
+
+// Leaps graph with the interface of CrossMwmGraph used by the overlay.
+class TestLeaps
+{
+public:
+  using EdgeListT = CrossMwmOverlay::EdgeListT;
+
+  void AddLeap(Segment const & enter, Segment const & exit, double weight)
+  {
+    TEST_EQUAL(enter.GetMwmId(), exit.GetMwmId(), ());
+    m_leaps[enter].emplace_back(exit, RouteWeight(weight));
+    AddTransition(enter, true /* isEnter */);
+    AddTransition(exit, false /* isEnter */);
+  }
+
+  void AddTwins(Segment const & exit, Segment const & enter)
+  {
+    TEST_NOT_EQUAL(enter.GetMwmId(), exit.GetMwmId(), ());
+    m_exitToEnters[exit].push_back(enter);
+    m_enterToExits[enter].push_back(exit);
+    AddTransition(enter, true /* isEnter */);
+    AddTransition(exit, false /* isEnter */);
+  }
+
+  template <class FnT>
+  void ForEachTransition(NumMwmId numMwmId, bool isEnter, FnT && fn) const
+  {
+    auto const & transitions = isEnter ? m_enters : m_exits;
+    auto const it = transitions.find(numMwmId);
+    if (it == transitions.end())
+      return;
+
+    for (auto const & s : it->second)
+      fn(s);
+  }
+
+  void GetOutgoingEdgeList(Segment const & enter, EdgeListT & edges) const
+  {
+    auto const it = m_leaps.find(enter);
+    if (it == m_leaps.end())
+      return;
+
+    for (auto const & edge : it->second)
+      edges.push_back(edge);
+  }
+
+  void GetTwins(Segment const & s, bool isOutgoing, vector<Segment> & twins) const
+  {
+    auto const & twinsMap = isOutgoing ? m_exitToEnters : m_enterToExits;
+    auto const it = twinsMap.find(s);
+    if (it != twinsMap.end())
+      twins.insert(twins.end(), it->second.begin(), it->second.end());
+  }
+
+private:
+  void AddTransition(Segment const & s, bool isEnter)
+  {
+    auto & transitions = (isEnter ? m_enters : m_exits)[s.GetMwmId()];
+    if (find(transitions.begin(), transitions.end(), s) == transitions.end())
+      transitions.push_back(s);
+  }
+
+  map<Segment, vector<SegmentEdge>> m_leaps;
+  map<Segment, vector<Segment>> m_exitToEnters;
+  map<Segment, vector<Segment>> m_enterToExits;
+  map<NumMwmId, vector<Segment>> m_enters;
+  map<NumMwmId, vector<Segment>> m_exits;
+};
+
+Segment MakeSegment(NumMwmId mwmId, uint32_t featureId)
+{
+  return Segment(mwmId, featureId, 0 /* segmentIdx */, true /* forward */);
+}
+
+// Mwms 0, 1 and 2 are of the same country, mwm 3 is of another one.
+// The country is entered by |kEnter| and left by |kExit| only.
+//
+//  mwm 3 -> kEnter (0) --10--> exit01 -> enter10 (1) --10--> exit11 -> enter21 (2) --10--> kExit -> mwm 3
+//                  (0) --50--> exit02 -> enter20 (2) ---5------------------------------> kExit
+NumMwmId constexpr kOuterMwm = 3;
+Segment const kEnter = MakeSegment(0, 0);
+Segment const kExit = MakeSegment(2, 3);
+
+void FillLeaps(TestLeaps & leaps)
+{
+  leaps.AddTwins(MakeSegment(kOuterMwm, 0), kEnter);
+
+  leaps.AddLeap(kEnter, MakeSegment(0, 1), 10.0);
+  leaps.AddLeap(kEnter, MakeSegment(0, 2), 50.0);
+  leaps.AddTwins(MakeSegment(0, 1), MakeSegment(1, 1));
+  leaps.AddTwins(MakeSegment(0, 2), MakeSegment(2, 2));
+
+  leaps.AddLeap(MakeSegment(1, 1), MakeSegment(1, 4), 10.0);
+  leaps.AddTwins(MakeSegment(1, 4), MakeSegment(2, 4));
+
+  leaps.AddLeap(MakeSegment(2, 2), kExit, 5.0);
+  leaps.AddLeap(MakeSegment(2, 4), kExit, 10.0);
+  leaps.AddTwins(kExit, MakeSegment(kOuterMwm, 3));
+}
+
+UNIT_TEST(CrossMwmOverlay_BuildCell)
+{
+  TestLeaps leaps;
+  FillLeaps(leaps);
+
+  CrossMwmOverlay overlay;
+  overlay.AddCell(cross_mwm_overlay::BuildCell(leaps, {2, 0, 1}));
+
+  auto const & cell = overlay.GetCells().front();
+  TEST_EQUAL(cell.m_mwms, vector<NumMwmId>({0, 1, 2}), ());
+  TEST_EQUAL(cell.m_enters, vector<Segment>({kEnter}), ());
+  TEST_EQUAL(cell.m_exits, vector<Segment>({kExit}), ());
+  TEST_EQUAL(cell.GetWeight(0, 0), 30, ());
+
+  TEST_EQUAL(overlay.GetCell(1), 0, ());
+  TEST_EQUAL(overlay.GetCell(kOuterMwm), CrossMwmOverlay::kNoCell, ());
+
+  CrossMwmOverlay::EdgeListT edges;
+  TEST(overlay.GetShortcuts(kEnter, true /* isOutgoing */, edges), ());
+  TEST_EQUAL(edges.size(), 1, ());
+  TEST_EQUAL(edges[0].GetTarget(), kExit, ());
+  TEST_EQUAL(edges[0].GetWeight(), RouteWeight(30.0), ());
+
+  edges.clear();
+  TEST(overlay.GetShortcuts(kExit, false /* isOutgoing */, edges), ());
+  TEST_EQUAL(edges.size(), 1, ());
+  TEST_EQUAL(edges[0].GetTarget(), kEnter, ());
+
+  // Transitions inside the cell have no shortcuts.
+  edges.clear();
+  TEST(!overlay.GetShortcuts(MakeSegment(1, 1), true /* isOutgoing */, edges), ());
+  TEST(edges.empty(), ());
+}
+
+UNIT_TEST(CrossMwmOverlay_UnpackShortcut)
+{
+  TestLeaps leaps;
+  FillLeaps(leaps);
+
+  cross_mwm_overlay::CellRouter<TestLeaps> router(leaps, {0, 1, 2});
+  router.Run(kEnter, kExit);
+
+  vector<Segment> path;
+  TEST(router.GetPath(kExit, path), ());
+  vector<Segment> const expected = {kEnter,           MakeSegment(0, 1), MakeSegment(1, 1),
+                                    MakeSegment(1, 4), MakeSegment(2, 4), kExit};
+  TEST_EQUAL(path, expected, ());
+
+  // The route can't leave the cell.
+  cross_mwm_overlay::CellRouter<TestLeaps> smallRouter(leaps, {0, 2});
+  smallRouter.Run(kEnter, kExit);
+  TEST_EQUAL(smallRouter.GetDistance(kExit), 55.0, ());
+}
+
+UNIT_TEST(CrossMwmOverlay_Serialization)
+{
+  TestLeaps leaps;
+  FillLeaps(leaps);
+
+  CrossMwmOverlay overlay;
+  overlay.AddCell(cross_mwm_overlay::BuildCell(leaps, {0, 1, 2}));
+
+  NumMwmIds numMwmIds;
+  for (auto const * name : {"Country_A", "Country_B", "Country_C", "Other"})
+    numMwmIds.RegisterFile(platform::CountryFile(name));
+
+  vector<uint8_t> buffer;
+  {
+    MemWriter<vector<uint8_t>> writer(buffer);
+    CrossMwmOverlaySerializer::Serialize(overlay, writer, numMwmIds);
+  }
+
+  {
+    CrossMwmOverlay deserialized;
+    MemReader reader(buffer.data(), buffer.size());
+    ReaderSource<MemReader> src(reader);
+    CrossMwmOverlaySerializer::Deserialize(deserialized, src, numMwmIds);
+
+    TEST_EQUAL(deserialized.GetCells().size(), 1, ());
+    auto const & expected = overlay.GetCells().front();
+    auto const & cell = deserialized.GetCells().front();
+    TEST_EQUAL(cell.m_mwms, expected.m_mwms, ());
+    TEST_EQUAL(cell.m_enters, expected.m_enters, ());
+    TEST_EQUAL(cell.m_exits, expected.m_exits, ());
+    TEST_EQUAL(cell.m_weights, expected.m_weights, ());
+  }
+
+  {
+    // Mwms are matched by names, cells with unknown mwms are skipped.
+    NumMwmIds otherIds;
+    for (auto const * name : {"Other", "Country_C", "Country_A"})
+      otherIds.RegisterFile(platform::CountryFile(name));
+
+    CrossMwmOverlay deserialized;
+    MemReader reader(buffer.data(), buffer.size());
+    ReaderSource<MemReader> src(reader);
+    CrossMwmOverlaySerializer::Deserialize(deserialized, src, otherIds);
+    TEST(deserialized.IsEmpty(), ());
+  }
+}
+}  // namespace cross_mwm_overlay_tests
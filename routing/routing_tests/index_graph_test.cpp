@@ -28,6 +28,7 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -350,6 +351,96 @@ UNIT_TEST(FindPathManhattan)
   }
 }
 
+// Parallel waves go by their own world graphs and find routes as good as the sequential ones.
+UNIT_TEST(FindPathManhattanParallelWaves)
+{
+  uint32_t constexpr kCitySize = 8;
+  auto const buildGraph = [](shared_ptr<EdgeEstimator> const & estimator)
+  {
+    unique_ptr<TestGeometryLoader> loader = make_unique<TestGeometryLoader>();
+    for (uint32_t i = 0; i < kCitySize; ++i)
+    {
+      RoadGeometry::Points street;
+      RoadGeometry::Points avenue;
+      for (uint32_t j = 0; j < kCitySize; ++j)
+      {
+        street.emplace_back(static_cast<double>(j), static_cast<double>(i));
+        avenue.emplace_back(static_cast<double>(i), static_cast<double>(j));
+      }
+      // Every third street and avenue is fast, so the routes are not only the straight ones.
+      double const speed = i % 3 == 0 ? 3.0 : 1.0;
+      loader->AddRoad(i, false, speed, street);
+      loader->AddRoad(i + kCitySize, false, speed, avenue);
+    }
+
+    vector<Joint> joints;
+    for (uint32_t i = 0; i < kCitySize; ++i)
+    {
+      for (uint32_t j = 0; j < kCitySize; ++j)
+        joints.emplace_back(MakeJoint({{i, j}, {j + kCitySize, i}}));
+    }
+
+    return BuildWorldGraph(std::move(loader), estimator, joints);
+  };
+
+  traffic::TrafficCache const trafficCache;
+  shared_ptr<EdgeEstimator> estimator = CreateEstimatorForCar(trafficCache);
+  unique_ptr<WorldGraph> forwardGraph = buildGraph(estimator);
+  unique_ptr<WorldGraph> backwardGraph = buildGraph(estimator);
+
+  vector<FakeEnding> endPoints;
+  for (uint32_t featureId = 0; featureId < kCitySize; featureId += 3)
+  {
+    for (uint32_t segmentId = 0; segmentId < kCitySize - 1; segmentId += 2)
+    {
+      endPoints.push_back(MakeFakeEnding(featureId, segmentId,
+                                         m2::PointD(0.5 + segmentId, featureId), *forwardGraph));
+      endPoints.push_back(MakeFakeEnding(featureId + kCitySize, segmentId,
+                                         m2::PointD(featureId, 0.5 + segmentId), *forwardGraph));
+    }
+  }
+
+  auto const getRouteWeight = [](IndexGraphStarter const & starter, vector<Segment> const & route)
+  {
+    double weight = 0.0;
+    for (auto const & segment : route)
+      weight += starter.CalcSegmentWeight(segment, EdgeEstimator::Purpose::Weight).GetWeight();
+    return weight;
+  };
+
+  AlgorithmForIndexGraphStarter algorithm;
+  for (auto const & start : endPoints)
+  {
+    for (auto const & finish : endPoints)
+    {
+      auto starter = MakeStarter(start, finish, *forwardGraph);
+
+      vector<Segment> expectedRoute;
+      double expectedTimeSec = 0.0;
+      TEST_EQUAL(CalculateRoute(*starter, expectedRoute, expectedTimeSec),
+                 AlgorithmForIndexGraphStarter::Result::OK, ());
+
+      IndexGraphStarter backwardStarter(*starter, *backwardGraph);
+      AlgorithmForIndexGraphStarter::ParamsForTests<AStarParallelLengthChecker> params(
+          *starter, starter->GetStartSegment(), starter->GetFinishSegment(),
+          AStarParallelLengthChecker(*starter));
+      params.m_backwardGraph = &backwardStarter;
+
+      RoutingResult<Segment, RouteWeight> result;
+      TEST_EQUAL(algorithm.FindPathBidirectional(params, result),
+                 AlgorithmForIndexGraphStarter::Result::OK, ());
+
+      // Equal shortest routes may differ, but their weights may not. The weights are summed up
+      // over the segments since |m_distance| depends on the vertex where the waves have met.
+      TEST(base::AlmostEqualAbs(getRouteWeight(*starter, result.m_path),
+                                getRouteWeight(*starter, expectedRoute), 1e-6),
+           (result.m_path, expectedRoute));
+      TEST_EQUAL(result.m_path.front(), starter->GetStartSegment(), ());
+      TEST_EQUAL(result.m_path.back(), starter->GetFinishSegment(), ());
+    }
+  }
+}
+
 // Roads                                          y:
 //
 //  fast road R0              * - * - *           -1
@@ -850,4 +941,61 @@ UNIT_TEST(FinishNearZeroEdge)
       {1.0 /* x */, 0.0 /* y */}, {2.0, 0.0}, {4.0, 0.0}, {5.0, 0.0}};
   TestRouteGeometry(*starter, AlgorithmForIndexGraphStarter::Result::OK, expectedGeom);
 }
+
+// Geometry loader which counts loads of every road.
+class CountingGeometryLoader final : public GeometryLoader
+{
+public:
+  // GeometryLoader overrides:
+  void Load(uint32_t featureId, RoadGeometry & road) override
+  {
+    ++m_loads[featureId];
+    road = RoadGeometry(false /* oneWay */, 1.0 /* weightSpeedKMpH */, 1.0 /* etaSpeedKMpH */,
+                        RoadGeometry::Points({{0.0, 0.0}, {double(featureId), 1.0}}));
+  }
+
+  map<uint32_t, size_t> m_loads;
+};
+
+UNIT_TEST(Geometry_RoadsCacheLru)
+{
+  auto loader = make_unique<CountingGeometryLoader>();
+  auto const & loads = loader->m_loads;
+
+  size_t const roadBytes =
+      RoadGeometry(false, 1.0, 1.0, RoadGeometry::Points({{0.0, 0.0}, {1.0, 1.0}})).GetMemorySize();
+  Geometry geometry(std::move(loader), 2 * roadBytes);
+
+  geometry.GetRoad(0);
+  geometry.GetRoad(1);
+  geometry.GetRoad(0);
+  // Road 1 is the least recently used one.
+  TEST_EQUAL(geometry.GetRoad(2).GetPoint(1), mercator::ToLatLon({2.0, 1.0}), ());
+  geometry.GetRoad(0);
+  geometry.GetRoad(1);
+
+  TEST_EQUAL(loads, (map<uint32_t, size_t>{{0, 1}, {1, 2}, {2, 1}}), ());
+
+  auto const stats = geometry.GetCacheStats();
+  TEST_EQUAL(stats.m_hits, 2, ());
+  TEST_EQUAL(stats.m_misses, 4, ());
+  TEST_EQUAL(stats.m_evictions, 2, ());
+  TEST_EQUAL(stats.m_roads, 2, ());
+  TEST_EQUAL(stats.m_bytes, 2 * roadBytes, ());
+}
+
+UNIT_TEST(Geometry_RoadsCacheKeepsLastRoad)
+{
+  Geometry geometry(make_unique<CountingGeometryLoader>(), 1 /* roadsCacheBytes */);
+
+  for (uint32_t featureId = 0; featureId < 10; ++featureId)
+    TEST_EQUAL(geometry.GetRoad(featureId).GetPoint(1), mercator::ToLatLon({double(featureId), 1.0}), ());
+
+  TEST_EQUAL(geometry.GetRoad(9).GetPointsCount(), 2, ());
+
+  auto const stats = geometry.GetCacheStats();
+  TEST_EQUAL(stats.m_hits, 1, ());
+  TEST_EQUAL(stats.m_misses, 10, ());
+  TEST_EQUAL(stats.m_roads, 1, ());
+}
 }  // namespace index_graph_test
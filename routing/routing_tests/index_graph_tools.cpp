@@ -117,6 +117,14 @@ Geometry & TestIndexGraphLoader::GetGeometry(NumMwmId mwmId)
 
 void TestIndexGraphLoader::Clear() { m_graphs.clear(); }
 
+RoadsCacheStats TestIndexGraphLoader::GetRoadsCacheStats() const
+{
+  RoadsCacheStats stats;
+  for (auto const & graph : m_graphs)
+    stats.Add(graph.second->GetGeometry().GetCacheStats());
+  return stats;
+}
+
 void TestIndexGraphLoader::AddGraph(NumMwmId mwmId, unique_ptr<IndexGraph> graph)
 {
   routing_test::AddGraph(m_graphs, mwmId, std::move(graph));
@@ -137,6 +137,8 @@ public:
   }
 
   void Clear() override;
+  RoadsCacheStats GetRoadsCacheStats() const override;
+  double GetGraphsLoadSeconds() const override { return 0.0; }
 
   void AddGraph(NumMwmId mwmId, std::unique_ptr<IndexGraph> graph);
 
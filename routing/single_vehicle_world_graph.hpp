@@ -50,6 +50,8 @@ public:
   bool IsOneWay(NumMwmId mwmId, uint32_t featureId) override;
   bool IsPassThroughAllowed(NumMwmId mwmId, uint32_t featureId) override;
   void ClearCachedGraphs() override { m_loader->Clear(); }
+  RoadsCacheStats GetRoadsCacheStats() const override { return m_loader->GetRoadsCacheStats(); }
+  double GetGraphsLoadSeconds() const override { return m_loader->GetGraphsLoadSeconds(); }
 
   void SetMode(WorldGraphMode mode) override { m_mode = mode; }
   WorldGraphMode GetMode() const override { return m_mode; }
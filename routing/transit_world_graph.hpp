@@ -57,6 +57,8 @@ public:
   // All transit features are allowed for through passage.
   bool IsPassThroughAllowed(NumMwmId mwmId, uint32_t featureId) override;
   void ClearCachedGraphs() override;
+  RoadsCacheStats GetRoadsCacheStats() const override { return m_indexLoader->GetRoadsCacheStats(); }
+  double GetGraphsLoadSeconds() const override { return m_indexLoader->GetGraphsLoadSeconds(); }
   void SetMode(WorldGraphMode mode) override { m_mode = mode; }
   WorldGraphMode GetMode() const override { return m_mode; }
 
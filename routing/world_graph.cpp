@@ -42,6 +42,16 @@ std::unique_ptr<TransitInfo> WorldGraph::GetTransitInfo(Segment const &)
   return nullptr;
 }
 
+RoadsCacheStats WorldGraph::GetRoadsCacheStats() const
+{
+  return {};
+}
+
+double WorldGraph::GetGraphsLoadSeconds() const
+{
+  return 0.0;
+}
+
 std::vector<RouteSegment::SpeedCamera> WorldGraph::GetSpeedCamInfo(Segment const &)
 {
   return {};
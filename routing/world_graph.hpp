@@ -76,6 +76,8 @@ public:
 
   // Clear memory used by loaded graphs.
   virtual void ClearCachedGraphs() = 0;
+  virtual RoadsCacheStats GetRoadsCacheStats() const;
+  virtual double GetGraphsLoadSeconds() const;
   virtual void SetMode(WorldGraphMode mode) = 0;
   virtual WorldGraphMode GetMode() const = 0;
 
@@ -1,5 +1,7 @@
 #include "search/cbv.hpp"
 
+#include "base/assert.hpp"
+
 #include <limits>
 #include <vector>
 
@@ -120,4 +122,30 @@ uint64_t CBV::Hash() const
     return kModulo;
   return coding::CompressedBitVectorHasher::Hash(*m_p) % kModulo;
 }
+
+CBV CBV::Clone() const
+{
+  if (IsFull() || IsEmpty())
+    return CBV(IsFull());
+  return CBV(m_p->Clone());
+}
+
+uint64_t CBV::GetSizeInBytes() const
+{
+  using coding::CompressedBitVector;
+
+  if (IsFull() || IsEmpty())
+    return 0;
+
+  switch (m_p->GetStorageStrategy())
+  {
+  case CompressedBitVector::StorageStrategy::Dense:
+    return static_cast<coding::DenseCBV const &>(*m_p).NumBitGroups() * sizeof(uint64_t);
+  case CompressedBitVector::StorageStrategy::Sparse:
+    return m_p->PopCount() * sizeof(uint64_t);
+  case CompressedBitVector::StorageStrategy::Run:
+    return static_cast<coding::RunCBV const &>(*m_p).NumRuns() * sizeof(coding::RunCBV::Interval);
+  }
+  UNREACHABLE();
+}
 }  // namespace search
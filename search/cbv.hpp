@@ -53,6 +53,13 @@ public:
 
   uint64_t Hash() const;
 
+  // Returns a copy that doesn't share the bit vector with this one.
+  // Reference counting is not thread-safe, so only such copies may be passed to other threads.
+  CBV Clone() const;
+
+  // Returns approximate size of the bit vector in memory.
+  uint64_t GetSizeInBytes() const;
+
 private:
   explicit CBV(bool full);
 
@@ -1,5 +1,6 @@
 #include "search/engine.hpp"
 
+#include "search/geometry_cache.hpp"
 #include "search/processor.hpp"
 
 #include "storage/country_info_getter.hpp"
@@ -11,7 +12,11 @@
 #include "base/timer.hpp"
 
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <map>
+#include <numeric>
+#include <utility>
 #include <vector>
 
 namespace search
@@ -72,10 +77,21 @@ void ProcessorHandle::Detach()
 }
 
 // Engine::Params ----------------------------------------------------------------------------------
-Engine::Params::Params() : m_locale("en"), m_numThreads(1) {}
+Engine::Params::Params()
+  : m_locale("en")
+  , m_numThreads(1)
+  , m_numGeocoderThreads(1)
+  , m_sharedGeometryCacheSizeBytes(0)
+  , m_collectLatencyStats(false)
+{
+}
 
 Engine::Params::Params(string const & locale, size_t numThreads)
-  : m_locale(locale), m_numThreads(numThreads)
+  : m_locale(locale)
+  , m_numThreads(numThreads)
+  , m_numGeocoderThreads(1)
+  , m_sharedGeometryCacheSizeBytes(0)
+  , m_collectLatencyStats(false)
 {
 }
 
@@ -88,11 +104,19 @@ Engine::Engine(DataSource & dataSource, CategoriesHolder const & categories,
   categories.ForEachName(doInit);
   doInit.GetSuggests(m_suggests);
 
+  if (params.m_sharedGeometryCacheSizeBytes != 0)
+    m_sharedGeometryCache = make_unique<SharedGeometryCache>(params.m_sharedGeometryCacheSizeBytes);
+  if (params.m_collectLatencyStats)
+    m_latencyStats = make_unique<LatencyStats>();
+
   m_contexts.resize(params.m_numThreads);
   for (size_t i = 0; i < params.m_numThreads; ++i)
   {
     auto processor = make_unique<Processor>(dataSource, categories, m_suggests, infoGetter);
     processor->SetPreferredLocale(params.m_locale);
+    processor->SetNumGeocoderThreads(params.m_numGeocoderThreads);
+    processor->SetSharedGeometryCache(m_sharedGeometryCache.get());
+    processor->SetLatencyStats(m_latencyStats.get());
     m_contexts[i].m_processor = std::move(processor);
   }
 
@@ -127,6 +151,53 @@ weak_ptr<ProcessorHandle> Engine::Search(SearchParams params)
   return handle;
 }
 
+vector<Engine::BatchResult> Engine::SearchBatch(vector<SearchParams> batch)
+{
+  vector<BatchResult> results(batch.size());
+  if (batch.empty())
+    return results;
+
+  // Queries are grouped by cells of a grid laid over the point they are
+  // searched around. Contiguous ranges of the ordered queries are processed
+  // as single tasks, several tasks per thread to balance the load.
+  double constexpr kGroupingCellSize = 1.0;
+  size_t constexpr kNumTasksPerThread = 4;
+
+  auto const getCell = [&batch](size_t i) {
+    auto const & params = batch[i];
+    auto const center = params.m_position ? *params.m_position : params.m_viewport.Center();
+    return make_pair(static_cast<int64_t>(floor(center.y / kGroupingCellSize)),
+                     static_cast<int64_t>(floor(center.x / kGroupingCellSize)));
+  };
+
+  vector<size_t> order(batch.size());
+  iota(order.begin(), order.end(), 0);
+  stable_sort(order.begin(), order.end(),
+              [&getCell](size_t lhs, size_t rhs) { return getCell(lhs) < getCell(rhs); });
+
+  size_t const numTasks = min(batch.size(), m_threads.size() * kNumTasksPerThread);
+  mutex mu;
+  condition_variable cv;
+  size_t numPendingTasks = numTasks;
+  for (size_t i = 0; i < numTasks; ++i)
+  {
+    size_t const begin = batch.size() * i / numTasks;
+    size_t const end = batch.size() * (i + 1) / numTasks;
+    PostMessage(Message::TYPE_TASK, [&, begin, end](Processor & processor) {
+      for (size_t j = begin; j < end; ++j)
+        DoBatchSearch(std::move(batch[order[j]]), processor, results[order[j]]);
+
+      lock_guard<mutex> lock(mu);
+      if (--numPendingTasks == 0)
+        cv.notify_one();
+    });
+  }
+
+  unique_lock<mutex> lock(mu);
+  cv.wait(lock, [&numPendingTasks]() { return numPendingTasks == 0; });
+  return results;
+}
+
 void Engine::SetLocale(string const & locale)
 {
   PostMessage(Message::TYPE_BROADCAST,
@@ -138,6 +209,8 @@ size_t Engine::GetNumThreads() const { return m_threads.size(); }
 void Engine::ClearCaches()
 {
   PostMessage(Message::TYPE_BROADCAST, [](Processor & processor) { processor.ClearCaches(); });
+  if (m_sharedGeometryCache)
+    m_sharedGeometryCache->Clear();
 }
 
 void Engine::CacheWorldLocalities()
@@ -294,4 +367,20 @@ void Engine::DoSearch(SearchParams params, shared_ptr<ProcessorHandle> handle, P
 
   processor.Search(std::move(params));
 }
+
+void Engine::DoBatchSearch(SearchParams params, Processor & processor, BatchResult & result)
+{
+  params.m_onResults = [&result, onResults = std::move(params.m_onResults)](Results const & results)
+  {
+    if (results.IsEndMarker())
+      result.m_results = results;
+    if (onResults)
+      onResults(results);
+  };
+
+  base::Timer timer;
+  processor.Reset();
+  processor.Search(std::move(params));
+  result.m_elapsed = timer.TimeElapsed();
+}
 }  // namespace search
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "search/latency_stats.hpp"
+#include "search/result.hpp"
 #include "search/search_params.hpp"
 #include "search/suggest.hpp"
 
@@ -7,8 +9,10 @@
 
 #include "base/macros.hpp"
 #include "base/thread.hpp"
+#include "base/timer.hpp"
 
 #include <condition_variable>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -27,6 +31,7 @@ namespace search
 {
 class EngineData;
 class Processor;
+class SharedGeometryCache;
 
 // This class is used as a reference to a search processor in the
 // SearchEngine's queue.  It's only possible to cancel a search
@@ -80,6 +85,25 @@ public:
     // to process queries. Use this field wisely as large values may
     // negatively affect performance due to false sharing.
     size_t m_numThreads;
+
+    // Number of threads each query processor uses to geocode mwms of
+    // a query, see Geocoder::SetNumThreads().
+    size_t m_numGeocoderThreads;
+
+    // Memory budget of the cache of features in rects shared by all
+    // query processors, zero disables the cache. See SharedGeometryCache.
+    uint64_t m_sharedGeometryCacheSizeBytes;
+
+    // When set, query processors time the search stages, see LatencyStats.
+    bool m_collectLatencyStats;
+  };
+
+  struct BatchResult
+  {
+    // Final results of the query, with the end marker set.
+    Results m_results;
+    // Time the query took on a search thread.
+    base::Timer::DurationT m_elapsed{};
   };
 
   // Doesn't take ownership of dataSource and categories.
@@ -90,12 +114,25 @@ public:
   // Posts search request to the queue and returns its handle.
   std::weak_ptr<ProcessorHandle> Search(SearchParams params);
 
+  // Processes |batch| on all search threads and blocks until all queries are done.
+  // Results are returned in the order of |batch|. Queries with close viewports
+  // (or positions) are processed one after another by the same processor, so
+  // they reuse its mwm contexts and geocoder caches. Batch queries can't be cancelled.
+  //
+  // *NOTE* Must not be called from the search threads, e.g. from |m_onResults|.
+  std::vector<BatchResult> SearchBatch(std::vector<SearchParams> batch);
+
   // Sets default locale on all query processors.
   void SetLocale(std::string const & locale);
 
   // Returns the number of request-processing threads.
   size_t GetNumThreads() const;
 
+  // Returns latency histograms of the search stages of all processed queries, or nullptr
+  // when Params::m_collectLatencyStats is not set. Stats may be read and cleared while
+  // queries are being processed.
+  LatencyStats * GetLatencyStats() { return m_latencyStats.get(); }
+
   // Posts request to clear caches to the queue.
   void ClearCaches();
 
@@ -167,6 +204,7 @@ private:
   void PostMessage(Args &&... args);
 
   void DoSearch(SearchParams params, std::shared_ptr<ProcessorHandle> handle, Processor & processor);
+  void DoBatchSearch(SearchParams params, Processor & processor, BatchResult & result);
 
   std::vector<Suggest> m_suggests;
 
@@ -175,6 +213,9 @@ private:
   std::condition_variable m_cv;
 
   std::queue<Message> m_messages;
+  // Must outlive processors in |m_contexts|.
+  std::unique_ptr<SharedGeometryCache> m_sharedGeometryCache;
+  std::unique_ptr<LatencyStats> m_latencyStats;
   std::vector<Context> m_contexts;
   std::vector<threads::SimpleThread> m_threads;
 };
@@ -19,6 +19,16 @@ std::unique_ptr<FeatureType> FeatureLoader::Load(FeatureID const & id)
   return m_guard->GetFeatureByIndex(id.m_index);
 }
 
+FeatureType * FeatureLoader::Load(FeatureID const & id, FeatureArena & arena)
+{
+  ASSERT(m_checker.CalledOnOriginalThread(), ());
+
+  auto const & mwmId = id.m_mwmId;
+  if (!m_guard || m_guard->GetId() != mwmId)
+    m_guard = std::make_unique<FeaturesLoaderGuard>(m_dataSource, mwmId);
+  return m_guard->GetFeatureByIndex(id.m_index, arena);
+}
+
 void FeatureLoader::Reset()
 {
   ASSERT(m_checker.CalledOnOriginalThread(), ());
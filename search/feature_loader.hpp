@@ -10,6 +10,7 @@
 #include <memory>
 #include <utility>
 
+class FeatureArena;
 class FeatureType;
 struct FeatureID;
 
@@ -21,6 +22,8 @@ public:
   explicit FeatureLoader(DataSource const & dataSource);
 
   std::unique_ptr<FeatureType> Load(FeatureID const & id);
+  /// Loads the feature into |arena|, the result is valid until arena.Reset().
+  FeatureType * Load(FeatureID const & id, FeatureArena & arena);
 
   void Reset();
 
@@ -13,10 +13,14 @@
 #include "base/string_utils.hpp"
 #include "base/uni_string_dfa.hpp"
 
+#include <algorithm>
+#include <cstdint>
 #include <limits>
+#include <map>
 #include <memory>
 #include <queue>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace search
@@ -45,23 +49,15 @@ bool FindLangIndex(trie::Iterator<ValueList> const & trieRoot, uint8_t lang, uin
 }
 }  // namespace
 
-template <typename ValueList, typename DFA, typename ToDo>
-bool MatchInTrie(trie::Iterator<ValueList> const & trieRoot, strings::UniChar const * rootPrefix,
-                 size_t rootPrefixSize, DFA const & dfa, ToDo && toDo)
+template <typename ValueList, typename DFAIt, typename ToDo>
+bool MatchInSubtrie(std::shared_ptr<trie::Iterator<ValueList>> trieRoot, DFAIt const & rootIt,
+                    ToDo && toDo)
 {
   using TrieDFAIt = std::shared_ptr<trie::Iterator<ValueList>>;
-  using DFAIt = typename DFA::Iterator;
   using State = std::pair<TrieDFAIt, DFAIt>;
 
   std::queue<State> q;
-
-  {
-    auto it = dfa.Begin();
-    DFAMove(it, rootPrefix, rootPrefix + rootPrefixSize);
-    if (it.Rejects())
-      return false;
-    q.emplace(trieRoot.Clone(), it);
-  }
+  q.emplace(std::move(trieRoot), rootIt);
 
   bool found = false;
 
@@ -95,6 +91,125 @@ bool MatchInTrie(trie::Iterator<ValueList> const & trieRoot, strings::UniChar co
   return found;
 }
 
+template <typename ValueList, typename DFA, typename ToDo>
+bool MatchInTrie(trie::Iterator<ValueList> const & trieRoot, strings::UniChar const * rootPrefix,
+                 size_t rootPrefixSize, DFA const & dfa, ToDo && toDo)
+{
+  auto it = dfa.Begin();
+  DFAMove(it, rootPrefix, rootPrefix + rootPrefixSize);
+  if (it.Rejects())
+    return false;
+  return MatchInSubtrie(std::shared_ptr<trie::Iterator<ValueList>>(trieRoot.Clone()), it, toDo);
+}
+
+// Same as MatchInSubtrie() but also appends to |frontier| paths of the topmost accepting nodes.
+// |rootPath| is the path to |trieRoot|. When the frontier has more than |maxFrontierSize| paths,
+// it is cleared and |frontierValid| is set to false.
+template <typename ValueList, typename DFAIt, typename ToDo>
+bool MatchInSubtrieWithFrontier(std::shared_ptr<trie::Iterator<ValueList>> trieRoot,
+                                DFAIt const & rootIt, strings::UniString const & rootPath,
+                                size_t maxFrontierSize, std::vector<strings::UniString> & frontier,
+                                bool & frontierValid, ToDo && toDo)
+{
+  struct State
+  {
+    std::shared_ptr<trie::Iterator<ValueList>> m_trieIt;
+    DFAIt m_dfaIt;
+    // Path to the node, it is not needed below the frontier.
+    strings::UniString m_path;
+    bool m_parentAccepts;
+  };
+
+  std::queue<State> q;
+  q.push({std::move(trieRoot), rootIt, rootPath, false /* parentAccepts */});
+
+  bool found = false;
+
+  while (!q.empty())
+  {
+    auto const s = std::move(q.front());
+    q.pop();
+
+    auto const & trieIt = s.m_trieIt;
+    auto const & dfaIt = s.m_dfaIt;
+    bool const accepts = dfaIt.Accepts();
+
+    if (accepts)
+    {
+      trieIt->m_values.ForEach(
+          [&dfaIt, &toDo](auto const & v) { toDo(v, dfaIt.ErrorsMade() == 0); });
+      found = true;
+
+      if (!s.m_parentAccepts && frontierValid)
+      {
+        if (frontier.size() == maxFrontierSize)
+        {
+          frontier.clear();
+          frontierValid = false;
+        }
+        else
+        {
+          frontier.push_back(s.m_path);
+        }
+      }
+    }
+
+    size_t const numEdges = trieIt->m_edges.size();
+    for (size_t i = 0; i < numEdges; ++i)
+    {
+      auto const & edge = trieIt->m_edges[i];
+
+      auto curIt = dfaIt;
+      strings::DFAMove(curIt, edge.m_label.begin(), edge.m_label.end());
+      if (curIt.Rejects())
+        continue;
+
+      strings::UniString path;
+      if (!accepts)
+      {
+        path = s.m_path;
+        path.append(edge.m_label.begin(), edge.m_label.end());
+      }
+      q.push({trieIt->GoToEdge(i), curIt, std::move(path), accepts});
+    }
+  }
+
+  return found;
+}
+
+// Moves |trieIt| and |dfaIt| along |path|. Returns false if the path is absent or rejected.
+template <typename ValueList, typename DFAIt>
+bool MoveAlongPath(std::shared_ptr<trie::Iterator<ValueList>> & trieIt, DFAIt & dfaIt,
+                   strings::UniString const & path)
+{
+  size_t pos = 0;
+  while (pos < path.size())
+  {
+    auto const & edges = trieIt->m_edges;
+    size_t i = 0;
+    // Labels of sibling edges start with different symbols.
+    while (i < edges.size() && edges[i].m_label[0] != path[pos])
+      ++i;
+    if (i == edges.size())
+      return false;
+
+    auto const & label = edges[i].m_label;
+    if (label.size() > path.size() - pos ||
+        !std::equal(label.begin(), label.end(), path.begin() + pos))
+    {
+      return false;
+    }
+
+    strings::DFAMove(dfaIt, label.begin(), label.end());
+    if (dfaIt.Rejects())
+      return false;
+
+    trieIt = trieIt->GoToEdge(i);
+    pos += label.size();
+  }
+  return true;
+}
+
 template <typename Filter, typename Value>
 class OffsetIntersector
 {
@@ -169,6 +284,69 @@ struct TrieRootPrefix
   }
 };
 
+// Frontiers of prefix DFA walks in a search trie: paths (from the language roots) of the topmost
+// nodes which are accepted by the DFA. When the user types one more character of the last token
+// and the number of allowed errors stays the same, all the features matched by the new DFA are
+// below the frontier of the old one, so the walk is resumed from the frontier
+// instead of the root. See MatchPrefixInTrie().
+struct TrieFrontiers
+{
+  using Paths = std::vector<strings::UniString>;
+
+  // Walks with larger frontiers are not resumed.
+  static size_t constexpr kMaxSize = 512;
+
+  // Frontiers of the previous walk for each language, the walk for a language without
+  // a frontier starts from the language root.
+  std::map<int8_t, Paths> m_resumeFrom;
+  // Frontiers of the current walk for each language.
+  std::map<int8_t, Paths> m_found;
+};
+
+// Matches |dfa| in the |lang| subtrie like MatchInTrie() does but starts from
+// |frontiers.m_resumeFrom| if it is present and saves the new frontier to |frontiers.m_found|.
+// *NOTE* It is the caller's responsibility to check that the walk can be resumed:
+// |dfa| must be a prefix DFA for an extension of the previous token with the same
+// number of allowed errors.
+template <typename DFA, typename ValueList, typename ToDo>
+void MatchPrefixInTrie(DFA const & dfa, TrieRootPrefix<ValueList> const & langRoot, int8_t lang,
+                       TrieFrontiers & frontiers, ToDo && toDo)
+{
+  auto & found = frontiers.m_found[lang];
+  found.clear();
+
+  auto it = dfa.Begin();
+  DFAMove(it, langRoot.m_prefix, langRoot.m_prefix + langRoot.m_prefixSize);
+  if (it.Rejects())
+    return;
+
+  using TrieIt = std::shared_ptr<trie::Iterator<ValueList>>;
+
+  bool frontierValid = true;
+  auto const resume = frontiers.m_resumeFrom.find(lang);
+  if (resume == frontiers.m_resumeFrom.end())
+  {
+    impl::MatchInSubtrieWithFrontier(TrieIt(langRoot.m_root.Clone()), it, {} /* rootPath */,
+                                     TrieFrontiers::kMaxSize, found, frontierValid, toDo);
+  }
+  else
+  {
+    for (auto const & path : resume->second)
+    {
+      TrieIt trieIt = langRoot.m_root.Clone();
+      auto dfaIt = it;
+      if (!impl::MoveAlongPath(trieIt, dfaIt, path))
+        continue;
+
+      impl::MatchInSubtrieWithFrontier(std::move(trieIt), dfaIt, path, TrieFrontiers::kMaxSize,
+                                       found, frontierValid, toDo);
+    }
+  }
+
+  if (!frontierValid)
+    frontiers.m_found.erase(lang);
+}
+
 template <typename Filter, typename Value>
 class TrieValuesHolder
 {
@@ -282,10 +460,11 @@ void ForEachLangPrefix(SearchTrieRequest<DFA> const & request,
 
 // Calls |toDo| for each feature whose description matches to
 // |request|.  Each feature will be passed to |toDo| only once.
+// If |frontiers| is not null, the walk of the first name DFA is performed by MatchPrefixInTrie().
 template <typename DFA, typename ValueList, typename Filter, typename ToDo>
 void MatchFeaturesInTrie(SearchTrieRequest<DFA> const & request,
                          trie::Iterator<ValueList> const & trieRoot, Filter const & filter,
-                         ToDo && toDo)
+                         ToDo && toDo, TrieFrontiers * frontiers = nullptr)
 {
   using Value = typename ValueList::Value;
 
@@ -297,10 +476,21 @@ void MatchFeaturesInTrie(SearchTrieRequest<DFA> const & request,
 
   ForEachLangPrefix(
       request, trieRoot,
-      [&request, &intersector](TrieRootPrefix<ValueList> & langRoot, int8_t /* lang */)
+      [&request, &intersector, frontiers](TrieRootPrefix<ValueList> & langRoot, int8_t lang)
       {
         // Aggregate for all languages.
-        MatchInTrie(request.m_names, langRoot, intersector);
+        if (!frontiers || request.m_names.empty())
+        {
+          MatchInTrie(request.m_names, langRoot, intersector);
+          return;
+        }
+
+        MatchPrefixInTrie(request.m_names.front(), langRoot, lang, *frontiers, intersector);
+        for (size_t i = 1; i < request.m_names.size(); ++i)
+        {
+          impl::MatchInTrie(langRoot.m_root, langRoot.m_prefix, langRoot.m_prefixSize,
+                            request.m_names[i], intersector);
+        }
       });
 
   if (categoriesExist)
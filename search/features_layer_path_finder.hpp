@@ -3,6 +3,7 @@
 #include "search/cancel_exception.hpp"
 #include "search/features_layer.hpp"
 #include "search/intersection_result.hpp"
+#include "search/latency_stats.hpp"
 
 #ifdef DEBUG
 #include "base/logging.hpp"
@@ -49,6 +50,10 @@ public:
 
   FeaturesLayerPathFinder(base::Cancellable const & cancellable) : m_cancellable(cancellable) {}
 
+  // Times every ForEachReachableVertex() call (including |fn| calls) into |stats|,
+  // nullptr disables timing.
+  void SetLatencyStats(LatencyStats * stats) { m_latencyStats = stats; }
+
   template <typename TFn>
   void ForEachReachableVertex(FeaturesLayerMatcher & matcher,
                               std::vector<FeaturesLayer const *> const & layers, TFn && fn)
@@ -56,6 +61,8 @@ public:
     if (layers.empty())
       return;
 
+    LatencyStats::ScopedTimer stageTimer(m_latencyStats, LatencyStats::Stage::PathFinding);
+
 // TODO (@y): remove following code as soon as
 // FindReachableVertices() will work fast for most cases
 // (significantly less than 1 second).
@@ -105,6 +112,7 @@ private:
                                      FnT && fn);
 
   base::Cancellable const & m_cancellable;
+  LatencyStats * m_latencyStats = nullptr;
 
   static Mode m_mode;
 };
@@ -38,6 +38,9 @@
 #include "base/stl_helpers.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <future>
+#include <limits>
 
 #include "defines.hpp"
 
@@ -71,6 +74,10 @@ size_t constexpr kPivotRectsCacheSize = 10;
 size_t constexpr kPostcodesRectsCacheSize = 10;
 size_t constexpr kSuburbsRectsCacheSize = 10;
 size_t constexpr kLocalityRectsCacheSize = 10;
+// A few tokens of the last queries for all the mwms processed by these queries.
+size_t constexpr kRetrievalCacheSize = 256;
+// Features of a short token in a big mwm may take up to a megabyte.
+uint64_t constexpr kRetrievalCacheSizeBytes = 16 * 1024 * 1024;
 
 UniString const kUniSpace(MakeUniString(" "));
 
@@ -108,6 +115,21 @@ struct ScopedMarkTokens
 // static
 BaseContext::TokenType constexpr ScopedMarkTokens::kUnused;
 
+// Returns true when features of the query may be taken from PopularPrefixes. It's done for
+// a single short prefix token only: PopularPrefixes keep the most popular features of a prefix,
+// so features which match other tokens as well may be missed there.
+bool IsPopularPrefixQuery(QueryParams const & params)
+{
+  if (params.GetNumTokens() != 1 || !params.IsPrefixToken(0))
+    return false;
+
+  auto const & token = params.GetToken(0);
+  auto const & original = token.GetOriginal();
+  return original.size() <= PopularPrefixes::kMaxPrefixLength &&
+         GetMaxErrorsForToken(original) == 0 &&
+         !token.AnyOfSynonyms([](UniString const &) { return true; });
+}
+
 class LazyRankTable : public RankTable
 {
 public:
@@ -317,6 +339,30 @@ void Geocoder::LocalitiesCaches::Clear()
   m_villages.Clear();
 }
 
+// Geocoder::MwmResults ----------------------------------------------------------------------------
+struct Geocoder::MwmResults
+{
+  std::vector<PreRankerResult> m_results;
+  // Results starting from this one are emitted by MatchAroundPivot().
+  size_t m_aroundPivotBegin = std::numeric_limits<size_t>::max();
+  bool m_geocoded = false;
+};
+
+// Geocoder::Worker --------------------------------------------------------------------------------
+struct Geocoder::Worker
+{
+  explicit Worker(Geocoder const & geocoder)
+    : m_localitiesCaches(geocoder.m_cancellable)
+    , m_geocoder(geocoder.m_dataSource, geocoder.m_infoGetter, geocoder.m_categories,
+                 geocoder.m_citiesBoundaries, geocoder.m_preRanker, m_localitiesCaches,
+                 geocoder.m_cancellable)
+  {
+  }
+
+  LocalitiesCaches m_localitiesCaches;
+  Geocoder m_geocoder;
+};
+
 // Geocoder::Geocoder ------------------------------------------------------------------------------
 Geocoder::Geocoder(DataSource const & dataSource, storage::CountryInfoGetter const & infoGetter,
                    CategoriesHolder const & categories,
@@ -337,6 +383,7 @@ Geocoder::Geocoder(DataSource const & dataSource, storage::CountryInfoGetter con
   , m_postcodesRectsCache(kPostcodesRectsCacheSize, m_cancellable, kMaxPostcodeRadiusM)
   , m_suburbsRectsCache(kSuburbsRectsCacheSize, m_cancellable, kMaxSuburbRadiusM)
   , m_localityRectsCache(kLocalityRectsCacheSize, m_cancellable)
+  , m_retrievalCache(kRetrievalCacheSize, kRetrievalCacheSizeBytes)
   , m_filter(nullptr)
   , m_matcher(nullptr)
   , m_finder(m_cancellable)
@@ -366,8 +413,15 @@ void Geocoder::SetParams(Params const & params)
 
   m_tokenRequests.clear();
   m_prefixTokenRequest.Clear();
+  m_retrievalKeys.clear();
   for (size_t i = 0; i < m_params.GetNumTokens(); ++i)
   {
+    m_retrievalKeys.push_back(RetrievalCache::MakeKey(m_params.GetToken(i), m_params.IsPrefixToken(i),
+                                                      m_params.GetTypeIndices(i), m_params.GetLangs()));
+    // Popular features are a part of the token features, so they are not reused by other queries.
+    if (IsPopularPrefixQuery(m_params))
+      m_retrievalKeys.back() += "\npopular";
+
     if (!m_params.IsPrefixToken(i))
     {
       m_tokenRequests.emplace_back();
@@ -384,6 +438,44 @@ void Geocoder::SetParams(Params const & params)
   LOG(LDEBUG, (static_cast<QueryParams const &>(m_params)));
 }
 
+void Geocoder::SetNumThreads(size_t numThreads)
+{
+  CHECK_GREATER(numThreads, 0, ());
+
+  m_threadPool.reset();
+  m_workers.clear();
+  if (numThreads == 1)
+    return;
+
+  m_threadPool = make_unique<base::thread_pool::computational::ThreadPool>(numThreads);
+  for (size_t i = 0; i < numThreads; ++i)
+  {
+    m_workers.push_back(make_unique<Worker>(*this));
+    m_workers.back()->m_geocoder.SetSharedGeometryCache(m_sharedGeometryCache);
+    m_workers.back()->m_geocoder.SetLatencyStats(m_latencyStats);
+  }
+}
+
+void Geocoder::SetSharedGeometryCache(SharedGeometryCache * sharedCache)
+{
+  m_sharedGeometryCache = sharedCache;
+  m_pivotRectsCache.SetSharedCache(sharedCache, static_cast<int>(RectId::Pivot));
+  m_postcodesRectsCache.SetSharedCache(sharedCache, static_cast<int>(RectId::Postcode));
+  m_suburbsRectsCache.SetSharedCache(sharedCache, static_cast<int>(RectId::Suburb));
+  m_localityRectsCache.SetSharedCache(sharedCache, static_cast<int>(RectId::Locality));
+
+  for (auto & worker : m_workers)
+    worker->m_geocoder.SetSharedGeometryCache(sharedCache);
+}
+
+void Geocoder::SetLatencyStats(LatencyStats * stats)
+{
+  m_latencyStats = stats;
+  m_finder.SetLatencyStats(stats);
+  for (auto & worker : m_workers)
+    worker->m_geocoder.SetLatencyStats(stats);
+}
+
 void Geocoder::GoEverywhere()
 {
 // TODO (@y): remove following code as soon as Geocoder::Go() will
@@ -440,6 +532,15 @@ void Geocoder::ClearCaches()
   m_cuisineFilter.ClearCaches();
   m_postcodePointsCache.Clear();
   m_postcodes.Clear();
+  m_retrievalCache.Clear();
+  m_trieFrontiersCache.Clear();
+  m_popularPrefixesCache.Clear();
+
+  for (auto & worker : m_workers)
+  {
+    worker->m_geocoder.ClearCaches();
+    worker->m_localitiesCaches.Clear();
+  }
 }
 
 void Geocoder::SetParamsForCategorialSearch(Params const & params)
@@ -541,6 +642,13 @@ void Geocoder::GoImpl(vector<MwmInfoPtr> const & infos, bool inViewport)
 {
   // base::PProf pprof("/tmp/geocoder.prof");
 
+  m_retrievalCache.RemoveDeregistered();
+  m_trieFrontiersCache.RemoveDeregistered();
+  m_popularPrefixesCache.RemoveDeregistered();
+  // The shared cache is common for the workers of GoImplParallel() too.
+  if (m_sharedGeometryCache)
+    m_sharedGeometryCache->RemoveDeregistered();
+
   // Tries to find world and fill localities table.
   {
     m_cities.clear();
@@ -580,79 +688,206 @@ void Geocoder::GoImpl(vector<MwmInfoPtr> const & infos, bool inViewport)
   // found.
   auto const infosWithType = OrderCountries(inViewport, infos);
 
-  // MatchAroundPivot() should always be matched in mwms
-  // intersecting with position and viewport.
+  // The tracer is not thread-safe and expects the sequential order of events.
+  if (!m_workers.empty() && !m_params.m_tracer)
+  {
+    GoImplParallel(infosWithType, inViewport);
+    return;
+  }
+
   auto processCountry = [&](unique_ptr<MwmContext> context, bool updatePreranker) {
-    ASSERT(context, ());
-    m_context = std::move(context);
+    GeocodeMwm(std::move(context), inViewport,
+               [this](MwmContext const & context) { return NeedAroundPivot(context.GetType()); });
 
-    SCOPE_GUARD(cleanup, [&]() {
-      LOG(LDEBUG, (m_context->GetName(), "geocoding complete."));
-      m_matcher->OnQueryFinished();
-      m_matcher = nullptr;
-      m_context.reset();
-    });
+    if (updatePreranker)
+      m_preRanker.UpdateResults(false /* lastUpdate */);
 
-    auto it = m_matchersCache.find(m_context->GetId());
-    if (it == m_matchersCache.end())
-    {
-      it = m_matchersCache
-               .insert(make_pair(m_context->GetId(),
-                                 std::make_unique<FeaturesLayerMatcher>(m_dataSource, m_cancellable)))
-               .first;
-    }
-    m_matcher = it->second.get();
-    m_matcher->SetContext(m_context.get());
+    if (m_preRanker.IsFull())
+      return base::ControlFlow::Break;
 
-    BaseContext ctx;
-    InitBaseContext(ctx);
+    return base::ControlFlow::Continue;
+  };
+
+  // Iterates through all alive mwms and performs geocoding.
+  ForEachCountry(infosWithType, processCountry);
+}
 
-    if (inViewport)
+void Geocoder::GoImplParallel(ExtendedMwmInfos const & infos, bool inViewport)
+{
+  for (auto & worker : m_workers)
+  {
+    auto & geocoder = worker->m_geocoder;
+    geocoder.SetParams(m_params);
+    geocoder.m_retrievalCache.RemoveDeregistered();
+    geocoder.m_trieFrontiersCache.RemoveDeregistered();
+    geocoder.m_popularPrefixesCache.RemoveDeregistered();
+    geocoder.m_worldId = m_worldId;
+    geocoder.m_cities = m_cities;
+    for (size_t i = 0; i < Region::TYPE_COUNT; ++i)
+      geocoder.m_regions[i] = m_regions[i];
+  }
+
+  size_t const numMwms = infos.m_infos.size();
+  vector<MwmResults> results(numMwms);
+  vector<promise<void>> geocoded(numMwms);
+  vector<future<void>> geocodedFutures;
+  geocodedFutures.reserve(numMwms);
+  for (auto & p : geocoded)
+    geocodedFutures.push_back(p.get_future());
+
+  // Mwms are taken by workers in the order of |infos|, so the mwm the results
+  // are replayed from is usually ready or is being geocoded.
+  atomic<size_t> nextMwm(0);
+  atomic<bool> stop(false);
+  auto const work = [&](Geocoder & geocoder) {
+    for (size_t i = nextMwm++; i < numMwms && !stop; i = nextMwm++)
     {
-      auto const viewportCBV =
-          RetrieveGeometryFeatures(*m_context, m_params.m_pivot, RectId::Pivot);
-      for (auto & features : ctx.m_features)
-        features = features.Intersect(viewportCBV);
+      try
+      {
+        auto handle = GetHandleToGeocode(infos.m_infos[i].m_info);
+        if (handle.IsAlive())
+        {
+          geocoder.GeocodeMwmSpeculatively(
+              make_unique<MwmContext>(std::move(handle), infos.m_infos[i].m_type), inViewport,
+              results[i]);
+        }
+        geocoded[i].set_value();
+      }
+      catch (...)
+      {
+        geocoded[i].set_exception(current_exception());
+      }
     }
+  };
 
-    ctx.m_villages = m_localitiesCaches.m_villages.Get(*m_context);
+  vector<future<void>> workers;
+  for (auto & worker : m_workers)
+    workers.push_back(m_threadPool->Submit([&work, &worker]() { work(worker->m_geocoder); }));
 
-    auto const citiesFromWorld = m_cities;
-    FillVillageLocalities(ctx);
-    SCOPE_GUARD(remove_villages, [&]() { m_cities = citiesFromWorld; });
+  SCOPE_GUARD(waitForWorkers, [&]() {
+    stop = true;
+    for (auto & worker : workers)
+      worker.wait();
+  });
 
-    if (m_params.IsCategorialRequest())
-    {
-      MatchCategories(ctx, m_context->GetType().m_viewportIntersected /* aroundPivot */);
-    }
-    else
-    {
-      MatchRegions(ctx, Region::TYPE_COUNTRY);
+  // Replays results as the sequential mode would emit them, see processCountry in GoImpl().
+  for (size_t i = 0; i < numMwms; ++i)
+  {
+    // Rethrows CancelException.
+    geocodedFutures[i].get();
 
-      auto const & mwmType = m_context->GetType();
-      if (mwmType.m_viewportIntersected || mwmType.m_containsUserPosition ||
-          !m_preRanker.HaveFullyMatchedResult())
-      {
-        MatchAroundPivot(ctx);
-      }
+    auto & mwmResults = results[i];
+    if (!mwmResults.m_geocoded)
+      continue;
+
+    auto & emitted = mwmResults.m_results;
+    auto const aroundPivotBegin = min(mwmResults.m_aroundPivotBegin, emitted.size());
+    for (size_t j = 0; j < aroundPivotBegin; ++j)
+      m_preRanker.Emplace(std::move(emitted[j]));
+
+    if (aroundPivotBegin < emitted.size() && NeedAroundPivot(infos.m_infos[i].m_type))
+    {
+      for (size_t j = aroundPivotBegin; j < emitted.size(); ++j)
+        m_preRanker.Emplace(std::move(emitted[j]));
     }
+    emitted = {};
 
-    if (updatePreranker)
+    if (i + 1 >= infos.m_firstBatchSize)
       m_preRanker.UpdateResults(false /* lastUpdate */);
 
     if (m_preRanker.IsFull())
-      return base::ControlFlow::Break;
+      break;
+  }
+}
 
-    return base::ControlFlow::Continue;
-  };
+template <typename Fn>
+void Geocoder::GeocodeMwm(unique_ptr<MwmContext> context, bool inViewport, Fn && needAroundPivot)
+{
+  ASSERT(context, ());
+  m_context = std::move(context);
+
+  SCOPE_GUARD(cleanup, [&]() {
+    LOG(LDEBUG, (m_context->GetName(), "geocoding complete."));
+    m_matcher->OnQueryFinished();
+    m_matcher = nullptr;
+    m_context.reset();
+  });
 
-  // Iterates through all alive mwms and performs geocoding.
-  ForEachCountry(infosWithType, processCountry);
+  auto it = m_matchersCache.find(m_context->GetId());
+  if (it == m_matchersCache.end())
+  {
+    it = m_matchersCache
+             .insert(make_pair(m_context->GetId(),
+                               std::make_unique<FeaturesLayerMatcher>(m_dataSource, m_cancellable)))
+             .first;
+  }
+  m_matcher = it->second.get();
+  m_matcher->SetContext(m_context.get());
+
+  BaseContext ctx;
+  InitBaseContext(ctx);
+
+  if (inViewport)
+  {
+    auto const viewportCBV =
+        RetrieveGeometryFeatures(*m_context, m_params.m_pivot, RectId::Pivot);
+    for (auto & features : ctx.m_features)
+      features = features.Intersect(viewportCBV);
+  }
+
+  ctx.m_villages = m_localitiesCaches.m_villages.Get(*m_context);
+
+  auto const citiesFromWorld = m_cities;
+  FillVillageLocalities(ctx);
+  SCOPE_GUARD(remove_villages, [&]() { m_cities = citiesFromWorld; });
+
+  if (m_params.IsCategorialRequest())
+  {
+    MatchCategories(ctx, m_context->GetType().m_viewportIntersected /* aroundPivot */);
+  }
+  else
+  {
+    MatchRegions(ctx, Region::TYPE_COUNTRY);
+
+    if (needAroundPivot(*m_context))
+      MatchAroundPivot(ctx);
+  }
+}
+
+void Geocoder::GeocodeMwmSpeculatively(unique_ptr<MwmContext> context, bool inViewport,
+                                       MwmResults & results)
+{
+  m_emitTo = &results.m_results;
+  SCOPE_GUARD(resetEmitTo, [this]() { m_emitTo = nullptr; });
+
+  // Whether results of MatchAroundPivot() are needed depends on the results
+  // of the previous mwms, so they are always found and filtered on replay.
+  GeocodeMwm(std::move(context), inViewport, [&results](MwmContext const &) {
+    results.m_aroundPivotBegin = results.m_results.size();
+    return true;
+  });
+  results.m_geocoded = true;
+}
+
+bool Geocoder::NeedAroundPivot(MwmContext::MwmType const & mwmType) const
+{
+  // MatchAroundPivot() should always be matched in mwms
+  // intersecting with position and viewport.
+  return mwmType.m_viewportIntersected || mwmType.m_containsUserPosition ||
+         !m_preRanker.HaveFullyMatchedResult();
 }
 
 void Geocoder::InitBaseContext(BaseContext & ctx)
 {
-  Retrieval retrieval(*m_context, m_cancellable);
+  LatencyStats::ScopedTimer stageTimer(m_latencyStats, LatencyStats::Stage::Retrieval);
+
+  // Opens the search index only if some token is not cached.
+  std::optional<Retrieval> retrieval;
+  auto const getRetrieval = [&]() -> Retrieval & {
+    if (!retrieval)
+      retrieval.emplace(*m_context, m_cancellable);
+    return *retrieval;
+  };
 
   size_t const numTokens = m_params.GetNumTokens();
   ctx.m_tokens.assign(numTokens, BaseContext::TOKEN_TYPE_COUNT);
@@ -666,13 +901,31 @@ void Geocoder::InitBaseContext(BaseContext & ctx)
       CategoriesCache cache(m_params.m_preferredTypes, m_cancellable);
       ctx.m_features[i] = Retrieval::ExtendedFeatures(cache.Get(*m_context));
     }
-    else if (m_params.IsPrefixToken(i))
-    {
-      ctx.m_features[i] = retrieval.RetrieveAddressFeatures(m_prefixTokenRequest);
-    }
     else
     {
-      ctx.m_features[i] = retrieval.RetrieveAddressFeatures(m_tokenRequests[i]);
+      bool found = false;
+      ctx.m_features[i] = m_retrievalCache.Get(m_context->GetId(), m_retrievalKeys[i], [&]()
+      {
+        if (!m_params.IsPrefixToken(i))
+          return getRetrieval().RetrieveAddressFeatures(m_tokenRequests[i]);
+
+        auto const & token = m_params.GetToken(i).GetOriginal();
+        if (IsPopularPrefixQuery(m_params))
+        {
+          if (auto const * popularPrefixes = m_popularPrefixesCache.Get(*m_context))
+            return getRetrieval().RetrieveAddressFeatures(m_prefixTokenRequest, *popularPrefixes,
+                                                          token);
+        }
+
+        TrieFrontiers frontiers;
+        m_trieFrontiersCache.Get(m_context->GetId(), token, frontiers);
+        auto features = getRetrieval().RetrieveAddressFeatures(m_prefixTokenRequest, frontiers);
+        m_trieFrontiersCache.Put(m_context->GetId(), token, std::move(frontiers.m_found));
+        return features;
+      }, found);
+
+      if (m_params.m_tracer)
+        m_params.m_tracer->OnRetrievalCacheAccess(found);
     }
   }
 
@@ -739,6 +992,8 @@ void Geocoder::CacheWorldLocalities()
 
 void Geocoder::FillLocalitiesTable(BaseContext const & ctx)
 {
+  LatencyStats::ScopedTimer stageTimer(m_latencyStats, LatencyStats::Stage::Localities);
+
   auto addRegionMaps = [this](FeatureType & ft, Locality && l, Region::Type type)
   {
     if (ft.GetGeomType() != feature::GeomType::Point)
@@ -840,6 +1095,8 @@ void Geocoder::FillLocalitiesTable(BaseContext const & ctx)
 
 void Geocoder::FillVillageLocalities(BaseContext const & ctx)
 {
+  LatencyStats::ScopedTimer stageTimer(m_latencyStats, LatencyStats::Stage::Localities);
+
   vector<Locality> preLocalities;
   FillLocalityCandidates(ctx, ctx.m_villages, kMaxNumVillages, preLocalities);
 
@@ -891,23 +1148,30 @@ bool Geocoder::CityHasPostcode(BaseContext const & ctx) const
   return m_postcodes.Has(ctx.m_city->GetFeatureIndex(), ctx.m_city->m_featureId.IsWorld());
 }
 
+MwmSet::MwmHandle Geocoder::GetHandleToGeocode(MwmInfoPtr const & info) const
+{
+  if (info->GetType() != MwmInfo::COUNTRY && info->GetType() != MwmInfo::WORLD)
+    return {};
+  if (info->GetType() == MwmInfo::COUNTRY && m_params.m_mode == Mode::Downloader)
+    return {};
+
+  auto handle = m_dataSource.GetMwmHandleById(MwmSet::MwmId(info));
+  if (!handle.IsAlive())
+    return {};
+  auto & value = *handle.GetValue();
+  if (!value.HasSearchIndex() || !value.HasGeometryIndex())
+    return {};
+  return handle;
+}
+
 template <typename Fn>
 void Geocoder::ForEachCountry(ExtendedMwmInfos const & extendedInfos, Fn && fn)
 {
   for (size_t i = 0; i < extendedInfos.m_infos.size(); ++i)
   {
-    auto const & info = extendedInfos.m_infos[i].m_info;
-    if (info->GetType() != MwmInfo::COUNTRY && info->GetType() != MwmInfo::WORLD)
-      continue;
-    if (info->GetType() == MwmInfo::COUNTRY && m_params.m_mode == Mode::Downloader)
-      continue;
-
-    auto handle = m_dataSource.GetMwmHandleById(MwmSet::MwmId(info));
+    auto handle = GetHandleToGeocode(extendedInfos.m_infos[i].m_info);
     if (!handle.IsAlive())
       continue;
-    auto & value = *handle.GetValue();
-    if (!value.HasSearchIndex() || !value.HasGeometryIndex())
-      continue;
     bool const updatePreranker = i + 1 >= extendedInfos.m_firstBatchSize;
     auto const & mwmType = extendedInfos.m_infos[i].m_type;
     if (fn(make_unique<MwmContext>(std::move(handle), mwmType), updatePreranker) ==
@@ -1220,7 +1484,10 @@ void Geocoder::ProcessStreets(BaseContext & ctx, CentersFilter const & centers,
 {
   using PredictionT = StreetsMatcher::Prediction;
   vector<PredictionT> predictions;
-  StreetsMatcher::Go(ctx, streets, *m_filter, m_params, predictions);
+  {
+    LatencyStats::ScopedTimer stageTimer(m_latencyStats, LatencyStats::Stage::Streets);
+    StreetsMatcher::Go(ctx, streets, *m_filter, m_params, predictions);
+  }
 
   // Iterating from best to worst predictions here. Make "Relaxed" results for the best probability.
   for (size_t i = 0; i < predictions.size(); ++i)
@@ -1234,7 +1501,10 @@ void Geocoder::GreedilyMatchStreetsWithSuburbs(BaseContext & ctx, CentersFilter
 {
   TRACE(GreedilyMatchStreetsWithSuburbs);
   vector<StreetsMatcher::Prediction> suburbs;
-  StreetsMatcher::Go(ctx, ctx.m_suburbs, *m_filter, m_params, suburbs);
+  {
+    LatencyStats::ScopedTimer stageTimer(m_latencyStats, LatencyStats::Stage::Streets);
+    StreetsMatcher::Go(ctx, ctx.m_suburbs, *m_filter, m_params, suburbs);
+  }
 
   auto const & suburbChecker = ftypes::IsSuburbChecker::Instance();
   for (auto const & suburb : suburbs)
@@ -1879,7 +2149,10 @@ void Geocoder::EmitResult(BaseContext & ctx, FeatureID const & id,
   info.m_allTokensUsed = allTokensUsed;
   info.m_exactMatch = exactMatch;
 
-  m_preRanker.Emplace(id, info, m_resultTracer.GetProvenance());
+  if (m_emitTo)
+    m_emitTo->emplace_back(id, info, m_resultTracer.GetProvenance());
+  else
+    m_preRanker.Emplace(id, info, m_resultTracer.GetProvenance());
 
   ++ctx.m_numEmitted;
 }
@@ -12,14 +12,18 @@
 #include "search/geocoder_context.hpp"
 #include "search/geocoder_locality.hpp"
 #include "search/geometry_cache.hpp"
+#include "search/latency_stats.hpp"
 #include "search/mode.hpp"
 #include "search/model.hpp"
 #include "search/mwm_context.hpp"
+#include "search/popular_prefixes.hpp"
 #include "search/postcode_points.hpp"
 #include "search/query_params.hpp"
+#include "search/retrieval_cache.hpp"
 #include "search/streets_matcher.hpp"
 #include "search/token_range.hpp"
 #include "search/tracer.hpp"
+#include "search/trie_frontiers_cache.hpp"
 
 #include "indexer/mwm_set.hpp"
 
@@ -29,10 +33,12 @@
 #include "base/cancellable.hpp"
 #include "base/dfa_helpers.hpp"
 #include "base/levenshtein_dfa.hpp"
+#include "base/thread_pool_computational.hpp"
 
 #include <map>
 #include <memory>
 #include <optional>
+#include <string>
 #include <vector>
 
 class CategoriesHolder;
@@ -49,6 +55,7 @@ namespace search
 class FeaturesFilter;
 class FeaturesLayerMatcher;
 class PreRanker;
+class PreRankerResult;
 class TokenSlice;
 
 // This class is used to retrieve all features corresponding to a
@@ -106,6 +113,19 @@ public:
   // Sets search query params.
   void SetParams(Params const & params);
 
+  // Sets the number of threads geocoding mwms of a single query.
+  // With more than one thread mwms are geocoded speculatively in parallel,
+  // and their results are fed to |m_preRanker| in the order and with the
+  // cut-offs of the sequential mode, so results do not depend on |numThreads|.
+  void SetNumThreads(size_t numThreads);
+
+  // Makes rect caches of this geocoder and its workers share features
+  // with other geocoders through |sharedCache|, nullptr disables sharing.
+  void SetSharedGeometryCache(SharedGeometryCache * sharedCache);
+
+  // Makes this geocoder and its workers time their stages into |stats|, nullptr disables timing.
+  void SetLatencyStats(LatencyStats * stats);
+
   // Starts geocoding, retrieved features will be appended to
   // |results|.
   void GoEverywhere();
@@ -156,6 +176,9 @@ private:
     size_t m_firstBatchSize = 0;
   };
 
+  struct MwmResults;
+  struct Worker;
+
   struct Postcodes
   {
     void Clear()
@@ -184,6 +207,20 @@ private:
 
   void GoImpl(std::vector<MwmInfoPtr> const & infos, bool inViewport);
 
+  // Geocodes mwms on |m_workers| and replays their results in the order of |infos|.
+  void GoImplParallel(ExtendedMwmInfos const & infos, bool inViewport);
+
+  // Geocodes the mwm of |context|. |needAroundPivot| is called after MatchRegions()
+  // and decides whether MatchAroundPivot() is needed.
+  template <typename Fn>
+  void GeocodeMwm(std::unique_ptr<MwmContext> context, bool inViewport, Fn && needAroundPivot);
+
+  // Geocodes the mwm of |context| on a worker, all results are stored to |results|.
+  void GeocodeMwmSpeculatively(std::unique_ptr<MwmContext> context, bool inViewport,
+                               MwmResults & results);
+
+  bool NeedAroundPivot(MwmContext::MwmType const & mwmType) const;
+
   template <typename Locality>
   using TokenToLocalities = std::map<TokenRange, std::vector<Locality>>;
 
@@ -204,6 +241,9 @@ private:
 
   bool CityHasPostcode(BaseContext const & ctx) const;
 
+  // Returns a handle of the mwm if it should be geocoded, otherwise returns a dead handle.
+  MwmSet::MwmHandle GetHandleToGeocode(MwmInfoPtr const & info) const;
+
   template <typename Fn>
   void ForEachCountry(ExtendedMwmInfos const & infos, Fn && fn);
 
@@ -277,7 +317,7 @@ private:
   void TraceResult(Tracer & tracer, BaseContext const & ctx, MwmSet::MwmId const & mwmId,
                    uint32_t ftId, Model::Type type, TokenRange const & tokenRange);
 
-  // Forms result and feeds it to |m_preRanker|.
+  // Forms result and feeds it to |m_preRanker| or stores it to |m_emitTo|.
   void EmitResult(BaseContext & ctx, FeatureID const & id, Model::Type type,
                   TokenRange const & tokenRange, IntersectionResult const * geoParts,
                   bool allTokensUsed, bool exactMatch);
@@ -352,9 +392,17 @@ private:
   PivotRectsCache m_postcodesRectsCache;
   PivotRectsCache m_suburbsRectsCache;
   LocalityRectsCache m_localityRectsCache;
+  SharedGeometryCache * m_sharedGeometryCache = nullptr;
+  LatencyStats * m_latencyStats = nullptr;
 
   PostcodePointsCache m_postcodePointsCache;
 
+  // Address features of query tokens, survives between queries.
+  RetrievalCache m_retrievalCache;
+  // Frontiers of the prefix token walks, survive between queries.
+  TrieFrontiersCache m_trieFrontiersCache;
+  PopularPrefixesCache m_popularPrefixesCache;
+
   // Postcodes features in the mwm that is currently being processed and World.mwm.
   Postcodes m_postcodes;
 
@@ -371,9 +419,17 @@ private:
   // Search query params prepared for retrieval.
   std::vector<SearchTrieRequest<strings::LevenshteinDFA>> m_tokenRequests;
   SearchTrieRequest<strings::PrefixDFAModifier<strings::LevenshteinDFA>> m_prefixTokenRequest;
+  // Keys of the token requests in |m_retrievalCache|, one per query token.
+  std::vector<std::string> m_retrievalKeys;
 
   ResultTracer m_resultTracer;
 
   PreRanker & m_preRanker;
+  // When set, results are stored here instead of |m_preRanker|.
+  std::vector<PreRankerResult> * m_emitTo = nullptr;
+
+  // Geocoders of the parallel mode, see SetNumThreads().
+  std::vector<std::unique_ptr<Worker>> m_workers;
+  std::unique_ptr<base::thread_pool::computational::ThreadPool> m_threadPool;
 };
 }  // namespace search
@@ -8,8 +8,163 @@
 
 #include "geometry/mercator.hpp"
 
+#include <functional>
+
+using namespace std;
+
 namespace search
 {
+// SharedGeometryCache -----------------------------------------------------------------------------
+SharedGeometryCache::SharedGeometryCache(uint64_t maxSizeBytes, size_t numShards)
+  : m_maxShardSizeBytes(maxSizeBytes / max<size_t>(numShards, 1))
+{
+  CHECK_GREATER(numShards, 0, ());
+  for (size_t i = 0; i < numShards; ++i)
+    m_shards.push_back(make_unique<Shard>());
+}
+
+bool SharedGeometryCache::Find(MwmSet::MwmId const & id, int kind, Pred const & pred,
+                               m2::RectD & rect, int & scale, CBV & cbv)
+{
+  auto & shard = GetShard(id);
+  lock_guard<mutex> lock(shard.m_mu);
+  auto const positions = shard.m_index.find(id);
+  if (positions == shard.m_index.end())
+    return false;
+
+  auto const it = find_if(positions->second.begin(), positions->second.end(), [&](auto const & item) {
+    return item->m_kind == kind && pred(item->m_rect, item->m_scale);
+  });
+  if (it == positions->second.end())
+    return false;
+
+  Touch(shard, positions->second, it);
+  auto const & item = *shard.m_items.begin();
+  rect = item.m_rect;
+  scale = item.m_scale;
+  cbv = item.m_cbv.Clone();
+  return true;
+}
+
+void SharedGeometryCache::Insert(MwmSet::MwmId const & id, int kind, m2::RectD const & rect,
+                                 int scale, CBV const & cbv)
+{
+  // Bit vector is cloned outside of the lock.
+  Item item;
+  item.m_id = id;
+  item.m_kind = kind;
+  item.m_rect = rect;
+  item.m_scale = scale;
+  item.m_cbv = cbv.Clone();
+  item.m_size = sizeof(Item) + item.m_cbv.GetSizeInBytes();
+  if (item.m_size > m_maxShardSizeBytes)
+    return;
+
+  auto & shard = GetShard(id);
+  lock_guard<mutex> lock(shard.m_mu);
+  auto & positions = shard.m_index[id];
+
+  // Another thread may have inserted the same rect meanwhile.
+  auto const it = find_if(positions.begin(), positions.end(), [&](auto const & other) {
+    return other->m_kind == kind && other->m_scale == scale && other->m_rect == rect;
+  });
+  if (it != positions.end())
+  {
+    Touch(shard, positions, it);
+    return;
+  }
+
+  shard.m_size += item.m_size;
+  shard.m_items.push_front(move(item));
+  positions.push_front(shard.m_items.begin());
+  shard.m_items.front().m_position = positions.begin();
+  while (shard.m_size > m_maxShardSizeBytes)
+    PopBack(shard);
+}
+
+void SharedGeometryCache::RemoveDeregistered()
+{
+  for (auto & shard : m_shards)
+  {
+    lock_guard<mutex> lock(shard->m_mu);
+    for (auto it = shard->m_index.begin(); it != shard->m_index.end();)
+    {
+      if (it->first.IsAlive())
+      {
+        ++it;
+        continue;
+      }
+
+      for (auto const & item : it->second)
+      {
+        shard->m_size -= item->m_size;
+        shard->m_items.erase(item);
+      }
+      it = shard->m_index.erase(it);
+    }
+  }
+}
+
+void SharedGeometryCache::Clear()
+{
+  for (auto & shard : m_shards)
+  {
+    lock_guard<mutex> lock(shard->m_mu);
+    shard->m_items.clear();
+    shard->m_index.clear();
+    shard->m_size = 0;
+  }
+}
+
+uint64_t SharedGeometryCache::GetSizeInBytes() const
+{
+  uint64_t size = 0;
+  for (auto const & shard : m_shards)
+  {
+    lock_guard<mutex> lock(shard->m_mu);
+    size += shard->m_size;
+  }
+  return size;
+}
+
+size_t SharedGeometryCache::GetNumEntries() const
+{
+  size_t numEntries = 0;
+  for (auto const & shard : m_shards)
+  {
+    lock_guard<mutex> lock(shard->m_mu);
+    numEntries += shard->m_items.size();
+  }
+  return numEntries;
+}
+
+SharedGeometryCache::Shard & SharedGeometryCache::GetShard(MwmSet::MwmId const & id)
+{
+  auto const h = std::hash<MwmInfo const *>()(id.GetInfo().get());
+  return *m_shards[h % m_shards.size()];
+}
+
+// static
+void SharedGeometryCache::Touch(Shard & shard, Positions & positions, Positions::iterator it)
+{
+  shard.m_items.splice(shard.m_items.begin(), shard.m_items, *it);
+  positions.splice(positions.begin(), positions, it);
+}
+
+// static
+void SharedGeometryCache::PopBack(Shard & shard)
+{
+  ASSERT(!shard.m_items.empty(), ());
+  auto & item = shard.m_items.back();
+  auto const positions = shard.m_index.find(item.m_id);
+  ASSERT(positions != shard.m_index.end(), ());
+  positions->second.erase(item.m_position);
+  if (positions->second.empty())
+    shard.m_index.erase(positions);
+  shard.m_size -= item.m_size;
+  shard.m_items.pop_back();
+}
+
 // GeometryCache -----------------------------------------------------------------------------------
 GeometryCache::GeometryCache(size_t maxNumEntries, base::Cancellable const & cancellable)
   : m_maxNumEntries(maxNumEntries), m_cancellable(cancellable)
@@ -17,6 +172,21 @@ GeometryCache::GeometryCache(size_t maxNumEntries, base::Cancellable const & can
   CHECK_GREATER(m_maxNumEntries, 0, ());
 }
 
+void GeometryCache::SetSharedCache(SharedGeometryCache * sharedCache, int kind)
+{
+  m_sharedCache = sharedCache;
+  m_sharedCacheKind = kind;
+}
+
+bool GeometryCache::FindShared(MwmSet::MwmId const & id, SharedGeometryCache::Pred const & pred,
+                               Entry & entry)
+{
+  if (!m_sharedCache)
+    return false;
+  return m_sharedCache->Find(id, m_sharedCacheKind, pred, entry.m_rect, entry.m_scale,
+                             entry.m_cbv);
+}
+
 void GeometryCache::InitEntry(MwmContext const & context, m2::RectD const & rect, int scale,
                               Entry & entry)
 {
@@ -25,6 +195,9 @@ void GeometryCache::InitEntry(MwmContext const & context, m2::RectD const & rect
   entry.m_rect = rect;
   entry.m_cbv = retrieval.RetrieveGeometryFeatures(rect, scale);
   entry.m_scale = scale;
+
+  if (m_sharedCache)
+    m_sharedCache->Insert(context.GetId(), m_sharedCacheKind, rect, scale, entry.m_cbv);
 }
 
 // PivotRectsCache ---------------------------------------------------------------------------------
@@ -36,14 +209,17 @@ PivotRectsCache::PivotRectsCache(size_t maxNumEntries, base::Cancellable const &
 
 CBV PivotRectsCache::Get(MwmContext const & context, m2::RectD const & rect, int scale)
 {
-  auto p = FindOrCreateEntry(
-      context.GetId(), [&rect, &scale](Entry const & entry)
-      {
-        return scale == entry.m_scale &&
-               (entry.m_rect.IsRectInside(rect) || IsEqualMercator(rect, entry.m_rect, kMwmPointAccuracy));
-      });
+  auto const pred = [&rect, &scale](m2::RectD const & entryRect, int entryScale)
+  {
+    return scale == entryScale &&
+           (entryRect.IsRectInside(rect) || IsEqualMercator(rect, entryRect, kMwmPointAccuracy));
+  };
+  auto p = FindOrCreateEntry(context.GetId(), [&pred](Entry const & entry)
+                             {
+                               return pred(entry.m_rect, entry.m_scale);
+                             });
   auto & entry = p.first;
-  if (p.second)
+  if (p.second && !FindShared(context.GetId(), pred, entry))
   {
     m2::RectD normRect = mercator::RectByCenterXYAndSizeInMeters(rect.Center(), m_maxRadiusMeters);
     if (!normRect.IsRectInside(rect))
@@ -62,13 +238,16 @@ LocalityRectsCache::LocalityRectsCache(size_t maxNumEntries,
 
 CBV LocalityRectsCache::Get(MwmContext const & context, m2::RectD const & rect, int scale)
 {
-  auto p = FindOrCreateEntry(context.GetId(), [&rect, &scale](Entry const & entry)
+  auto const pred = [&rect, &scale](m2::RectD const & entryRect, int entryScale)
+  {
+    return scale == entryScale && IsEqualMercator(rect, entryRect, kMwmPointAccuracy);
+  };
+  auto p = FindOrCreateEntry(context.GetId(), [&pred](Entry const & entry)
                              {
-                               return scale == entry.m_scale &&
-                                      IsEqualMercator(rect, entry.m_rect, kMwmPointAccuracy);
+                               return pred(entry.m_rect, entry.m_scale);
                              });
   auto & entry = p.first;
-  if (p.second)
+  if (p.second && !FindShared(context.GetId(), pred, entry))
     InitEntry(context, rect, scale, entry);
   return entry.m_cbv;
 }
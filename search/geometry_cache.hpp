@@ -7,12 +7,19 @@
 #include "geometry/rect2d.hpp"
 
 #include "base/assert.hpp"
+#include "base/macros.hpp"
 
 #include <algorithm>
 #include <cstdint>
 #include <deque>
+#include <functional>
+#include <list>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace base
 {
@@ -23,6 +30,82 @@ namespace search
 {
 class MwmContext;
 
+// Cache of features in rects shared by geocoders of all search threads.
+// Entries are kept per (mwm, kind), where kind distinguishes caches with
+// different rect normalization (e.g. pivot and locality rects).
+// The cache is split into shards by mwm, each shard has its own mutex and
+// an equal part of |maxSizeBytes|, least recently used entries are evicted first.
+// Entries of a shard are indexed by mwm, so a lookup checks the entries of its mwm only.
+//
+// Entries are deep copies of the retrieved bit vectors, see CBV::Clone().
+//
+// This class is thread-safe.
+class SharedGeometryCache
+{
+public:
+  using Pred = std::function<bool(m2::RectD const & rect, int scale)>;
+
+  static size_t constexpr kDefaultNumShards = 16;
+
+  explicit SharedGeometryCache(uint64_t maxSizeBytes, size_t numShards = kDefaultNumShards);
+
+  // Returns true and fills |rect|, |scale| and |cbv| if there is an entry
+  // for (|id|, |kind|) satisfying |pred|.
+  bool Find(MwmSet::MwmId const & id, int kind, Pred const & pred, m2::RectD & rect, int & scale,
+            CBV & cbv);
+
+  // Entries larger than the shard budget are not cached.
+  void Insert(MwmSet::MwmId const & id, int kind, m2::RectD const & rect, int scale,
+              CBV const & cbv);
+
+  // Removes entries of deregistered mwms.
+  void RemoveDeregistered();
+
+  void Clear();
+
+  uint64_t GetSizeInBytes() const;
+  size_t GetNumEntries() const;
+
+private:
+  struct Item;
+  using Items = std::list<Item>;
+  using Positions = std::list<Items::iterator>;
+
+  struct Item
+  {
+    MwmSet::MwmId m_id;
+    int m_kind = 0;
+    m2::RectD m_rect;
+    int m_scale = 0;
+    CBV m_cbv;
+    uint64_t m_size = 0;
+    // Position of the item in |Shard::m_index|.
+    Positions::iterator m_position;
+  };
+
+  struct Shard
+  {
+    mutable std::mutex m_mu;
+    // Most recently used items are in front.
+    Items m_items;
+    // Items of every mwm, most recently used are in front.
+    std::unordered_map<MwmSet::MwmId, Positions> m_index;
+    uint64_t m_size = 0;
+  };
+
+  Shard & GetShard(MwmSet::MwmId const & id);
+
+  // Moves |it| to the front of both |shard.m_items| and |positions|.
+  static void Touch(Shard & shard, Positions & positions, Positions::iterator it);
+  // Removes the least recently used item of |shard|.
+  static void PopBack(Shard & shard);
+
+  uint64_t const m_maxShardSizeBytes;
+  std::vector<std::unique_ptr<Shard>> m_shards;
+
+  DISALLOW_COPY_AND_MOVE(SharedGeometryCache);
+};
+
 // This class represents a simple cache of features in rects for all mwms.
 //
 // *NOTE* This class is not thread-safe.
@@ -38,6 +121,10 @@ public:
 
   inline void Clear() { m_entries.clear(); }
 
+  // Makes the cache consult |sharedCache| on misses and put retrieved features there.
+  // |kind| must be unique for each cache of a geocoder, nullptr disables sharing.
+  void SetSharedCache(SharedGeometryCache * sharedCache, int kind);
+
 protected:
   struct Entry
   {
@@ -71,11 +158,17 @@ protected:
     return std::pair<Entry &, bool>(entries.front(), true);
   }
 
+  // Fills |entry| from the shared cache, returns false if there is no suitable shared entry.
+  bool FindShared(MwmSet::MwmId const & id, SharedGeometryCache::Pred const & pred, Entry & entry);
+
   void InitEntry(MwmContext const & context, m2::RectD const & rect, int scale, Entry & entry);
 
   std::map<MwmSet::MwmId, std::deque<Entry>> m_entries;
   size_t const m_maxNumEntries;
   base::Cancellable const & m_cancellable;
+
+  SharedGeometryCache * m_sharedCache = nullptr;
+  int m_sharedCacheKind = 0;
 };
 
 class PivotRectsCache : public GeometryCache
@@ -884,7 +884,8 @@ int HouseDetector::LoadStreets(vector<FeatureID> const & ids)
     if (m_id2st.find(ids[i]) != m_id2st.end())
       continue;
 
-    auto f = m_loader.Load(ids[i]);
+    m_arena.Reset();
+    auto * f = m_loader.Load(ids[i], m_arena);
     if (!f)
     {
       LOG(LWARNING, ("Can't read feature from:", ids[i].m_mwmId));
@@ -918,6 +919,7 @@ int HouseDetector::LoadStreets(vector<FeatureID> const & ids)
     }
   }
 
+  m_arena.Reset();
   m_loader.Reset();
   return count;
 }
@@ -3,6 +3,7 @@
 #include "search/feature_loader.hpp"
 #include "search/projection_on_street.hpp"
 
+#include "indexer/feature_arena.hpp"
 #include "indexer/feature_decl.hpp"
 #include "indexer/ftypes_matcher.hpp"
 
@@ -241,6 +242,8 @@ private:
   double GetApprLengthMeters(int index) const;
 
   FeatureLoader m_loader;
+  // Street features are decoded one by one, so one reusable feature object is enough.
+  FeatureArena m_arena;
 
   StreetMap m_id2st;
   HouseMap m_id2house;
@@ -0,0 +1,118 @@
+#include "search/latency_stats.hpp"
+
+#include "base/assert.hpp"
+#include "base/bits.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+using namespace std;
+
+namespace search
+{
+// LatencyStats::Histogram -------------------------------------------------------------------------
+uint64_t LatencyStats::Histogram::GetPercentileUs(double p) const
+{
+  if (m_count == 0)
+    return 0;
+
+  auto const rank = max<uint64_t>(1, static_cast<uint64_t>(ceil(p * static_cast<double>(m_count))));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kNumBuckets; ++i)
+  {
+    seen += m_buckets[i];
+    if (seen >= rank)
+      return min(uint64_t{1} << i, m_maxUs);
+  }
+  return m_maxUs;
+}
+
+// LatencyStats::ScopedTimer -----------------------------------------------------------------------
+LatencyStats::ScopedTimer::ScopedTimer(LatencyStats * stats, Stage stage)
+  : m_stats(stats), m_stage(stage), m_timer(stats != nullptr /* start */)
+{
+}
+
+LatencyStats::ScopedTimer::~ScopedTimer()
+{
+  if (m_stats)
+    m_stats->Add(m_stage, m_timer.TimeElapsed());
+}
+
+// LatencyStats ------------------------------------------------------------------------------------
+LatencyStats::LatencyStats() { Clear(); }
+
+// static
+size_t LatencyStats::GetBucket(uint64_t us)
+{
+  if (us == 0)
+    return 0;
+  return min(kNumBuckets - 1, static_cast<size_t>(bits::FloorLog(us)) + 1);
+}
+
+void LatencyStats::Add(Stage stage, base::Timer::DurationT duration)
+{
+  AddUs(stage, static_cast<uint64_t>(chrono::duration_cast<chrono::microseconds>(duration).count()));
+}
+
+void LatencyStats::AddUs(Stage stage, uint64_t us)
+{
+  ASSERT_LESS(static_cast<size_t>(stage), m_histograms.size(), ());
+  auto & h = m_histograms[static_cast<size_t>(stage)];
+  h.m_buckets[GetBucket(us)].fetch_add(1, memory_order_relaxed);
+  h.m_count.fetch_add(1, memory_order_relaxed);
+  h.m_sumUs.fetch_add(us, memory_order_relaxed);
+
+  auto maxUs = h.m_maxUs.load(memory_order_relaxed);
+  while (maxUs < us && !h.m_maxUs.compare_exchange_weak(maxUs, us, memory_order_relaxed))
+    ;
+}
+
+LatencyStats::Histogram LatencyStats::GetHistogram(Stage stage) const
+{
+  ASSERT_LESS(static_cast<size_t>(stage), m_histograms.size(), ());
+  auto const & h = m_histograms[static_cast<size_t>(stage)];
+
+  // Counters are read one by one, so the histogram may be slightly inconsistent
+  // while queries are running.
+  Histogram result;
+  for (size_t i = 0; i < kNumBuckets; ++i)
+    result.m_buckets[i] = h.m_buckets[i].load(memory_order_relaxed);
+  result.m_count = h.m_count.load(memory_order_relaxed);
+  result.m_sumUs = h.m_sumUs.load(memory_order_relaxed);
+  result.m_maxUs = h.m_maxUs.load(memory_order_relaxed);
+  return result;
+}
+
+void LatencyStats::Clear()
+{
+  for (auto & h : m_histograms)
+  {
+    for (auto & bucket : h.m_buckets)
+      bucket.store(0, memory_order_relaxed);
+    h.m_count.store(0, memory_order_relaxed);
+    h.m_sumUs.store(0, memory_order_relaxed);
+    h.m_maxUs.store(0, memory_order_relaxed);
+  }
+}
+
+string DebugPrint(LatencyStats::Stage stage)
+{
+  using Stage = LatencyStats::Stage;
+  switch (stage)
+  {
+  case Stage::Tokenization: return "Tokenization";
+  case Stage::Retrieval: return "Retrieval";
+  case Stage::Localities: return "Localities";
+  case Stage::Streets: return "Streets";
+  case Stage::PathFinding: return "PathFinding";
+  case Stage::PreRanking: return "PreRanking";
+  case Stage::Ranking: return "Ranking";
+  case Stage::Formatting: return "Formatting";
+  case Stage::Total: return "Total";
+  case Stage::Count: return "Count";
+  }
+  UNREACHABLE();
+}
+}  // namespace search
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "base/macros.hpp"
+#include "base/timer.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace search
+{
+// Histograms of the durations of the search stages. Collection is opt-in: stats are created
+// by Engine when Engine::Params::m_collectLatencyStats is set and are filled by all search
+// threads (and geocoder workers) concurrently, so counters are atomic.
+//
+// Durations are put into buckets of powers of two microseconds: bucket 0 holds durations
+// shorter than 1us and bucket i > 0 holds durations in [2^(i-1), 2^i) us.
+class LatencyStats
+{
+public:
+  enum class Stage
+  {
+    // Splitting and normalization of the query.
+    Tokenization,
+    // Retrieval of the features of all query tokens in an mwm, one sample per mwm.
+    Retrieval,
+    // Matching of the cities, villages and regions.
+    Localities,
+    // Matching of the streets.
+    Streets,
+    // FeaturesLayerPathFinder, one sample per layers chain.
+    PathFinding,
+    // PreRanker filtering of a batch of results.
+    PreRanking,
+    // Ranker scoring and sorting of a batch of results.
+    Ranking,
+    // Making of the final results (names, addresses, highlighting).
+    Formatting,
+    // Whole query, from Processor::Search() start to the end marker.
+    Total,
+
+    Count
+  };
+
+  static size_t constexpr kNumBuckets = 32;
+
+  struct Histogram
+  {
+    // Returns the upper bound of the bucket with the |p|-th quantile, in microseconds.
+    uint64_t GetPercentileUs(double p) const;
+
+    std::array<uint64_t, kNumBuckets> m_buckets = {};
+    uint64_t m_count = 0;
+    uint64_t m_sumUs = 0;
+    uint64_t m_maxUs = 0;
+  };
+
+  // Measures the lifetime of the timer. Does nothing when |stats| is nullptr.
+  class ScopedTimer
+  {
+  public:
+    ScopedTimer(LatencyStats * stats, Stage stage);
+    ~ScopedTimer();
+
+  private:
+    LatencyStats * m_stats;
+    Stage m_stage;
+    base::Timer m_timer;
+
+    DISALLOW_COPY_AND_MOVE(ScopedTimer);
+  };
+
+  LatencyStats();
+
+  static size_t GetBucket(uint64_t us);
+
+  void Add(Stage stage, base::Timer::DurationT duration);
+  void AddUs(Stage stage, uint64_t us);
+
+  Histogram GetHistogram(Stage stage) const;
+
+  void Clear();
+
+private:
+  struct AtomicHistogram
+  {
+    std::array<std::atomic<uint64_t>, kNumBuckets> m_buckets;
+    std::atomic<uint64_t> m_count;
+    std::atomic<uint64_t> m_sumUs;
+    std::atomic<uint64_t> m_maxUs;
+  };
+
+  std::array<AtomicHistogram, static_cast<size_t>(Stage::Count)> m_histograms;
+
+  DISALLOW_COPY_AND_MOVE(LatencyStats);
+};
+
+std::string DebugPrint(LatencyStats::Stage stage);
+}  // namespace search
@@ -0,0 +1,149 @@
+#include "search/popular_prefixes.hpp"
+
+#include "coding/compressed_bit_vector.hpp"
+#include "coding/read_write_utils.hpp"
+#include "coding/varint.hpp"
+#include "coding/writer.hpp"
+
+#include "base/assert.hpp"
+#include "base/checked_cast.hpp"
+
+#include <algorithm>
+#include <string>
+#include <tuple>
+
+#include "defines.hpp"
+
+using namespace std;
+
+namespace search
+{
+// PopularPrefixes::Header -------------------------------------------------------------------------
+void PopularPrefixes::Header::Read(Reader & reader)
+{
+  NonOwningReaderSource source(reader);
+  m_version = static_cast<Version>(ReadPrimitiveFromSource<uint8_t>(source));
+  CHECK_EQUAL(static_cast<uint8_t>(m_version), static_cast<uint8_t>(Version::V0), ());
+  m_indexOffset = ReadPrimitiveFromSource<uint32_t>(source);
+  m_indexSize = ReadPrimitiveFromSource<uint32_t>(source);
+  m_listsOffset = ReadPrimitiveFromSource<uint32_t>(source);
+  m_listsSize = ReadPrimitiveFromSource<uint32_t>(source);
+}
+
+// PopularPrefixes::Entry --------------------------------------------------------------------------
+bool PopularPrefixes::Entry::operator<(Entry const & rhs) const
+{
+  return tie(m_lang, m_prefix) < tie(rhs.m_lang, rhs.m_prefix);
+}
+
+// PopularPrefixes ---------------------------------------------------------------------------------
+PopularPrefixes::PopularPrefixes(Reader const & reader)
+{
+  auto const headerReader = reader.CreateSubReader(0 /* pos */, reader.Size());
+  m_header.Read(*headerReader);
+
+  auto const indexSubReader = reader.CreateSubReader(m_header.m_indexOffset, m_header.m_indexSize);
+  NonOwningReaderSource src(*indexSubReader);
+  auto const numEntries = ReadVarUint<uint32_t>(src);
+  m_entries.resize(numEntries);
+  for (auto & entry : m_entries)
+  {
+    entry.m_lang = ReadPrimitiveFromSource<int8_t>(src);
+    string prefix;
+    rw::Read(src, prefix);
+    entry.m_prefix = strings::MakeUniString(prefix);
+    entry.m_listOffset = ReadVarUint<uint32_t>(src);
+  }
+
+  m_listsSubReader = reader.CreateSubReader(m_header.m_listsOffset, m_header.m_listsSize);
+}
+
+// static
+void PopularPrefixes::Serialize(vector<Entry> const & entries, Writer & writer)
+{
+  ASSERT(is_sorted(entries.begin(), entries.end()), ());
+
+  auto const startOffset = writer.Pos();
+  Header header;
+  header.Serialize(writer);
+
+  vector<uint32_t> listOffsets;
+  vector<uint8_t> lists;
+  {
+    MemWriter<vector<uint8_t>> listsWriter(lists);
+    for (auto const & entry : entries)
+    {
+      listOffsets.push_back(base::asserted_cast<uint32_t>(listsWriter.Pos()));
+      vector<uint64_t> const features(entry.m_features.begin(), entry.m_features.end());
+      coding::CompressedBitVectorBuilder::FromBitPositions(features)->Serialize(listsWriter);
+    }
+  }
+
+  header.m_indexOffset = base::asserted_cast<uint32_t>(writer.Pos() - startOffset);
+  WriteVarUint(writer, base::asserted_cast<uint32_t>(entries.size()));
+  for (size_t i = 0; i < entries.size(); ++i)
+  {
+    WriteToSink(writer, entries[i].m_lang);
+    rw::Write(writer, strings::ToUtf8(entries[i].m_prefix));
+    WriteVarUint(writer, listOffsets[i]);
+  }
+  header.m_indexSize =
+      base::asserted_cast<uint32_t>(writer.Pos() - startOffset - header.m_indexOffset);
+
+  header.m_listsOffset = base::asserted_cast<uint32_t>(writer.Pos() - startOffset);
+  writer.Write(lists.data(), lists.size());
+  header.m_listsSize = base::asserted_cast<uint32_t>(lists.size());
+
+  auto const endOffset = writer.Pos();
+  writer.Seek(startOffset);
+  header.Serialize(writer);
+  writer.Seek(endOffset);
+}
+
+bool PopularPrefixes::Get(int8_t lang, strings::UniString const & prefix, CBV & features) const
+{
+  auto const it = lower_bound(m_entries.begin(), m_entries.end(), lang,
+                              [&prefix](IndexEntry const & entry, int8_t value) {
+                                return tie(entry.m_lang, entry.m_prefix) < tie(value, prefix);
+                              });
+  if (it == m_entries.end() || it->m_lang != lang || it->m_prefix != prefix)
+    return false;
+
+  auto const nextIt = next(it);
+  auto const listEnd = nextIt == m_entries.end() ? m_header.m_listsSize : nextIt->m_listOffset;
+  auto const listReader =
+      m_listsSubReader->CreateSubReader(it->m_listOffset, listEnd - it->m_listOffset);
+  NonOwningReaderSource src(*listReader);
+  features = CBV(coding::CompressedBitVectorBuilder::DeserializeFromSource(src));
+  return true;
+}
+
+// PopularPrefixesCache ----------------------------------------------------------------------------
+PopularPrefixes const * PopularPrefixesCache::Get(MwmContext const & context)
+{
+  auto const mwmId = context.GetId();
+  auto it = m_entries.find(mwmId);
+  if (it == m_entries.end())
+  {
+    unique_ptr<PopularPrefixes> prefixes;
+    if (context.m_value.m_cont.IsExist(SEARCH_PREFIXES_FILE_TAG))
+    {
+      auto const reader = context.m_value.m_cont.GetReader(SEARCH_PREFIXES_FILE_TAG);
+      prefixes = make_unique<PopularPrefixes>(*reader.GetPtr());
+    }
+    it = m_entries.emplace(mwmId, std::move(prefixes)).first;
+  }
+  return it->second.get();
+}
+
+void PopularPrefixesCache::RemoveDeregistered()
+{
+  for (auto it = m_entries.begin(); it != m_entries.end();)
+  {
+    if (it->first.IsAlive())
+      ++it;
+    else
+      it = m_entries.erase(it);
+  }
+}
+}  // namespace search
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "search/cbv.hpp"
+#include "search/mwm_context.hpp"
+
+#include "indexer/mwm_set.hpp"
+
+#include "coding/reader.hpp"
+#include "coding/write_to_sink.hpp"
+
+#include "base/string_utils.hpp"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+class Writer;
+
+namespace search
+{
+// Lists of the top ranked features for short name prefixes matching too many features,
+// per language. Search index subtries of such prefixes are huge, so the lists are
+// precomputed by the generator and used by Retrieval for the first keystrokes.
+class PopularPrefixes
+{
+public:
+  enum class Version : uint8_t
+  {
+    V0 = 0,
+    Latest = V0
+  };
+
+  struct Header
+  {
+    template <typename Sink>
+    void Serialize(Sink & sink) const
+    {
+      CHECK_EQUAL(static_cast<uint8_t>(m_version), static_cast<uint8_t>(Version::V0), ());
+      WriteToSink(sink, static_cast<uint8_t>(m_version));
+      WriteToSink(sink, m_indexOffset);
+      WriteToSink(sink, m_indexSize);
+      WriteToSink(sink, m_listsOffset);
+      WriteToSink(sink, m_listsSize);
+    }
+
+    void Read(Reader & reader);
+
+    Version m_version = Version::Latest;
+    // All offsets are relative to the start of the section (offset of header is zero).
+    uint32_t m_indexOffset = 0;
+    uint32_t m_indexSize = 0;
+    uint32_t m_listsOffset = 0;
+    uint32_t m_listsSize = 0;
+  };
+
+  struct Entry
+  {
+    bool operator<(Entry const & rhs) const;
+
+    int8_t m_lang = 0;
+    strings::UniString m_prefix;
+    // Sorted feature ids.
+    std::vector<uint32_t> m_features;
+  };
+
+  // Lists are built for prefixes of at most this length.
+  static size_t constexpr kMaxPrefixLength = 3;
+  // Prefixes matching more features than this are popular, their lists
+  // keep this number of the top ranked features.
+  static size_t constexpr kMaxNumFeatures = 1000;
+
+  // |reader| is a reader of the SEARCH_PREFIXES_FILE_TAG section.
+  explicit PopularPrefixes(Reader const & reader);
+
+  // Writes the section, |entries| must be sorted.
+  static void Serialize(std::vector<Entry> const & entries, Writer & writer);
+
+  // Returns false when |prefix| is not popular in |lang|.
+  bool Get(int8_t lang, strings::UniString const & prefix, CBV & features) const;
+
+  size_t GetNumEntries() const { return m_entries.size(); }
+
+private:
+  struct IndexEntry
+  {
+    int8_t m_lang = 0;
+    strings::UniString m_prefix;
+    uint32_t m_listOffset = 0;
+  };
+
+  Header m_header;
+  std::vector<IndexEntry> m_entries;
+  std::unique_ptr<Reader> m_listsSubReader;
+};
+
+class PopularPrefixesCache
+{
+public:
+  // Returns nullptr when the mwm has no popular prefixes.
+  PopularPrefixes const * Get(MwmContext const & context);
+  // Removes entries of deregistered mwms.
+  void RemoveDeregistered();
+  void Clear() { m_entries.clear(); }
+
+private:
+  std::map<MwmSet::MwmId, std::unique_ptr<PopularPrefixes>> m_entries;
+};
+}  // namespace search
@@ -238,9 +238,12 @@ void PreRanker::Filter()
 
 void PreRanker::UpdateResults(bool lastUpdate)
 {
-  FilterRelaxedResults(lastUpdate);
-  FillMissingFieldsInPreResults();
-  Filter();
+  {
+    LatencyStats::ScopedTimer stageTimer(m_latencyStats, LatencyStats::Stage::PreRanking);
+    FilterRelaxedResults(lastUpdate);
+    FillMissingFieldsInPreResults();
+    Filter();
+  }
   m_numSentResults += m_results.size();
   m_ranker.AddPreRankerResults(std::move(m_results));
   m_results.clear();
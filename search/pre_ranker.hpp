@@ -1,6 +1,7 @@
 #pragma once
 
 #include "search/intermediate_result.hpp"
+#include "search/latency_stats.hpp"
 #include "search/nested_rects_cache.hpp"
 #include "search/ranker.hpp"
 
@@ -133,6 +134,9 @@ public:
 
   void ClearCaches();
 
+  // Times filtering of the results into |stats|, nullptr disables timing.
+  void SetLatencyStats(LatencyStats * stats) { m_latencyStats = stats; }
+
 private:
   // Computes missing fields for all pre-results.
   void FillMissingFieldsInPreResults();
@@ -169,6 +173,8 @@ private:
 
   unsigned m_rndSeed;
 
+  LatencyStats * m_latencyStats = nullptr;
+
   DISALLOW_COPY_AND_MOVE(PreRanker);
 };
 }  // namespace search
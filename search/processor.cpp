@@ -232,6 +232,24 @@ void Processor::SetInputLocale(string const & locale)
   m_inputLocaleCode = CategoriesHolder::MapLocaleToInteger(locale);
 }
 
+void Processor::SetNumGeocoderThreads(size_t numThreads)
+{
+  m_geocoder.SetNumThreads(numThreads);
+}
+
+void Processor::SetSharedGeometryCache(SharedGeometryCache * sharedCache)
+{
+  m_geocoder.SetSharedGeometryCache(sharedCache);
+}
+
+void Processor::SetLatencyStats(LatencyStats * stats)
+{
+  m_latencyStats = stats;
+  m_geocoder.SetLatencyStats(stats);
+  m_preRanker.SetLatencyStats(stats);
+  m_ranker.SetLatencyStats(stats);
+}
+
 void Processor::SetQuery(string const & query, bool categorialRequest /* = false */)
 {
   LOG(LDEBUG, ("query:", query, "isCategorial:", categorialRequest));
@@ -550,6 +568,8 @@ void Processor::ForEachCategoryTypeFuzzy(StringSliceBase const & slice, ToDo &&
 
 void Processor::Search(SearchParams params)
 {
+  LatencyStats::ScopedTimer totalTimer(m_latencyStats, LatencyStats::Stage::Total);
+
   /// @DebugNote
   // Comment this line to run search in a debugger.
   SetDeadline(chrono::steady_clock::now() + params.m_timeout);
@@ -577,7 +597,10 @@ void Processor::Search(SearchParams params)
 
   SetInputLocale(params.m_inputLocale);
 
-  SetQuery(params.m_query, params.m_categorialRequest);
+  {
+    LatencyStats::ScopedTimer stageTimer(m_latencyStats, LatencyStats::Stage::Tokenization);
+    SetQuery(params.m_query, params.m_categorialRequest);
+  }
   SetViewport(viewport);
 
   // Used to store the earliest available cancellation status:
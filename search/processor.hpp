@@ -63,6 +63,10 @@ public:
   void SetViewport(m2::RectD const & viewport);
   void SetPreferredLocale(std::string const & locale);
   void SetInputLocale(std::string const & locale);
+  void SetNumGeocoderThreads(size_t numThreads);
+  void SetSharedGeometryCache(SharedGeometryCache * sharedCache);
+  // Times the search stages into |stats|, nullptr disables timing.
+  void SetLatencyStats(LatencyStats * stats);
   void SetQuery(std::string const & query, bool categorialRequest = false);
 
   inline bool IsEmptyQuery() const { return m_prefix.empty() && m_tokens.empty(); }
@@ -179,5 +183,7 @@ protected:
   bookmarks::Processor m_bookmarksProcessor;
 
   geo::UnifiedParser m_geoUrlParser;
+
+  LatencyStats * m_latencyStats = nullptr;
 };
 }  // namespace search
@@ -22,8 +22,12 @@
 #include "base/string_utils.hpp"
 
 #include <algorithm>
+#include <map>
 #include <memory>
+#include <numeric>
 #include <optional>
+#include <tuple>
+#include <vector>
 
 namespace search
 {
@@ -331,6 +335,11 @@ public:
     , m_params(params)
     , m_isViewportMode(m_params.m_mode == Mode::Viewport)
   {
+    for (size_t i = 0; i < m_params.GetNumTokens(); ++i)
+      m_totalLength += m_params.GetToken(i).GetOriginal().size();
+    // Avoid division by zero.
+    if (m_totalLength == 0)
+      m_totalLength = 1;
   }
 
   optional<RankerResult> operator()(PreRankerResult const & preResult)
@@ -437,6 +446,23 @@ private:
     return ft;
   }
 
+  // Returns name scores of the street, suburb or city |id| matched by |range| as |type|.
+  // Scores are cached, since many results depend on the same features, e.g. buildings on a street.
+  optional<NameScores> GetDependNameScores(FeatureID const & id, Model::Type type,
+                                           TokenRange const & range)
+  {
+    auto const key = make_tuple(id, type, range);
+    auto const it = m_dependNameScores.find(key);
+    if (it != m_dependNameScores.end())
+      return it->second;
+
+    optional<NameScores> scores;
+    if (auto ft = LoadFeature(id))
+      scores = GetNameScores(*ft, m_params, range, type);
+    m_dependNameScores.emplace(key, scores);
+    return scores;
+  }
+
   bool GetExactAddress(FeatureType & ft, m2::PointD const & center, ReverseGeocoder::Address & addr) const
   {
     if (m_reverseGeocoder.GetExactAddress(ft, addr, true /* placeAsStreet */))
@@ -514,12 +540,7 @@ private:
     info.m_categorialRequest = m_params.IsCategorialRequest();
     info.m_tokenRanges = preInfo.m_tokenRanges;
 
-    size_t totalLength = 0;
-    for (size_t i = 0; i < m_params.GetNumTokens(); ++i)
-      totalLength += m_params.GetToken(i).GetOriginal().size();
-    // Avoid division by zero.
-    if (totalLength == 0)
-      totalLength = 1;
+    auto const totalLength = m_totalLength;
 
     if (m_params.IsCategorialRequest())
     {
@@ -539,26 +560,25 @@ private:
       bool isAltOrOldName = scores.m_isAltOrOldName;
       auto matchedLength = scores.m_matchedLength;
 
-      auto const updateScoreForFeature = [&](FeatureType & ft, Model::Type type)
+      auto const updateScoreForFeature = [&](FeatureID const & id, Model::Type type)
       {
         auto const & range = preInfo.m_tokenRanges[type];
         ASSERT(!range.Empty(), ());
-        auto const scores = GetNameScores(ft, m_params, range, type);
+        auto const scores = GetDependNameScores(id, type, range);
+        if (!scores)
+          return;
 
-        nameScore = std::min(nameScore, scores.m_nameScore);
-        errorsMade += scores.m_errorsMade;
-        if (scores.m_isAltOrOldName)
+        nameScore = std::min(nameScore, scores->m_nameScore);
+        errorsMade += scores->m_errorsMade;
+        if (scores->m_isAltOrOldName)
           isAltOrOldName = true;
-        matchedLength += scores.m_matchedLength;
+        matchedLength += scores->m_matchedLength;
       };
 
       auto const updateDependScore = [&](Model::Type type, uint32_t dependID)
       {
         if (info.m_type != type && dependID != IntersectionResult::kInvalidId)
-        {
-          if (auto p = LoadFeature({ ft.GetID().m_mwmId, dependID }))
-            updateScoreForFeature(*p, type);
-        }
+          updateScoreForFeature({ ft.GetID().m_mwmId, dependID }, type);
       };
 
       updateDependScore(Model::TYPE_STREET, preInfo.m_geoParts.m_street);
@@ -566,19 +586,16 @@ private:
 
       if (!Model::IsLocalityType(info.m_type) && preInfo.m_cityId.IsValid())
       {
-        if (auto city = LoadFeature(preInfo.m_cityId))
+        auto type = Model::TYPE_CITY;
+        if (preInfo.m_tokenRanges[type].Empty())
+          type = Model::TYPE_VILLAGE;
+        else
         {
-          auto type = Model::TYPE_CITY;
-          if (preInfo.m_tokenRanges[type].Empty())
-            type = Model::TYPE_VILLAGE;
-          else
-          {
-            /// @todo Possible match by city AND village? What will be in preInfo.m_cityId?
-            ASSERT(preInfo.m_tokenRanges[Model::TYPE_VILLAGE].Empty(), ());
-          }
-
-          updateScoreForFeature(*city, type);
+          /// @todo Possible match by city AND village? What will be in preInfo.m_cityId?
+          ASSERT(preInfo.m_tokenRanges[Model::TYPE_VILLAGE].Empty(), ());
         }
+
+        updateScoreForFeature(preInfo.m_cityId, type);
       }
 
       info.m_nameScore = nameScore;
@@ -650,8 +667,11 @@ private:
   ReverseGeocoder const & m_reverseGeocoder;
   Geocoder::Params const & m_params;
   bool m_isViewportMode;
+  // Total length of the query tokens, at least 1.
+  size_t m_totalLength = 0;
 
   unique_ptr<FeaturesLoaderGuard> m_loader;
+  map<tuple<FeatureID, Model::Type, TokenRange>, optional<NameScores>> m_dependNameScores;
 };
 
 Ranker::Ranker(DataSource const & dataSource, CitiesBoundariesTable const & boundariesTable,
@@ -755,6 +775,9 @@ void Ranker::UpdateResults(bool lastUpdate)
   if (!lastUpdate)
     BailIfCancelled();
 
+  optional<LatencyStats::ScopedTimer> rankingTimer;
+  rankingTimer.emplace(m_latencyStats, LatencyStats::Stage::Ranking);
+
   MakeRankerResults();
   RemoveDuplicatingLinear(m_tentativeResults);
   if (m_tentativeResults.empty())
@@ -788,6 +811,9 @@ void Ranker::UpdateResults(bool lastUpdate)
     ProcessSuggestions(m_tentativeResults);
   }
 
+  rankingTimer.reset();
+  LatencyStats::ScopedTimer formattingTimer(m_latencyStats, LatencyStats::Stage::Formatting);
+
   // Emit feature results.
   size_t count = m_emitter.GetResults().GetCount();
   size_t i = 0;
@@ -860,13 +886,28 @@ void Ranker::MakeRankerResults()
   LOG(LDEBUG, ("PreRankerResults number =", m_preRankerResults.size()));
 
   RankerResultMaker maker(*this, m_dataSource, m_infoGetter, m_reverseGeocoder, m_geocoderParams);
-  for (auto const & r : m_preRankerResults)
+
+  // Results are made in the order of feature ids, so features of an mwm are read
+  // by a single loader and close to each other, but are kept in the PreRanker order.
+  vector<size_t> order(m_preRankerResults.size());
+  iota(order.begin(), order.end(), 0);
+  stable_sort(order.begin(), order.end(), [this](size_t lhs, size_t rhs)
+  {
+    return m_preRankerResults[lhs].GetId() < m_preRankerResults[rhs].GetId();
+  });
+
+  vector<optional<RankerResult>> results(m_preRankerResults.size());
+  for (auto const i : order)
+    results[i] = maker(m_preRankerResults[i]);
+
+  for (size_t i = 0; i < results.size(); ++i)
   {
-    auto p = maker(r);
+    auto & p = results[i];
     if (!p)
       continue;
 
-    ASSERT(m_geocoderParams.m_mode != Mode::Viewport || m_geocoderParams.m_pivot.IsPointInside(p->GetCenter()), (r));
+    ASSERT(m_geocoderParams.m_mode != Mode::Viewport || m_geocoderParams.m_pivot.IsPointInside(p->GetCenter()),
+           (m_preRankerResults[i]));
 
     // Do not filter any _duplicates_ here. Leave it for high level Results class.
     m_tentativeResults.push_back(std::move(*p));
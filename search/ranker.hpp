@@ -5,6 +5,7 @@
 #include "search/geocoder.hpp"
 #include "search/intermediate_result.hpp"
 #include "search/keyword_lang_matcher.hpp"
+#include "search/latency_stats.hpp"
 #include "search/locality_finder.hpp"
 #include "search/region_info_getter.hpp"
 #include "search/result.hpp"
@@ -100,6 +101,9 @@ public:
 
   void LoadCountriesTree();
 
+  // Times ranking and formatting of the results into |stats|, nullptr disables timing.
+  void SetLatencyStats(LatencyStats * stats) { m_latencyStats = stats; }
+
 private:
   friend class RankerResultMaker;
 
@@ -129,5 +133,7 @@ private:
 
   std::vector<PreRankerResult> m_preRankerResults;
   std::vector<RankerResult> m_tentativeResults;
+
+  LatencyStats * m_latencyStats = nullptr;
 };
 }  // namespace search
@@ -3,6 +3,7 @@
 #include "search/cancel_exception.hpp"
 #include "search/feature_offset_match.hpp"
 #include "search/mwm_context.hpp"
+#include "search/popular_prefixes.hpp"
 #include "search/search_index_header.hpp"
 #include "search/search_index_values.hpp"
 #include "search/token_slice.hpp"
@@ -23,6 +24,8 @@
 
 #include "base/checked_cast.hpp"
 #include "base/control_flow.hpp"
+#include "base/scope_guard.hpp"
+#include "base/stl_helpers.hpp"
 
 #include <algorithm>
 #include <cstddef>
@@ -242,7 +245,8 @@ template <typename Value, typename DFA>
 Retrieval::ExtendedFeatures RetrieveAddressFeaturesImpl(Retrieval::TrieRoot<Value> const & root,
                                                         MwmContext const & context,
                                                         base::Cancellable const & cancellable,
-                                                        SearchTrieRequest<DFA> const & request)
+                                                        SearchTrieRequest<DFA> const & request,
+                                                        TrieFrontiers * frontiers = nullptr)
 {
   EditedFeaturesHolder holder(context.GetId());
   vector<uint64_t> features;
@@ -254,7 +258,7 @@ Retrieval::ExtendedFeatures RetrieveAddressFeaturesImpl(Retrieval::TrieRoot<Valu
       [&holder](Value const & value) {
         return !holder.ModifiedOrDeleted(base::asserted_cast<uint32_t>(value.m_featureId));
       } /* filter */,
-      collector);
+      collector, frontiers);
 
   holder.ForEachModifiedOrCreated([&](EditableMapObject const & emo, uint64_t index) {
     auto const matched = MatchFeatureByNameAndType(emo, request);
@@ -399,6 +403,55 @@ Retrieval::ExtendedFeatures Retrieval::RetrieveAddressFeatures(
   return Retrieve<RetrieveAddressFeaturesAdaptor>(request);
 }
 
+Retrieval::ExtendedFeatures Retrieval::RetrieveAddressFeatures(
+    SearchTrieRequest<PrefixDFAModifier<LevenshteinDFA>> const & request,
+    TrieFrontiers & frontiers) const
+{
+  return Retrieve<RetrieveAddressFeaturesAdaptor>(request, &frontiers);
+}
+
+Retrieval::ExtendedFeatures Retrieval::RetrieveAddressFeatures(
+    SearchTrieRequest<PrefixDFAModifier<LevenshteinDFA>> & request,
+    PopularPrefixes const & popularPrefixes, UniString const & prefix) const
+{
+  vector<int8_t> popularLangs;
+  vector<uint64_t> features;
+  for (auto const lang : request.m_langs)
+  {
+    CBV popular;
+    if (!popularPrefixes.Get(lang, prefix, popular))
+      continue;
+
+    popularLangs.push_back(lang);
+    popular.ForEach([&features](uint64_t id) { features.push_back(id); });
+  }
+
+  if (popularLangs.empty())
+    return RetrieveAddressFeatures(request);
+
+  EditedFeaturesHolder holder(m_context.GetId());
+  base::EraseIf(features, [&holder](uint64_t id) {
+    return holder.ModifiedOrDeleted(base::asserted_cast<uint32_t>(id));
+  });
+  holder.ForEachModifiedOrCreated([&](EditableMapObject const & emo, uint64_t index) {
+    if (MatchFeatureByNameAndType(emo, request).first)
+      features.push_back(index);
+  });
+
+  // No misprints are allowed, so all the features match exactly.
+  auto const popular = SortFeaturesAndBuildResult(std::move(features));
+
+  // Other langs and categories are retrieved from the search index.
+  auto const langs = request.m_langs;
+  SCOPE_GUARD(restoreLangs, [&]() { request.m_langs = langs; });
+  for (auto const lang : popularLangs)
+    request.m_langs.erase(lang);
+
+  auto const others = RetrieveAddressFeatures(request);
+  return ExtendedFeatures(popular.m_features.Union(others.m_features),
+                          popular.m_exactMatchingFeatures.Union(others.m_exactMatchingFeatures));
+}
+
 Retrieval::Features Retrieval::RetrievePostcodeFeatures(TokenSlice const & slice) const
 {
   return Retrieve<RetrievePostcodeFeaturesAdaptor>(slice).m_features;
@@ -25,6 +25,7 @@ class MwmValue;
 namespace search
 {
 class MwmContext;
+class PopularPrefixes;
 class TokenSlice;
 
 class Retrieval
@@ -101,6 +102,20 @@ public:
   ExtendedFeatures RetrieveAddressFeatures(
       SearchTrieRequest<strings::PrefixDFAModifier<strings::LevenshteinDFA>> const & request) const;
 
+  // Same as above but resumes the walk of the original token DFA from |frontiers.m_resumeFrom|
+  // and stores the new frontiers to |frontiers.m_found|. See MatchPrefixInTrie().
+  ExtendedFeatures RetrieveAddressFeatures(
+      SearchTrieRequest<strings::PrefixDFAModifier<strings::LevenshteinDFA>> const & request,
+      TrieFrontiers & frontiers) const;
+
+  // Same as above but takes features of the langs |prefix| is popular in from |popularPrefixes|.
+  // |request| must be built for |prefix| without synonyms and misprints, its langs are
+  // changed during the call and restored on return. Only a part of the features is returned
+  // for popular prefixes, so it's used when |prefix| is the whole query.
+  ExtendedFeatures RetrieveAddressFeatures(
+      SearchTrieRequest<strings::PrefixDFAModifier<strings::LevenshteinDFA>> & request,
+      PopularPrefixes const & popularPrefixes, strings::UniString const & prefix) const;
+
   // Retrieves all postcodes matching to |slice| from the search index.
   Features RetrievePostcodeFeatures(TokenSlice const & slice) const;
 
@@ -0,0 +1,91 @@
+#include "search/retrieval_cache.hpp"
+
+#include "indexer/search_string_utils.hpp"
+
+#include "base/assert.hpp"
+#include "base/string_utils.hpp"
+
+namespace search
+{
+using namespace std;
+
+RetrievalCache::RetrievalCache(size_t maxSize, uint64_t maxSizeBytes)
+  : m_maxSize(maxSize), m_maxSizeBytes(maxSizeBytes)
+{
+  CHECK_GREATER(m_maxSize, 0, ());
+}
+
+// static
+string RetrievalCache::MakeKey(QueryParams::Token const & token, bool isPrefix,
+                               QueryParams::TypeIndices const & types,
+                               QueryParams::Langs const & langs)
+{
+  // Misprints are allowed for the original token only, see FillRequestFromToken().
+  string key = isPrefix ? "p" : "f";
+  key += strings::to_string(GetMaxErrorsForToken(token.GetOriginal()));
+  token.ForOriginalAndSynonyms([&key](strings::UniString const & s) {
+    key += '\n';
+    key += strings::ToUtf8(s);
+  });
+
+  key += "\nt";
+  for (auto const type : types)
+  {
+    key += ' ';
+    key += strings::to_string(type);
+  }
+
+  key += "\nl";
+  for (auto const lang : langs)
+  {
+    key += ' ';
+    key += strings::to_string(static_cast<int>(lang));
+  }
+  return key;
+}
+
+void RetrievalCache::RemoveDeregistered()
+{
+  for (auto it = m_lru.begin(); it != m_lru.end();)
+  {
+    if (it->m_key.first.IsAlive())
+    {
+      ++it;
+      continue;
+    }
+
+    m_index.erase(it->m_key);
+    m_sizeBytes -= it->m_size;
+    it = m_lru.erase(it);
+  }
+}
+
+void RetrievalCache::Clear()
+{
+  m_index.clear();
+  m_lru.clear();
+  m_sizeBytes = 0;
+}
+
+void RetrievalCache::Insert(MwmSet::MwmId const & mwmId, string const & key,
+                            Retrieval::ExtendedFeatures const & features)
+{
+  // |m_features| and |m_exactMatchingFeatures| may share a bit vector, so it's an upper bound.
+  uint64_t const size = sizeof(Entry) + key.size() + features.m_features.GetSizeInBytes() +
+                        features.m_exactMatchingFeatures.GetSizeInBytes();
+  if (size > m_maxSizeBytes)
+    return;
+
+  m_lru.push_front({make_pair(mwmId, key), features, size});
+  m_index.emplace(m_lru.front().m_key, m_lru.begin());
+  m_sizeBytes += size;
+
+  while (m_lru.size() > m_maxSize || m_sizeBytes > m_maxSizeBytes)
+  {
+    ASSERT(!m_lru.empty(), ());
+    m_index.erase(m_lru.back().m_key);
+    m_sizeBytes -= m_lru.back().m_size;
+    m_lru.pop_back();
+  }
+}
+}  // namespace search
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "search/query_params.hpp"
+#include "search/retrieval.hpp"
+
+#include "indexer/mwm_set.hpp"
+
+#include "base/macros.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <string>
+#include <utility>
+
+namespace search
+{
+// Cache of the address features retrieved for a single query token.
+// It lives as long as Geocoder does, so results are reused across queries,
+// e.g. while the query is being typed and only its last token changes.
+// Cached values are reused only for the same mwm and the same token request:
+// the request (and its Levenshtein DFAs) is fully determined by the key, see MakeKey().
+// Features of a short token in a big mwm may take megabytes, so the cache is bounded both
+// by the number of entries and by the size of the cached bit vectors.
+//
+// *NOTE* This class is not thread-safe.
+class RetrievalCache
+{
+public:
+  // Results larger than |maxSizeBytes| are not cached.
+  RetrievalCache(size_t maxSize, uint64_t maxSizeBytes);
+
+  // Returns a key for the request built by FillRequestFromToken() for |token|.
+  static std::string MakeKey(QueryParams::Token const & token, bool isPrefix,
+                             QueryParams::TypeIndices const & types,
+                             QueryParams::Langs const & langs);
+
+  // Returns cached features for (|mwmId|, |key|) or calls |retrieve| and caches its result.
+  // Nothing is cached when |retrieve| throws, e.g. when search is cancelled.
+  template <typename Retrieve>
+  Retrieval::ExtendedFeatures Get(MwmSet::MwmId const & mwmId, std::string const & key,
+                                  Retrieve && retrieve, bool & found)
+  {
+    auto const it = m_index.find(std::make_pair(mwmId, key));
+    if (it != m_index.end())
+    {
+      found = true;
+      m_lru.splice(m_lru.begin(), m_lru, it->second);
+      return it->second->m_features;
+    }
+
+    found = false;
+    auto features = retrieve();
+    Insert(mwmId, key, features);
+    return features;
+  }
+
+  // Removes entries of deregistered mwms.
+  void RemoveDeregistered();
+
+  void Clear();
+
+  size_t GetSize() const { return m_lru.size(); }
+  uint64_t GetSizeInBytes() const { return m_sizeBytes; }
+
+private:
+  using Key = std::pair<MwmSet::MwmId, std::string>;
+
+  struct Entry
+  {
+    Key m_key;
+    Retrieval::ExtendedFeatures m_features;
+    // Approximate size of the entry in memory.
+    uint64_t m_size = 0;
+  };
+
+  using LruList = std::list<Entry>;
+
+  void Insert(MwmSet::MwmId const & mwmId, std::string const & key,
+              Retrieval::ExtendedFeatures const & features);
+
+  size_t const m_maxSize;
+  uint64_t const m_maxSizeBytes;
+  uint64_t m_sizeBytes = 0;
+  // Most recently used entries are in front.
+  LruList m_lru;
+  std::map<Key, LruList::iterator> m_index;
+
+  DISALLOW_COPY_AND_MOVE(RetrievalCache);
+};
+}  // namespace search
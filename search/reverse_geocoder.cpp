@@ -9,19 +9,27 @@
 
 #include "editor/osm_editor.hpp"
 
+#include "indexer/address_points.hpp"
 #include "indexer/data_source.hpp"
 #include "indexer/fake_feature_ids.hpp"
 #include "indexer/feature.hpp"
 #include "indexer/feature_algo.hpp"
+#include "indexer/feature_source.hpp"
 #include "indexer/ftypes_matcher.hpp"
 #include "indexer/scales.hpp"
 
+#include "geometry/mercator.hpp"
+
 #include "base/stl_helpers.hpp"
 
 #include <algorithm>
 #include <cstddef>
 #include <functional>
 #include <limits>
+#include <memory>
+#include <utility>
+
+#include "defines.hpp"
 
 namespace search
 {
@@ -32,6 +40,9 @@ namespace
 int constexpr kQueryScale = scales::GetUpperScale();
 /// Max number of tries (nearest houses with housenumber) to check when getting point address.
 size_t constexpr kMaxNumTriesToApproxAddress = 10;
+/// Distances to centers of address points only approximate distances to buildings,
+/// so more candidates are read than there are tries.
+size_t constexpr kMaxNumAddressPointsCandidates = 2 * kMaxNumTriesToApproxAddress;
 
 using AppendStreet = function<void(FeatureType & ft)>;
 using FillStreets =
@@ -272,6 +283,9 @@ bool ReverseGeocoder::GetNearbyAddress(HouseTable & table, Building const & bld,
 void ReverseGeocoder::GetNearbyBuildings(m2::PointD const & center, double radius,
                                          vector<Building> & buildings) const
 {
+  if (m_useAddressPoints && GetNearbyBuildingsFromAddressPoints(center, radius, buildings))
+    return;
+
   auto const addBuilding = [&](FeatureType & ft)
   {
     std::string const & hn = GetHouseNumber(ft);
@@ -289,6 +303,88 @@ void ReverseGeocoder::GetNearbyBuildings(m2::PointD const & center, double radiu
   sort(buildings.begin(), buildings.end(), base::LessBy(&Building::m_distanceMeters));
 }
 
+bool ReverseGeocoder::GetNearbyBuildingsFromAddressPoints(m2::PointD const & center,
+                                                          double radius,
+                                                          vector<Building> & buildings) const
+{
+  m2::RectD const rect = GetLookupRect(center, radius);
+
+  vector<shared_ptr<MwmInfo>> infos;
+  m_dataSource.GetMwmsInfo(infos);
+
+  vector<MwmSet::MwmHandle> handles;
+  for (auto const & info : infos)
+  {
+    if (info->GetType() != MwmInfo::COUNTRY || !rect.IsIntersect(info->m_bordersRect) ||
+        kQueryScale < info->m_minScale || kQueryScale > info->m_maxScale)
+    {
+      continue;
+    }
+
+    auto handle = m_dataSource.GetMwmHandleById(MwmSet::MwmId(info));
+    if (!handle.IsAlive())
+      continue;
+    if (!handle.GetValue()->m_cont.IsExist(ADDRESS_POINTS_FILE_TAG))
+      return false;
+    handles.push_back(std::move(handle));
+  }
+
+  vector<pair<double, FeatureID>> candidates;
+  auto & editor = osm::Editor::Instance();
+  for (auto const & handle : handles)
+  {
+    auto & value = *handle.GetValue();
+    if (!value.m_addressPoints)
+    {
+      auto reader = value.m_cont.GetReader(ADDRESS_POINTS_FILE_TAG);
+      value.m_addressPoints =
+          AddressPoints::Load(reader.GetPtr()->CreateSubReader(0 /* pos */, reader.Size()));
+      if (!value.m_addressPoints)
+        return false;
+    }
+
+    auto const & mwmId = handle.GetId();
+    value.m_addressPoints->ForEachInRect(rect, [&](uint32_t index, m2::PointD const & point)
+    {
+      candidates.emplace_back(mercator::DistanceOnEarth(center, point), FeatureID(mwmId, index));
+    });
+
+    // Features created in the editor are not indexed, their distances are computed below.
+    editor.ForEachCreatedFeature(mwmId, [&](uint32_t index)
+    {
+      candidates.emplace_back(0.0, FeatureID(mwmId, index));
+    }, rect, kQueryScale);
+  }
+
+  base::EraseIf(candidates, [&editor](pair<double, FeatureID> const & candidate)
+  {
+    return editor.GetFeatureStatus(candidate.second) == FeatureStatus::Deleted;
+  });
+
+  auto const numCandidates = min(candidates.size(), kMaxNumAddressPointsCandidates);
+  partial_sort(candidates.begin(), candidates.begin() + numCandidates, candidates.end());
+
+  vector<FeatureID> ids;
+  ids.reserve(numCandidates);
+  for (size_t i = 0; i < numCandidates; ++i)
+    ids.push_back(candidates[i].second);
+  sort(ids.begin(), ids.end());
+
+  m_dataSource.ReadFeatures([&](FeatureType & ft)
+  {
+    std::string const & hn = GetHouseNumber(ft);
+    if (hn.empty())
+      return;
+
+    auto const distance = feature::GetMinDistanceMeters(ft, center);
+    if (distance <= radius)
+      buildings.push_back(FromFeatureImpl(ft, hn, distance));
+  }, ids);
+
+  sort(buildings.begin(), buildings.end(), base::LessBy(&Building::m_distanceMeters));
+  return true;
+}
+
 // static
 ReverseGeocoder::RegionAddress ReverseGeocoder::GetNearbyRegionAddress(
     m2::PointD const & center, storage::CountryInfoGetter const & infoGetter,
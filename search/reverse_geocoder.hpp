@@ -29,6 +29,7 @@ class RegionInfoGetter;
 class ReverseGeocoder
 {
   DataSource const & m_dataSource;
+  bool m_useAddressPoints = false;
 
   struct Object
   {
@@ -53,6 +54,12 @@ public:
 
   explicit ReverseGeocoder(DataSource const & dataSource);
 
+  /// Nearby buildings are looked up in the ADDRESS_POINTS_FILE_TAG sections when all mwms
+  /// around have them. Disabled by default: only the buildings with centers in the lookup rect
+  /// and the nearest of them by center are checked, so big buildings may be missed unlike
+  /// the features scan.
+  void SetUseAddressPoints(bool useAddressPoints) { m_useAddressPoints = useAddressPoints; }
+
   struct Street : public Object
   {
     StringUtf8Multilang m_multilangName;
@@ -184,6 +191,9 @@ private:
   /// @return Sorted by distance houses vector with valid house number.
   void GetNearbyBuildings(m2::PointD const & center, double maxDistanceM,
                           std::vector<Building> & buildings) const;
+  /// Fast path of GetNearbyBuildings(), returns false when some mwm around has no address points.
+  bool GetNearbyBuildingsFromAddressPoints(m2::PointD const & center, double maxDistanceM,
+                                           std::vector<Building> & buildings) const;
 
   static Building FromFeature(FeatureType & ft, double distMeters);
 };
@@ -3585,4 +3585,113 @@ UNIT_CLASS_TEST(ProcessorTest, ComplexPoi_Match)
   }
 }
 
+UNIT_CLASS_TEST(ProcessorTest, ParallelGeocoding)
+{
+  TestCity london({1, 1}, "London", "en", 100 /* rank */);
+  BuildWorld([&](TestMwmBuilder & builder) { builder.Add(london); });
+
+  // Every country has matching features, so results of all mwms are mixed by PreRanker.
+  for (int i = 0; i < 6; ++i)
+  {
+    double const x = i * 0.1;
+    TestStreet street({{x, 1.0}, {x + 0.05, 1.0}}, "Baker Street", "en");
+    TestBuilding building({x + 0.01, 1.001}, "Baker House", "221", street.GetName("en"), "en");
+    TestCafe cafe({x + 0.02, 1.002}, "Baker Cafe", "en");
+    BuildCountry("Wonderland" + strings::to_string(i), [&](TestMwmBuilder & builder)
+    {
+      builder.Add(street);
+      builder.Add(building);
+      builder.Add(cafe);
+    });
+  }
+
+  Engine::Params params;
+  params.m_numGeocoderThreads = 3;
+  TestSearchEngine parallelEngine(m_dataSource, params, true /* mockCountryInfo */);
+
+  auto const getIds = [](TestSearchRequest const & request) {
+    vector<FeatureID> ids;
+    for (auto const & result : request.Results())
+    {
+      TEST_EQUAL(result.GetResultType(), Result::Type::Feature, ());
+      ids.push_back(result.GetFeatureID());
+    }
+    return ids;
+  };
+
+  SetViewport(m2::RectD(0.2, 0.9, 0.3, 1.1));
+  for (auto const * query : {"baker", "baker street", "baker street 221", "baker cafe", "cafe"})
+  {
+    TestSearchRequest sequential(m_engine, query, "en", Mode::Everywhere, m_viewport);
+    sequential.Run();
+    TestSearchRequest parallel(parallelEngine, query, "en", Mode::Everywhere, m_viewport);
+    parallel.Run();
+
+    TEST(!sequential.Results().empty(), (query));
+    TEST_EQUAL(getIds(sequential), getIds(parallel), (query));
+  }
+}
+
+UNIT_CLASS_TEST(ProcessorTest, SearchBatch)
+{
+  TestCity london({1, 1}, "London", "en", 100 /* rank */);
+  BuildWorld([&](TestMwmBuilder & builder) { builder.Add(london); });
+
+  for (int i = 0; i < 3; ++i)
+  {
+    double const x = i * 0.5;
+    TestStreet street({{x, 1.0}, {x + 0.05, 1.0}}, "Baker Street", "en");
+    TestBuilding building({x + 0.01, 1.001}, "Baker House", "221", street.GetName("en"), "en");
+    TestCafe cafe({x + 0.02, 1.002}, "Baker Cafe", "en");
+    BuildCountry("Wonderland" + strings::to_string(i), [&](TestMwmBuilder & builder)
+    {
+      builder.Add(street);
+      builder.Add(building);
+      builder.Add(cafe);
+    });
+  }
+
+  auto const getIds = [](auto const & results) {
+    vector<FeatureID> ids;
+    for (auto const & result : results)
+      ids.push_back(result.GetFeatureID());
+    return ids;
+  };
+
+  vector<SearchParams> batch;
+  vector<vector<FeatureID>> expected;
+  for (auto const * query : {"baker", "baker street 221", "baker cafe", "cafe "})
+  {
+    for (int i = 0; i < 3; ++i)
+    {
+      SetViewport(m2::RectD(i * 0.5, 0.9, i * 0.5 + 0.1, 1.1));
+      TestSearchRequest request(m_engine, query, "en", Mode::Everywhere, m_viewport);
+      request.Run();
+      TEST(!request.Results().empty(), (query));
+      expected.push_back(getIds(request.Results()));
+
+      SearchParams params;
+      params.m_query = query;
+      params.m_inputLocale = "en";
+      params.m_viewport = m_viewport;
+      params.m_mode = Mode::Everywhere;
+      batch.push_back(std::move(params));
+    }
+  }
+
+  size_t numCallbacks = 0;
+  batch.back().m_onResults = [&numCallbacks](Results const & results) {
+    if (results.IsEndMarker())
+      ++numCallbacks;
+  };
+
+  auto const results = m_engine.SearchBatch(std::move(batch));
+  TEST_EQUAL(results.size(), expected.size(), ());
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    TEST(results[i].m_results.IsEndedNormal(), (i));
+    TEST_EQUAL(getIds(results[i].m_results), expected[i], (i));
+  }
+  TEST_EQUAL(numCallbacks, 1, ());
+}
 } // namespace processor_test
@@ -1,11 +1,28 @@
 #include "testing/testing.hpp"
 
+#include "search/categories_cache.hpp"
+#include "search/cities_boundaries_table.hpp"
+#include "search/emitter.hpp"
+#include "search/intermediate_result.hpp"
+#include "search/keyword_lang_matcher.hpp"
+#include "search/ranker.hpp"
 #include "search/search_tests_support/helpers.hpp"
 #include "search/search_tests_support/test_results_matching.hpp"
+#include "search/search_tests_support/test_search_engine.hpp"
+#include "search/suggest.hpp"
+
+#include "indexer/categories_holder.hpp"
+#include "indexer/data_source.hpp"
+#include "indexer/scales.hpp"
+#include "indexer/search_string_utils.hpp"
 
 #include "generator/generator_tests_support/test_feature.hpp"
 #include "generator/generator_tests_support/test_mwm_builder.hpp"
 
+#include "base/cancellable.hpp"
+
+#include <map>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -123,4 +140,106 @@ UNIT_CLASS_TEST(RankerTest, PreferCountry)
     TEST(OrderedResultsMatch("Wanderland", rules), ());
   }
 }
+
+UNIT_CLASS_TEST(RankerTest, BatchedRankingInfo)
+{
+  // Results of one batch share the name scores of their streets, they must be ranked
+  // the same way as one by one.
+  TestStreet mainStreet(vector<m2::PointD>{{0.0, 0.0}, {0.01, 0.0}}, "Main Street", "en");
+  TestStreet secondStreet(vector<m2::PointD>{{0.0, 0.01}, {0.01, 0.01}}, "Second Street", "en");
+  vector<TestPOI> bakeries;
+  for (size_t i = 0; i < 6; ++i)
+  {
+    bakeries.emplace_back(m2::PointD(0.001 * i, i % 2 == 0 ? 0.0001 : 0.0099), "Bakery", "en");
+    bakeries.back().SetTypes({{"shop", "bakery"}});
+  }
+
+  auto const id = BuildCountry("Wonderland", [&](TestMwmBuilder & builder)
+  {
+    builder.Add(mainStreet);
+    builder.Add(secondStreet);
+    for (auto const & bakery : bakeries)
+      builder.Add(bakery);
+  });
+
+  auto const en = StringUtf8Multilang::GetLangIndex("en");
+  uint32_t mainStreetIndex = 0;
+  uint32_t secondStreetIndex = 0;
+  vector<pair<uint32_t, double>> bakeryIndices;
+  m_dataSource.ForEachFeatureIDInRect([&](FeatureID const & fid)
+  {
+    FeaturesLoaderGuard guard(m_dataSource, fid.m_mwmId);
+    auto ft = guard.GetFeatureByIndex(fid.m_index);
+    auto const name = ft->GetName(en);
+    if (name == "Main Street")
+      mainStreetIndex = fid.m_index;
+    else if (name == "Second Street")
+      secondStreetIndex = fid.m_index;
+    else if (name == "Bakery")
+      bakeryIndices.emplace_back(fid.m_index, ft->GetCenter().y);
+  }, m2::RectD(-1, -1, 1, 1), scales::GetUpperScale());
+  TEST_EQUAL(bakeryIndices.size(), bakeries.size(), ());
+
+  // "bakery main street" and "bakery second street" are matched by the same tokens.
+  vector<PreRankerResult> preResults;
+  for (auto const & [index, y] : bakeryIndices)
+  {
+    PreRankingInfo info(Model::TYPE_SUBPOI, TokenRange(0, 1));
+    info.m_tokenRanges[Model::TYPE_STREET] = TokenRange(1, 3);
+    info.m_geoParts.m_street = y < 0.005 ? mainStreetIndex : secondStreetIndex;
+    preResults.emplace_back(FeatureID(id, index), info, vector<ResultTracer::Branch>());
+  }
+  preResults.emplace_back(FeatureID(id, mainStreetIndex),
+                          PreRankingInfo(Model::TYPE_STREET, TokenRange(1, 3)),
+                          vector<ResultTracer::Branch>());
+
+  string const query = "bakery main street";
+  auto const tokens = NormalizeAndTokenizeString(query);
+  Geocoder::Params geocoderParams;
+  geocoderParams.Init(query, tokens, false /* isLastPrefix */);
+  geocoderParams.m_pivot = m2::RectD(0, 0, 0.01, 0.01);
+  geocoderParams.m_useDebugInfo = true;
+
+  Ranker::Params rankerParams;
+  rankerParams.m_batchSize = preResults.size();
+  rankerParams.m_limit = preResults.size();
+
+  CitiesBoundariesTable boundariesTable(m_dataSource);
+  base::Cancellable cancellable;
+  VillagesCache villagesCache(cancellable);
+  KeywordLangMatcher keywordsScorer(0 /* maxLanguageTiers */);
+  vector<Suggest> suggests;
+
+  auto const getRankingInfos = [&](bool batched)
+  {
+    Emitter emitter;
+    emitter.Init([](Results const &) {});
+    Ranker ranker(m_dataSource, boundariesTable, m_engine.GetCountryInfoGetter(), keywordsScorer,
+                  emitter, GetDefaultCategories(), suggests, villagesCache, cancellable);
+    ranker.Init(rankerParams, geocoderParams);
+    if (batched)
+    {
+      auto copy = preResults;
+      ranker.AddPreRankerResults(std::move(copy));
+      ranker.UpdateResults(true /* lastUpdate */);
+    }
+    else
+    {
+      for (auto const & preResult : preResults)
+      {
+        ranker.AddPreRankerResults({preResult});
+        ranker.UpdateResults(true /* lastUpdate */);
+      }
+    }
+
+    map<FeatureID, string> infos;
+    for (auto const & result : emitter.GetResults())
+      infos.emplace(result.GetFeatureID(), DebugPrint(result.GetRankingInfo()));
+    return infos;
+  };
+
+  auto const batched = getRankingInfos(true /* batched */);
+  TEST_EQUAL(batched.size(), preResults.size(), ());
+  TEST_EQUAL(batched, getRankingInfos(false /* batched */), ());
+}
 } // namespace ranker_test
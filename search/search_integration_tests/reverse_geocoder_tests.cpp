@@ -0,0 +1,109 @@
+#include "testing/testing.hpp"
+
+#include "search/reverse_geocoder.hpp"
+#include "search/search_tests_support/helpers.hpp"
+
+#include "generator/generator_tests_support/test_feature.hpp"
+#include "generator/generator_tests_support/test_mwm_builder.hpp"
+
+#include "indexer/feature_decl.hpp"
+
+#include "geometry/mercator.hpp"
+#include "geometry/point2d.hpp"
+
+#include "base/string_utils.hpp"
+
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace reverse_geocoder_tests
+{
+using namespace generator::tests_support;
+using namespace search::tests_support;
+using namespace search;
+using namespace std;
+
+class ReverseGeocoderTest : public SearchTest
+{
+};
+
+// Compares the address points lookup with the features scan.
+UNIT_CLASS_TEST(ReverseGeocoderTest, AddressPoints)
+{
+  size_t constexpr kNumStreets = 20;
+  size_t constexpr kNumHousesPerStreet = 40;
+  size_t constexpr kNumLookups = 500;
+  // About 110 meters.
+  double constexpr kStep = 0.001;
+
+  vector<TestStreet> streets;
+  vector<TestBuilding> buildings;
+  for (size_t i = 0; i < kNumStreets; ++i)
+  {
+    double const y = 2 * kStep * i;
+    streets.emplace_back(vector<m2::PointD>{{0.0, y}, {kStep * kNumHousesPerStreet, y}},
+                         "Street " + strings::to_string(i), "en");
+    for (size_t j = 0; j < kNumHousesPerStreet; ++j)
+    {
+      buildings.emplace_back(m2::PointD(kStep * j, y + kStep / 4), "", strings::to_string(j + 1),
+                             streets.back().GetName("en"), "en");
+    }
+  }
+
+  BuildCountry("Wonderland", [&](TestMwmBuilder & builder)
+  {
+    for (auto const & street : streets)
+      builder.Add(street);
+    for (auto const & building : buildings)
+      builder.Add(building);
+  });
+
+  ReverseGeocoder fast(m_dataSource);
+  fast.SetUseAddressPoints(true);
+  ReverseGeocoder scan(m_dataSource);
+
+  mt19937 rng(0);
+  uniform_real_distribution<double> x(0.0, kStep * kNumHousesPerStreet);
+  uniform_real_distribution<double> y(0.0, 2 * kStep * kNumStreets);
+  vector<m2::PointD> points;
+  for (size_t i = 0; i < kNumLookups; ++i)
+    points.emplace_back(x(rng), y(rng));
+
+  vector<ReverseGeocoder::Address> fastAddresses(points.size());
+  for (size_t i = 0; i < points.size(); ++i)
+    fast.GetNearbyAddress(points[i], fastAddresses[i]);
+
+  vector<ReverseGeocoder::Address> scanAddresses(points.size());
+  for (size_t i = 0; i < points.size(); ++i)
+    scan.GetNearbyAddress(points[i], scanAddresses[i]);
+
+  for (size_t i = 0; i < points.size(); ++i)
+  {
+    auto const & address = fastAddresses[i];
+    TEST(address.IsValid(), (points[i]));
+
+    // The nearest building is found.
+    double minDistance = numeric_limits<double>::max();
+    string houseNumber;
+    string streetName;
+    for (size_t j = 0; j < buildings.size(); ++j)
+    {
+      auto const distance = mercator::DistanceOnEarth(points[i], buildings[j].GetCenter());
+      if (distance < minDistance)
+      {
+        minDistance = distance;
+        houseNumber = strings::to_string(j % kNumHousesPerStreet + 1);
+        streetName = "Street " + strings::to_string(j / kNumHousesPerStreet);
+      }
+    }
+    TEST_EQUAL(address.GetHouseNumber(), houseNumber, (points[i]));
+    TEST_EQUAL(address.GetStreetName(), streetName, (points[i]));
+
+    // The scan may stop before the nearest building is found.
+    TEST(scanAddresses[i].IsValid(), (points[i]));
+    TEST_LESS_OR_EQUAL(address.GetDistance(), scanAddresses[i].GetDistance() + 1e-3, (points[i]));
+  }
+}
+}  // namespace reverse_geocoder_tests
@@ -86,4 +86,39 @@ UNIT_CLASS_TEST(TracerTest, Smoke)
     TEST_EQUAL(expected, actual, ());
   }
 }
+
+UNIT_CLASS_TEST(TracerTest, RetrievalCache)
+{
+  TestCity moscow(m2::PointD(0, 0), "Moscow", "en", 100 /* rank */);
+  TestCafe moscowCafe(m2::PointD(0, 0), "Moscow", "en");
+
+  BuildWorld([&](TestMwmBuilder & builder) { builder.Add(moscow); });
+  auto const id = BuildCountry("Wonderland", [&](TestMwmBuilder & builder) {
+    builder.Add(moscowCafe);
+  });
+
+  SearchParams params;
+  params.m_inputLocale = "en";
+  params.m_viewport = m2::RectD(-1, -1, 1, 1);
+  params.m_mode = Mode::Everywhere;
+  params.m_query = "moscow caf";
+
+  auto const run = [&]() {
+    auto tracer = make_shared<Tracer>();
+    params.m_tracer = tracer;
+
+    TestSearchRequest request(m_engine, params);
+    request.Run();
+    TEST(ResultsMatch(request.Results(), {ExactMatch(id, moscowCafe)}), ());
+    return tracer;
+  };
+
+  auto const first = run();
+  TEST_GREATER(first->GetRetrievalCacheMisses(), 0, ());
+
+  // The same tokens in the same mwms are taken from the cache.
+  auto const second = run();
+  TEST_GREATER(second->GetRetrievalCacheHits(), 0, ());
+  TEST_EQUAL(second->GetRetrievalCacheMisses(), 0, ());
+}
 }  // namespace
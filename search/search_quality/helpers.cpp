@@ -150,11 +150,14 @@ void InitDataSource(FrozenDataSource & dataSource, string const & mwmListPath)
 }
 
 unique_ptr<search::tests_support::TestSearchEngine> InitSearchEngine(
-    DataSource & dataSource, string const & locale, size_t numThreads)
+    DataSource & dataSource, string const & locale, size_t numThreads, size_t numGeocoderThreads,
+    bool collectLatencyStats)
 {
   search::Engine::Params params;
   params.m_locale = locale;
   params.m_numThreads = base::checked_cast<size_t>(numThreads);
+  params.m_numGeocoderThreads = numGeocoderThreads;
+  params.m_collectLatencyStats = collectLatencyStats;
 
   return make_unique<search::tests_support::TestSearchEngine>(dataSource, params);
 }
@@ -29,6 +29,7 @@ void InitViewport(std::string viewportName, m2::RectD & viewport);
 void InitDataSource(FrozenDataSource & dataSource, std::string const & mwmListPath);
 
 std::unique_ptr<search::tests_support::TestSearchEngine> InitSearchEngine(
-    DataSource & dataSource, std::string const & locale, size_t numThreads);
+    DataSource & dataSource, std::string const & locale, size_t numThreads,
+    size_t numGeocoderThreads = 1, bool collectLatencyStats = false);
 }  // namespace search_quality
 }  // namespace search
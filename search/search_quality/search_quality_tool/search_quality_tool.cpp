@@ -3,6 +3,8 @@
 #include "search/search_tests_support/test_search_engine.hpp"
 #include "search/search_tests_support/test_search_request.hpp"
 
+#include "search/latency_stats.hpp"
+#include "search/latlon_match.hpp"
 #include "search/ranking_info.hpp"
 #include "search/result.hpp"
 #include "search/search_params.hpp"
@@ -39,6 +41,8 @@
 #include <string>
 #include <vector>
 
+#include "cppjansson/cppjansson.hpp"
+
 #include <gflags/gflags.h>
 
 using namespace search::search_quality;
@@ -50,6 +54,7 @@ using namespace std;
 DEFINE_string(data_path, "", "Path to data directory (resources dir)");
 DEFINE_string(locale, "en", "Locale of all the search queries");
 DEFINE_int32(num_threads, 1, "Number of search engine threads");
+DEFINE_int32(num_geocoder_threads, 1, "Number of threads geocoding mwms of a single query");
 DEFINE_string(mwm_list_path, "",
               "Path to a file containing the names of available mwms, one per line");
 DEFINE_string(mwm_path, "", "Path to mwm files (writable dir)");
@@ -58,6 +63,13 @@ DEFINE_int32(top, 1, "Number of top results to show for every query");
 DEFINE_string(viewport, "", "Viewport to use when searching (default, moscow, london, zurich)");
 DEFINE_string(check_completeness, "", "Path to the file with completeness data");
 DEFINE_string(ranking_csv_file, "", "File ranking info will be exported to");
+DEFINE_bool(replay_typing, false,
+            "Replay every query character by character and report per-keystroke latency");
+DEFINE_bool(batch, false,
+            "Run all queries as a single batch and report throughput. Lines of the queries "
+            "file may be followed by a tab and \"lat,lon\" of the point to search around");
+DEFINE_string(latency_stats_json, "",
+              "File per-stage latency histograms of all queries will be written to, as JSON");
 
 string const kDefaultQueriesPathSuffix =
     "/../search/search_quality/search_quality_tool/queries.txt";
@@ -355,6 +367,197 @@ void RunRequests(TestSearchEngine & engine, m2::RectD const & viewport, string q
        << " (std. dev. " << stdDevTime << "s)" << endl;
 }
 
+// Returns the value at the |p|-th percentile of sorted |a|.
+double GetPercentile(vector<double> const & a, double p)
+{
+  CHECK(!a.empty(), ());
+  auto const idx = static_cast<size_t>(p * static_cast<double>(a.size() - 1) + 0.5);
+  return a[min(idx, a.size() - 1)];
+}
+
+// Emulates a user typing the queries: every query is sent after each typed character
+// with the last token being a prefix. Consecutive requests of a query share the caches
+// of the search engine, so this mode measures the latency of the incremental search.
+// Use a single search thread for the requests of a query to be processed by the same geocoder.
+void ReplayTyping(TestSearchEngine & engine, m2::RectD const & viewport, string queriesPath,
+                  string const & locale)
+{
+  vector<string> queries;
+  {
+    if (queriesPath.empty())
+      queriesPath = base::JoinPath(GetPlatform().WritableDir(), kDefaultQueriesPathSuffix);
+    ReadStringsFromFile(queriesPath, queries);
+  }
+
+  cout << fixed << setprecision(3);
+
+  vector<double> keystrokeTimes;
+  for (auto const & query : queries)
+  {
+    auto const uniQuery = strings::MakeUniString(query);
+
+    double queryTime = 0;
+    double queryMaxTime = 0;
+    for (size_t length = 1; length <= uniQuery.size(); ++length)
+    {
+      strings::UniString const typed(uniQuery.begin(), uniQuery.begin() + length);
+      TestSearchRequest request(engine, strings::ToUtf8(typed), locale, Mode::Everywhere, viewport);
+      request.Run();
+
+      auto const time = duration_cast<duration<double>>(request.ResponseTime()).count();
+      keystrokeTimes.push_back(time);
+      queryTime += time;
+      queryMaxTime = max(queryMaxTime, time);
+    }
+
+    cout << query << "\t" << uniQuery.size() << " keystrokes\t[total " << queryTime << "s, max "
+         << queryMaxTime << "s]" << endl;
+  }
+
+  if (keystrokeTimes.empty())
+    return;
+
+  double averageTime;
+  double maxTime;
+  double varianceTime;
+  double stdDevTime;
+  CalcStatistics(keystrokeTimes, averageTime, maxTime, varianceTime, stdDevTime);
+  sort(keystrokeTimes.begin(), keystrokeTimes.end());
+
+  cout << endl;
+  cout << "Keystrokes: " << keystrokeTimes.size() << endl;
+  cout << "Average keystroke response time: " << averageTime << "s"
+       << " (std. dev. " << stdDevTime << "s)" << endl;
+  cout << "Keystroke response time p50: " << GetPercentile(keystrokeTimes, 0.5)
+       << "s, p90: " << GetPercentile(keystrokeTimes, 0.9) << "s, max: " << maxTime << "s"
+       << endl;
+}
+
+// Runs all the queries through Engine::SearchBatch(), so they are spread over all
+// search threads, and reports the throughput and the per-query latencies.
+void RunBatch(TestSearchEngine & engine, m2::RectD const & viewport, string queriesPath,
+              string const & locale, size_t top)
+{
+  // Size of the viewport around the point of a query.
+  double constexpr kQueryViewportSizeM = 10000.0;
+
+  vector<string> lines;
+  {
+    if (queriesPath.empty())
+      queriesPath = base::JoinPath(GetPlatform().WritableDir(), kDefaultQueriesPathSuffix);
+    ReadStringsFromFile(queriesPath, lines);
+  }
+
+  vector<string> queries;
+  vector<SearchParams> batch;
+  for (auto const & line : lines)
+  {
+    vector<string> parts;
+    Split(line, '\t', parts);
+    if (parts.empty())
+      continue;
+
+    SearchParams params;
+    params.m_query = MakePrefixFree(parts[0]);
+    params.m_inputLocale = locale;
+    params.m_mode = Mode::Everywhere;
+    params.m_viewport = viewport;
+
+    double lat;
+    double lon;
+    if (parts.size() == 2 && MatchLatLonDegree(parts[1], lat, lon))
+    {
+      auto const point = mercator::FromLatLon(lat, lon);
+      params.m_position = point;
+      params.m_viewport = mercator::RectByCenterXYAndSizeInMeters(point, kQueryViewportSizeM);
+    }
+    else if (parts.size() != 1)
+    {
+      LOG(LERROR, ("Malformed query:", line));
+      continue;
+    }
+
+    queries.push_back(params.m_query);
+    batch.push_back(std::move(params));
+  }
+
+  base::Timer timer;
+  auto const results = engine.SearchBatch(std::move(batch));
+  auto const totalTime = timer.ElapsedSeconds();
+
+  vector<double> responseTimes(results.size());
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    responseTimes[i] = duration_cast<duration<double>>(results[i].m_elapsed).count();
+    vector<Result> const topResults(results[i].m_results.begin(), results[i].m_results.end());
+    PrintTopResults(queries[i], topResults, top, responseTimes[i]);
+  }
+
+  if (responseTimes.empty())
+    return;
+
+  double averageTime;
+  double maxTime;
+  double varianceTime;
+  double stdDevTime;
+  CalcStatistics(responseTimes, averageTime, maxTime, varianceTime, stdDevTime);
+  sort(responseTimes.begin(), responseTimes.end());
+
+  cout << fixed << setprecision(3);
+  cout << endl;
+  cout << "Queries: " << responseTimes.size() << ", total time: " << totalTime << "s" << endl;
+  cout << "Throughput: " << static_cast<double>(responseTimes.size()) / totalTime
+       << " queries/s" << endl;
+  cout << "Average response time: " << averageTime << "s"
+       << " (std. dev. " << stdDevTime << "s)" << endl;
+  cout << "Response time p50: " << GetPercentile(responseTimes, 0.5)
+       << "s, p90: " << GetPercentile(responseTimes, 0.9) << "s, max: " << maxTime << "s"
+       << endl;
+}
+
+// Writes the histograms of all search stages as
+// {"<stage>": {"count", "sum_us", "max_us", "p50_us", "p90_us", "p99_us",
+//              "buckets": [{"le_us", "count"}, ...]}, ...},
+// where only non-empty buckets are listed and "le_us" is the exclusive upper bound of a bucket.
+void DumpLatencyStats(LatencyStats const & stats, string const & path)
+{
+  using Stage = LatencyStats::Stage;
+
+  auto root = base::NewJSONObject();
+  for (size_t i = 0; i < static_cast<size_t>(Stage::Count); ++i)
+  {
+    auto const stage = static_cast<Stage>(i);
+    auto const histogram = stats.GetHistogram(stage);
+
+    auto json = base::NewJSONObject();
+    ToJSONObject(*json, "count", histogram.m_count);
+    ToJSONObject(*json, "sum_us", histogram.m_sumUs);
+    ToJSONObject(*json, "max_us", histogram.m_maxUs);
+    ToJSONObject(*json, "p50_us", histogram.GetPercentileUs(0.5));
+    ToJSONObject(*json, "p90_us", histogram.GetPercentileUs(0.9));
+    ToJSONObject(*json, "p99_us", histogram.GetPercentileUs(0.99));
+
+    auto buckets = base::NewJSONArray();
+    for (size_t b = 0; b < LatencyStats::kNumBuckets; ++b)
+    {
+      if (histogram.m_buckets[b] == 0)
+        continue;
+      auto bucket = base::NewJSONObject();
+      ToJSONObject(*bucket, "le_us", uint64_t{1} << b);
+      ToJSONObject(*bucket, "count", histogram.m_buckets[b]);
+      ToJSONArray(*buckets, bucket);
+    }
+    ToJSONObject(*json, "buckets", buckets);
+
+    ToJSONObject(*root, DebugPrint(stage), json);
+  }
+
+  ofstream os(path);
+  os << base::DumpToString(root, JSON_INDENT(2)) << endl;
+  if (!os)
+    LOG(LERROR, ("Can't write latency stats to", path));
+}
+
 int main(int argc, char * argv[])
 {
   platform::tests_support::ChangeMaxNumberOfOpenFiles(kMaxOpenFiles);
@@ -370,7 +573,9 @@ int main(int argc, char * argv[])
   FrozenDataSource dataSource;
   InitDataSource(dataSource, FLAGS_mwm_list_path);
 
-  auto engine = InitSearchEngine(dataSource, FLAGS_locale, FLAGS_num_threads);
+  auto engine = InitSearchEngine(dataSource, FLAGS_locale, FLAGS_num_threads,
+                                 static_cast<size_t>(FLAGS_num_geocoder_threads),
+                                 !FLAGS_latency_stats_json.empty() /* collectLatencyStats */);
   engine->InitAffiliations();
 
   m2::RectD viewport;
@@ -381,10 +586,23 @@ int main(int argc, char * argv[])
   if (!FLAGS_check_completeness.empty())
   {
     CheckCompleteness(FLAGS_check_completeness, dataSource, *engine, viewport, FLAGS_locale);
-    return 0;
+  }
+  else if (FLAGS_replay_typing)
+  {
+    ReplayTyping(*engine, viewport, FLAGS_queries_path, FLAGS_locale);
+  }
+  else if (FLAGS_batch)
+  {
+    RunBatch(*engine, viewport, FLAGS_queries_path, FLAGS_locale,
+             static_cast<size_t>(FLAGS_top));
+  }
+  else
+  {
+    RunRequests(*engine, viewport, FLAGS_queries_path, FLAGS_locale, FLAGS_ranking_csv_file,
+                static_cast<size_t>(FLAGS_top));
   }
 
-  RunRequests(*engine, viewport, FLAGS_queries_path, FLAGS_locale, FLAGS_ranking_csv_file,
-              static_cast<size_t>(FLAGS_top));
+  if (auto const * stats = engine->GetLatencyStats())
+    DumpLatencyStats(*stats, FLAGS_latency_stats_json);
   return 0;
 }
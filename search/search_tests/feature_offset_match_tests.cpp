@@ -99,4 +99,47 @@ UNIT_TEST(MatchPrefixInTrieTest)
     TEST(vals.at(1), (vals));
   }
 }
+
+UNIT_TEST(MatchPrefixInTrie_ResumeFromFrontier)
+{
+  Trie trie;
+
+  vector<pair<string, uint32_t>> const data = {
+      {"moscow", 1},  {"moskva", 2},   {"mosque", 3}, {"mocow", 4},  {"moscowskaya", 5},
+      {"mascow", 6},  {"most", 7},     {"mos", 8},    {"minsk", 9},  {"moscowa", 10},
+      {"noscow", 11}, {"moscovia", 12}};
+
+  for (auto const & kv : data)
+    trie.Add(MakeUniString(kv.first), kv.second);
+
+  trie::MemTrieIterator<Key, ValueList> const rootIterator(trie.GetRootIterator());
+  search::TrieRootPrefix<ValueList> const langRoot(rootIterator, {0} /* edge */);
+
+  UniString const query = MakeUniString("moscowskaya");
+  search::TrieFrontiers frontiers;
+  size_t prevMaxErrors = 0;
+  for (size_t length = 1; length <= query.size(); ++length)
+  {
+    UniString const token(query.begin(), query.begin() + length);
+    auto const dfa = PrefixDFA(search::BuildLevenshteinDFA(token));
+
+    map<uint32_t, bool> expected;
+    search::impl::MatchInTrie(rootIterator, nullptr, 0 /* prefixSize */, dfa,
+                              [&expected](uint32_t v, bool exactMatch) { expected[v] = exactMatch; });
+
+    // Resumes only while the number of allowed errors is the same, as TrieFrontiersCache does.
+    size_t const maxErrors = search::GetMaxErrorsForToken(token);
+    frontiers.m_resumeFrom.clear();
+    if (maxErrors == prevMaxErrors)
+      frontiers.m_resumeFrom = frontiers.m_found;
+    prevMaxErrors = maxErrors;
+
+    map<uint32_t, bool> actual;
+    search::MatchPrefixInTrie(dfa, langRoot, 0 /* lang */, frontiers,
+                              [&actual](uint32_t v, bool exactMatch) { actual[v] = exactMatch; });
+
+    TEST_EQUAL(actual, expected, (token));
+    TEST_EQUAL(frontiers.m_found.count(0), 1, (token));
+  }
+}
 } // namespace feature_offset_match_tests
@@ -0,0 +1,175 @@
+#include "testing/testing.hpp"
+
+#include "search/cbv.hpp"
+#include "search/geometry_cache.hpp"
+
+#include "indexer/mwm_set.hpp"
+
+#include "coding/compressed_bit_vector.hpp"
+
+#include "geometry/rect2d.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace geometry_cache_tests
+{
+using namespace search;
+using namespace std;
+
+class TestMwmInfo : public MwmInfo
+{
+public:
+  using MwmInfo::SetStatus;
+};
+
+MwmSet::MwmId MakeAliveMwmId()
+{
+  auto info = make_shared<TestMwmInfo>();
+  info->SetStatus(MwmInfo::STATUS_REGISTERED);
+  return MwmSet::MwmId(info);
+}
+
+CBV MakeCBV(vector<uint64_t> features)
+{
+  return CBV(coding::CompressedBitVectorBuilder::FromBitPositions(move(features)));
+}
+
+SharedGeometryCache::Pred EqualTo(m2::RectD const & rect, int scale)
+{
+  return [rect, scale](m2::RectD const & r, int s) { return s == scale && r == rect; };
+}
+
+UNIT_TEST(SharedGeometryCache_Smoke)
+{
+  SharedGeometryCache cache(1 << 20 /* maxSizeBytes */);
+  auto const mwm1 = MakeAliveMwmId();
+  auto const mwm2 = MakeAliveMwmId();
+  m2::RectD const rect(0, 0, 1, 1);
+
+  m2::RectD foundRect;
+  int foundScale = 0;
+  CBV cbv;
+  TEST(!cache.Find(mwm1, 0 /* kind */, EqualTo(rect, 10), foundRect, foundScale, cbv), ());
+
+  cache.Insert(mwm1, 0 /* kind */, rect, 10 /* scale */, MakeCBV({1, 5}));
+  TEST(cache.Find(mwm1, 0 /* kind */, EqualTo(rect, 10), foundRect, foundScale, cbv), ());
+  TEST_EQUAL(foundRect, rect, ());
+  TEST_EQUAL(foundScale, 10, ());
+  TEST(cbv.HasBit(1), ());
+  TEST(cbv.HasBit(5), ());
+  TEST_EQUAL(cbv.PopCount(), 2, ());
+
+  TEST(!cache.Find(mwm1, 1 /* kind */, EqualTo(rect, 10), foundRect, foundScale, cbv), ());
+  TEST(!cache.Find(mwm2, 0 /* kind */, EqualTo(rect, 10), foundRect, foundScale, cbv), ());
+  TEST(!cache.Find(mwm1, 0 /* kind */, EqualTo(rect, 11), foundRect, foundScale, cbv), ());
+
+  // Duplicates are not stored.
+  cache.Insert(mwm1, 0 /* kind */, rect, 10 /* scale */, MakeCBV({1, 5}));
+  TEST_EQUAL(cache.GetNumEntries(), 1, ());
+
+  cache.Clear();
+  TEST_EQUAL(cache.GetNumEntries(), 0, ());
+  TEST_EQUAL(cache.GetSizeInBytes(), 0, ());
+}
+
+UNIT_TEST(SharedGeometryCache_Budget)
+{
+  auto const mwm = MakeAliveMwmId();
+  auto const features = MakeCBV({1, 2, 3});
+
+  // A single shard fits two entries only.
+  SharedGeometryCache probe(1 << 20 /* maxSizeBytes */, 1 /* numShards */);
+  probe.Insert(mwm, 0 /* kind */, m2::RectD(0, 0, 1, 1), 10 /* scale */, features);
+  auto const entrySize = probe.GetSizeInBytes();
+  TEST_GREATER(entrySize, 0, ());
+
+  SharedGeometryCache cache(2 * entrySize + entrySize / 2, 1 /* numShards */);
+  for (int i = 0; i < 3; ++i)
+    cache.Insert(mwm, 0 /* kind */, m2::RectD(i, i, i + 1, i + 1), 10 /* scale */, features);
+  TEST_EQUAL(cache.GetNumEntries(), 2, ());
+  TEST_LESS_OR_EQUAL(cache.GetSizeInBytes(), 2 * entrySize + entrySize / 2, ());
+
+  // The least recently used entry is evicted.
+  m2::RectD rect;
+  int scale = 0;
+  CBV cbv;
+  TEST(!cache.Find(mwm, 0 /* kind */, EqualTo(m2::RectD(0, 0, 1, 1), 10), rect, scale, cbv), ());
+  TEST(cache.Find(mwm, 0 /* kind */, EqualTo(m2::RectD(2, 2, 3, 3), 10), rect, scale, cbv), ());
+
+  // Entries larger than the budget are not cached.
+  SharedGeometryCache tiny(entrySize / 2, 1 /* numShards */);
+  tiny.Insert(mwm, 0 /* kind */, m2::RectD(0, 0, 1, 1), 10 /* scale */, features);
+  TEST_EQUAL(tiny.GetNumEntries(), 0, ());
+}
+
+UNIT_TEST(SharedGeometryCache_RemoveDeregistered)
+{
+  SharedGeometryCache cache(1 << 20 /* maxSizeBytes */, 1 /* numShards */);
+  auto const mwm1 = MakeAliveMwmId();
+  auto const mwm2 = MakeAliveMwmId();
+  m2::RectD const rect(0, 0, 1, 1);
+  cache.Insert(mwm1, 0 /* kind */, rect, 10 /* scale */, MakeCBV({1}));
+  cache.Insert(mwm1, 1 /* kind */, rect, 10 /* scale */, MakeCBV({2}));
+  cache.Insert(mwm2, 0 /* kind */, rect, 10 /* scale */, MakeCBV({3}));
+  TEST_EQUAL(cache.GetNumEntries(), 3, ());
+  auto const size = cache.GetSizeInBytes();
+
+  cache.RemoveDeregistered();
+  TEST_EQUAL(cache.GetNumEntries(), 3, ());
+
+  static_pointer_cast<TestMwmInfo>(mwm1.GetInfo())->SetStatus(MwmInfo::STATUS_DEREGISTERED);
+  cache.RemoveDeregistered();
+  TEST_EQUAL(cache.GetNumEntries(), 1, ());
+  TEST_LESS(cache.GetSizeInBytes(), size, ());
+
+  m2::RectD foundRect;
+  int foundScale = 0;
+  CBV cbv;
+  TEST(cache.Find(mwm2, 0 /* kind */, EqualTo(rect, 10), foundRect, foundScale, cbv), ());
+  TEST(cbv.HasBit(3), ());
+}
+
+UNIT_TEST(SharedGeometryCache_Threads)
+{
+  SharedGeometryCache cache(1 << 20 /* maxSizeBytes */);
+  vector<MwmSet::MwmId> mwms;
+  for (size_t i = 0; i < 8; ++i)
+    mwms.push_back(MakeAliveMwmId());
+
+  // Each thread inserts and reads clones of its own bit vector.
+  size_t constexpr kNumThreads = 4;
+  vector<thread> threads;
+  vector<size_t> hits(kNumThreads);
+  for (size_t t = 0; t < kNumThreads; ++t)
+  {
+    threads.emplace_back([&, t]() {
+      auto const features = MakeCBV({t});
+      for (size_t i = 0; i < 1000; ++i)
+      {
+        auto const & mwm = mwms[i % mwms.size()];
+        m2::RectD const rect(i % 10, 0, i % 10 + 1, 1);
+        m2::RectD foundRect;
+        int scale = 0;
+        CBV cbv;
+        if (cache.Find(mwm, static_cast<int>(t), EqualTo(rect, 10), foundRect, scale, cbv))
+        {
+          TEST(cbv.HasBit(t), ());
+          ++hits[t];
+        }
+        else
+        {
+          cache.Insert(mwm, static_cast<int>(t), rect, 10 /* scale */, features);
+        }
+      }
+    });
+  }
+  for (auto & thread : threads)
+    thread.join();
+
+  for (auto const h : hits)
+    TEST_GREATER(h, 0, ());
+}
+}  // namespace geometry_cache_tests
@@ -0,0 +1,94 @@
+#include "testing/testing.hpp"
+
+#include "search/latency_stats.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace latency_stats_tests
+{
+using namespace search;
+using namespace std;
+
+using Stage = LatencyStats::Stage;
+
+UNIT_TEST(LatencyStats_Buckets)
+{
+  TEST_EQUAL(LatencyStats::GetBucket(0), 0, ());
+  TEST_EQUAL(LatencyStats::GetBucket(1), 1, ());
+  TEST_EQUAL(LatencyStats::GetBucket(2), 2, ());
+  TEST_EQUAL(LatencyStats::GetBucket(3), 2, ());
+  TEST_EQUAL(LatencyStats::GetBucket(4), 3, ());
+  TEST_EQUAL(LatencyStats::GetBucket(1000), 10, ());
+  TEST_EQUAL(LatencyStats::GetBucket(UINT64_MAX), LatencyStats::kNumBuckets - 1, ());
+}
+
+UNIT_TEST(LatencyStats_Smoke)
+{
+  LatencyStats stats;
+  for (uint64_t us = 1; us <= 100; ++us)
+    stats.AddUs(Stage::Retrieval, us);
+  stats.Add(Stage::Ranking, chrono::milliseconds(3));
+
+  auto const retrieval = stats.GetHistogram(Stage::Retrieval);
+  TEST_EQUAL(retrieval.m_count, 100, ());
+  TEST_EQUAL(retrieval.m_sumUs, 5050, ());
+  TEST_EQUAL(retrieval.m_maxUs, 100, ());
+  // 50us is in [32, 64).
+  TEST_EQUAL(retrieval.GetPercentileUs(0.5), 64, ());
+  TEST_EQUAL(retrieval.GetPercentileUs(0.99), 100, ());
+
+  auto const ranking = stats.GetHistogram(Stage::Ranking);
+  TEST_EQUAL(ranking.m_count, 1, ());
+  TEST_EQUAL(ranking.m_sumUs, 3000, ());
+  TEST_EQUAL(stats.GetHistogram(Stage::Total).m_count, 0, ());
+  TEST_EQUAL(stats.GetHistogram(Stage::Total).GetPercentileUs(0.5), 0, ());
+
+  stats.Clear();
+  TEST_EQUAL(stats.GetHistogram(Stage::Retrieval).m_count, 0, ());
+  TEST_EQUAL(stats.GetHistogram(Stage::Retrieval).m_maxUs, 0, ());
+}
+
+UNIT_TEST(LatencyStats_ScopedTimer)
+{
+  LatencyStats stats;
+  {
+    LatencyStats::ScopedTimer timer(&stats, Stage::Streets);
+  }
+  {
+    // Timing is disabled.
+    LatencyStats::ScopedTimer timer(nullptr, Stage::Streets);
+  }
+  TEST_EQUAL(stats.GetHistogram(Stage::Streets).m_count, 1, ());
+}
+
+UNIT_TEST(LatencyStats_Concurrent)
+{
+  size_t constexpr kNumThreads = 4;
+  uint64_t constexpr kNumSamples = 10000;
+
+  LatencyStats stats;
+  vector<thread> threads;
+  for (size_t i = 0; i < kNumThreads; ++i)
+  {
+    threads.emplace_back([&stats, i]()
+    {
+      for (uint64_t us = 0; us < kNumSamples; ++us)
+        stats.AddUs(Stage::PathFinding, us + i);
+    });
+  }
+  for (auto & t : threads)
+    t.join();
+
+  auto const histogram = stats.GetHistogram(Stage::PathFinding);
+  TEST_EQUAL(histogram.m_count, kNumThreads * kNumSamples, ());
+  TEST_EQUAL(histogram.m_maxUs, kNumSamples - 1 + kNumThreads - 1, ());
+
+  uint64_t total = 0;
+  for (auto const count : histogram.m_buckets)
+    total += count;
+  TEST_EQUAL(total, histogram.m_count, ());
+}
+}  // namespace latency_stats_tests
@@ -0,0 +1,89 @@
+#include "testing/testing.hpp"
+
+#include "search/cbv.hpp"
+#include "search/popular_prefixes.hpp"
+
+#include "coding/reader.hpp"
+#include "coding/writer.hpp"
+
+#include "base/string_utils.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace popular_prefixes_tests
+{
+using namespace search;
+using namespace std;
+
+PopularPrefixes::Entry MakeEntry(int8_t lang, string const & prefix, vector<uint32_t> features)
+{
+  PopularPrefixes::Entry entry;
+  entry.m_lang = lang;
+  entry.m_prefix = strings::MakeUniString(prefix);
+  entry.m_features = move(features);
+  return entry;
+}
+
+vector<uint64_t> GetFeatures(CBV const & cbv)
+{
+  vector<uint64_t> features;
+  cbv.ForEach([&features](uint64_t id) { features.push_back(id); });
+  return features;
+}
+
+UNIT_TEST(PopularPrefixes_Serialization)
+{
+  vector<uint32_t> many(PopularPrefixes::kMaxNumFeatures);
+  for (uint32_t i = 0; i < many.size(); ++i)
+    many[i] = 3 * i;
+
+  vector<PopularPrefixes::Entry> entries = {
+      MakeEntry(0, "a", {1, 5, 7}), MakeEntry(0, "ab", many), MakeEntry(1, "a", {2}),
+      MakeEntry(1, "бу", {100000, 100001})};
+  sort(entries.begin(), entries.end());
+
+  vector<uint8_t> buffer;
+  {
+    MemWriter<vector<uint8_t>> writer(buffer);
+    // Some data before the section.
+    writer.Write("xyz", 3);
+    PopularPrefixes::Serialize(entries, writer);
+  }
+
+  MemReader reader(buffer.data() + 3, buffer.size() - 3);
+  PopularPrefixes prefixes(reader);
+  TEST_EQUAL(prefixes.GetNumEntries(), entries.size(), ());
+
+  for (auto const & entry : entries)
+  {
+    CBV features;
+    TEST(prefixes.Get(entry.m_lang, entry.m_prefix, features), (entry.m_prefix));
+    TEST_EQUAL(GetFeatures(features),
+               vector<uint64_t>(entry.m_features.begin(), entry.m_features.end()), ());
+  }
+
+  CBV features;
+  TEST(!prefixes.Get(0, strings::MakeUniString("b"), features), ());
+  TEST(!prefixes.Get(0, strings::MakeUniString("бу"), features), ());
+  TEST(!prefixes.Get(2, strings::MakeUniString("a"), features), ());
+  TEST(!prefixes.Get(1, strings::MakeUniString("abc"), features), ());
+}
+
+UNIT_TEST(PopularPrefixes_Empty)
+{
+  vector<uint8_t> buffer;
+  {
+    MemWriter<vector<uint8_t>> writer(buffer);
+    PopularPrefixes::Serialize({}, writer);
+  }
+
+  MemReader reader(buffer.data(), buffer.size());
+  PopularPrefixes prefixes(reader);
+  TEST_EQUAL(prefixes.GetNumEntries(), 0, ());
+
+  CBV features;
+  TEST(!prefixes.Get(0, strings::MakeUniString("a"), features), ());
+}
+}  // namespace popular_prefixes_tests
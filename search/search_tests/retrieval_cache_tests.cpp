@@ -0,0 +1,180 @@
+#include "testing/testing.hpp"
+
+#include "search/cbv.hpp"
+#include "search/query_params.hpp"
+#include "search/retrieval.hpp"
+#include "search/retrieval_cache.hpp"
+
+#include "indexer/mwm_set.hpp"
+
+#include "coding/compressed_bit_vector.hpp"
+
+#include "base/string_utils.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace retrieval_cache_tests
+{
+using namespace search;
+using namespace std;
+
+Retrieval::ExtendedFeatures MakeFeatures(vector<uint64_t> features)
+{
+  return Retrieval::ExtendedFeatures(
+      CBV(coding::CompressedBitVectorBuilder::FromBitPositions(move(features))));
+}
+
+class TestMwmInfo : public MwmInfo
+{
+public:
+  using MwmInfo::SetStatus;
+};
+
+uint64_t constexpr kUnlimitedSizeBytes = numeric_limits<uint64_t>::max();
+
+MwmSet::MwmId MakeAliveMwmId()
+{
+  auto info = make_shared<TestMwmInfo>();
+  info->SetStatus(MwmInfo::STATUS_REGISTERED);
+  return MwmSet::MwmId(info);
+}
+
+UNIT_TEST(RetrievalCache_MakeKey)
+{
+  QueryParams::Token token(strings::MakeUniString("moscow"));
+  QueryParams::TypeIndices const types = {1, 2};
+  QueryParams::Langs langs;
+  langs.Insert(0);
+
+  auto const key = RetrievalCache::MakeKey(token, false /* isPrefix */, types, langs);
+  TEST_EQUAL(key, RetrievalCache::MakeKey(token, false /* isPrefix */, types, langs), ());
+  TEST_NOT_EQUAL(key, RetrievalCache::MakeKey(token, true /* isPrefix */, types, langs), ());
+  TEST_NOT_EQUAL(key, RetrievalCache::MakeKey(token, false /* isPrefix */, {1}, langs), ());
+
+  QueryParams::Langs otherLangs;
+  otherLangs.Insert(1);
+  TEST_NOT_EQUAL(key, RetrievalCache::MakeKey(token, false /* isPrefix */, types, otherLangs), ());
+
+  QueryParams::Token longer(strings::MakeUniString("moscowa"));
+  TEST_NOT_EQUAL(key, RetrievalCache::MakeKey(longer, false /* isPrefix */, types, langs), ());
+
+  QueryParams::Token withSynonym(strings::MakeUniString("moscow"));
+  withSynonym.AddSynonym(std::string("msk"));
+  TEST_NOT_EQUAL(key, RetrievalCache::MakeKey(withSynonym, false /* isPrefix */, types, langs), ());
+}
+
+UNIT_TEST(RetrievalCache_Smoke)
+{
+  RetrievalCache cache(2 /* maxSize */, kUnlimitedSizeBytes);
+  auto const mwm1 = MakeAliveMwmId();
+  auto const mwm2 = MakeAliveMwmId();
+
+  size_t calls = 0;
+  auto const retrieve = [&calls]() {
+    ++calls;
+    return MakeFeatures({calls});
+  };
+
+  bool found = true;
+  auto features = cache.Get(mwm1, "a", retrieve, found);
+  TEST(!found, ());
+  TEST(features.m_features.HasBit(1), ());
+
+  features = cache.Get(mwm1, "a", retrieve, found);
+  TEST(found, ());
+  TEST(features.m_features.HasBit(1), ());
+  TEST_EQUAL(calls, 1, ());
+
+  // The same key in another mwm.
+  features = cache.Get(mwm2, "a", retrieve, found);
+  TEST(!found, ());
+  TEST(features.m_features.HasBit(2), ());
+
+  // (mwm1, "a") is the least recently used entry.
+  cache.Get(mwm2, "b", retrieve, found);
+  TEST(!found, ());
+  TEST_EQUAL(cache.GetSize(), 2, ());
+  cache.Get(mwm1, "a", retrieve, found);
+  TEST(!found, ());
+  cache.Get(mwm2, "b", retrieve, found);
+  TEST(found, ());
+}
+
+UNIT_TEST(RetrievalCache_FailedRetrieval)
+{
+  RetrievalCache cache(2 /* maxSize */, kUnlimitedSizeBytes);
+  auto const mwm = MakeAliveMwmId();
+
+  bool found = false;
+  TEST_ANY_THROW(cache.Get(mwm, "a", []() -> Retrieval::ExtendedFeatures {
+    throw runtime_error("Cancelled");
+  }, found), ());
+  TEST_EQUAL(cache.GetSize(), 0, ());
+
+  cache.Get(mwm, "a", []() { return MakeFeatures({1}); }, found);
+  TEST(!found, ());
+}
+
+UNIT_TEST(RetrievalCache_MaxSizeBytes)
+{
+  auto const mwm = MakeAliveMwmId();
+  auto const small = MakeFeatures({1});
+  vector<uint64_t> bigFeatures;
+  for (uint64_t i = 0; i < 32; ++i)
+    bigFeatures.push_back(i * 1000);
+  auto const big = MakeFeatures(bigFeatures);
+
+  // Measures the sizes of the entries.
+  RetrievalCache probe(10 /* maxSize */, kUnlimitedSizeBytes);
+  bool found = false;
+  probe.Get(mwm, "a", [&]() { return small; }, found);
+  auto const smallSize = probe.GetSizeInBytes();
+  probe.Clear();
+  probe.Get(mwm, "a", [&]() { return big; }, found);
+  auto const bigSize = probe.GetSizeInBytes();
+  TEST_LESS(smallSize, bigSize, ());
+
+  RetrievalCache cache(10 /* maxSize */, bigSize - 1);
+  cache.Get(mwm, "big", [&]() { return big; }, found);
+  TEST(!found, ());
+  TEST_EQUAL(cache.GetSize(), 0, ());
+  TEST_EQUAL(cache.GetSizeInBytes(), 0, ());
+
+  // Old entries are evicted when the size is exceeded.
+  size_t const maxSmallEntries = (bigSize - 1) / smallSize;
+  for (size_t i = 0; i <= maxSmallEntries; ++i)
+    cache.Get(mwm, strings::to_string(i), [&]() { return small; }, found);
+  TEST_EQUAL(cache.GetSize(), maxSmallEntries, ());
+  TEST_LESS_OR_EQUAL(cache.GetSizeInBytes(), bigSize - 1, ());
+  cache.Get(mwm, "0", [&]() { return small; }, found);
+  TEST(!found, ());
+}
+
+UNIT_TEST(RetrievalCache_RemoveDeregistered)
+{
+  RetrievalCache cache(4 /* maxSize */, kUnlimitedSizeBytes);
+  auto const alive = MakeAliveMwmId();
+  auto deregistered = make_shared<TestMwmInfo>();
+  deregistered->SetStatus(MwmInfo::STATUS_REGISTERED);
+
+  bool found = false;
+  auto const retrieve = []() { return MakeFeatures({1}); };
+  cache.Get(alive, "a", retrieve, found);
+  cache.Get(MwmSet::MwmId(deregistered), "a", retrieve, found);
+  TEST_EQUAL(cache.GetSize(), 2, ());
+
+  deregistered->SetStatus(MwmInfo::STATUS_DEREGISTERED);
+  cache.RemoveDeregistered();
+  TEST_EQUAL(cache.GetSize(), 1, ());
+  cache.Get(alive, "a", retrieve, found);
+  TEST(found, ());
+
+  cache.Clear();
+  TEST_EQUAL(cache.GetSize(), 0, ());
+}
+}  // namespace retrieval_cache_tests
@@ -7,6 +7,8 @@
 
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 class DataSource;
 
@@ -29,6 +31,13 @@ public:
 
   std::weak_ptr<ProcessorHandle> Search(SearchParams const & params);
 
+  std::vector<Engine::BatchResult> SearchBatch(std::vector<SearchParams> batch)
+  {
+    return m_engine.SearchBatch(std::move(batch));
+  }
+
+  LatencyStats * GetLatencyStats() { return m_engine.GetLatencyStats(); }
+
   storage::CountryInfoGetter & GetCountryInfoGetter() { return *m_infoGetter; }
 
 private:
@@ -4,6 +4,7 @@
 #include "search/token_range.hpp"
 
 #include <array>
+#include <cstddef>
 #include <string>
 #include <utility>
 #include <vector>
@@ -45,8 +46,23 @@ public:
 
   std::vector<Parse> GetUniqueParses() const;
 
+  // Called for every retrieval of a query token features, |found| is true when the features
+  // are taken from the retrieval cache.
+  void OnRetrievalCacheAccess(bool found)
+  {
+    if (found)
+      ++m_retrievalCacheHits;
+    else
+      ++m_retrievalCacheMisses;
+  }
+
+  size_t GetRetrievalCacheHits() const { return m_retrievalCacheHits; }
+  size_t GetRetrievalCacheMisses() const { return m_retrievalCacheMisses; }
+
 private:
   std::vector<Parse> m_parses;
+  size_t m_retrievalCacheHits = 0;
+  size_t m_retrievalCacheMisses = 0;
 };
 
 class ResultTracer
@@ -0,0 +1,50 @@
+#include "search/trie_frontiers_cache.hpp"
+
+#include "indexer/search_string_utils.hpp"
+
+#include <utility>
+
+namespace search
+{
+using namespace std;
+
+void TrieFrontiersCache::Get(MwmSet::MwmId const & mwmId, strings::UniString const & token,
+                             TrieFrontiers & frontiers) const
+{
+  frontiers.m_resumeFrom.clear();
+
+  auto const it = m_entries.find(mwmId);
+  if (it == m_entries.end())
+    return;
+
+  auto const & entry = it->second;
+  if (!strings::StartsWith(token, entry.m_token))
+    return;
+
+  // The prefix DFA for a longer token may allow more errors, its matches are not limited
+  // by the previous frontier in this case.
+  if (GetMaxErrorsForToken(token) != GetMaxErrorsForToken(entry.m_token))
+    return;
+
+  frontiers.m_resumeFrom = entry.m_frontiers;
+}
+
+void TrieFrontiersCache::Put(MwmSet::MwmId const & mwmId, strings::UniString const & token,
+                             Frontiers && frontiers)
+{
+  auto & entry = m_entries[mwmId];
+  entry.m_token = token;
+  entry.m_frontiers = move(frontiers);
+}
+
+void TrieFrontiersCache::RemoveDeregistered()
+{
+  for (auto it = m_entries.begin(); it != m_entries.end();)
+  {
+    if (it->first.IsAlive())
+      ++it;
+    else
+      it = m_entries.erase(it);
+  }
+}
+}  // namespace search
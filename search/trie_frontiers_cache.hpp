@@ -0,0 +1,54 @@
+#pragma once
+
+#include "search/feature_offset_match.hpp"
+
+#include "indexer/mwm_set.hpp"
+
+#include "base/macros.hpp"
+#include "base/string_utils.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+
+namespace search
+{
+// Frontiers of the last prefix token walk in the search index of each mwm.
+// While the query is being typed, the walk for the next keystroke is resumed
+// from the frontier of the previous one, see MatchPrefixInTrie().
+//
+// *NOTE* This class is not thread-safe.
+class TrieFrontiersCache
+{
+public:
+  using Frontiers = std::map<int8_t, TrieFrontiers::Paths>;
+
+  TrieFrontiersCache() = default;
+
+  // Fills |frontiers.m_resumeFrom| with the frontiers of the last walk in |mwmId|
+  // if the walk for the prefix |token| may be resumed from them, i.e. the previous token
+  // is a prefix of |token| and both tokens allow the same number of errors.
+  void Get(MwmSet::MwmId const & mwmId, strings::UniString const & token,
+           TrieFrontiers & frontiers) const;
+
+  void Put(MwmSet::MwmId const & mwmId, strings::UniString const & token, Frontiers && frontiers);
+
+  // Removes entries of deregistered mwms.
+  void RemoveDeregistered();
+
+  void Clear() { m_entries.clear(); }
+
+  size_t GetSize() const { return m_entries.size(); }
+
+private:
+  struct Entry
+  {
+    strings::UniString m_token;
+    Frontiers m_frontiers;
+  };
+
+  std::map<MwmSet::MwmId, Entry> m_entries;
+
+  DISALLOW_COPY_AND_MOVE(TrieFrontiersCache);
+};
+}  // namespace search
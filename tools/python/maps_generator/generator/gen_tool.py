@@ -37,6 +37,7 @@ class GenTool:
         "make_city_roads": bool,
         "make_coasts": bool,
         "make_cross_mwm": bool,
+        "make_cross_mwm_overlay": bool,
         "make_routing_index": bool,
         "make_transit_cross_mwm": bool,
         "make_transit_cross_mwm_experimental": bool,